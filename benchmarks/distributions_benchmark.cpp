@@ -0,0 +1,86 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+// Throughput of the ziggurat distributions against their std counterparts, per engine.
+
+#include <cstddef>
+#include <cstdio>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include "psygine/utilities/distributions.hpp"
+#include "psygine/utilities/random_bulk.hpp"
+#include "psygine/utilities/time.hpp"
+
+namespace
+{
+    namespace random = psygine::utilities::random;
+    namespace time = psygine::utilities::time;
+
+    constexpr std::size_t SAMPLES = 10'000'000;
+
+    // Keeps the optimizer from discarding the samples.
+    volatile double sink = 0.0;
+
+    template <typename Engine, typename Distribution>
+    void Run(const std::string_view label, Engine engine, Distribution distribution)
+    {
+        double sum = 0.0;
+        const auto start = time::Now();
+        for (std::size_t i = 0; i < SAMPLES; ++i)
+        {
+            sum += static_cast<double>(distribution(engine));
+        }
+        const double nanoseconds = time::ElapsedSinceNanoseconds(start);
+        sink = sink + sum;
+
+        std::printf("  %-40.*s %7.2f ns/sample\n", static_cast<int>(label.size()), label.data(),
+                    nanoseconds / static_cast<double>(SAMPLES));
+    }
+
+    template <typename Engine, typename Distribution>
+    void RunFill(const std::string_view label, Engine engine, Distribution distribution)
+    {
+        std::vector<double> values(SAMPLES);
+        const auto start = time::Now();
+        distribution.fill(engine, std::span(values));
+        const double nanoseconds = time::ElapsedSinceNanoseconds(start);
+        sink = sink + values[SAMPLES / 2];
+
+        std::printf("  %-40.*s %7.2f ns/sample\n", static_cast<int>(label.size()), label.data(),
+                    nanoseconds / static_cast<double>(SAMPLES));
+    }
+
+    template <typename Engine>
+    void RunEngine(const std::string_view name, const Engine& engine)
+    {
+        std::printf("%.*s\n", static_cast<int>(name.size()), name.data());
+
+        Run("std::normal_distribution", engine, std::normal_distribution<double>(0.0, 1.0));
+        Run("random::NormalDistribution", engine, random::NormalDistribution<double>(0.0, 1.0));
+        RunFill("random::NormalDistribution::fill", engine, random::NormalDistribution<double>(0.0, 1.0));
+
+        Run("std::exponential_distribution", engine, std::exponential_distribution<double>(1.0));
+        Run("random::ExponentialDistribution", engine, random::ExponentialDistribution<double>(1.0));
+        RunFill("random::ExponentialDistribution::fill", engine, random::ExponentialDistribution<double>(1.0));
+
+        Run("std::gamma_distribution (2.5)", engine, std::gamma_distribution<double>(2.5, 1.0));
+        Run("random::GammaDistribution (2.5)", engine, random::GammaDistribution<double>(2.5, 1.0));
+        Run("std::gamma_distribution (0.5)", engine, std::gamma_distribution<double>(0.5, 1.0));
+        Run("random::GammaDistribution (0.5)", engine, random::GammaDistribution<double>(0.5, 1.0));
+
+        Run("std::poisson_distribution (4)", engine, std::poisson_distribution<int>(4.0));
+        Run("random::PoissonDistribution (4)", engine, random::PoissonDistribution<int>(4.0));
+        Run("std::poisson_distribution (100)", engine, std::poisson_distribution<int>(100.0));
+        Run("random::PoissonDistribution (100)", engine, random::PoissonDistribution<int>(100.0));
+    }
+}
+
+int main()
+{
+    RunEngine("std::mt19937", std::mt19937(12345));
+    RunEngine("std::mt19937_64", std::mt19937_64(12345));
+    RunEngine("random::SimdRng", random::SimdRng(12345));
+    return 0;
+}
@@ -0,0 +1,250 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+// Cost of the fixed-point operations against float, per operation, to choose a number type per system.
+
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <random>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "psygine/math/fixed.hpp"
+#include "psygine/math/vector.hpp"
+#include "psygine/utilities/time.hpp"
+
+namespace
+{
+    namespace math = psygine::math;
+    namespace time = psygine::utilities::time;
+
+    constexpr std::size_t VALUES = 4096;
+    constexpr std::size_t ROUNDS = 2000;
+    constexpr float STEP = 1.0F / 60.0F;
+
+    // Keeps the optimizer from discarding the results.
+    volatile double sink = 0.0;
+
+    template <typename T>
+    T Convert(const float value)
+    {
+        if constexpr (std::is_same_v<T, float>)
+        {
+            return value;
+        }
+        else
+        {
+            return T::FromFloat(value);
+        }
+    }
+
+    template <typename T>
+    double ToDouble(const T value)
+    {
+        if constexpr (std::is_same_v<T, float>)
+        {
+            return static_cast<double>(value);
+        }
+        else
+        {
+            return value.toDouble();
+        }
+    }
+
+    template <typename T>
+    T SquareRoot(const T value)
+    {
+        if constexpr (std::is_same_v<T, float>)
+        {
+            return std::sqrt(value);
+        }
+        else
+        {
+            return math::Sqrt(value);
+        }
+    }
+
+    template <typename T>
+    T Sine(const T value)
+    {
+        if constexpr (std::is_same_v<T, float>)
+        {
+            return std::sin(value);
+        }
+        else
+        {
+            return math::Sin(value);
+        }
+    }
+
+    template <typename T>
+    T Angle(const T y, const T x)
+    {
+        if constexpr (std::is_same_v<T, float>)
+        {
+            return std::atan2(y, x);
+        }
+        else
+        {
+            return math::Atan2(y, x);
+        }
+    }
+
+    template <typename Body>
+    void Run(const std::string_view label, Body body)
+    {
+        double result = 0.0;
+        const auto start = time::Now();
+        for (std::size_t round = 0; round < ROUNDS; ++round)
+        {
+            result += body();
+        }
+        const double nanoseconds = time::ElapsedSinceNanoseconds(start);
+        sink = sink + result;
+
+        std::printf("  %-40.*s %7.2f ns/op\n", static_cast<int>(label.size()), label.data(),
+                    nanoseconds / static_cast<double>(ROUNDS * VALUES));
+    }
+
+    template <typename T>
+    void RunType(const std::string_view name, const std::vector<float>& signedValues,
+                 const std::vector<float>& positiveValues)
+    {
+        std::printf("%.*s\n", static_cast<int>(name.size()), name.data());
+
+        std::vector<T> a(VALUES);
+        std::vector<T> b(VALUES);
+        for (std::size_t i = 0; i < VALUES; ++i)
+        {
+            a[i] = Convert<T>(signedValues[i]);
+            b[i] = Convert<T>(positiveValues[i]);
+        }
+
+        Run("multiply-add",
+            [&]
+            {
+                T sum{};
+                for (std::size_t i = 0; i < VALUES; ++i)
+                {
+                    sum += a[i] * b[i];
+                }
+                return ToDouble(sum);
+            });
+        Run("divide",
+            [&]
+            {
+                T sum{};
+                for (std::size_t i = 0; i < VALUES; ++i)
+                {
+                    sum += a[i] / b[i];
+                }
+                return ToDouble(sum);
+            });
+        Run("sqrt",
+            [&]
+            {
+                T sum{};
+                for (std::size_t i = 0; i < VALUES; ++i)
+                {
+                    sum += SquareRoot(b[i]);
+                }
+                return ToDouble(sum);
+            });
+        Run("sin",
+            [&]
+            {
+                T sum{};
+                for (std::size_t i = 0; i < VALUES; ++i)
+                {
+                    sum += Sine(a[i]);
+                }
+                return ToDouble(sum);
+            });
+        Run("atan2",
+            [&]
+            {
+                T sum{};
+                for (std::size_t i = 0; i < VALUES; ++i)
+                {
+                    sum += Angle(a[i], b[i]);
+                }
+                return ToDouble(sum);
+            });
+        Run("normalize vector",
+            [&]
+            {
+                math::Vector2<T> sum{};
+                for (std::size_t i = 0; i + 1 < VALUES; ++i)
+                {
+                    sum += math::Normalize(math::Vector2<T>{a[i], a[i + 1]});
+                }
+                return ToDouble(sum.x);
+            });
+    }
+
+    void RunIntegration(const std::vector<float>& signedValues)
+    {
+        std::printf("integrate positions (position += velocity * step)\n");
+
+        std::vector<float> positions(VALUES);
+        const std::vector<float>& velocities = signedValues;
+        Run("float loop",
+            [&]
+            {
+                for (std::size_t i = 0; i < VALUES; ++i)
+                {
+                    positions[i] += velocities[i] * STEP;
+                }
+                return static_cast<double>(positions[VALUES / 2]);
+            });
+
+        std::vector<math::Fixed16> fixedPositions(VALUES);
+        std::vector<math::Fixed16> fixedVelocities(VALUES);
+        math::ToFixed(velocities, fixedVelocities);
+        const auto step = math::Fixed16::FromFloat(STEP);
+        Run("Fixed16 loop",
+            [&]
+            {
+                for (std::size_t i = 0; i < VALUES; ++i)
+                {
+                    fixedPositions[i] += fixedVelocities[i] * step;
+                }
+                return fixedPositions[VALUES / 2].toDouble();
+            });
+        Run("Fixed16 MultiplyAdd (SIMD)",
+            [&]
+            {
+                math::MultiplyAdd(fixedVelocities, step, fixedPositions);
+                return fixedPositions[VALUES / 2].toDouble();
+            });
+        Run("Fixed16 ToFixed + ToFloat (SIMD)",
+            [&]
+            {
+                math::ToFixed(positions, fixedPositions);
+                math::ToFloat(fixedPositions, positions);
+                return static_cast<double>(positions[VALUES / 2]);
+            });
+    }
+}
+
+int main()
+{
+    std::mt19937 engine(12345);
+    std::uniform_real_distribution<float> signedDistribution(-3.0F, 3.0F);
+    std::uniform_real_distribution<float> positiveDistribution(0.5F, 2.0F);
+    std::vector<float> signedValues(VALUES);
+    std::vector<float> positiveValues(VALUES);
+    for (std::size_t i = 0; i < VALUES; ++i)
+    {
+        signedValues[i] = signedDistribution(engine);
+        positiveValues[i] = positiveDistribution(engine);
+    }
+
+    RunType<float>("float", signedValues, positiveValues);
+    RunType<math::Fixed16>("Fixed16 (Q16.16)", signedValues, positiveValues);
+    RunType<math::Fixed32>("Fixed32 (Q32.32)", signedValues, positiveValues);
+    RunIntegration(signedValues);
+    return 0;
+}
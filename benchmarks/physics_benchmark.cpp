@@ -0,0 +1,152 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+// Step cost of 10k-body 2D scenes, serial and on a thread pool, with a state hash to check determinism.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+#include "psygine/core/thread_pool.hpp"
+#include "psygine/physics/physics_world.hpp"
+#include "psygine/utilities/time.hpp"
+
+namespace
+{
+    namespace physics = psygine::physics;
+    namespace time = psygine::utilities::time;
+    using psygine::math::Vec2;
+
+    constexpr std::size_t BODIES = 10'000;
+    constexpr std::size_t WARMUP_STEPS = 60;
+    constexpr std::size_t MEASURED_STEPS = 120;
+    constexpr double STEP = 1.0 / 60.0;
+
+    void AddShape(physics::World& world, const physics::BodyId body, const std::size_t kind)
+    {
+        switch (kind % 3)
+        {
+        case 0:
+            world.createShape(body, {}, physics::Circle{{}, 0.5F});
+            break;
+        case 1:
+            world.createShape(body, {}, physics::MakeBox(0.5F, 0.5F));
+            break;
+        default:
+            {
+                constexpr std::array<Vec2, 5> points{{{-0.5F, -0.4F}, {0.5F, -0.4F}, {0.6F, 0.2F}, {0.0F, 0.5F},
+                                                      {-0.6F, 0.1F}}};
+                world.createShape(body, {}, physics::MakePolygon(points));
+                break;
+            }
+        }
+    }
+
+    // One big container of mixed shapes: a single island for most of the run.
+    void BuildPile(physics::World& world)
+    {
+        constexpr std::size_t COLUMNS = 100;
+        const physics::BodyId ground = world.createBody({});
+        world.createShape(ground, {}, physics::MakeOffsetBox(60.0F, 1.0F, {0.0F, -1.0F}, {}));
+        world.createShape(ground, {}, physics::MakeOffsetBox(1.0F, 100.0F, {-58.0F, 100.0F}, {}));
+        world.createShape(ground, {}, physics::MakeOffsetBox(1.0F, 100.0F, {58.0F, 100.0F}, {}));
+
+        for (std::size_t i = 0; i < BODIES; ++i)
+        {
+            const std::size_t row = i / COLUMNS;
+            const std::size_t column = i % COLUMNS;
+            physics::BodyDef def;
+            def.type = physics::BodyType::Dynamic;
+            def.position = {-55.0F + (static_cast<float>(column) * 1.1F) + (static_cast<float>(row % 2) * 0.3F),
+                            0.6F + (static_cast<float>(row) * 1.05F)};
+            AddShape(world, world.createBody(def), row + column);
+        }
+    }
+
+    // Many short box stacks far enough apart to stay separate islands.
+    void BuildStacks(physics::World& world)
+    {
+        constexpr std::size_t HEIGHT = 10;
+        const physics::BodyId ground = world.createBody({});
+        const float width = static_cast<float>(BODIES / HEIGHT) * 2.0F;
+        world.createShape(ground, {}, physics::MakeOffsetBox(width * 0.5F + 2.0F, 1.0F, {0.0F, -1.0F}, {}));
+
+        for (std::size_t stack = 0; stack < BODIES / HEIGHT; ++stack)
+        {
+            for (std::size_t level = 0; level < HEIGHT; ++level)
+            {
+                physics::BodyDef def;
+                def.type = physics::BodyType::Dynamic;
+                def.allowSleep = false;
+                def.position = {(-width * 0.5F) + (static_cast<float>(stack) * 2.0F),
+                                0.5F + static_cast<float>(level)};
+                world.createShape(world.createBody(def), {}, physics::MakeBox(0.5F, 0.5F));
+            }
+        }
+    }
+
+    std::uint64_t Hash(const physics::World& world, const std::vector<physics::BodyId>& bodies)
+    {
+        std::uint64_t hash = 14695981039346656037ULL;
+        for (const physics::BodyId body : bodies)
+        {
+            const physics::Transform xf = world.transform(body);
+            const std::array<float, 4> values{xf.position.x, xf.position.y, xf.rotation.c, xf.rotation.s};
+            std::array<unsigned char, sizeof(values)> bytes{};
+            std::memcpy(bytes.data(), values.data(), sizeof(values));
+            for (const unsigned char byte : bytes)
+            {
+                hash = (hash ^ byte) * 1099511628211ULL;
+            }
+        }
+        return hash;
+    }
+
+    template <typename Build>
+    void Run(const std::string_view label, Build build, psygine::core::ThreadPool* pool)
+    {
+        physics::World world;
+        build(world);
+        std::vector<physics::BodyId> bodies;
+        for (std::uint32_t i = 0; i < world.bodyCount(); ++i)
+        {
+            bodies.push_back({i, 0});
+        }
+
+        for (std::size_t i = 0; i < WARMUP_STEPS; ++i)
+        {
+            world.step(STEP, pool);
+        }
+        const auto start = time::Now();
+        for (std::size_t i = 0; i < MEASURED_STEPS; ++i)
+        {
+            world.step(STEP, pool);
+        }
+        const double nanoseconds = time::ElapsedSinceNanoseconds(start);
+
+        std::printf("  %-32.*s %8.3f ms/step  contacts %6zu  islands %6zu  hash %016llx\n",
+                    static_cast<int>(label.size()), label.data(),
+                    nanoseconds / static_cast<double>(MEASURED_STEPS) / 1e6, world.contactCount(),
+                    world.islandCount(), static_cast<unsigned long long>(Hash(world, bodies)));
+    }
+}
+
+int main()
+{
+    psygine::core::ThreadPool pool;
+    std::printf("%zu bodies, %zu steps after %zu warm-up steps, %zu threads\n", BODIES, MEASURED_STEPS, WARMUP_STEPS,
+                pool.concurrency());
+
+    std::printf("pile\n");
+    Run("serial", BuildPile, nullptr);
+    Run("pool", BuildPile, &pool);
+
+    std::printf("stacks\n");
+    Run("serial", BuildStacks, nullptr);
+    Run("pool", BuildStacks, &pool);
+    return 0;
+}
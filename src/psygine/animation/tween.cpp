@@ -0,0 +1,468 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#include "tween.hpp"
+
+#include <algorithm>
+#include <array>
+#include <utility>
+
+#include "psygine/debug/assert.hpp"
+#include "psygine/utilities/simd.hpp"
+
+namespace
+{
+    namespace simd = psygine::utilities::simd;
+    using psygine::animation::Easing;
+    using psygine::animation::EASING_COUNT;
+
+    template <std::size_t W>
+    using Vf = simd::Float<W>;
+
+    template <std::size_t W>
+    using Vi = simd::Int<W>;
+
+    constexpr float HALF_PI = 1.57079632679489661923F;
+
+    // Penner's overshoot constants for the Back easings.
+    constexpr float BACK_OVERSHOOT = 1.70158F;
+    constexpr float BACK_IN_OUT_OVERSHOOT = BACK_OVERSHOOT * 1.525F;
+
+    // Taylor series of cos(x) in x^2, highest power first; truncation error below 1e-8 on [0, pi/2].
+    constexpr std::array<float, 7> COS_COEFFICIENTS = {
+        1.0F / 479001600.0F,
+        -1.0F / 3628800.0F,
+        1.0F / 40320.0F,
+        -1.0F / 720.0F,
+        1.0F / 24.0F,
+        -1.0F / 2.0F,
+        1.0F
+    };
+
+    // cos(pi/2 * u) for u in [0, 1].
+    template <std::size_t W>
+    Vf<W> CosHalfPi(const Vf<W>& u)
+    {
+        const Vf<W> x = u * Vf<W>(HALF_PI);
+        const Vf<W> x2 = x * x;
+        Vf<W> result(COS_COEFFICIENTS[0]);
+        for (std::size_t i = 1; i < COS_COEFFICIENTS.size(); ++i)
+        {
+            result = (result * x2) + Vf<W>(COS_COEFFICIENTS[i]);
+        }
+        return result;
+    }
+
+    // The "in" half of each family; the "out" and "in-out" variants are derived from it by symmetry.
+    template <Easing E, std::size_t W>
+    Vf<W> EaseIn(const Vf<W>& t)
+    {
+        if constexpr (E == Easing::QuadIn || E == Easing::QuadOut || E == Easing::QuadInOut)
+        {
+            return t * t;
+        }
+        else if constexpr (E == Easing::CubicIn || E == Easing::CubicOut || E == Easing::CubicInOut)
+        {
+            return t * t * t;
+        }
+        else if constexpr (E == Easing::QuartIn || E == Easing::QuartOut || E == Easing::QuartInOut)
+        {
+            const Vf<W> t2 = t * t;
+            return t2 * t2;
+        }
+        else if constexpr (E == Easing::SineIn || E == Easing::SineOut || E == Easing::SineInOut)
+        {
+            return Vf<W>(1.0F) - CosHalfPi(t);
+        }
+        else if constexpr (E == Easing::BackIn || E == Easing::BackOut)
+        {
+            return t * t * ((Vf<W>(BACK_OVERSHOOT + 1.0F) * t) - Vf<W>(BACK_OVERSHOOT));
+        }
+        else if constexpr (E == Easing::BackInOut)
+        {
+            return t * t * ((Vf<W>(BACK_IN_OUT_OVERSHOOT + 1.0F) * t) - Vf<W>(BACK_IN_OUT_OVERSHOOT));
+        }
+        else
+        {
+            return t;
+        }
+    }
+
+    template <Easing E, std::size_t W>
+    Vf<W> EaseAs(const Vf<W>& t)
+    {
+        const Vf<W> one(1.0F);
+        const Vf<W> half(0.5F);
+        if constexpr (E == Easing::Linear)
+        {
+            return t;
+        }
+        else if constexpr (E == Easing::SmoothStep)
+        {
+            return t * t * (Vf<W>(3.0F) - (Vf<W>(2.0F) * t));
+        }
+        else if constexpr (E == Easing::QuadOut || E == Easing::CubicOut || E == Easing::QuartOut ||
+                           E == Easing::SineOut || E == Easing::BackOut)
+        {
+            return one - EaseIn<E>(one - t);
+        }
+        else if constexpr (E == Easing::QuadInOut || E == Easing::CubicInOut || E == Easing::QuartInOut ||
+                           E == Easing::SineInOut || E == Easing::BackInOut)
+        {
+            const Vf<W> first = EaseIn<E>(t + t) * half;
+            const Vf<W> u = one - t;
+            const Vf<W> second = one - (EaseIn<E>(u + u) * half);
+            return simd::Select(t < half, first, second);
+        }
+        else
+        {
+            return EaseIn<E>(t);
+        }
+    }
+
+    // Raw pointers into one group's arrays for the duration of an update.
+    struct GroupView
+    {
+        float* elapsed;
+        const float* delay;
+        const float* inverseDuration;
+        const float* period;
+        const float* inversePeriod;
+        const float* from;
+        const float* delta;
+        const std::int32_t* pingPong;
+        const std::uint32_t* target;
+        std::int32_t* finished;
+        float* values;
+        std::size_t count;
+    };
+
+    // Advances tweens [begin, begin + W), writes their values and flags the ones that finished.
+    template <std::size_t W, typename EaseFn>
+    void AdvanceBatch(const GroupView& group, const std::size_t begin, const float deltaTime, const EaseFn& ease)
+    {
+        const Vf<W> zero(0.0F);
+        const Vf<W> one(1.0F);
+
+        const Vf<W> period = simd::Load(group.period + begin, Vf<W>{});
+        Vf<W> elapsed = simd::Load(group.elapsed + begin, Vf<W>{}) + Vf<W>(deltaTime);
+        Vf<W> active = simd::Max(elapsed - simd::Load(group.delay + begin, Vf<W>{}), zero);
+
+        // Looping tweens drop whole periods so elapsed stays small and keeps its precision.
+        const Vf<W> wraps = simd::Floor(active * simd::Load(group.inversePeriod + begin, Vf<W>{}));
+        active = active - (wraps * period);
+        elapsed = elapsed - (wraps * period);
+        simd::Store(group.elapsed + begin, elapsed);
+
+        const Vf<W> phase = active * simd::Load(group.inverseDuration + begin, Vf<W>{});
+        const Vi<W> pingPong = simd::Load(group.pingPong + begin, Vi<W>{});
+        const Vf<W> t = simd::Max(simd::Select(pingPong, one - simd::Abs(phase - one), simd::Min(phase, one)), zero);
+
+        const Vf<W> value = simd::Load(group.from + begin, Vf<W>{}) +
+                            (simd::Load(group.delta + begin, Vf<W>{}) * ease(t));
+        simd::Store(group.finished + begin, (period <= zero) & (phase >= one));
+
+        std::array<float, W> lanes{};
+        simd::Store(lanes.data(), value);
+        for (std::size_t lane = 0; lane < W; ++lane)
+        {
+            group.values[group.target[begin + lane]] = lanes[lane];
+        }
+    }
+
+    // Full native-width batches, then the tail one lane at a time; both give identical results.
+    template <typename EaseFn>
+    void AdvanceGroup(const GroupView& group, const float deltaTime, const EaseFn& ease)
+    {
+        constexpr std::size_t width = simd::NATIVE_WIDTH;
+        std::size_t i = 0;
+        for (; i + width <= group.count; i += width)
+        {
+            AdvanceBatch<width>(group, i, deltaTime, ease);
+        }
+        for (; i < group.count; ++i)
+        {
+            AdvanceBatch<1>(group, i, deltaTime, ease);
+        }
+    }
+
+    template <Easing E>
+    void AdvanceEasing(const GroupView& group, const float deltaTime)
+    {
+        AdvanceGroup(group, deltaTime, []<std::size_t W>(const Vf<W>& t)
+        {
+            return EaseAs<E>(t);
+        });
+    }
+
+    template <Easing E>
+    float EaseScalar(const float t)
+    {
+        return EaseAs<E>(Vf<1>(t)).v[0];
+    }
+
+    using GroupKernel = void (*)(const GroupView&, float);
+    using ScalarEase = float (*)(float);
+
+    template <std::size_t... I>
+    constexpr std::array<GroupKernel, EASING_COUNT> MakeGroupKernels(std::index_sequence<I...>)
+    {
+        return {&AdvanceEasing<static_cast<Easing>(I)>...};
+    }
+
+    template <std::size_t... I>
+    constexpr std::array<ScalarEase, EASING_COUNT> MakeScalarEases(std::index_sequence<I...>)
+    {
+        return {&EaseScalar<static_cast<Easing>(I)>...};
+    }
+
+    constexpr auto GROUP_KERNELS = MakeGroupKernels(std::make_index_sequence<EASING_COUNT>{});
+    constexpr auto SCALAR_EASES = MakeScalarEases(std::make_index_sequence<EASING_COUNT>{});
+}
+
+namespace psygine::animation
+{
+    float Ease(const Easing easing, const float t)
+    {
+        PSYGINE_DEBUG_ASSERT(easing < Easing::Count, "Ease: unknown easing");
+        return SCALAR_EASES[static_cast<std::size_t>(easing)](t);
+    }
+
+    std::uint32_t TweenSystem::createSlot(const float initial)
+    {
+        if (!freeSlots_.empty())
+        {
+            const std::uint32_t slot = freeSlots_.back();
+            freeSlots_.pop_back();
+            values_[slot] = initial;
+            return slot;
+        }
+        values_.push_back(initial);
+        return static_cast<std::uint32_t>(values_.size() - 1);
+    }
+
+    void TweenSystem::releaseSlot(const std::uint32_t slot)
+    {
+        PSYGINE_DEBUG_ASSERT(slot < values_.size(), "TweenSystem::releaseSlot: slot out of range");
+        freeSlots_.push_back(slot);
+    }
+
+    float TweenSystem::value(const std::uint32_t slot) const
+    {
+        PSYGINE_DEBUG_ASSERT(slot < values_.size(), "TweenSystem::value: slot out of range");
+        return values_[slot];
+    }
+
+    void TweenSystem::setValue(const std::uint32_t slot, const float value)
+    {
+        PSYGINE_DEBUG_ASSERT(slot < values_.size(), "TweenSystem::setValue: slot out of range");
+        values_[slot] = value;
+    }
+
+    CurveId TweenSystem::addCurve(const std::span<const float> samples)
+    {
+        PSYGINE_ASSERT(samples.size() >= 2, "TweenSystem::addCurve: a curve needs at least two samples");
+        curves_.push_back(Curve{std::vector<float>(samples.begin(), samples.end())});
+        groups_.emplace_back();
+        return CurveId{static_cast<std::uint32_t>(curves_.size() - 1)};
+    }
+
+    TweenHandle TweenSystem::add(const std::uint32_t slot, const float from, const float to, const float duration,
+                                 const Easing easing, const TweenOptions options)
+    {
+        PSYGINE_DEBUG_ASSERT(easing < Easing::Count, "TweenSystem::add: unknown easing");
+        return insert(static_cast<std::size_t>(easing), slot, from, to, duration, options);
+    }
+
+    TweenHandle TweenSystem::add(const std::uint32_t slot, const float from, const float to, const float duration,
+                                 const CurveId curve, const TweenOptions options)
+    {
+        PSYGINE_ASSERT(curve.index < curves_.size(), "TweenSystem::add: unknown curve");
+        return insert(EASING_COUNT + curve.index, slot, from, to, duration, options);
+    }
+
+    bool TweenSystem::cancel(const TweenHandle handle)
+    {
+        const Record* record = find(handle);
+        if (record == nullptr)
+        {
+            return false;
+        }
+        erase(groups_[record->group], record->position);
+        return true;
+    }
+
+    bool TweenSystem::active(const TweenHandle handle) const
+    {
+        return find(handle) != nullptr;
+    }
+
+    void TweenSystem::update(const float deltaTime)
+    {
+        completed_.clear();
+        for (std::size_t index = 0; index < groups_.size(); ++index)
+        {
+            Group& group = groups_[index];
+            if (group.size() == 0)
+            {
+                continue;
+            }
+
+            group.finished.resize(group.size());
+            const GroupView view{
+                group.elapsed.data(), group.delay.data(), group.inverseDuration.data(), group.period.data(),
+                group.inversePeriod.data(), group.from.data(), group.delta.data(), group.pingPong.data(),
+                group.target.data(), group.finished.data(), values_.data(), group.size()
+            };
+
+            if (index < EASING_COUNT)
+            {
+                GROUP_KERNELS[index](view, deltaTime);
+            }
+            else
+            {
+                const std::vector<float>& samples = curves_[index - EASING_COUNT].samples;
+                const auto segments = static_cast<float>(samples.size() - 1);
+                AdvanceGroup(view, deltaTime, [&samples, segments]<std::size_t W>(const Vf<W>& t)
+                {
+                    // Table lookups have no SIMD form here; the rest of the batch stays vectorized.
+                    std::array<float, W> lanes{};
+                    simd::Store(lanes.data(), t * Vf<W>(segments));
+                    for (float& x : lanes)
+                    {
+                        const std::size_t segment = std::min(static_cast<std::size_t>(x), samples.size() - 2);
+                        const float fraction = x - static_cast<float>(segment);
+                        x = samples[segment] + ((samples[segment + 1] - samples[segment]) * fraction);
+                    }
+                    return simd::Load(lanes.data(), Vf<W>{});
+                });
+            }
+
+            // Back to front, so the tween swapped into a freed position has already been checked.
+            for (std::size_t position = group.size(); position-- > 0;)
+            {
+                if (group.finished[position] != 0)
+                {
+                    const std::uint32_t record = group.record[position];
+                    completed_.push_back(TweenHandle{record, records_[record].generation});
+                    erase(group, position);
+                }
+            }
+        }
+    }
+
+    void TweenSystem::clear()
+    {
+        for (Group& group : groups_)
+        {
+            group = Group{};
+        }
+        freeRecord_ = NIL;
+        for (std::size_t index = records_.size(); index-- > 0;)
+        {
+            Record& record = records_[index];
+            if (record.group != NIL)
+            {
+                ++record.generation;
+                record.group = NIL;
+            }
+            record.position = freeRecord_;
+            freeRecord_ = static_cast<std::uint32_t>(index);
+        }
+        size_ = 0;
+        completed_.clear();
+    }
+
+    TweenHandle TweenSystem::insert(const std::size_t group, const std::uint32_t slot, const float from,
+                                    const float to, const float duration, const TweenOptions options)
+    {
+        PSYGINE_ASSERT(duration > 0.0F, "TweenSystem::add: duration must be positive");
+        PSYGINE_DEBUG_ASSERT(slot < values_.size(), "TweenSystem::add: slot out of range");
+
+        std::uint32_t index = freeRecord_;
+        if (index != NIL)
+        {
+            freeRecord_ = records_[index].position;
+        }
+        else
+        {
+            index = static_cast<std::uint32_t>(records_.size());
+            records_.emplace_back();
+        }
+
+        Group& target = groups_[group];
+        Record& record = records_[index];
+        record.group = static_cast<std::uint32_t>(group);
+        record.position = static_cast<std::uint32_t>(target.size());
+
+        float period = 0.0F;
+        if (options.loop == TweenLoop::Loop)
+        {
+            period = duration;
+        }
+        else if (options.loop == TweenLoop::PingPong)
+        {
+            period = duration * 2.0F;
+        }
+
+        target.elapsed.push_back(0.0F);
+        target.delay.push_back(std::max(options.delay, 0.0F));
+        target.inverseDuration.push_back(1.0F / duration);
+        target.period.push_back(period);
+        target.inversePeriod.push_back(period > 0.0F ? 1.0F / period : 0.0F);
+        target.from.push_back(from);
+        target.delta.push_back(to - from);
+        target.pingPong.push_back(options.loop == TweenLoop::PingPong ? -1 : 0);
+        target.target.push_back(slot);
+        target.record.push_back(index);
+
+        values_[slot] = from;
+        ++size_;
+        return TweenHandle{index, record.generation};
+    }
+
+    void TweenSystem::erase(Group& group, const std::size_t position)
+    {
+        const std::uint32_t index = group.record[position];
+        auto moveLast = [position](auto& array)
+        {
+            array[position] = array.back();
+            array.pop_back();
+        };
+        moveLast(group.elapsed);
+        moveLast(group.delay);
+        moveLast(group.inverseDuration);
+        moveLast(group.period);
+        moveLast(group.inversePeriod);
+        moveLast(group.from);
+        moveLast(group.delta);
+        moveLast(group.pingPong);
+        moveLast(group.target);
+        moveLast(group.record);
+        if (position < group.size())
+        {
+            records_[group.record[position]].position = static_cast<std::uint32_t>(position);
+        }
+
+        Record& record = records_[index];
+        ++record.generation;
+        record.group = NIL;
+        record.position = freeRecord_;
+        freeRecord_ = index;
+        --size_;
+    }
+
+    const TweenSystem::Record* TweenSystem::find(const TweenHandle handle) const
+    {
+        if (handle.index >= records_.size())
+        {
+            return nullptr;
+        }
+        const Record& record = records_[handle.index];
+        if (record.group == NIL || record.generation != handle.generation)
+        {
+            return nullptr;
+        }
+        return &record;
+    }
+}
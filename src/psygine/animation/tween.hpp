@@ -0,0 +1,280 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#ifndef PSYGINE_TWEEN_HPP
+#define PSYGINE_TWEEN_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace psygine::animation
+{
+    /**
+     * @brief Easing curves built into `TweenSystem`, all evaluated without branches or table lookups.
+     *
+     * The names follow the usual easings.net conventions; `Sine*` uses a polynomial cosine accurate to
+     * about 1e-7, so results do not depend on the platform's `std::cos`.
+     */
+    enum class Easing : std::uint8_t
+    {
+        Linear,
+        QuadIn,
+        QuadOut,
+        QuadInOut,
+        CubicIn,
+        CubicOut,
+        CubicInOut,
+        QuartIn,
+        QuartOut,
+        QuartInOut,
+        SineIn,
+        SineOut,
+        SineInOut,
+        BackIn,
+        BackOut,
+        BackInOut,
+        SmoothStep,
+        Count
+    };
+
+    inline constexpr std::size_t EASING_COUNT = static_cast<std::size_t>(Easing::Count);
+
+    /**
+     * @brief What a tween does once it reaches its end.
+     *
+     * - `Once`: writes the end value and finishes; the tween is recycled and reported by `completed()`.
+     * - `Loop`: jumps back to the start and runs again until cancelled.
+     * - `PingPong`: runs backwards to the start, then forwards again, until cancelled.
+     */
+    enum class TweenLoop : std::uint8_t
+    {
+        Once,
+        Loop,
+        PingPong
+    };
+
+    /**
+     * @brief Optional settings for `TweenSystem::add`.
+     */
+    struct TweenOptions
+    {
+        float delay = 0.0F; // seconds before the tween starts; the start value is written meanwhile
+        TweenLoop loop = TweenLoop::Once;
+    };
+
+    /**
+     * @brief Identifies a tween added to a `TweenSystem`.
+     *
+     * The slot's generation changes when it is reused, so a stale handle simply reports the tween as gone.
+     */
+    struct TweenHandle
+    {
+        static constexpr std::uint32_t INVALID_INDEX = std::numeric_limits<std::uint32_t>::max();
+
+        std::uint32_t index = INVALID_INDEX;
+        std::uint32_t generation = 0;
+
+        [[nodiscard]] bool valid() const
+        {
+            return index != INVALID_INDEX;
+        }
+
+        bool operator==(const TweenHandle&) const = default;
+    };
+
+    /**
+     * @brief Identifies a sampled animation curve registered with `TweenSystem::addCurve`.
+     */
+    struct CurveId
+    {
+        std::uint32_t index = 0;
+
+        bool operator==(const CurveId&) const = default;
+    };
+
+    /**
+     * @brief Evaluates a built-in easing at a single point.
+     *
+     * @param easing The curve.
+     * @param t Progress in [0, 1].
+     * @return The eased progress; 0 at t = 0 and 1 at t = 1, overshooting in between for `Back*`.
+     */
+    [[nodiscard]] float Ease(Easing easing, float t);
+
+    /**
+     * @brief Animates float values held in target slots, in batches.
+     *
+     * Tweens are stored as structure-of-arrays groups, one group per easing or curve, so `update` runs
+     * each group as a tight SIMD loop over its start values, deltas and timers with no per-tween
+     * dispatch. Results are written through an index into the system's slot array rather than through
+     * callbacks or pointers; read them back with `value` or `values` after `update`. Animate vectors or
+     * colours by giving each component its own slot.
+     *
+     * Finished tweens are swap-removed from their group and their handles recycled, so a steady churn
+     * of short tweens does not allocate once the arrays have grown. When several tweens write the same
+     * slot the one updated last wins; cancel the old tween when retargeting a slot.
+     *
+     * Time only moves through `update`, and every backend produces bit-identical results, so the same
+     * calls yield the same values on every run. The system is single-threaded.
+     */
+    class TweenSystem
+    {
+    public:
+        TweenSystem() = default;
+
+        /**
+         * @brief Allocates a target slot.
+         *
+         * @param initial The slot's value until a tween writes it.
+         * @return The slot index; stays fixed until `releaseSlot`.
+         */
+        std::uint32_t createSlot(float initial = 0.0F);
+
+        /**
+         * @brief Returns a slot for reuse. Cancel the tweens writing to it first.
+         */
+        void releaseSlot(std::uint32_t slot);
+
+        [[nodiscard]] float value(std::uint32_t slot) const;
+
+        void setValue(std::uint32_t slot, float value);
+
+        /**
+         * @brief Every slot's value, indexed by slot. Released slots hold stale values.
+         */
+        [[nodiscard]] std::span<const float> values() const
+        {
+            return values_;
+        }
+
+        /**
+         * @brief Registers a curve given as samples evenly spaced over [0, 1], linearly interpolated.
+         *
+         * @param samples The curve's values at t = 0, ..., 1; at least two.
+         * @return The id to pass to `add`. Curves live as long as the system.
+         */
+        CurveId addCurve(std::span<const float> samples);
+
+        /**
+         * @brief Starts animating a slot from `from` to `to` along a built-in easing.
+         *
+         * @param slot The slot to write.
+         * @param from The value at the start.
+         * @param to The value at the end.
+         * @param duration Seconds from start to end; must be positive.
+         * @param easing The curve to follow.
+         * @param options Delay and loop behaviour.
+         * @return A handle for cancelling or querying the tween.
+         */
+        TweenHandle add(std::uint32_t slot, float from, float to, float duration, Easing easing = Easing::Linear,
+                        TweenOptions options = {});
+
+        /**
+         * @brief Starts animating a slot from `from` to `to` along a curve registered with `addCurve`.
+         */
+        TweenHandle add(std::uint32_t slot, float from, float to, float duration, CurveId curve,
+                        TweenOptions options = {});
+
+        /**
+         * @brief Stops a tween, leaving its slot at the last value written.
+         *
+         * @return True if the tween was running; false if it already finished, was cancelled or is invalid.
+         */
+        bool cancel(TweenHandle handle);
+
+        /**
+         * @brief Checks whether a tween is still running.
+         */
+        [[nodiscard]] bool active(TweenHandle handle) const;
+
+        /**
+         * @brief Advances every tween and writes the results to their slots.
+         *
+         * @param deltaTime Seconds since the previous update.
+         */
+        void update(float deltaTime);
+
+        /**
+         * @brief The `Once` tweens that reached their end during the last `update`, in no particular order.
+         */
+        [[nodiscard]] std::span<const TweenHandle> completed() const
+        {
+            return completed_;
+        }
+
+        /**
+         * @brief Cancels every tween. Slots and curves are kept.
+         */
+        void clear();
+
+        /**
+         * @brief The number of running tweens.
+         */
+        [[nodiscard]] std::size_t size() const
+        {
+            return size_;
+        }
+
+        [[nodiscard]] bool empty() const
+        {
+            return size_ == 0;
+        }
+
+    private:
+        static constexpr std::uint32_t NIL = TweenHandle::INVALID_INDEX;
+
+        // Groups [0, EASING_COUNT) hold the built-in easings; curve c has group EASING_COUNT + c.
+        struct Group
+        {
+            std::vector<float> elapsed;
+            std::vector<float> delay;
+            std::vector<float> inverseDuration;
+            std::vector<float> period; // duration for Loop, twice that for PingPong, 0 for Once
+            std::vector<float> inversePeriod;
+            std::vector<float> from;
+            std::vector<float> delta;
+            std::vector<std::int32_t> pingPong; // all bits set for PingPong tweens, a lane mask
+            std::vector<std::uint32_t> target;
+            std::vector<std::uint32_t> record;
+            std::vector<std::int32_t> finished; // scratch for update
+
+            [[nodiscard]] std::size_t size() const
+            {
+                return target.size();
+            }
+        };
+
+        struct Curve
+        {
+            std::vector<float> samples;
+        };
+
+        struct Record
+        {
+            std::uint32_t group = NIL;
+            std::uint32_t position = NIL; // also links the free list while the record is unused
+            std::uint32_t generation = 0;
+        };
+
+        TweenHandle insert(std::size_t group, std::uint32_t slot, float from, float to, float duration,
+                           TweenOptions options);
+        void erase(Group& group, std::size_t position);
+        [[nodiscard]] const Record* find(TweenHandle handle) const;
+
+        std::vector<Group> groups_ = std::vector<Group>(EASING_COUNT);
+        std::vector<Curve> curves_;
+        std::vector<Record> records_;
+        std::uint32_t freeRecord_ = NIL;
+        std::size_t size_ = 0;
+
+        std::vector<float> values_;
+        std::vector<std::uint32_t> freeSlots_;
+
+        std::vector<TweenHandle> completed_;
+    };
+}
+
+#endif //PSYGINE_TWEEN_HPP
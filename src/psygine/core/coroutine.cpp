@@ -0,0 +1,271 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#include "coroutine.hpp"
+
+#include <array>
+#include <new>
+
+#include "psygine/debug/assert.hpp"
+
+namespace
+{
+    constexpr std::size_t FRAME_GRANULARITY = 64;
+    constexpr std::size_t FRAME_CLASSES = 32; // frames up to 2 KiB are pooled
+
+    struct FreeFrame
+    {
+        FreeFrame* next;
+    };
+
+    // Trivially destructible on purpose: frames freed during static destruction, after thread-locals
+    // are gone, still find a valid pool. Pooled blocks are kept for the lifetime of the thread.
+    thread_local std::array<FreeFrame*, FRAME_CLASSES> freeFrames{};
+
+    std::size_t FrameClass(const std::size_t size)
+    {
+        return size == 0 ? 0 : (size - 1) / FRAME_GRANULARITY;
+    }
+}
+
+namespace psygine::core
+{
+    namespace detail
+    {
+        void* AllocateFrame(const std::size_t size)
+        {
+            const std::size_t sizeClass = FrameClass(size);
+            if (sizeClass >= FRAME_CLASSES)
+            {
+                return ::operator new(size);
+            }
+
+            if (FreeFrame* frame = freeFrames[sizeClass])
+            {
+                freeFrames[sizeClass] = frame->next;
+                return frame;
+            }
+            return ::operator new((sizeClass + 1) * FRAME_GRANULARITY);
+        }
+
+        void DeallocateFrame(void* frame, const std::size_t size) noexcept
+        {
+            const std::size_t sizeClass = FrameClass(size);
+            if (sizeClass >= FRAME_CLASSES)
+            {
+                ::operator delete(frame, size);
+                return;
+            }
+
+            auto* node = static_cast<FreeFrame*>(frame);
+            node->next = freeFrames[sizeClass];
+            freeFrames[sizeClass] = node;
+        }
+    }
+
+    CoroutineScheduler::~CoroutineScheduler()
+    {
+        clear();
+    }
+
+    TaskId CoroutineScheduler::spawn(Task task)
+    {
+        const Task::Handle handle = std::exchange(task.handle_, {});
+        PSYGINE_ASSERT(static_cast<bool>(handle), "CoroutineScheduler: spawning an empty task");
+
+        std::uint32_t index = freeHead_;
+        if (index != TaskId::INVALID_INDEX)
+        {
+            freeHead_ = entries_[index].nextFree;
+        }
+        else
+        {
+            PSYGINE_ASSERT(entries_.size() < TaskId::INVALID_INDEX, "CoroutineScheduler: too many tasks");
+            index = static_cast<std::uint32_t>(entries_.size());
+            entries_.emplace_back();
+        }
+
+        Entry& entry = entries_[index];
+        entry.handle = handle;
+        entry.alive = true;
+        entry.nextFree = TaskId::INVALID_INDEX;
+        const TaskId id{index, entry.generation};
+        ++size_;
+
+        handle.promise().scheduler_ = this;
+        handle.promise().id_ = id;
+
+        makeReady(id);
+        drain();
+        return id;
+    }
+
+    bool CoroutineScheduler::cancel(const TaskId id)
+    {
+        if (find(id) == nullptr)
+        {
+            return false;
+        }
+        PSYGINE_ASSERT(id != current_, "CoroutineScheduler: a task cannot cancel itself");
+        finish(id);
+        drain();
+        return true;
+    }
+
+    bool CoroutineScheduler::alive(const TaskId id) const
+    {
+        return id.index < entries_.size() && entries_[id.index].alive &&
+            entries_[id.index].generation == id.generation;
+    }
+
+    void CoroutineScheduler::fixedUpdate()
+    {
+        ticks_.advance();
+        drain();
+    }
+
+    void CoroutineScheduler::update(const double deltaTime)
+    {
+        time_ += deltaTime;
+
+        // Nothing resumes before drain(), so tasks that wait for another frame while it runs land in the
+        // emptied list and belong to the next update.
+        for (const TaskId id : frameWaiters_)
+        {
+            makeReady(id);
+        }
+        frameWaiters_.clear();
+
+        while (!timed_.empty() && timed_.top().time <= time_)
+        {
+            makeReady(timed_.top().id);
+            timed_.pop();
+        }
+
+        drain();
+    }
+
+    void CoroutineScheduler::clear()
+    {
+        for (std::uint32_t index = 0; index < entries_.size(); ++index)
+        {
+            if (entries_[index].alive)
+            {
+                release(TaskId{index, entries_[index].generation});
+            }
+        }
+        ticks_.clear();
+        frameWaiters_.clear();
+        timed_ = {};
+        ready_.clear();
+        readyCursor_ = 0;
+    }
+
+    CoroutineScheduler::Entry* CoroutineScheduler::find(const TaskId id)
+    {
+        return alive(id) ? &entries_[id.index] : nullptr;
+    }
+
+    void CoroutineScheduler::waitTicks(const TaskId id, const std::uint64_t ticks)
+    {
+        entries_[id.index].timer = ticks_.schedule(ticks, [this, id]
+        {
+            makeReady(id);
+        });
+    }
+
+    void CoroutineScheduler::waitFrame(const TaskId id)
+    {
+        frameWaiters_.push_back(id);
+    }
+
+    void CoroutineScheduler::waitSeconds(const TaskId id, const double seconds)
+    {
+        timed_.push({time_ + seconds, timedSequence_++, id});
+    }
+
+    void CoroutineScheduler::waitTask(const TaskId id, const TaskId target)
+    {
+        PSYGINE_ASSERT(id != target, "CoroutineScheduler: a task cannot wait for itself");
+        if (Entry* entry = find(target))
+        {
+            entry->waiters.push_back(id);
+        }
+        else
+        {
+            makeReady(id);
+        }
+    }
+
+    void CoroutineScheduler::makeReady(const TaskId id)
+    {
+        ready_.push_back(id);
+    }
+
+    void CoroutineScheduler::finish(const TaskId id)
+    {
+        for (const TaskId waiter : entries_[id.index].waiters)
+        {
+            makeReady(waiter);
+        }
+        release(id);
+    }
+
+    void CoroutineScheduler::release(const TaskId id)
+    {
+        Entry& entry = entries_[id.index];
+        ticks_.cancel(entry.timer);
+        entry.handle.destroy();
+        entry.handle = {};
+        entry.waiters.clear();
+        entry.timer = {};
+        entry.alive = false;
+        ++entry.generation;
+        entry.nextFree = freeHead_;
+        freeHead_ = id.index;
+        --size_;
+    }
+
+    void CoroutineScheduler::drain()
+    {
+        if (draining_)
+        {
+            return;
+        }
+        draining_ = true;
+
+        // Ids are checked on the way out, so wake-ups left behind by cancelled tasks are skipped here
+        // instead of being searched for and removed when the task goes away.
+        while (readyCursor_ < ready_.size())
+        {
+            const TaskId id = ready_[readyCursor_++];
+            const Entry* entry = find(id);
+            if (entry == nullptr)
+            {
+                continue;
+            }
+
+            current_ = id;
+            try
+            {
+                entry->handle.resume();
+            }
+            catch (...)
+            {
+                current_ = {};
+                // The task is suspended at its final point; it never reached finish() on its own.
+                if (find(id) != nullptr)
+                {
+                    finish(id);
+                }
+                draining_ = false;
+                throw;
+            }
+            current_ = {};
+        }
+
+        ready_.clear();
+        readyCursor_ = 0;
+        draining_ = false;
+    }
+}
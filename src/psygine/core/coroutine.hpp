@@ -0,0 +1,413 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#ifndef PSYGINE_COROUTINE_HPP
+#define PSYGINE_COROUTINE_HPP
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "timer_wheel.hpp"
+
+namespace psygine::core
+{
+    class CoroutineScheduler;
+
+    /**
+     * @brief Suspends the task until the next fixed update.
+     */
+    struct NextFixedTick
+    {};
+
+    /**
+     * @brief Suspends the task for a number of fixed updates; 0 continues immediately.
+     */
+    struct FixedTicks
+    {
+        std::uint64_t count = 1;
+    };
+
+    /**
+     * @brief Suspends the task until the next variable-rate update.
+     */
+    struct NextFrame
+    {};
+
+    /**
+     * @brief Suspends the task until this much frame time has passed; resumed from `update`.
+     */
+    struct Seconds
+    {
+        double value = 0.0;
+    };
+
+    /**
+     * @brief Identifies a task spawned on a `CoroutineScheduler`. `co_await` it to wait for the task to finish.
+     */
+    struct TaskId
+    {
+        static constexpr std::uint32_t INVALID_INDEX = std::numeric_limits<std::uint32_t>::max();
+
+        std::uint32_t index = INVALID_INDEX;
+        std::uint32_t generation = 0;
+
+        [[nodiscard]] bool valid() const
+        {
+            return index != INVALID_INDEX;
+        }
+
+        bool operator==(const TaskId&) const = default;
+    };
+
+    namespace detail
+    {
+        /**
+         * @brief Allocates a coroutine frame from a per-thread pool of size classes.
+         *
+         * Frames are recycled through free lists instead of going back to the heap, so a script that
+         * spawns short-lived tasks every tick stops allocating once warmed up. Frames must be freed on
+         * the thread that allocated them, which holds for tasks driven by one scheduler.
+         */
+        [[nodiscard]] void* AllocateFrame(std::size_t size);
+
+        /**
+         * @brief Returns a frame obtained from `AllocateFrame` to its size class.
+         */
+        void DeallocateFrame(void* frame, std::size_t size) noexcept;
+    }
+
+    /**
+     * @brief Coroutine type for scripts run by a `CoroutineScheduler`.
+     *
+     * A function returning `Task` may `co_await`:
+     * - `NextFixedTick{}` or `FixedTicks{n}` to continue from a later fixed update,
+     * - `NextFrame{}` or `Seconds{s}` to continue from a later update,
+     * - a `TaskId` to wait for that task to finish,
+     * - another `Task`, which is spawned and waited for.
+     *
+     * A `Task` does nothing until it is passed to `CoroutineScheduler::spawn`. Exceptions escaping a
+     * task propagate out of the scheduler call that resumed it, and the task is destroyed.
+     */
+    class Task
+    {
+    public:
+        class promise_type;
+        using Handle = std::coroutine_handle<promise_type>;
+
+        Task(Task&& other) noexcept :
+            handle_{std::exchange(other.handle_, {})}
+        {}
+
+        Task& operator=(Task&& other) noexcept
+        {
+            if (this != &other)
+            {
+                reset();
+                handle_ = std::exchange(other.handle_, {});
+            }
+            return *this;
+        }
+
+        ~Task()
+        {
+            reset();
+        }
+
+        Task(const Task& other) = delete;
+        Task& operator=(const Task& other) = delete;
+
+    private:
+        friend class CoroutineScheduler;
+
+        explicit Task(const Handle handle) :
+            handle_{handle}
+        {}
+
+        void reset()
+        {
+            if (handle_)
+            {
+                handle_.destroy();
+                handle_ = {};
+            }
+        }
+
+        Handle handle_;
+    };
+
+    /**
+     * @brief Resumes `Task` coroutines from the runtime's fixed and variable-rate updates.
+     *
+     * Waiting tasks sit in structures keyed by their wake-up time, so a task that is not due costs
+     * nothing per frame: tick waits go into a `TimerWheel`, time waits into a min-heap, and only
+     * `NextFrame` waiters are visited every update. Wake-ups are processed in a fixed order, so the same
+     * sequence of calls resumes the same tasks in the same order on every run.
+     *
+     * The scheduler is single-threaded; all calls, and all task code, run on the owning thread.
+     */
+    class CoroutineScheduler
+    {
+    public:
+        CoroutineScheduler() = default;
+
+        /**
+         * @brief Destroys every task that has not finished.
+         */
+        ~CoroutineScheduler();
+
+        /**
+         * @brief Takes ownership of a task and runs it until its first suspension.
+         *
+         * Called from inside a task, the new task starts after the caller suspends, in the same pass.
+         *
+         * @param task The task to start.
+         * @return The task's id; stays valid to query after the task finishes.
+         */
+        TaskId spawn(Task task);
+
+        /**
+         * @brief Destroys a suspended task and wakes the tasks waiting for it.
+         *
+         * @param id The task to cancel. A task cannot cancel itself; return from it instead.
+         * @return True if the task was alive.
+         */
+        bool cancel(TaskId id);
+
+        /**
+         * @brief Checks whether a task has neither finished nor been cancelled.
+         */
+        [[nodiscard]] bool alive(TaskId id) const;
+
+        /**
+         * @brief Resumes tasks waiting on fixed ticks. Called once per fixed update.
+         */
+        void fixedUpdate();
+
+        /**
+         * @brief Advances frame time and resumes tasks waiting on frames or time.
+         *
+         * @param deltaTime Seconds since the previous update.
+         */
+        void update(double deltaTime);
+
+        /**
+         * @brief Destroys every task.
+         */
+        void clear();
+
+        /**
+         * @brief The number of tasks alive.
+         */
+        [[nodiscard]] std::size_t size() const
+        {
+            return size_;
+        }
+
+        /**
+         * @brief Seconds of frame time accumulated by `update`.
+         */
+        [[nodiscard]] double time() const
+        {
+            return time_;
+        }
+
+        CoroutineScheduler(const CoroutineScheduler& other) = delete;
+        CoroutineScheduler(CoroutineScheduler&& other) noexcept = delete;
+        CoroutineScheduler& operator=(const CoroutineScheduler& other) = delete;
+        CoroutineScheduler& operator=(CoroutineScheduler&& other) noexcept = delete;
+
+    private:
+        friend class Task::promise_type;
+
+        struct Entry
+        {
+            Task::Handle handle;
+            std::vector<TaskId> waiters;
+            TimerHandle timer;
+            std::uint32_t generation = 0;
+            std::uint32_t nextFree = TaskId::INVALID_INDEX;
+            bool alive = false;
+        };
+
+        struct TimedWake
+        {
+            double time = 0.0;
+            std::uint64_t sequence = 0;
+            TaskId id;
+
+            // Min-heap on time; the sequence keeps equal times in the order they were requested.
+            bool operator<(const TimedWake& other) const
+            {
+                return time != other.time ? time > other.time : sequence > other.sequence;
+            }
+        };
+
+        [[nodiscard]] Entry* find(TaskId id);
+        void waitTicks(TaskId id, std::uint64_t ticks);
+        void waitFrame(TaskId id);
+        void waitSeconds(TaskId id, double seconds);
+        void waitTask(TaskId id, TaskId target);
+        void makeReady(TaskId id);
+        void finish(TaskId id);
+        void release(TaskId id);
+        void drain();
+
+        std::vector<Entry> entries_;
+        std::uint32_t freeHead_ = TaskId::INVALID_INDEX;
+        std::size_t size_ = 0;
+
+        TimerWheel ticks_;
+        std::vector<TaskId> frameWaiters_;
+        std::priority_queue<TimedWake> timed_;
+        std::uint64_t timedSequence_ = 0;
+        double time_ = 0.0;
+
+        std::vector<TaskId> ready_;
+        std::size_t readyCursor_ = 0;
+        TaskId current_;
+        bool draining_ = false;
+    };
+
+    class Task::promise_type
+    {
+    public:
+        Task get_return_object()
+        {
+            return Task{Handle::from_promise(*this)};
+        }
+
+        std::suspend_always initial_suspend() noexcept
+        {
+            return {};
+        }
+
+        auto final_suspend() noexcept
+        {
+            struct FinalAwaiter
+            {
+                bool await_ready() noexcept
+                {
+                    return false;
+                }
+
+                void await_suspend(const Handle handle) noexcept
+                {
+                    const promise_type& promise = handle.promise();
+                    promise.scheduler_->finish(promise.id_);
+                }
+
+                void await_resume() noexcept
+                {}
+            };
+            return FinalAwaiter{};
+        }
+
+        void return_void()
+        {}
+
+        void unhandled_exception()
+        {
+            throw;
+        }
+
+        static void* operator new(const std::size_t size)
+        {
+            return detail::AllocateFrame(size);
+        }
+
+        static void operator delete(void* frame, const std::size_t size) noexcept
+        {
+            detail::DeallocateFrame(frame, size);
+        }
+
+        auto await_transform(const FixedTicks ticks)
+        {
+            return Suspend{ticks.count == 0, [this, ticks]
+            {
+                scheduler_->waitTicks(id_, ticks.count);
+            }};
+        }
+
+        auto await_transform(NextFixedTick)
+        {
+            return await_transform(FixedTicks{1});
+        }
+
+        auto await_transform(NextFrame)
+        {
+            return Suspend{false, [this]
+            {
+                scheduler_->waitFrame(id_);
+            }};
+        }
+
+        auto await_transform(const Seconds seconds)
+        {
+            return Suspend{!(seconds.value > 0.0), [this, seconds]
+            {
+                scheduler_->waitSeconds(id_, seconds.value);
+            }};
+        }
+
+        auto await_transform(const TaskId target)
+        {
+            struct TaskAwaiter
+            {
+                promise_type* promise;
+                TaskId target;
+
+                bool await_ready() const
+                {
+                    return !promise->scheduler_->alive(target);
+                }
+
+                void await_suspend(Handle)
+                {
+                    promise->scheduler_->waitTask(promise->id_, target);
+                }
+
+                void await_resume() const noexcept
+                {}
+            };
+            return TaskAwaiter{this, target};
+        }
+
+        auto await_transform(Task task)
+        {
+            return await_transform(scheduler_->spawn(std::move(task)));
+        }
+
+    private:
+        friend class CoroutineScheduler;
+
+        template <typename Register>
+        struct Suspend
+        {
+            bool ready;
+            Register registerWake;
+
+            [[nodiscard]] bool await_ready() const noexcept
+            {
+                return ready;
+            }
+
+            void await_suspend(Handle)
+            {
+                registerWake();
+            }
+
+            void await_resume() const noexcept
+            {}
+        };
+
+        CoroutineScheduler* scheduler_ = nullptr;
+        TaskId id_;
+    };
+}
+
+#endif //PSYGINE_COROUTINE_HPP
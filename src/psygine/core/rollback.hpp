@@ -0,0 +1,148 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#ifndef PSYGINE_ROLLBACK_HPP
+#define PSYGINE_ROLLBACK_HPP
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "snapshot.hpp"
+#include "psygine/debug/assert.hpp"
+
+namespace psygine::core
+{
+    /**
+     * @brief Rollback and resimulation over a `SnapshotRing`: the state after each fixed tick together
+     * with the input the tick was stepped with.
+     *
+     * Call `record` at the end of every fixed update. When the real input of an earlier tick turns up
+     * (a remote player's, in rollback networking), pass it to `correct`; `resimulate` then restores the
+     * state before the earliest corrected tick and steps every tick since again with the recorded
+     * inputs, re-recording each. A deterministic simulation ends up exactly where it would have been
+     * had the input been known in time.
+     */
+    template <typename Input>
+    class Rollback
+    {
+    public:
+        explicit Rollback(const std::size_t capacity,
+                          const std::size_t keyframeInterval = SnapshotRing::DEFAULT_KEYFRAME_INTERVAL) :
+            snapshots_{capacity, keyframeInterval},
+            inputs_(capacity)
+        {
+        }
+
+        /**
+         * @brief Records that `tick` was stepped with `input` and snapshots the state it left.
+         *
+         * Ticks are recorded one after another; recording one at or before the newest forgets the later
+         * ones, as after restoring an earlier snapshot by hand.
+         */
+        template <typename Save>
+            requires std::invocable<Save&, SnapshotWriter&>
+        void record(const std::uint64_t tick, const Input& input, Save&& save)
+        {
+            PSYGINE_ASSERT(snapshots_.empty() || tick <= snapshots_.newestTick() + 1,
+                           "Rollback::record: ticks must be recorded one after another");
+            snapshots_.save(tick, save);
+            inputs_[tick % inputs_.size()] = input;
+            if (tick <= earliest_)
+            {
+                earliest_ = NONE;
+            }
+        }
+
+        /**
+         * @brief Replaces the input recorded for `tick`; the next `resimulate` redoes that tick and the
+         * ones after it. False when the state before `tick` is no longer held, so it cannot be redone.
+         */
+        bool correct(const std::uint64_t tick, const Input& input)
+        {
+            if (tick == 0 || !snapshots_.contains(tick) || !snapshots_.contains(tick - 1))
+            {
+                return false;
+            }
+            inputs_[tick % inputs_.size()] = input;
+            earliest_ = std::min(earliest_, tick);
+            return true;
+        }
+
+        /**
+         * @brief Whether a corrected input is waiting for `resimulate`.
+         */
+        [[nodiscard]] bool pending() const
+        {
+            return earliest_ != NONE;
+        }
+
+        /**
+         * @brief Rewinds to before the earliest corrected tick and steps forward to the newest tick again.
+         *
+         * @param load Restores the state: `load(SnapshotReader&)`.
+         * @param step Simulates one tick: `step(tick, input)`.
+         * @param save Snapshots the state, as for `record`: `save(SnapshotWriter&)`.
+         * @return The number of ticks stepped; 0 when nothing was corrected or the corrected ticks have
+         * since left the ring.
+         */
+        template <typename Load, typename Step, typename Save>
+            requires std::invocable<Load&, SnapshotReader&> && std::invocable<Step&, std::uint64_t, const Input&> &&
+            std::invocable<Save&, SnapshotWriter&>
+        std::size_t resimulate(Load&& load, Step&& step, Save&& save)
+        {
+            if (earliest_ == NONE)
+            {
+                return 0;
+            }
+            const std::uint64_t from = earliest_;
+            earliest_ = NONE;
+            const std::uint64_t to = snapshots_.newestTick();
+            if (!snapshots_.restore(from - 1, load))
+            {
+                return 0;
+            }
+            for (std::uint64_t tick = from; tick <= to; ++tick)
+            {
+                step(tick, inputs_[tick % inputs_.size()]);
+                snapshots_.save(tick, save);
+            }
+            return static_cast<std::size_t>(to - from + 1);
+        }
+
+        /**
+         * @brief The input recorded for a held tick.
+         */
+        [[nodiscard]] const Input& input(const std::uint64_t tick) const
+        {
+            PSYGINE_ASSERT(snapshots_.contains(tick), "Rollback::input: tick is not held");
+            return inputs_[tick % inputs_.size()];
+        }
+
+        /**
+         * @brief The snapshots, for restoring one directly, such as an editor's undo.
+         */
+        [[nodiscard]] SnapshotRing& snapshots()
+        {
+            return snapshots_;
+        }
+
+        [[nodiscard]] const SnapshotRing& snapshots() const
+        {
+            return snapshots_;
+        }
+
+    private:
+        static constexpr std::uint64_t NONE = std::numeric_limits<std::uint64_t>::max();
+
+        SnapshotRing snapshots_;
+        // Indexed by tick modulo the capacity; recorded ticks are consecutive, so held ticks never collide.
+        std::vector<Input> inputs_;
+        std::uint64_t earliest_ = NONE;
+    };
+}
+
+#endif //PSYGINE_ROLLBACK_HPP
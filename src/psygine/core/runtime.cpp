@@ -49,6 +49,8 @@ namespace psygine::core
             initialized_ = false;
         }
         window_.reset();
+        // Open gamepads are closed while SDL is still up.
+        input_ = {};
 
         if (SDL_WasInit(0) != 0)
         {
@@ -64,6 +66,9 @@ namespace psygine::core
             return true;
         }
 
+        // Measure the tick rate now rather than on the first timestamp taken mid-frame.
+        utilities::time::CalibrateTicks();
+
         if (!SDL_Init(SDL_INIT_VIDEO))
         {
             std::cerr << "SDL_Init failed: " << SDL_GetError() << '\n' << std::flush;
@@ -214,6 +219,11 @@ namespace psygine::core
 
         running_ = true;
 
+        if (config_.gamepadPollRate > 0 && isGamepadInitialized())
+        {
+            input_.startGamepadPolling(config_.gamepadPollRate);
+        }
+
         auto now = utilities::time::Now();
 
         double accumulator = 0.0;
@@ -229,8 +239,9 @@ namespace psygine::core
             handleEvents();
 
             // Protect some against lag spikes and all, kept within parentheses
-            const double deltaTime = std::min(utilities::time::ElapsedSinceSeconds(now), maxTimestep);
-            now = utilities::time::Now();
+            const auto frameStart = utilities::time::Now();
+            const double deltaTime = std::min(utilities::time::ElapsedSeconds(now, frameStart), maxTimestep);
+            now = frameStart;
             lastDeltaTime_ = deltaTime;
             accumulator += deltaTime;
 
@@ -239,7 +250,16 @@ namespace psygine::core
             {
                 accumulator -= fixedTimestep;
                 ++updatesThisFrame;
-                fixedUpdate(fixedTimestep);
+
+                // The step ends where the accumulator leaves it, behind the frame start; the last step
+                // of the frame takes all input up to the frame start so none waits for the next frame.
+                auto inputTime = frameStart;
+                if (accumulator >= fixedTimestep && updatesThisFrame < config_.maxUpdatesPerTick)
+                {
+                    inputTime -= std::chrono::duration_cast<utilities::time::types::Duration>(
+                        std::chrono::duration<double>(accumulator));
+                }
+                fixedUpdate(fixedTimestep, inputTime);
             }
 
             // Still too much lag, keep only the remainder
@@ -248,7 +268,7 @@ namespace psygine::core
                 accumulator = std::fmod(accumulator, fixedTimestep);
             }
 
-            update(deltaTime);
+            update(deltaTime, frameStart);
 
             const double interpolation = accumulator > 0.0 ? std::min(accumulator / fixedTimestep, 0.999999) : 0.0;
             render(interpolation);
@@ -258,6 +278,8 @@ namespace psygine::core
                 SDL_DelayNS(1);
             }
         }
+
+        input_.stopGamepadPolling();
     }
 
     void Runtime::quit()
@@ -335,6 +357,26 @@ namespace psygine::core
         return 1.0 / lastDeltaTime_;
     }
 
+    TimerWheel& Runtime::getTimers()
+    {
+        return timers_;
+    }
+
+    CoroutineScheduler& Runtime::getScheduler()
+    {
+        return scheduler_;
+    }
+
+    animation::TweenSystem& Runtime::getTweens()
+    {
+        return tweens_;
+    }
+
+    input::InputSystem& Runtime::getInput()
+    {
+        return input_;
+    }
+
     bool Runtime::onQuitRequested()
     {
         return true;
@@ -345,6 +387,7 @@ namespace psygine::core
         SDL_Event event;
         while (SDL_PollEvent(&event))
         {
+            input_.handleEvent(event);
             switch (event.type)
             {
                 case SDL_EVENT_QUIT: if (onQuitRequested())
@@ -374,13 +417,19 @@ namespace psygine::core
         }
     }
 
-    void Runtime::fixedUpdate(const double deltaTime)
+    void Runtime::fixedUpdate(const double deltaTime, const utilities::time::types::TimePoint inputTime)
     {
+        input_.beginTick(inputTime);
+        timers_.advance();
+        scheduler_.fixedUpdate();
         onFixedUpdate(deltaTime);
     }
 
-    void Runtime::update(const double deltaTime)
+    void Runtime::update(const double deltaTime, const utilities::time::types::TimePoint inputTime)
     {
+        input_.beginFrame(inputTime);
+        scheduler_.update(deltaTime);
+        tweens_.update(static_cast<float>(deltaTime));
         onUpdate(deltaTime);
     }
 
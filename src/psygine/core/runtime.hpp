@@ -6,8 +6,13 @@
 
 #include <chrono>
 
+#include "coroutine.hpp"
 #include "runtime_config.hpp"
 #include "sdl_raii.hpp"
+#include "timer_wheel.hpp"
+#include "psygine/animation/tween.hpp"
+#include "psygine/input/input_system.hpp"
+#include "psygine/utilities/time.hpp"
 #include "SDL3/SDL.h"
 #include "bgfx/bgfx.h"
 
@@ -225,6 +230,52 @@ namespace psygine::core
 
         [[nodiscard]] double getCurrentFps() const;
 
+        /**
+         * @brief Retrieves the timer wheel advanced once per fixed update.
+         *
+         * Timers are counted in fixed ticks, so delays are deterministic regardless of frame rate.
+         * Due timers fire at the start of each fixed update, before `onFixedUpdate`.
+         *
+         * @return A reference to the runtime's timer wheel.
+         */
+        [[nodiscard]] TimerWheel& getTimers();
+
+        /**
+         * @brief Retrieves the scheduler that runs coroutine scripts.
+         *
+         * Tasks waiting on ticks are resumed at the start of each fixed update and tasks waiting on
+         * frames or time at the start of each update, before `onFixedUpdate` and `onUpdate` respectively.
+         *
+         * @return A reference to the runtime's coroutine scheduler.
+         */
+        [[nodiscard]] CoroutineScheduler& getScheduler();
+
+        /**
+         * @brief Retrieves the tween system animating float slots.
+         *
+         * Tweens are advanced at the start of each update, after coroutine tasks and before `onUpdate`,
+         * so values read in `onUpdate` and `onRender` are current for the frame.
+         *
+         * @return A reference to the runtime's tween system.
+         */
+        [[nodiscard]] animation::TweenSystem& getTweens();
+
+        /**
+         * @brief Retrieves the input system fed with every SDL event.
+         *
+         * A snapshot is taken at the start of each fixed update, before timers and coroutine tasks, and
+         * at the start of each update, so `onFixedUpdate` reads `tick()` and `onUpdate` reads `frame()`
+         * instead of interpreting events. Events are still passed to `onEvent` afterwards.
+         *
+         * With `RuntimeConfig::gamepadPollRate` set and the gamepad subsystem initialized, `run` polls
+         * gamepads on a dedicated thread. Each fixed update applies the samples taken up to the time its
+         * step covers, so a burst of catch-up ticks splits them the way they happened; the last tick of a
+         * frame takes everything up to the frame start.
+         *
+         * @return A reference to the runtime's input system.
+         */
+        [[nodiscard]] input::InputSystem& getInput();
+
         // Copy and Move Operations
         Runtime(const Runtime& other) = delete;
         Runtime(Runtime&& other) noexcept = delete;
@@ -294,8 +345,8 @@ namespace psygine::core
 
     private:
         void handleEvents();
-        void fixedUpdate(double deltaTime);
-        void update(double deltaTime);
+        void fixedUpdate(double deltaTime, utilities::time::types::TimePoint inputTime);
+        void update(double deltaTime, utilities::time::types::TimePoint inputTime);
         void render(double interpolation);
 
         [[nodiscard]] std::uint32_t bgfxDebugFlags() const;
@@ -312,6 +363,10 @@ namespace psygine::core
         SdlWindowPtr window_{nullptr, &SDL_DestroyWindow};
         SdlMetalViewPtr metalView_{nullptr, &SDL_Metal_DestroyView};
         RuntimeConfig config_;
+        TimerWheel timers_;
+        CoroutineScheduler scheduler_;
+        animation::TweenSystem tweens_;
+        input::InputSystem input_;
     };
 }
 
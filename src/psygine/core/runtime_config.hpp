@@ -98,6 +98,8 @@ namespace psygine::core
      * - `fixedTimestep`: Sets the interval for fixed-update logic.
      * - `maxTimestep`: Specifies the maximum duration for catching up during updates.
      * - `maxUpdatesPerTick`: Defines the maximum number of update steps allowed per tick.
+     * - `gamepadPollRate`: Polls gamepads on a dedicated thread this many times per second (500-1000
+     *   suits most pads); 0 reads them from events once per frame.
      * - `gpuDeviceId`: Specifies the GPU device ID to use; 0 selects the first compatible GPU.
      * - `graphicsApi`: Determines the graphics API to use (e.g., DirectX, Vulkan, OpenGL).
      * - `msaa`: Configures the level of Multi-Sample Anti-Aliasing (MSAA).
@@ -125,6 +127,9 @@ namespace psygine::core
         std::chrono::duration<double> maxTimestep = std::chrono::duration<double>(1);
         std::size_t maxUpdatesPerTick = 10;
 
+        // Only used once the gamepad subsystem is initialized
+        std::uint32_t gamepadPollRate = 0;
+
         // If set to 0. will take the first good matching one
         std::uint16_t gpuDeviceId = 0;
         GraphicsApi graphicsApi = GraphicsApi::Any;
@@ -6,6 +6,7 @@
 
 #include <memory>
 
+#include <SDL3/SDL_gamepad.h>
 #include <SDL3/SDL_metal.h>
 #include <SDL3/SDL_video.h>
 
@@ -13,6 +14,7 @@ namespace psygine::core
 {
     using SdlWindowPtr = std::unique_ptr<SDL_Window, decltype(&SDL_DestroyWindow)>;
     using SdlMetalViewPtr = std::unique_ptr<SDL_MetalView, decltype(&SDL_Metal_DestroyView)>;
+    using SdlGamepadPtr = std::unique_ptr<SDL_Gamepad, decltype(&SDL_CloseGamepad)>;
 
     namespace sdl_raii
     {
@@ -27,6 +29,12 @@ namespace psygine::core
         {
             return SdlMetalViewPtr(SDL_Metal_CreateView(std::forward<Args>(args)...), &SDL_Metal_DestroyView);
         }
+
+        template <typename... Args>
+        [[nodiscard]] SdlGamepadPtr OpenGamepad(Args&&... args)
+        {
+            return SdlGamepadPtr(SDL_OpenGamepad(std::forward<Args>(args)...), &SDL_CloseGamepad);
+        }
     }
 }
 
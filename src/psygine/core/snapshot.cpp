@@ -0,0 +1,272 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#include "snapshot.hpp"
+
+#include <algorithm>
+
+namespace
+{
+    // Granularity of delta encoding.
+    constexpr std::size_t WORD = 8;
+
+    // Unchanged words shorter than this between two changed runs are stored with them, since a new
+    // run header costs as much.
+    constexpr std::size_t MERGE_GAP_WORDS = 2;
+
+    struct RunHeader
+    {
+        // Unchanged bytes since the end of the previous run.
+        std::uint32_t skip;
+        std::uint32_t length;
+    };
+
+    bool WordDiffers(const std::byte* a, const std::byte* b, const std::size_t offset, const std::size_t size)
+    {
+        const std::size_t length = std::min(WORD, size - offset);
+        if (length == WORD)
+        {
+            std::uint64_t x;
+            std::uint64_t y;
+            std::memcpy(&x, a + offset, WORD);
+            std::memcpy(&y, b + offset, WORD);
+            return x != y;
+        }
+        return std::memcmp(a + offset, b + offset, length) != 0;
+    }
+
+    // Runs of `state` that differ from the equally sized `base`, each a header and the new bytes.
+    void EncodeDelta(const std::vector<std::byte>& base, const std::vector<std::byte>& state,
+                     std::vector<std::byte>& out)
+    {
+        out.clear();
+        const std::size_t size = state.size();
+        PSYGINE_ASSERT(size <= std::numeric_limits<std::uint32_t>::max(), "SnapshotRing: snapshot too large");
+        std::size_t previousEnd = 0;
+        std::size_t offset = 0;
+        while (offset < size)
+        {
+            if (!WordDiffers(base.data(), state.data(), offset, size))
+            {
+                offset += WORD;
+                continue;
+            }
+
+            const std::size_t begin = offset;
+            std::size_t end = std::min(offset + WORD, size);
+            std::size_t gap = 0;
+            for (offset = end; offset < size && gap < MERGE_GAP_WORDS; offset += WORD)
+            {
+                if (WordDiffers(base.data(), state.data(), offset, size))
+                {
+                    end = std::min(offset + WORD, size);
+                    gap = 0;
+                }
+                else
+                {
+                    ++gap;
+                }
+            }
+            offset = end;
+
+            const RunHeader header{static_cast<std::uint32_t>(begin - previousEnd),
+                                   static_cast<std::uint32_t>(end - begin)};
+            const std::size_t at = out.size();
+            out.resize(at + sizeof(RunHeader) + (end - begin));
+            std::memcpy(out.data() + at, &header, sizeof(RunHeader));
+            std::memcpy(out.data() + at + sizeof(RunHeader), state.data() + begin, end - begin);
+            previousEnd = end;
+        }
+    }
+
+    void ApplyDelta(const std::vector<std::byte>& delta, std::vector<std::byte>& state)
+    {
+        std::size_t position = 0;
+        for (std::size_t at = 0; at < delta.size();)
+        {
+            RunHeader header;
+            std::memcpy(&header, delta.data() + at, sizeof(RunHeader));
+            at += sizeof(RunHeader);
+            position += header.skip;
+            std::memcpy(state.data() + position, delta.data() + at, header.length);
+            at += header.length;
+            position += header.length;
+        }
+    }
+}
+
+namespace psygine::core
+{
+    void SnapshotWriter::append(const void* data, const std::size_t size)
+    {
+        const std::size_t at = out_.size();
+        out_.resize(at + size);
+        if (size != 0)
+        {
+            std::memcpy(out_.data() + at, data, size);
+        }
+    }
+
+    void SnapshotReader::take(void* data, const std::size_t size)
+    {
+        PSYGINE_ASSERT(size <= remaining(), "SnapshotReader: read past the end of the snapshot");
+        if (size != 0)
+        {
+            std::memcpy(data, bytes_.data() + offset_, size);
+        }
+        offset_ += size;
+    }
+
+    SnapshotRing::SnapshotRing(const std::size_t capacity, const std::size_t keyframeInterval) :
+        entries_(capacity),
+        keyframeInterval_{keyframeInterval}
+    {
+        PSYGINE_ASSERT(capacity > 0, "SnapshotRing: capacity must be positive");
+        PSYGINE_ASSERT(keyframeInterval > 0, "SnapshotRing: keyframe interval must be positive");
+    }
+
+    bool SnapshotRing::contains(const std::uint64_t tick) const
+    {
+        return find(tick) != count_;
+    }
+
+    void SnapshotRing::discardFrom(const std::uint64_t tick)
+    {
+        while (count_ > 0 && entry(count_ - 1).tick >= tick)
+        {
+            --count_;
+            release(entries_[(first_ + count_) % entries_.size()].keyframe);
+        }
+    }
+
+    void SnapshotRing::clear()
+    {
+        discardFrom(0);
+        if (current_ != INVALID_INDEX)
+        {
+            release(current_);
+            current_ = INVALID_INDEX;
+        }
+    }
+
+    std::uint64_t SnapshotRing::oldestTick() const
+    {
+        PSYGINE_ASSERT(count_ > 0, "SnapshotRing::oldestTick: ring is empty");
+        return entry(0).tick;
+    }
+
+    std::uint64_t SnapshotRing::newestTick() const
+    {
+        PSYGINE_ASSERT(count_ > 0, "SnapshotRing::newestTick: ring is empty");
+        return entry(count_ - 1).tick;
+    }
+
+    std::size_t SnapshotRing::storedBytes() const
+    {
+        std::size_t bytes = 0;
+        for (const Keyframe& keyframe : keyframes_)
+        {
+            bytes += keyframe.users > 0 ? keyframe.data.size() : 0;
+        }
+        for (std::size_t i = 0; i < count_; ++i)
+        {
+            bytes += entry(i).delta.size();
+        }
+        return bytes;
+    }
+
+    std::size_t SnapshotRing::find(const std::uint64_t tick) const
+    {
+        // Ticks increase along the ring.
+        std::size_t lo = 0;
+        std::size_t hi = count_;
+        while (lo < hi)
+        {
+            const std::size_t mid = lo + ((hi - lo) / 2);
+            if (entry(mid).tick < tick)
+            {
+                lo = mid + 1;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+        return lo < count_ && entry(lo).tick == tick ? lo : count_;
+    }
+
+    void SnapshotRing::commit(const std::uint64_t tick)
+    {
+        discardFrom(tick);
+        if (count_ == entries_.size())
+        {
+            release(entries_[first_].keyframe);
+            first_ = (first_ + 1) % entries_.size();
+            --count_;
+        }
+        Entry& slot = entries_[(first_ + count_) % entries_.size()];
+
+        if (current_ == INVALID_INDEX || sinceKeyframe_ >= keyframeInterval_ ||
+            keyframes_[current_].data.size() != scratch_.size())
+        {
+            std::uint32_t keyframe;
+            if (freeKeyframes_.empty())
+            {
+                keyframe = static_cast<std::uint32_t>(keyframes_.size());
+                keyframes_.emplace_back();
+            }
+            else
+            {
+                keyframe = freeKeyframes_.back();
+                freeKeyframes_.pop_back();
+            }
+            // The recycled buffer becomes the next scratch, so neither side allocates.
+            keyframes_[keyframe].data.swap(scratch_);
+            keyframes_[keyframe].users = 1;
+            if (current_ != INVALID_INDEX)
+            {
+                release(current_);
+            }
+            current_ = keyframe;
+            sinceKeyframe_ = 0;
+            slot.delta.clear();
+        }
+        else
+        {
+            EncodeDelta(keyframes_[current_].data, scratch_, slot.delta);
+        }
+
+        ++keyframes_[current_].users;
+        slot.tick = tick;
+        slot.keyframe = current_;
+        ++sinceKeyframe_;
+        ++count_;
+    }
+
+    const std::vector<std::byte>* SnapshotRing::decode(const std::uint64_t tick)
+    {
+        const std::size_t index = find(tick);
+        if (index == count_)
+        {
+            return nullptr;
+        }
+        const Entry& found = entry(index);
+        const std::vector<std::byte>& keyframe = keyframes_[found.keyframe].data;
+        if (found.delta.empty())
+        {
+            return &keyframe;
+        }
+        scratch_.assign(keyframe.begin(), keyframe.end());
+        ApplyDelta(found.delta, scratch_);
+        return &scratch_;
+    }
+
+    void SnapshotRing::release(const std::uint32_t keyframe)
+    {
+        PSYGINE_DEBUG_ASSERT(keyframes_[keyframe].users > 0, "SnapshotRing: keyframe released too often");
+        if (--keyframes_[keyframe].users == 0)
+        {
+            freeKeyframes_.push_back(keyframe);
+        }
+    }
+}
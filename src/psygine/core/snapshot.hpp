@@ -0,0 +1,252 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#ifndef PSYGINE_SNAPSHOT_HPP
+#define PSYGINE_SNAPSHOT_HPP
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "psygine/debug/assert.hpp"
+
+namespace psygine::core
+{
+    /**
+     * @brief Types a snapshot stores as raw bytes.
+     */
+    template <typename T>
+    concept BlockCopyable = std::is_trivially_copyable_v<T>;
+
+    /**
+     * @brief Appends state to a snapshot as raw bytes.
+     *
+     * Snapshots are only read back by the same build, so values are copied as they are in memory,
+     * without any conversion.
+     */
+    class SnapshotWriter
+    {
+    public:
+        explicit SnapshotWriter(std::vector<std::byte>& out) :
+            out_{out}
+        {
+        }
+
+        template <BlockCopyable T>
+        void write(const T& value)
+        {
+            append(&value, sizeof(T));
+        }
+
+        /**
+         * @brief Writes a length, then the elements as one block.
+         */
+        template <BlockCopyable T>
+        void writeArray(const std::span<const T> values)
+        {
+            write(static_cast<std::uint64_t>(values.size()));
+            append(values.data(), values.size_bytes());
+        }
+
+        template <BlockCopyable T>
+        void writeArray(const std::vector<T>& values)
+        {
+            writeArray(std::span<const T>(values));
+        }
+
+    private:
+        void append(const void* data, std::size_t size);
+
+        std::vector<std::byte>& out_;
+    };
+
+    /**
+     * @brief Reads state back in the order a `SnapshotWriter` wrote it.
+     */
+    class SnapshotReader
+    {
+    public:
+        explicit SnapshotReader(const std::span<const std::byte> bytes) :
+            bytes_{bytes}
+        {
+        }
+
+        template <BlockCopyable T>
+        void read(T& value)
+        {
+            take(&value, sizeof(T));
+        }
+
+        template <BlockCopyable T>
+        [[nodiscard]] T read()
+        {
+            T value;
+            read(value);
+            return value;
+        }
+
+        /**
+         * @brief Replaces the contents of `values` with an array written by `writeArray`. The vector
+         * keeps its capacity, so restoring into the same vectors every time does not allocate.
+         */
+        template <BlockCopyable T>
+        void readArray(std::vector<T>& values)
+        {
+            const auto count = read<std::uint64_t>();
+            PSYGINE_ASSERT(count <= remaining() / std::max<std::size_t>(sizeof(T), 1),
+                           "SnapshotReader::readArray: array runs past the end of the snapshot");
+            values.resize(static_cast<std::size_t>(count));
+            take(values.data(), values.size() * sizeof(T));
+        }
+
+        [[nodiscard]] std::size_t remaining() const
+        {
+            return bytes_.size() - offset_;
+        }
+
+    private:
+        void take(void* data, std::size_t size);
+
+        std::span<const std::byte> bytes_;
+        std::size_t offset_ = 0;
+    };
+
+    /**
+     * @brief The last N snapshots of some state, one per tick, for rollback and undo.
+     *
+     * Every `keyframeInterval`-th snapshot (and any whose size differs from the last keyframe) is
+     * kept whole; the others store only the 8-byte words that differ from their keyframe. State that
+     * mostly sits still, such as a world of sleeping bodies, then costs a few bytes per tick, and
+     * restoring any snapshot is one copy of its keyframe plus one pass over its delta.
+     *
+     * Buffers are recycled, so once the ring has filled, saving and restoring do not allocate.
+     */
+    class SnapshotRing
+    {
+    public:
+        static constexpr std::size_t DEFAULT_KEYFRAME_INTERVAL = 16;
+
+        /**
+         * @param capacity Snapshots kept; saving beyond that drops the oldest.
+         * @param keyframeInterval Snapshots per keyframe. Longer intervals store less but deltas
+         * grow as the state drifts from its keyframe.
+         */
+        explicit SnapshotRing(std::size_t capacity, std::size_t keyframeInterval = DEFAULT_KEYFRAME_INTERVAL);
+
+        /**
+         * @brief Snapshots the state `save(writer)` writes, as of `tick`.
+         *
+         * Ticks must increase from one save to the next, but saving a tick at or before the newest
+         * one first drops that snapshot and every later one: after a rollback the future is written
+         * again.
+         */
+        template <typename Save>
+            requires std::invocable<Save&, SnapshotWriter&>
+        void save(const std::uint64_t tick, Save&& save)
+        {
+            scratch_.clear();
+            SnapshotWriter writer(scratch_);
+            save(writer);
+            commit(tick);
+        }
+
+        /**
+         * @brief Hands the snapshot of `tick` to `load(reader)`; false when it is not held.
+         */
+        template <typename Load>
+            requires std::invocable<Load&, SnapshotReader&>
+        bool restore(const std::uint64_t tick, Load&& load)
+        {
+            const std::vector<std::byte>* bytes = decode(tick);
+            if (bytes == nullptr)
+            {
+                return false;
+            }
+            SnapshotReader reader(*bytes);
+            load(reader);
+            PSYGINE_DEBUG_ASSERT(reader.remaining() == 0, "SnapshotRing::restore: snapshot was not read completely");
+            return true;
+        }
+
+        [[nodiscard]] bool contains(std::uint64_t tick) const;
+
+        /**
+         * @brief Drops the snapshot of `tick` and every later one.
+         */
+        void discardFrom(std::uint64_t tick);
+
+        void clear();
+
+        [[nodiscard]] std::size_t size() const
+        {
+            return count_;
+        }
+
+        [[nodiscard]] bool empty() const
+        {
+            return count_ == 0;
+        }
+
+        [[nodiscard]] std::size_t capacity() const
+        {
+            return entries_.size();
+        }
+
+        [[nodiscard]] std::uint64_t oldestTick() const;
+        [[nodiscard]] std::uint64_t newestTick() const;
+
+        /**
+         * @brief Bytes of snapshot data currently held, keyframes and deltas, for tuning the interval.
+         */
+        [[nodiscard]] std::size_t storedBytes() const;
+
+    private:
+        static constexpr std::uint32_t INVALID_INDEX = std::numeric_limits<std::uint32_t>::max();
+
+        struct Keyframe
+        {
+            std::vector<std::byte> data;
+            // Entries using it, plus one while it is the keyframe new snapshots are encoded against.
+            std::uint32_t users = 0;
+        };
+
+        struct Entry
+        {
+            std::uint64_t tick = 0;
+            std::uint32_t keyframe = INVALID_INDEX;
+            // Changed runs against the keyframe; empty when the snapshot equals it.
+            std::vector<std::byte> delta;
+        };
+
+        [[nodiscard]] const Entry& entry(std::size_t logical) const
+        {
+            return entries_[(first_ + logical) % entries_.size()];
+        }
+
+        [[nodiscard]] std::size_t find(std::uint64_t tick) const;
+        void commit(std::uint64_t tick);
+        [[nodiscard]] const std::vector<std::byte>* decode(std::uint64_t tick);
+        void release(std::uint32_t keyframe);
+
+        std::vector<Entry> entries_;
+        std::size_t first_ = 0;
+        std::size_t count_ = 0;
+
+        std::vector<Keyframe> keyframes_;
+        std::vector<std::uint32_t> freeKeyframes_;
+        std::uint32_t current_ = INVALID_INDEX;
+        std::size_t sinceKeyframe_ = 0;
+        std::size_t keyframeInterval_;
+
+        // The snapshot being saved, or the one being restored when it had to be rebuilt.
+        std::vector<std::byte> scratch_;
+    };
+}
+
+#endif //PSYGINE_SNAPSHOT_HPP
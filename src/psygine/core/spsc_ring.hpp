@@ -0,0 +1,117 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#ifndef PSYGINE_SPSC_RING_HPP
+#define PSYGINE_SPSC_RING_HPP
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <type_traits>
+
+#include "psygine/debug/assert.hpp"
+
+namespace psygine::core
+{
+    /**
+     * @brief Bounded lock-free queue between exactly one producer thread and one consumer thread.
+     *
+     * The indices only ever grow and are masked into the slot array, so full and empty are told apart
+     * without a spare slot. Each side keeps its own index and a cached copy of the other side's on a
+     * separate cache line, and only reloads the shared index when the cached one says the ring looks
+     * full or empty, so steady traffic costs one release store per push and per pop.
+     *
+     * @tparam T A trivially copyable element type.
+     * @tparam Capacity The number of slots; a power of two.
+     */
+    template <typename T, std::size_t Capacity>
+    class SpscRing
+    {
+        static_assert(std::has_single_bit(Capacity), "SpscRing capacity must be a power of two");
+        static_assert(std::is_trivially_copyable_v<T>, "SpscRing elements must be trivially copyable");
+
+    public:
+        static constexpr std::size_t CAPACITY = Capacity;
+
+        SpscRing() = default;
+
+        /**
+         * @brief Producer: appends `value`, or returns false and leaves the ring unchanged when it is full.
+         */
+        bool tryPush(const T& value)
+        {
+            const std::size_t tail = tail_.load(std::memory_order_relaxed);
+            if (tail - headCache_ == Capacity)
+            {
+                headCache_ = head_.load(std::memory_order_acquire);
+                if (tail - headCache_ == Capacity)
+                {
+                    return false;
+                }
+            }
+
+            slots_[tail & MASK] = value;
+            tail_.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Consumer: the oldest element, or nullptr when the ring is empty. It stays valid until `pop`.
+         */
+        [[nodiscard]] const T* front()
+        {
+            const std::size_t head = head_.load(std::memory_order_relaxed);
+            if (head == tailCache_)
+            {
+                tailCache_ = tail_.load(std::memory_order_acquire);
+                if (head == tailCache_)
+                {
+                    return nullptr;
+                }
+            }
+            return &slots_[head & MASK];
+        }
+
+        /**
+         * @brief Consumer: removes the element returned by `front`.
+         */
+        void pop()
+        {
+            const std::size_t head = head_.load(std::memory_order_relaxed);
+            PSYGINE_DEBUG_ASSERT(head != tail_.load(std::memory_order_acquire), "SpscRing::pop: ring is empty");
+            head_.store(head + 1, std::memory_order_release);
+        }
+
+        /**
+         * @brief The number of queued elements; only a snapshot while the other side is running.
+         */
+        [[nodiscard]] std::size_t size() const
+        {
+            const std::size_t head = head_.load(std::memory_order_acquire);
+            return tail_.load(std::memory_order_acquire) - head;
+        }
+
+        SpscRing(const SpscRing& other) = delete;
+        SpscRing(SpscRing&& other) noexcept = delete;
+        SpscRing& operator=(const SpscRing& other) = delete;
+        SpscRing& operator=(SpscRing&& other) noexcept = delete;
+
+    private:
+        static constexpr std::size_t MASK = Capacity - 1;
+        // Keeps the producer's and consumer's indices from sharing a cache line.
+        static constexpr std::size_t CACHE_LINE = 64;
+
+        // Consumer side.
+        alignas(CACHE_LINE) std::atomic<std::size_t> head_{0};
+        std::size_t tailCache_ = 0;
+
+        // Producer side.
+        alignas(CACHE_LINE) std::atomic<std::size_t> tail_{0};
+        std::size_t headCache_ = 0;
+
+        alignas(CACHE_LINE) std::array<T, Capacity> slots_{};
+    };
+}
+
+#endif //PSYGINE_SPSC_RING_HPP
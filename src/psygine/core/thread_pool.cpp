@@ -0,0 +1,178 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace
+{
+    // Shared between the caller and helper tasks; helpers may outlive the call, so it is ref-counted.
+    struct RangeJob
+    {
+        const psygine::core::ThreadPool::RangeFunction* fn = nullptr;
+        std::size_t count = 0;
+        std::size_t grain = 1;
+        std::size_t chunks = 0;
+        std::atomic<std::size_t> nextChunk{0};
+        std::atomic<std::size_t> doneChunks{0};
+
+        // Claims and runs chunks until none are left. Returns once nothing more can be claimed.
+        void drain()
+        {
+            for (;;)
+            {
+                const std::size_t chunk = nextChunk.fetch_add(1, std::memory_order_relaxed);
+                if (chunk >= chunks)
+                {
+                    return;
+                }
+
+                const std::size_t begin = chunk * grain;
+                const std::size_t end = std::min(begin + grain, count);
+                (*fn)(begin, end);
+
+                if (doneChunks.fetch_add(1, std::memory_order_acq_rel) + 1 == chunks)
+                {
+                    doneChunks.notify_all();
+                }
+            }
+        }
+    };
+}
+
+namespace psygine::core
+{
+    ThreadPool::ThreadPool(const std::size_t workerCount)
+    {
+        workers_.reserve(workerCount);
+        for (std::size_t i = 0; i < workerCount; ++i)
+        {
+            workers_.emplace_back([this]
+            {
+                workerLoop();
+            });
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::scoped_lock lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+
+        for (auto& worker : workers_)
+        {
+            worker.join();
+        }
+    }
+
+    void ThreadPool::parallelFor(const std::size_t count, std::size_t grain, const RangeFunction& fn)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        if (grain == 0)
+        {
+            // Aim for a few chunks per thread so uneven chunks still balance.
+            grain = std::max<std::size_t>(1, count / (concurrency() * 4));
+        }
+
+        const std::size_t chunks = (count + grain - 1) / grain;
+        if (chunks == 1 || workers_.empty())
+        {
+            for (std::size_t begin = 0; begin < count; begin += grain)
+            {
+                fn(begin, std::min(begin + grain, count));
+            }
+            return;
+        }
+
+        auto job = std::make_shared<RangeJob>();
+        job->fn = &fn;
+        job->count = count;
+        job->grain = grain;
+        job->chunks = chunks;
+
+        const std::size_t helpers = std::min(workers_.size(), chunks - 1);
+        {
+            std::scoped_lock lock(mutex_);
+            for (std::size_t i = 0; i < helpers; ++i)
+            {
+                tasks_.emplace_back([job]
+                {
+                    job->drain();
+                });
+            }
+        }
+        if (helpers == 1)
+        {
+            wake_.notify_one();
+        }
+        else
+        {
+            wake_.notify_all();
+        }
+
+        job->drain();
+
+        // Everything is claimed; wait for the chunks still running on other threads.
+        for (std::size_t done = job->doneChunks.load(std::memory_order_acquire); done < chunks;
+             done = job->doneChunks.load(std::memory_order_acquire))
+        {
+            job->doneChunks.wait(done, std::memory_order_acquire);
+        }
+    }
+
+    void ThreadPool::submit(std::function<void()> task)
+    {
+        if (workers_.empty())
+        {
+            task();
+            return;
+        }
+
+        {
+            std::scoped_lock lock(mutex_);
+            tasks_.push_back(std::move(task));
+        }
+        wake_.notify_one();
+    }
+
+    std::size_t ThreadPool::DefaultWorkerCount()
+    {
+        const unsigned hardware = std::thread::hardware_concurrency();
+        return hardware > 1 ? static_cast<std::size_t>(hardware - 1) : 0;
+    }
+
+    void ThreadPool::workerLoop()
+    {
+        for (;;)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock lock(mutex_);
+                wake_.wait(lock, [this]
+                {
+                    return stopping_ || !tasks_.empty();
+                });
+
+                if (tasks_.empty())
+                {
+                    return;
+                }
+
+                task = std::move(tasks_.front());
+                tasks_.pop_front();
+            }
+
+            task();
+        }
+    }
+}
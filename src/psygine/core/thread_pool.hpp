@@ -0,0 +1,105 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#ifndef PSYGINE_THREAD_POOL_HPP
+#define PSYGINE_THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace psygine::core
+{
+    /**
+     * @brief Fixed-size pool of worker threads for data-parallel work.
+     *
+     * The pool is built around `parallelFor`, which splits an index range into chunks that the
+     * calling thread and the workers claim from a shared atomic counter. The caller always takes
+     * part, so a pool with zero workers simply runs everything inline, and a `parallelFor` issued
+     * from inside another one cannot deadlock: every chunk that was claimed is being run.
+     */
+    class ThreadPool
+    {
+    public:
+        /**
+         * @brief Signature of the work callback: processes indices in [begin, end).
+         */
+        using RangeFunction = std::function<void(std::size_t begin, std::size_t end)>;
+
+        /**
+         * @brief Constructs a pool with the given number of worker threads.
+         *
+         * @param workerCount Number of workers to spawn, not counting the calling thread.
+         *                    Defaults to one less than the hardware concurrency.
+         */
+        explicit ThreadPool(std::size_t workerCount = DefaultWorkerCount());
+
+        /**
+         * @brief Stops and joins all workers. Pending tasks are finished first.
+         */
+        ~ThreadPool();
+
+        /**
+         * @brief Runs `fn` over [0, count) split into chunks of at most `grain` indices.
+         *
+         * Blocks until every chunk has completed. Chunks are handed out dynamically, so uneven
+         * work balances itself; pick a grain large enough to amortize the claim (a few microseconds
+         * of work per chunk).
+         *
+         * @param count The number of indices to process.
+         * @param grain The maximum number of indices per chunk; 0 picks one based on the worker count.
+         * @param fn The callback invoked as `fn(begin, end)` for each chunk.
+         */
+        void parallelFor(std::size_t count, std::size_t grain, const RangeFunction& fn);
+
+        /**
+         * @brief Queues a fire-and-forget task for the next free worker.
+         *
+         * With no workers the task runs inline before returning.
+         *
+         * @param task The task to run.
+         */
+        void submit(std::function<void()> task);
+
+        /**
+         * @brief Number of worker threads, not counting callers of `parallelFor`.
+         */
+        [[nodiscard]] std::size_t workerCount() const
+        {
+            return workers_.size();
+        }
+
+        /**
+         * @brief Number of threads that can work on a `parallelFor` at once, including the caller.
+         */
+        [[nodiscard]] std::size_t concurrency() const
+        {
+            return workers_.size() + 1;
+        }
+
+        /**
+         * @brief One less than the hardware concurrency, leaving room for the main thread.
+         */
+        [[nodiscard]] static std::size_t DefaultWorkerCount();
+
+        ThreadPool(const ThreadPool& other) = delete;
+        ThreadPool(ThreadPool&& other) noexcept = delete;
+        ThreadPool& operator=(const ThreadPool& other) = delete;
+        ThreadPool& operator=(ThreadPool&& other) noexcept = delete;
+
+    private:
+        void workerLoop();
+
+        std::vector<std::thread> workers_;
+        std::deque<std::function<void()>> tasks_;
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        bool stopping_ = false;
+    };
+}
+
+#endif //PSYGINE_THREAD_POOL_HPP
@@ -0,0 +1,263 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#include "timer_wheel.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include "psygine/debug/assert.hpp"
+
+namespace psygine::core
+{
+    TimerHandle TimerWheel::schedule(const std::uint64_t delayTicks, Callback callback)
+    {
+        return add(delayTicks, 0, std::move(callback));
+    }
+
+    TimerHandle TimerWheel::scheduleRepeating(const std::uint64_t intervalTicks, Callback callback,
+                                              const std::uint64_t firstDelayTicks)
+    {
+        PSYGINE_ASSERT(intervalTicks > 0, "TimerWheel: repeating interval must be non-zero");
+        return add(firstDelayTicks == 0 ? intervalTicks : firstDelayTicks, intervalTicks, std::move(callback));
+    }
+
+    bool TimerWheel::cancel(const TimerHandle handle)
+    {
+        if (find(handle) == nullptr)
+        {
+            return false;
+        }
+
+        Node& node = nodes_[handle.index];
+        if (node.state == NodeState::Pending)
+        {
+            unlink(handle.index);
+            release(handle.index);
+            --size_;
+            return true;
+        }
+        if (node.state == NodeState::Firing && node.interval != 0)
+        {
+            // Cancelled from inside its own callback; fire() releases it once the callback returns.
+            node.state = NodeState::Cancelled;
+            --size_;
+            return true;
+        }
+        return false;
+    }
+
+    bool TimerWheel::pending(const TimerHandle handle) const
+    {
+        const Node* node = find(handle);
+        return node != nullptr &&
+            (node->state == NodeState::Pending || (node->state == NodeState::Firing && node->interval != 0));
+    }
+
+    std::uint64_t TimerWheel::remaining(const TimerHandle handle) const
+    {
+        if (!pending(handle))
+        {
+            return 0;
+        }
+        const Node& node = nodes_[handle.index];
+        return node.state == NodeState::Firing ? node.interval : node.deadline - now_;
+    }
+
+    void TimerWheel::advance(const std::uint64_t ticks)
+    {
+        for (std::uint64_t i = 0; i < ticks; ++i)
+        {
+            if (size_ == 0)
+            {
+                now_ += ticks - i;
+                return;
+            }
+            ++now_;
+
+            // Level L turns over when the low L * SLOT_BITS bits of the tick wrap to zero. Outer levels
+            // are emptied first so their timers can land in the inner slots emptied after them.
+            std::uint32_t turned = 0;
+            while (turned + 1 < LEVELS && (now_ & ((std::uint64_t{1} << (SLOT_BITS * (turned + 1))) - 1)) == 0)
+            {
+                ++turned;
+            }
+            for (std::uint32_t level = turned; level > 0; --level)
+            {
+                cascade(level);
+            }
+
+            fire(static_cast<std::uint32_t>(now_ & SLOT_MASK));
+        }
+    }
+
+    void TimerWheel::clear()
+    {
+        for (std::uint32_t index = 0; index < nodes_.size(); ++index)
+        {
+            Node& node = nodes_[index];
+            if (node.state == NodeState::Pending)
+            {
+                release(index);
+            }
+            else if (node.state == NodeState::Firing)
+            {
+                node.state = NodeState::Cancelled;
+            }
+        }
+        slots_.fill(Slot{});
+        size_ = 0;
+    }
+
+    TimerHandle TimerWheel::add(const std::uint64_t delayTicks, const std::uint64_t intervalTicks, Callback callback)
+    {
+        std::uint32_t index = freeHead_;
+        if (index != NIL)
+        {
+            freeHead_ = nodes_[index].next;
+        }
+        else
+        {
+            PSYGINE_ASSERT(nodes_.size() < NIL, "TimerWheel: too many timers");
+            index = static_cast<std::uint32_t>(nodes_.size());
+            nodes_.emplace_back();
+        }
+
+        Node& node = nodes_[index];
+        node.callback = std::move(callback);
+        node.deadline = now_ + std::max<std::uint64_t>(delayTicks, 1);
+        node.interval = intervalTicks;
+        node.state = NodeState::Pending;
+        link(index);
+        ++size_;
+        return {index, node.generation};
+    }
+
+    const TimerWheel::Node* TimerWheel::find(const TimerHandle handle) const
+    {
+        if (handle.index >= nodes_.size())
+        {
+            return nullptr;
+        }
+        const Node& node = nodes_[handle.index];
+        return node.generation == handle.generation && node.state != NodeState::Free ? &node : nullptr;
+    }
+
+    void TimerWheel::link(const std::uint32_t index)
+    {
+        Node& node = nodes_[index];
+
+        // Deadlines beyond the outermost level are parked in a level-3 slot that turns before they are
+        // due; cascading re-examines them against the real deadline.
+        constexpr std::uint64_t RANGE = std::uint64_t{1} << (SLOT_BITS * LEVELS);
+        constexpr std::uint64_t PARK_OFFSET = RANGE - (std::uint64_t{1} << (SLOT_BITS * (LEVELS - 1)));
+        const std::uint64_t distance = node.deadline - now_;
+        const std::uint64_t target = distance < RANGE ? node.deadline : now_ + PARK_OFFSET;
+
+        std::uint32_t level = 0;
+        while (level + 1 < LEVELS && distance >= (std::uint64_t{1} << (SLOT_BITS * (level + 1))))
+        {
+            ++level;
+        }
+        node.slot = (level * SLOTS) + static_cast<std::uint32_t>((target >> (SLOT_BITS * level)) & SLOT_MASK);
+
+        Slot& slot = slots_[node.slot];
+        node.prev = slot.tail;
+        node.next = NIL;
+        if (slot.tail != NIL)
+        {
+            nodes_[slot.tail].next = index;
+        }
+        else
+        {
+            slot.head = index;
+        }
+        slot.tail = index;
+    }
+
+    void TimerWheel::unlink(const std::uint32_t index)
+    {
+        Node& node = nodes_[index];
+        Slot& slot = slots_[node.slot];
+        if (node.prev != NIL)
+        {
+            nodes_[node.prev].next = node.next;
+        }
+        else
+        {
+            slot.head = node.next;
+        }
+        if (node.next != NIL)
+        {
+            nodes_[node.next].prev = node.prev;
+        }
+        else
+        {
+            slot.tail = node.prev;
+        }
+        node.prev = NIL;
+        node.next = NIL;
+        node.slot = NIL;
+    }
+
+    void TimerWheel::release(const std::uint32_t index)
+    {
+        Node& node = nodes_[index];
+        node.callback = nullptr;
+        node.state = NodeState::Free;
+        ++node.generation;
+        node.prev = NIL;
+        node.next = freeHead_;
+        node.slot = NIL;
+        freeHead_ = index;
+    }
+
+    void TimerWheel::cascade(const std::uint32_t level)
+    {
+        const std::uint32_t slotIndex =
+            (level * SLOTS) + static_cast<std::uint32_t>((now_ >> (SLOT_BITS * level)) & SLOT_MASK);
+        std::uint32_t index = std::exchange(slots_[slotIndex], Slot{}).head;
+        while (index != NIL)
+        {
+            const std::uint32_t next = nodes_[index].next;
+            link(index);
+            index = next;
+        }
+    }
+
+    void TimerWheel::fire(const std::uint32_t slot)
+    {
+        // Callbacks only ever add timers at least one tick ahead, so this slot cannot refill while it
+        // drains; cancelling another timer in it just unlinks that timer.
+        while (slots_[slot].head != NIL)
+        {
+            const std::uint32_t index = slots_[slot].head;
+            unlink(index);
+
+            Node& node = nodes_[index];
+            node.state = NodeState::Firing;
+            const bool repeating = node.interval != 0;
+            if (!repeating)
+            {
+                --size_;
+            }
+
+            // Moved out because the callback may schedule timers and grow nodes_.
+            Callback callback = std::move(node.callback);
+            callback();
+
+            Node& after = nodes_[index];
+            if (repeating && after.state == NodeState::Firing)
+            {
+                after.callback = std::move(callback);
+                after.deadline += after.interval;
+                after.state = NodeState::Pending;
+                link(index);
+            }
+            else
+            {
+                release(index);
+            }
+        }
+    }
+}
@@ -0,0 +1,176 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#ifndef PSYGINE_TIMER_WHEEL_HPP
+#define PSYGINE_TIMER_WHEEL_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <vector>
+
+namespace psygine::core
+{
+    /**
+     * @brief Identifies a timer scheduled on a `TimerWheel`.
+     *
+     * Handles stay safe to use after the timer fired or was cancelled: the slot's generation changes
+     * when it is reused, so a stale handle simply reports the timer as gone.
+     */
+    struct TimerHandle
+    {
+        static constexpr std::uint32_t INVALID_INDEX = std::numeric_limits<std::uint32_t>::max();
+
+        std::uint32_t index = INVALID_INDEX;
+        std::uint32_t generation = 0;
+
+        [[nodiscard]] bool valid() const
+        {
+            return index != INVALID_INDEX;
+        }
+
+        bool operator==(const TimerHandle&) const = default;
+    };
+
+    /**
+     * @brief Hierarchical timing wheel for delayed and repeating callbacks, counted in fixed ticks.
+     *
+     * Four levels of 256 slots cover deadlines up to 2^32 ticks ahead; later deadlines are parked in
+     * the outermost level and re-examined as it turns. Scheduling, cancelling and expiring are O(1)
+     * (a timer is moved down at most three times before it fires), and timer nodes are pooled, so a
+     * steady state of scheduling and firing does not allocate.
+     *
+     * Time only moves through `advance`, so the same sequence of calls fires the same callbacks on the
+     * same ticks on every run. Timers due on the same tick fire in the order they were scheduled, unless
+     * they were parked in different levels. Callbacks may schedule and cancel timers, including their own.
+     */
+    class TimerWheel
+    {
+    public:
+        using Callback = std::function<void()>;
+
+        TimerWheel() = default;
+
+        /**
+         * @brief Runs `callback` once, `delayTicks` ticks from now.
+         *
+         * @param delayTicks Ticks to wait; 0 and 1 both fire on the next `advance`.
+         * @param callback The function to call.
+         * @return A handle for cancelling or querying the timer.
+         */
+        TimerHandle schedule(std::uint64_t delayTicks, Callback callback);
+
+        /**
+         * @brief Runs `callback` every `intervalTicks` ticks until cancelled.
+         *
+         * @param intervalTicks Ticks between calls; must be non-zero.
+         * @param callback The function to call.
+         * @param firstDelayTicks Ticks until the first call; 0 uses `intervalTicks`.
+         * @return A handle for cancelling or querying the timer.
+         */
+        TimerHandle scheduleRepeating(std::uint64_t intervalTicks, Callback callback,
+                                      std::uint64_t firstDelayTicks = 0);
+
+        /**
+         * @brief Cancels a pending timer.
+         *
+         * @param handle The timer to cancel.
+         * @return True if the timer was pending; false if it already fired, was cancelled or is invalid.
+         */
+        bool cancel(TimerHandle handle);
+
+        /**
+         * @brief Checks whether a timer is still going to fire.
+         */
+        [[nodiscard]] bool pending(TimerHandle handle) const;
+
+        /**
+         * @brief Ticks until the timer next fires, or 0 when it is not pending.
+         */
+        [[nodiscard]] std::uint64_t remaining(TimerHandle handle) const;
+
+        /**
+         * @brief Moves time forward, firing every timer that comes due, tick by tick.
+         *
+         * @param ticks The number of ticks to advance.
+         */
+        void advance(std::uint64_t ticks = 1);
+
+        /**
+         * @brief Cancels every timer without calling it. The current tick is kept.
+         */
+        void clear();
+
+        /**
+         * @brief The number of ticks advanced so far.
+         */
+        [[nodiscard]] std::uint64_t currentTick() const
+        {
+            return now_;
+        }
+
+        /**
+         * @brief The number of pending timers.
+         */
+        [[nodiscard]] std::size_t size() const
+        {
+            return size_;
+        }
+
+        [[nodiscard]] bool empty() const
+        {
+            return size_ == 0;
+        }
+
+    private:
+        static constexpr std::uint32_t NIL = TimerHandle::INVALID_INDEX;
+        static constexpr std::uint32_t LEVELS = 4;
+        static constexpr std::uint32_t SLOT_BITS = 8;
+        static constexpr std::uint32_t SLOTS = 1U << SLOT_BITS;
+        static constexpr std::uint64_t SLOT_MASK = SLOTS - 1;
+
+        enum class NodeState : std::uint8_t
+        {
+            Free,
+            Pending,
+            Firing,
+            Cancelled
+        };
+
+        struct Node
+        {
+            Callback callback;
+            std::uint64_t deadline = 0;
+            std::uint64_t interval = 0; // 0 for one-shot timers
+            std::uint32_t prev = NIL;
+            std::uint32_t next = NIL; // also links the free list
+            std::uint32_t slot = NIL; // index into slots_ while linked into one
+            std::uint32_t generation = 0;
+            NodeState state = NodeState::Free;
+        };
+
+        struct Slot
+        {
+            std::uint32_t head = NIL;
+            std::uint32_t tail = NIL;
+        };
+
+        TimerHandle add(std::uint64_t delayTicks, std::uint64_t intervalTicks, Callback callback);
+        [[nodiscard]] const Node* find(TimerHandle handle) const;
+        void link(std::uint32_t index);
+        void unlink(std::uint32_t index);
+        void release(std::uint32_t index);
+        void cascade(std::uint32_t level);
+        void fire(std::uint32_t slot);
+
+        std::vector<Node> nodes_;
+        std::array<Slot, LEVELS * SLOTS> slots_{};
+        std::uint32_t freeHead_ = NIL;
+        std::uint64_t now_ = 0;
+        std::size_t size_ = 0;
+    };
+}
+
+#endif //PSYGINE_TIMER_WHEEL_HPP
@@ -0,0 +1,174 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#include "archetype.hpp"
+
+#include <algorithm>
+#include <new>
+#include <utility>
+
+#include "psygine/debug/assert.hpp"
+
+namespace
+{
+    using psygine::ecs::Archetype;
+    using psygine::ecs::CHUNK_ALIGNMENT;
+    using psygine::ecs::CHUNK_SIZE;
+    using psygine::ecs::Entity;
+    using psygine::ecs::detail::AlignUp;
+
+    // Bytes used by a chunk of `capacity` rows, laying out the columns after the entity ids.
+    std::size_t LayoutSize(const std::vector<Archetype::Column>& columns, const std::size_t capacity)
+    {
+        std::size_t end = capacity * sizeof(Entity);
+        for (const Archetype::Column& column : columns)
+        {
+            end = AlignUp(end, CHUNK_ALIGNMENT) + (capacity * column.info.size);
+        }
+        return end;
+    }
+
+    std::byte* AllocateChunk()
+    {
+        return static_cast<std::byte*>(::operator new(CHUNK_SIZE, std::align_val_t{CHUNK_ALIGNMENT}));
+    }
+
+    void FreeChunk(std::byte* chunk)
+    {
+        ::operator delete(chunk, std::align_val_t{CHUNK_ALIGNMENT});
+    }
+}
+
+namespace psygine::ecs
+{
+    Archetype::Archetype(std::vector<ComponentId> signature) :
+        signature_{std::move(signature)}
+    {
+        PSYGINE_DEBUG_ASSERT(std::ranges::adjacent_find(signature_, std::ranges::greater_equal{}) == signature_.end(),
+                             "Archetype: signature must be sorted and unique");
+
+        std::size_t rowBytes = sizeof(Entity);
+        columns_.reserve(signature_.size());
+        for (const ComponentId id : signature_)
+        {
+            Column column;
+            column.id = id;
+            column.info = detail::GetComponentInfo(id);
+            PSYGINE_ASSERT(column.info.alignment <= CHUNK_ALIGNMENT, "Archetype: component alignment exceeds 64");
+            rowBytes += column.info.size;
+            columns_.push_back(column);
+        }
+
+        std::size_t capacity = CHUNK_SIZE / rowBytes;
+        while (capacity > 0 && LayoutSize(columns_, capacity) > CHUNK_SIZE)
+        {
+            --capacity;
+        }
+        PSYGINE_ASSERT(capacity > 0, "Archetype: components do not fit in one chunk");
+        chunkCapacity_ = static_cast<std::uint32_t>(capacity);
+
+        std::size_t end = capacity * sizeof(Entity);
+        for (Column& column : columns_)
+        {
+            column.offset = AlignUp(end, CHUNK_ALIGNMENT);
+            end = column.offset + (capacity * column.info.size);
+        }
+    }
+
+    Archetype::~Archetype()
+    {
+        const bool trivial = std::ranges::all_of(columns_, [](const Column& column)
+        {
+            return column.info.trivial;
+        });
+        if (!trivial)
+        {
+            for (std::size_t row = 0; row < size_; ++row)
+            {
+                destroyRow(locate(row));
+            }
+        }
+        for (std::byte* chunk : chunks_)
+        {
+            FreeChunk(chunk);
+        }
+    }
+
+    std::size_t Archetype::columnIndex(const ComponentId id) const
+    {
+        const auto it = std::ranges::lower_bound(signature_, id);
+        if (it == signature_.end() || *it != id)
+        {
+            return NPOS;
+        }
+        return static_cast<std::size_t>(it - signature_.begin());
+    }
+
+    RowLocation Archetype::allocate(const Entity entity)
+    {
+        const RowLocation location = locate(size_);
+        if (location.chunk == chunks_.size())
+        {
+            chunks_.push_back(AllocateChunk());
+        }
+        entities(location.chunk)[location.row] = entity;
+        ++size_;
+        return location;
+    }
+
+    void Archetype::destroyRow(const RowLocation location)
+    {
+        for (std::size_t column = 0; column < columns_.size(); ++column)
+        {
+            detail::Destroy(columns_[column].info, component(location, column));
+        }
+    }
+
+    Entity Archetype::swapRemove(const RowLocation location)
+    {
+        PSYGINE_DEBUG_ASSERT(size_ > 0, "Archetype::swapRemove: archetype is empty");
+
+        Entity moved;
+        const RowLocation last = locate(size_ - 1);
+        if (location.chunk != last.chunk || location.row != last.row)
+        {
+            for (std::size_t column = 0; column < columns_.size(); ++column)
+            {
+                detail::Relocate(columns_[column].info, component(location, column), component(last, column));
+            }
+            moved = entities(last.chunk)[last.row];
+            entities(location.chunk)[location.row] = moved;
+        }
+        --size_;
+
+        // Keep one empty chunk around so an entity bouncing across a chunk boundary does not allocate.
+        while (chunks_.size() > chunkCount() + 1)
+        {
+            FreeChunk(chunks_.back());
+            chunks_.pop_back();
+        }
+        return moved;
+    }
+
+    Archetype* Archetype::addTarget(const ComponentId id) const
+    {
+        const auto it = addEdges_.find(id);
+        return it != addEdges_.end() ? it->second : nullptr;
+    }
+
+    Archetype* Archetype::removeTarget(const ComponentId id) const
+    {
+        const auto it = removeEdges_.find(id);
+        return it != removeEdges_.end() ? it->second : nullptr;
+    }
+
+    void Archetype::setAddTarget(const ComponentId id, Archetype* target)
+    {
+        addEdges_[id] = target;
+    }
+
+    void Archetype::setRemoveTarget(const ComponentId id, Archetype* target)
+    {
+        removeEdges_[id] = target;
+    }
+}
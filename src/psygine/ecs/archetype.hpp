@@ -0,0 +1,206 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#ifndef PSYGINE_ARCHETYPE_HPP
+#define PSYGINE_ARCHETYPE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "component.hpp"
+#include "entity.hpp"
+
+namespace psygine::ecs
+{
+    /**
+     * @brief Bytes per chunk of archetype storage; small enough to stay resident in L1/L2 while a
+     * chunk is processed.
+     */
+    inline constexpr std::size_t CHUNK_SIZE = 16 * 1024;
+
+    /**
+     * @brief Alignment of every chunk and of every column inside one, so columns start on a cache line.
+     */
+    inline constexpr std::size_t CHUNK_ALIGNMENT = 64;
+
+    /**
+     * @brief Position of an entity's row inside an archetype.
+     */
+    struct RowLocation
+    {
+        std::uint32_t chunk = 0;
+        std::uint32_t row = 0;
+    };
+
+    /**
+     * @brief Table of all entities that have exactly the same set of components.
+     *
+     * Rows live in fixed-size chunks of `CHUNK_SIZE` bytes. Each chunk holds the entity ids followed
+     * by one tightly packed array (column) per component, so iterating a component touches contiguous
+     * memory. Rows are kept dense: every chunk except the last is full, and removing a row moves the
+     * archetype's last row into the hole.
+     *
+     * Archetypes also cache their neighbours in the archetype graph (the archetype reached by adding
+     * or removing one component), which turns structural changes into O(1) lookups once warmed up.
+     * The `World` owns archetypes and keeps entity records in sync with the moves reported here.
+     */
+    class Archetype
+    {
+    public:
+        static constexpr std::size_t NPOS = static_cast<std::size_t>(-1);
+
+        struct Column
+        {
+            ComponentId id = 0;
+            ComponentInfo info;
+            std::size_t offset = 0; // byte offset of the column inside a chunk
+        };
+
+        /**
+         * @brief Creates an empty archetype.
+         *
+         * @param signature The component ids, sorted and without duplicates.
+         */
+        explicit Archetype(std::vector<ComponentId> signature);
+
+        /**
+         * @brief Destroys every component still stored and frees the chunks.
+         */
+        ~Archetype();
+
+        /**
+         * @brief The sorted component ids of this archetype.
+         */
+        [[nodiscard]] std::span<const ComponentId> signature() const
+        {
+            return signature_;
+        }
+
+        /**
+         * @brief The column holding a component, or `NPOS` when the archetype does not have it.
+         */
+        [[nodiscard]] std::size_t columnIndex(ComponentId id) const;
+
+        [[nodiscard]] const Column& column(const std::size_t index) const
+        {
+            return columns_[index];
+        }
+
+        [[nodiscard]] std::size_t columnCount() const
+        {
+            return columns_.size();
+        }
+
+        /**
+         * @brief Rows per chunk, derived from the component sizes.
+         */
+        [[nodiscard]] std::uint32_t chunkCapacity() const
+        {
+            return chunkCapacity_;
+        }
+
+        /**
+         * @brief Chunks in use; the last may be partly filled, all others are full.
+         */
+        [[nodiscard]] std::size_t chunkCount() const
+        {
+            return (size_ + chunkCapacity_ - 1) / chunkCapacity_;
+        }
+
+        /**
+         * @brief Rows stored in a chunk.
+         */
+        [[nodiscard]] std::uint32_t chunkSize(const std::size_t chunk) const
+        {
+            const std::size_t begin = chunk * chunkCapacity_;
+            return static_cast<std::uint32_t>(size_ - begin < chunkCapacity_ ? size_ - begin : chunkCapacity_);
+        }
+
+        /**
+         * @brief The entity ids of a chunk's rows.
+         */
+        [[nodiscard]] Entity* entities(const std::size_t chunk) const
+        {
+            return reinterpret_cast<Entity*>(chunks_[chunk]);
+        }
+
+        /**
+         * @brief Start of a component column inside a chunk.
+         */
+        [[nodiscard]] void* columnData(const std::size_t chunk, const std::size_t column) const
+        {
+            return chunks_[chunk] + columns_[column].offset;
+        }
+
+        /**
+         * @brief Address of one component of one row.
+         */
+        [[nodiscard]] void* component(const RowLocation location, const std::size_t column) const
+        {
+            return chunks_[location.chunk] + columns_[column].offset + (location.row * columns_[column].info.size);
+        }
+
+        /**
+         * @brief The number of rows.
+         */
+        [[nodiscard]] std::size_t size() const
+        {
+            return size_;
+        }
+
+        /**
+         * @brief Appends a row for `entity`, leaving its components uninitialized.
+         */
+        RowLocation allocate(Entity entity);
+
+        /**
+         * @brief Destroys the components of a row, leaving it to be removed with `swapRemove`.
+         */
+        void destroyRow(RowLocation location);
+
+        /**
+         * @brief Removes a row whose components were already destroyed or relocated away.
+         *
+         * @return The entity moved into the freed row, or an invalid entity if the last row was removed.
+         */
+        Entity swapRemove(RowLocation location);
+
+        /**
+         * @brief Cached archetype reached by adding `id`, or null when the edge was not built yet.
+         */
+        [[nodiscard]] Archetype* addTarget(ComponentId id) const;
+
+        /**
+         * @brief Cached archetype reached by removing `id`, or null when the edge was not built yet.
+         */
+        [[nodiscard]] Archetype* removeTarget(ComponentId id) const;
+
+        void setAddTarget(ComponentId id, Archetype* target);
+        void setRemoveTarget(ComponentId id, Archetype* target);
+
+        Archetype(const Archetype& other) = delete;
+        Archetype(Archetype&& other) noexcept = delete;
+        Archetype& operator=(const Archetype& other) = delete;
+        Archetype& operator=(Archetype&& other) noexcept = delete;
+
+    private:
+        [[nodiscard]] RowLocation locate(const std::size_t row) const
+        {
+            return {static_cast<std::uint32_t>(row / chunkCapacity_), static_cast<std::uint32_t>(row % chunkCapacity_)};
+        }
+
+        std::vector<ComponentId> signature_;
+        std::vector<Column> columns_;
+        std::vector<std::byte*> chunks_; // allocated chunks; may hold one spare beyond chunkCount()
+        std::uint32_t chunkCapacity_ = 0;
+        std::size_t size_ = 0;
+
+        std::unordered_map<ComponentId, Archetype*> addEdges_;
+        std::unordered_map<ComponentId, Archetype*> removeEdges_;
+    };
+}
+
+#endif //PSYGINE_ARCHETYPE_HPP
@@ -0,0 +1,84 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#include "command_buffer.hpp"
+
+#include <algorithm>
+#include <new>
+
+#include "psygine/debug/assert.hpp"
+
+namespace psygine::ecs
+{
+    CommandBuffer::~CommandBuffer()
+    {
+        clear();
+    }
+
+    CommandBuffer::CommandBuffer(CommandBuffer&& other) noexcept :
+        pending_{std::exchange(other.pending_, {})},
+        blocks_{std::exchange(other.blocks_, {})},
+        block_{std::exchange(other.block_, 0)},
+        used_{std::exchange(other.used_, 0)}
+    {}
+
+    CommandBuffer& CommandBuffer::operator=(CommandBuffer&& other) noexcept
+    {
+        if (this != &other)
+        {
+            clear();
+            pending_ = std::exchange(other.pending_, {});
+            blocks_ = std::exchange(other.blocks_, {});
+            block_ = std::exchange(other.block_, 0);
+            used_ = std::exchange(other.used_, 0);
+        }
+        return *this;
+    }
+
+    void CommandBuffer::clear()
+    {
+        for (const PendingOp& op : pending_)
+        {
+            if (op.payload != nullptr)
+            {
+                op.destroy(op.payload);
+            }
+        }
+        reset();
+    }
+
+    void CommandBuffer::BlockDeleter::operator()(std::byte* block) const
+    {
+        ::operator delete(block, std::align_val_t{BLOCK_ALIGNMENT});
+    }
+
+    void* CommandBuffer::allocate(const std::size_t size, const std::size_t alignment)
+    {
+        PSYGINE_DEBUG_ASSERT(alignment <= BLOCK_ALIGNMENT, "CommandBuffer: component alignment exceeds 64");
+        while (block_ < blocks_.size())
+        {
+            const std::size_t offset = detail::AlignUp(used_, alignment);
+            if (offset + size <= blocks_[block_].size)
+            {
+                used_ = offset + size;
+                return blocks_[block_].data.get() + offset;
+            }
+            ++block_;
+            used_ = 0;
+        }
+
+        Block block;
+        block.size = std::max(BLOCK_SIZE, detail::AlignUp(size, BLOCK_ALIGNMENT));
+        block.data.reset(static_cast<std::byte*>(::operator new(block.size, std::align_val_t{BLOCK_ALIGNMENT})));
+        blocks_.push_back(std::move(block));
+        used_ = size;
+        return blocks_.back().data.get();
+    }
+
+    void CommandBuffer::reset()
+    {
+        pending_.clear();
+        block_ = 0;
+        used_ = 0;
+    }
+}
@@ -0,0 +1,173 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#ifndef PSYGINE_COMMAND_BUFFER_HPP
+#define PSYGINE_COMMAND_BUFFER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "component.hpp"
+#include "entity.hpp"
+
+namespace psygine::ecs
+{
+    class World;
+
+    namespace detail
+    {
+        template <typename T, typename... Ts>
+        inline constexpr std::size_t COUNT_OF = (std::size_t{std::is_same_v<T, Ts>} + ... + 0);
+
+        /**
+         * @brief True when no type appears twice in `Ts`.
+         */
+        template <typename... Ts>
+        inline constexpr bool UNIQUE_TYPES = ((COUNT_OF<Ts, Ts...> == 1) && ...);
+    }
+
+    /**
+     * @brief Records structural changes to a `World` so they can be applied later, in order.
+     *
+     * Entities cannot be created, destroyed or change components while a query is iterating, because
+     * that would move rows under the iteration. Record the changes here instead and apply them with
+     * `World::apply` (or `World::flush` for the world's own buffer) once iteration is over, the same
+     * way `StateManager` queues stack changes in `pending_` and commits them between frames.
+     *
+     * Component values are moved into a block arena owned by the buffer and relocated into the world
+     * on apply, so a buffer that is reused every frame stops allocating once warmed up. Operations on
+     * entities that are gone by the time they are applied are skipped. A buffer is not thread-safe;
+     * give each thread its own.
+     */
+    class CommandBuffer
+    {
+    public:
+        CommandBuffer() = default;
+
+        /**
+         * @brief Destroys the component values of operations that were never applied.
+         */
+        ~CommandBuffer();
+
+        CommandBuffer(CommandBuffer&& other) noexcept;
+        CommandBuffer& operator=(CommandBuffer&& other) noexcept;
+
+        CommandBuffer(const CommandBuffer& other) = delete;
+        CommandBuffer& operator=(const CommandBuffer& other) = delete;
+
+        /**
+         * @brief Queues creating an entity with the given components.
+         */
+        template <Component... Ts>
+            requires detail::UNIQUE_TYPES<Ts...>
+        void spawn(Ts... components)
+        {
+            pending_.push_back(PendingOp{
+                .kind = OpKind::Spawn, .entity = Entity{}, .component = 0, .payload = nullptr, .destroy = nullptr,
+                .count = static_cast<std::uint32_t>(sizeof...(Ts))
+            });
+            (pushComponent(OpKind::Add, Entity{}, std::move(components)), ...);
+        }
+
+        /**
+         * @brief Queues destroying an entity.
+         */
+        void destroy(Entity entity)
+        {
+            pending_.push_back(PendingOp{.kind = OpKind::Destroy, .entity = entity, .component = 0, .payload = nullptr});
+        }
+
+        /**
+         * @brief Queues adding a component, or replacing its value if the entity already has one.
+         */
+        template <Component T, typename... Args>
+            requires std::constructible_from<T, Args&&...>
+        void add(Entity entity, Args&&... args)
+        {
+            pushComponent(OpKind::Add, entity, T(std::forward<Args>(args)...));
+        }
+
+        /**
+         * @brief Queues removing a component; nothing happens if the entity does not have it.
+         */
+        template <Component T>
+        void remove(Entity entity)
+        {
+            pending_.push_back(PendingOp{.kind = OpKind::Remove, .entity = entity, .component = ComponentIdOf<T>()});
+        }
+
+        /**
+         * @brief Drops every queued operation, destroying the component values held for them.
+         */
+        void clear();
+
+        [[nodiscard]] bool empty() const
+        {
+            return pending_.empty();
+        }
+
+        /**
+         * @brief The number of queued operations; a spawn counts once per component plus one.
+         */
+        [[nodiscard]] std::size_t size() const
+        {
+            return pending_.size();
+        }
+
+    private:
+        friend class World;
+
+        static constexpr std::size_t BLOCK_SIZE = 16 * 1024;
+        static constexpr std::size_t BLOCK_ALIGNMENT = 64;
+
+        enum class OpKind : std::uint8_t { Spawn, Destroy, Add, Remove };
+
+        struct PendingOp
+        {
+            OpKind kind = OpKind::Destroy;
+            Entity entity;
+            ComponentId component = 0;
+            void* payload = nullptr; // component value for Add, owned until applied
+            void (*destroy)(void* object) noexcept = nullptr;
+            std::uint32_t count = 0; // for Spawn: the number of Add entries that follow
+        };
+
+        struct BlockDeleter
+        {
+            void operator()(std::byte* block) const;
+        };
+
+        struct Block
+        {
+            std::unique_ptr<std::byte, BlockDeleter> data;
+            std::size_t size = 0;
+        };
+
+        template <Component T>
+        void pushComponent(const OpKind kind, const Entity entity, T&& value)
+        {
+            void* payload = allocate(sizeof(T), alignof(T));
+            std::construct_at(static_cast<T*>(payload), std::move(value));
+            pending_.push_back(PendingOp{
+                .kind = kind, .entity = entity, .component = ComponentIdOf<T>(), .payload = payload,
+                .destroy = detail::MakeComponentInfo<T>().destroy
+            });
+        }
+
+        [[nodiscard]] void* allocate(std::size_t size, std::size_t alignment);
+
+        // Forgets the queued operations once World::apply has consumed their values.
+        void reset();
+
+        std::vector<PendingOp> pending_;
+        std::vector<Block> blocks_;
+        std::size_t block_ = 0; // block currently bumped from
+        std::size_t used_ = 0;  // bytes used in that block
+    };
+}
+
+#endif //PSYGINE_COMMAND_BUFFER_HPP
@@ -0,0 +1,43 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#include "component.hpp"
+
+#include <mutex>
+#include <vector>
+
+#include "psygine/debug/assert.hpp"
+
+namespace
+{
+    struct Registry
+    {
+        std::mutex mutex;
+        std::vector<psygine::ecs::ComponentInfo> infos;
+    };
+
+    Registry& GetRegistry()
+    {
+        static Registry registry;
+        return registry;
+    }
+}
+
+namespace psygine::ecs::detail
+{
+    ComponentId RegisterComponent(const ComponentInfo& info)
+    {
+        Registry& registry = GetRegistry();
+        std::scoped_lock lock(registry.mutex);
+        registry.infos.push_back(info);
+        return static_cast<ComponentId>(registry.infos.size() - 1);
+    }
+
+    ComponentInfo GetComponentInfo(const ComponentId id)
+    {
+        Registry& registry = GetRegistry();
+        std::scoped_lock lock(registry.mutex);
+        PSYGINE_ASSERT(id < registry.infos.size(), "GetComponentInfo: unknown component id");
+        return registry.infos[id];
+    }
+}
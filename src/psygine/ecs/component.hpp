@@ -0,0 +1,134 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#ifndef PSYGINE_COMPONENT_HPP
+#define PSYGINE_COMPONENT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace psygine::ecs
+{
+    /**
+     * @brief Process-wide id of a component type, assigned on first use of `ComponentIdOf`.
+     */
+    using ComponentId = std::uint32_t;
+
+    /**
+     * @brief How to store and move a component type without knowing it statically.
+     */
+    struct ComponentInfo
+    {
+        std::size_t size = 0;
+        std::size_t alignment = 1;
+        // Move-constructs the object at `destination` from `source`, then destroys `source`.
+        void (*relocate)(void* destination, void* source) noexcept = nullptr;
+        void (*destroy)(void* object) noexcept = nullptr;
+        // True when relocating is a plain copy and destroying does nothing.
+        bool trivial = false;
+    };
+
+    /**
+     * @brief Requirements on component types: plain objects that can be moved without throwing.
+     *
+     * Components are relocated between chunks as entities change archetype, so the move constructor
+     * must not throw.
+     */
+    template <typename T>
+    concept Component = std::is_object_v<T> && !std::is_const_v<T> && !std::is_array_v<T> &&
+                        std::is_nothrow_move_constructible_v<T> && std::is_nothrow_destructible_v<T>;
+
+    namespace detail
+    {
+        /**
+         * @brief Rounds `value` up to a multiple of `alignment`, which must be a power of two.
+         */
+        constexpr std::size_t AlignUp(const std::size_t value, const std::size_t alignment)
+        {
+            return (value + alignment - 1) & ~(alignment - 1);
+        }
+
+        /**
+         * @brief Registers a component type and returns its id. Thread-safe.
+         */
+        [[nodiscard]] ComponentId RegisterComponent(const ComponentInfo& info);
+
+        /**
+         * @brief Looks up the storage description of a registered component. Thread-safe.
+         */
+        [[nodiscard]] ComponentInfo GetComponentInfo(ComponentId id);
+
+        template <Component T>
+        ComponentInfo MakeComponentInfo()
+        {
+            ComponentInfo info;
+            info.size = sizeof(T);
+            info.alignment = alignof(T);
+            info.trivial = std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>;
+            info.relocate = [](void* destination, void* source) noexcept
+            {
+                T* from = static_cast<T*>(source);
+                std::construct_at(static_cast<T*>(destination), std::move(*from));
+                std::destroy_at(from);
+            };
+            info.destroy = [](void* object) noexcept
+            {
+                std::destroy_at(static_cast<T*>(object));
+            };
+            return info;
+        }
+
+        /**
+         * @brief Relocates one component, taking the `memcpy` path for trivial types.
+         */
+        inline void Relocate(const ComponentInfo& info, void* destination, void* source) noexcept
+        {
+            if (info.trivial)
+            {
+                std::memcpy(destination, source, info.size);
+            }
+            else
+            {
+                info.relocate(destination, source);
+            }
+        }
+
+        /**
+         * @brief Destroys one component, skipping the call for trivial types.
+         */
+        inline void Destroy(const ComponentInfo& info, void* object) noexcept
+        {
+            if (!info.trivial)
+            {
+                info.destroy(object);
+            }
+        }
+    }
+
+    /**
+     * @brief The id of component type `T`; const and non-const `T` share it.
+     *
+     * The first call for a type registers it, later calls only cost the check of a function-local static.
+     */
+    template <typename T>
+        requires Component<std::remove_const_t<T>>
+    ComponentId ComponentIdOf()
+    {
+        if constexpr (std::is_const_v<T>)
+        {
+            return ComponentIdOf<std::remove_const_t<T>>();
+        }
+        else
+        {
+            static const ComponentId id = detail::RegisterComponent(detail::MakeComponentInfo<T>());
+            return id;
+        }
+    }
+}
+
+#endif //PSYGINE_COMPONENT_HPP
@@ -0,0 +1,34 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#ifndef PSYGINE_ENTITY_HPP
+#define PSYGINE_ENTITY_HPP
+
+#include <cstdint>
+#include <limits>
+
+namespace psygine::ecs
+{
+    /**
+     * @brief Identifies an entity in a `World`.
+     *
+     * Handles stay safe to use after the entity is destroyed: the slot's generation changes when it is
+     * reused, so a stale handle simply reports the entity as gone.
+     */
+    struct Entity
+    {
+        static constexpr std::uint32_t INVALID_INDEX = std::numeric_limits<std::uint32_t>::max();
+
+        std::uint32_t index = INVALID_INDEX;
+        std::uint32_t generation = 0;
+
+        [[nodiscard]] bool valid() const
+        {
+            return index != INVALID_INDEX;
+        }
+
+        bool operator==(const Entity&) const = default;
+    };
+}
+
+#endif //PSYGINE_ENTITY_HPP
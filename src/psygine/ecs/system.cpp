@@ -0,0 +1,159 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#include "system.hpp"
+
+#include <algorithm>
+
+#include "psygine/debug/assert.hpp"
+
+namespace
+{
+    bool Intersects(const std::vector<psygine::ecs::ComponentId>& a, const std::vector<psygine::ecs::ComponentId>& b)
+    {
+        return std::ranges::any_of(a, [&b](const psygine::ecs::ComponentId id)
+        {
+            return std::ranges::find(b, id) != b.end();
+        });
+    }
+}
+
+namespace psygine::ecs
+{
+    bool Access::conflictsWith(const Access& other) const
+    {
+        return Intersects(writes, other.writes) || Intersects(writes, other.reads) || Intersects(reads, other.writes);
+    }
+
+    std::size_t SystemContext::reserveChunkCommands(const std::size_t count)
+    {
+        const std::size_t first = usedChunkCommands_;
+        usedChunkCommands_ += count;
+        if (chunkCommands_.size() < usedChunkCommands_)
+        {
+            chunkCommands_.resize(usedChunkCommands_);
+        }
+        return first;
+    }
+
+    void SystemContext::applyCommands(World& world)
+    {
+        world.apply(commands_);
+        for (std::size_t i = 0; i < usedChunkCommands_; ++i)
+        {
+            world.apply(chunkCommands_[i]);
+        }
+        usedChunkCommands_ = 0;
+    }
+
+    void SystemScheduler::addExclusive(std::string name, ExclusiveFunction fn)
+    {
+        auto system = std::make_unique<System>();
+        system->name = std::move(name);
+        system->exclusive = true;
+        system->runExclusive = std::move(fn);
+        systems_.push_back(std::move(system));
+        dirty_ = true;
+    }
+
+    void SystemScheduler::run(World& world, const double deltaTime, core::ThreadPool* pool)
+    {
+        PSYGINE_ASSERT(!world.iterating(), "SystemScheduler::run: world is being iterated");
+        if (dirty_)
+        {
+            rebuild();
+        }
+
+        // Systems before this index have had their command buffers applied.
+        std::size_t applied = 0;
+        const auto applyUpTo = [&](const std::size_t end)
+        {
+            for (; applied < end; ++applied)
+            {
+                systems_[applied]->context.applyCommands(world);
+            }
+        };
+
+        for (const std::vector<std::size_t>& stage : stages_)
+        {
+            System& first = *systems_[stage.front()];
+            if (first.exclusive)
+            {
+                // Every earlier system sits in an earlier stage, so their changes can land now.
+                applyUpTo(stage.front());
+                first.runExclusive(world, deltaTime);
+                applied = stage.front() + 1;
+                continue;
+            }
+
+            for (const std::size_t index : stage)
+            {
+                System& system = *systems_[index];
+                system.prepare(world);
+                system.context.world_ = &world;
+                system.context.pool_ = pool;
+                system.context.deltaTime_ = deltaTime;
+            }
+
+            const auto body = [&](const std::size_t begin, const std::size_t end)
+            {
+                for (std::size_t i = begin; i < end; ++i)
+                {
+                    System& system = *systems_[stage[i]];
+                    system.run(system.context);
+                }
+            };
+            if (pool == nullptr || stage.size() == 1)
+            {
+                body(0, stage.size());
+            }
+            else
+            {
+                pool->parallelFor(stage.size(), 1, body);
+            }
+        }
+
+        applyUpTo(systems_.size());
+    }
+
+    const std::vector<std::vector<std::size_t>>& SystemScheduler::stages()
+    {
+        if (dirty_)
+        {
+            rebuild();
+        }
+        return stages_;
+    }
+
+    const std::string& SystemScheduler::name(const std::size_t index) const
+    {
+        PSYGINE_DEBUG_ASSERT(index < systems_.size(), "SystemScheduler::name: index out of range");
+        return systems_[index]->name;
+    }
+
+    void SystemScheduler::rebuild()
+    {
+        stages_.clear();
+        std::vector<std::size_t> stageOf(systems_.size(), 0);
+        for (std::size_t i = 0; i < systems_.size(); ++i)
+        {
+            const System& system = *systems_[i];
+            std::size_t stage = 0;
+            for (std::size_t j = 0; j < i; ++j)
+            {
+                const System& earlier = *systems_[j];
+                if (system.exclusive || earlier.exclusive || system.access.conflictsWith(earlier.access))
+                {
+                    stage = std::max(stage, stageOf[j] + 1);
+                }
+            }
+            stageOf[i] = stage;
+            if (stage == stages_.size())
+            {
+                stages_.emplace_back();
+            }
+            stages_[stage].push_back(i);
+        }
+        dirty_ = false;
+    }
+}
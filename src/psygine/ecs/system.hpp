@@ -0,0 +1,268 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#ifndef PSYGINE_SYSTEM_HPP
+#define PSYGINE_SYSTEM_HPP
+
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "command_buffer.hpp"
+#include "component.hpp"
+#include "world.hpp"
+#include "psygine/core/thread_pool.hpp"
+
+namespace psygine::ecs
+{
+    /**
+     * @brief The components a system reads and writes.
+     *
+     * Two systems conflict when one writes a component the other reads or writes; conflicting systems
+     * never run at the same time.
+     */
+    struct Access
+    {
+        std::vector<ComponentId> reads;
+        std::vector<ComponentId> writes;
+
+        template <Component T>
+        Access& read()
+        {
+            reads.push_back(ComponentIdOf<T>());
+            return *this;
+        }
+
+        template <Component T>
+        Access& write()
+        {
+            writes.push_back(ComponentIdOf<T>());
+            return *this;
+        }
+
+        [[nodiscard]] bool conflictsWith(const Access& other) const;
+    };
+
+    /**
+     * @brief What a system sees while it runs: the world, the frame's time step and its command buffers.
+     *
+     * Structural changes must go through `commands()` or the per-chunk buffers handed to
+     * `forEachChunk` callbacks, never through `World` directly, because other systems may be iterating.
+     */
+    class SystemContext
+    {
+    public:
+        [[nodiscard]] World& world() const
+        {
+            return *world_;
+        }
+
+        [[nodiscard]] double deltaTime() const
+        {
+            return deltaTime_;
+        }
+
+        /**
+         * @brief The pool the scheduler runs on, or null when running inline.
+         */
+        [[nodiscard]] core::ThreadPool* pool() const
+        {
+            return pool_;
+        }
+
+        /**
+         * @brief Buffer for structural changes made outside of per-chunk callbacks.
+         */
+        [[nodiscard]] CommandBuffer& commands()
+        {
+            return commands_;
+        }
+
+        /**
+         * @brief Runs `fn(view)` or `fn(view, commands)` for every chunk matching the query, split across
+         * the pool one chunk per task.
+         *
+         * Each chunk gets its own command buffer, and the buffers are applied in chunk order after the
+         * system's `commands()`, so the result does not depend on which thread ran which chunk.
+         */
+        template <typename... Ts, typename Fn>
+            requires std::invocable<Fn&, const ChunkView<Ts...>&> ||
+                     std::invocable<Fn&, const ChunkView<Ts...>&, CommandBuffer&>
+        void forEachChunk(Query<Ts...>& query, Fn&& fn)
+        {
+            using View = ChunkView<Ts...>;
+            constexpr bool withCommands = std::invocable<Fn&, const View&, CommandBuffer&>;
+
+            std::vector<View> views;
+            query.gatherChunks(views);
+            const std::size_t first = withCommands ? reserveChunkCommands(views.size()) : 0;
+
+            World::IterationScope scope(*world_);
+            const auto body = [&](const std::size_t begin, const std::size_t end)
+            {
+                for (std::size_t i = begin; i < end; ++i)
+                {
+                    if constexpr (withCommands)
+                    {
+                        std::invoke(fn, views[i], chunkCommands_[first + i]);
+                    }
+                    else
+                    {
+                        std::invoke(fn, views[i]);
+                    }
+                }
+            };
+
+            if (pool_ == nullptr)
+            {
+                body(0, views.size());
+                return;
+            }
+            pool_->parallelFor(views.size(), 1, body);
+        }
+
+        /**
+         * @brief Runs `fn(components...)` or `fn(entity, components...)` for every matching entity,
+         * split across the pool by chunk.
+         */
+        template <typename... Ts, typename Fn>
+            requires std::invocable<Fn&, Ts&...> || std::invocable<Fn&, Entity, Ts&...>
+        void forEach(Query<Ts...>& query, Fn&& fn)
+        {
+            forEachChunk(query, [&fn](const ChunkView<Ts...>& view)
+            {
+                view.each(fn);
+            });
+        }
+
+    private:
+        friend class SystemScheduler;
+
+        // Hands out `count` consecutive chunk buffers for one forEachChunk call.
+        std::size_t reserveChunkCommands(std::size_t count);
+
+        // Applies and empties the system's buffers: commands() first, then the chunk buffers in order.
+        void applyCommands(World& world);
+
+        World* world_ = nullptr;
+        core::ThreadPool* pool_ = nullptr;
+        double deltaTime_ = 0.0;
+
+        CommandBuffer commands_;
+        std::vector<CommandBuffer> chunkCommands_;
+        std::size_t usedChunkCommands_ = 0;
+    };
+
+    /**
+     * @brief Runs ECS systems in registration order semantics, in parallel where their access allows.
+     *
+     * Systems are grouped into stages: each system lands in the first stage after every earlier-added
+     * system it conflicts with, so non-conflicting systems share a stage and run concurrently on the
+     * pool while the result matches running them one by one in the order they were added. Inside a
+     * system, `SystemContext::forEach` and `forEachChunk` split the query across the pool as well.
+     *
+     * Command buffers are applied after the last stage, in the order the systems were added and, within
+     * a system, in chunk order, so structural changes come out the same for any number of threads.
+     * Exclusive systems act as barriers: buffers of earlier systems are applied first, and the
+     * exclusive system runs alone with full access to the world.
+     *
+     * Call `run` from `onFixedUpdate` to advance a simulation by one step.
+     */
+    class SystemScheduler
+    {
+    public:
+        using ExclusiveFunction = std::function<void(World& world, double deltaTime)>;
+
+        SystemScheduler() = default;
+
+        /**
+         * @brief Adds a system iterating `Query<Ts...>`; `const` components are read, others written.
+         *
+         * @param name A name for diagnostics.
+         * @param fn Called as `fn(context, query)` once per run.
+         * @param extra Components the system touches outside its query, for example through `World::get`.
+         */
+        template <typename... Ts, typename Fn>
+            requires std::invocable<Fn&, SystemContext&, Query<Ts...>&>
+        void add(std::string name, Fn&& fn, Access extra = {})
+        {
+            (((std::is_const_v<Ts> ? extra.reads : extra.writes).push_back(ComponentIdOf<Ts>())), ...);
+
+            struct Bound
+            {
+                std::decay_t<Fn> fn;
+                Query<Ts...>* query = nullptr;
+            };
+            auto bound = std::make_shared<Bound>(Bound{std::forward<Fn>(fn)});
+
+            auto system = std::make_unique<System>();
+            system->name = std::move(name);
+            system->access = std::move(extra);
+            system->prepare = [bound](World& world)
+            {
+                bound->query = &world.query<Ts...>();
+                bound->query->refresh();
+            };
+            system->run = [bound](SystemContext& context)
+            {
+                std::invoke(bound->fn, context, *bound->query);
+            };
+            systems_.push_back(std::move(system));
+            dirty_ = true;
+        }
+
+        /**
+         * @brief Adds a system that runs alone and may change the world directly.
+         */
+        void addExclusive(std::string name, ExclusiveFunction fn);
+
+        /**
+         * @brief Runs every system once.
+         *
+         * @param world The world to update.
+         * @param deltaTime Passed on to the systems.
+         * @param pool Pool to run on; null runs everything on the calling thread, with the same result.
+         */
+        void run(World& world, double deltaTime, core::ThreadPool* pool = nullptr);
+
+        /**
+         * @brief The system indices of each stage, in execution order.
+         */
+        [[nodiscard]] const std::vector<std::vector<std::size_t>>& stages();
+
+        /**
+         * @brief The name a system was added with, by index.
+         */
+        [[nodiscard]] const std::string& name(std::size_t index) const;
+
+        [[nodiscard]] std::size_t size() const
+        {
+            return systems_.size();
+        }
+
+    private:
+        struct System
+        {
+            std::string name;
+            Access access;
+            bool exclusive = false;
+            std::function<void(World&)> prepare;
+            std::function<void(SystemContext&)> run;
+            ExclusiveFunction runExclusive;
+            SystemContext context;
+        };
+
+        void rebuild();
+
+        std::vector<std::unique_ptr<System>> systems_;
+        std::vector<std::vector<std::size_t>> stages_;
+        bool dirty_ = false;
+    };
+}
+
+#endif //PSYGINE_SYSTEM_HPP
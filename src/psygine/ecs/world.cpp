@@ -0,0 +1,290 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#include "world.hpp"
+
+#include <atomic>
+#include <iterator>
+
+namespace psygine::ecs
+{
+    namespace detail
+    {
+        std::size_t NextQuerySlot()
+        {
+            static std::atomic<std::size_t> next{0};
+            return next.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    World::World()
+    {
+        root_ = archetypeFor({});
+    }
+
+    World::~World() = default;
+
+    Entity World::create()
+    {
+        PSYGINE_DEBUG_ASSERT(!iterating(), "World::create: use a CommandBuffer while a query iterates");
+        return allocate(root_);
+    }
+
+    void World::destroy(const Entity entity)
+    {
+        PSYGINE_DEBUG_ASSERT(!iterating(), "World::destroy: use a CommandBuffer while a query iterates");
+        if (!alive(entity))
+        {
+            return;
+        }
+
+        EntityRecord& entry = records_[entity.index];
+        entry.archetype->destroyRow(entry.location);
+        if (const Entity moved = entry.archetype->swapRemove(entry.location); moved.valid())
+        {
+            records_[moved.index].location = entry.location;
+        }
+
+        ++entry.generation;
+        entry.archetype = nullptr;
+        entry.nextFree = freeHead_;
+        freeHead_ = entity.index;
+        --size_;
+    }
+
+    bool World::alive(const Entity entity) const
+    {
+        return record(entity) != nullptr;
+    }
+
+    void World::apply(CommandBuffer& buffer)
+    {
+        PSYGINE_DEBUG_ASSERT(!iterating(), "World::apply: cannot apply commands while a query iterates");
+
+        using OpKind = CommandBuffer::OpKind;
+        std::vector<CommandBuffer::PendingOp>& pending = buffer.pending_;
+        std::vector<ComponentId> signature;
+        for (std::size_t i = 0; i < pending.size(); ++i)
+        {
+            CommandBuffer::PendingOp& op = pending[i];
+            switch (op.kind)
+            {
+                case OpKind::Spawn:
+                {
+                    const std::span<CommandBuffer::PendingOp> components(pending.data() + i + 1, op.count);
+                    signature.clear();
+                    for (const CommandBuffer::PendingOp& component : components)
+                    {
+                        signature.push_back(component.component);
+                    }
+                    std::ranges::sort(signature);
+
+                    Archetype* archetype = archetypeFor(signature);
+                    const RowLocation location = records_[allocate(archetype).index].location;
+                    for (CommandBuffer::PendingOp& component : components)
+                    {
+                        const std::size_t column = archetype->columnIndex(component.component);
+                        detail::Relocate(archetype->column(column).info, archetype->component(location, column),
+                                         component.payload);
+                        component.payload = nullptr;
+                    }
+                    i += op.count;
+                }
+                break;
+                case OpKind::Destroy:
+                    destroy(op.entity);
+                    break;
+                case OpKind::Add:
+                {
+                    if (alive(op.entity))
+                    {
+                        void* storage = emplace(op.entity, op.component);
+                        const EntityRecord& entry = records_[op.entity.index];
+                        const Archetype::Column& column =
+                            entry.archetype->column(entry.archetype->columnIndex(op.component));
+                        detail::Relocate(column.info, storage, op.payload);
+                    }
+                    else
+                    {
+                        op.destroy(op.payload);
+                    }
+                    op.payload = nullptr;
+                }
+                break;
+                case OpKind::Remove:
+                    erase(op.entity, op.component);
+                    break;
+            }
+        }
+        buffer.reset();
+    }
+
+    std::size_t World::SignatureHash::operator()(const std::span<const ComponentId> signature) const
+    {
+        // FNV-1a over the ids; signatures are short, so this is cheaper than anything fancier.
+        std::size_t hash = 14695981039346656037ULL;
+        for (const ComponentId id : signature)
+        {
+            hash = (hash ^ id) * 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    const World::EntityRecord* World::record(const Entity entity) const
+    {
+        if (entity.index >= records_.size())
+        {
+            return nullptr;
+        }
+        const EntityRecord& entry = records_[entity.index];
+        if (entry.archetype == nullptr || entry.generation != entity.generation)
+        {
+            return nullptr;
+        }
+        return &entry;
+    }
+
+    void* World::find(const Entity entity, const ComponentId id) const
+    {
+        const EntityRecord* entry = record(entity);
+        if (entry == nullptr)
+        {
+            return nullptr;
+        }
+        const std::size_t column = entry->archetype->columnIndex(id);
+        if (column == Archetype::NPOS)
+        {
+            return nullptr;
+        }
+        return entry->archetype->component(entry->location, column);
+    }
+
+    void* World::emplace(const Entity entity, const ComponentId id)
+    {
+        PSYGINE_DEBUG_ASSERT(!iterating(), "World::add: use a CommandBuffer while a query iterates");
+        PSYGINE_ASSERT(alive(entity), "World::add: entity is not alive");
+
+        EntityRecord& entry = records_[entity.index];
+        if (const std::size_t column = entry.archetype->columnIndex(id); column != Archetype::NPOS)
+        {
+            void* existing = entry.archetype->component(entry.location, column);
+            detail::Destroy(entry.archetype->column(column).info, existing);
+            return existing;
+        }
+
+        move(entry, addTarget(entry.archetype, id));
+        return entry.archetype->component(entry.location, entry.archetype->columnIndex(id));
+    }
+
+    void World::erase(const Entity entity, const ComponentId id)
+    {
+        PSYGINE_DEBUG_ASSERT(!iterating(), "World::remove: use a CommandBuffer while a query iterates");
+        if (!alive(entity))
+        {
+            return;
+        }
+
+        EntityRecord& entry = records_[entity.index];
+        if (entry.archetype->columnIndex(id) != Archetype::NPOS)
+        {
+            move(entry, removeTarget(entry.archetype, id));
+        }
+    }
+
+    Entity World::allocate(Archetype* archetype)
+    {
+        std::uint32_t index = freeHead_;
+        if (index != NIL)
+        {
+            freeHead_ = records_[index].nextFree;
+        }
+        else
+        {
+            index = static_cast<std::uint32_t>(records_.size());
+            records_.emplace_back();
+        }
+
+        EntityRecord& entry = records_[index];
+        const Entity entity{index, entry.generation};
+        entry.archetype = archetype;
+        entry.location = archetype->allocate(entity);
+        entry.nextFree = NIL;
+        ++size_;
+        return entity;
+    }
+
+    void World::move(EntityRecord& record, Archetype* target)
+    {
+        Archetype* source = record.archetype;
+        const RowLocation from = record.location;
+        const RowLocation to = target->allocate(source->entities(from.chunk)[from.row]);
+
+        // Components shared by both archetypes are relocated; ones the target lacks are destroyed.
+        for (std::size_t column = 0; column < source->columnCount(); ++column)
+        {
+            const Archetype::Column& sourceColumn = source->column(column);
+            void* value = source->component(from, column);
+            if (const std::size_t targetColumn = target->columnIndex(sourceColumn.id); targetColumn != Archetype::NPOS)
+            {
+                detail::Relocate(sourceColumn.info, target->component(to, targetColumn), value);
+            }
+            else
+            {
+                detail::Destroy(sourceColumn.info, value);
+            }
+        }
+
+        if (const Entity moved = source->swapRemove(from); moved.valid())
+        {
+            records_[moved.index].location = from;
+        }
+        record.archetype = target;
+        record.location = to;
+    }
+
+    Archetype* World::archetypeFor(const std::span<const ComponentId> signature)
+    {
+        if (const auto it = archetypeLookup_.find(signature); it != archetypeLookup_.end())
+        {
+            return it->second;
+        }
+
+        std::vector<ComponentId> key(signature.begin(), signature.end());
+        archetypes_.push_back(std::make_unique<Archetype>(key));
+        Archetype* archetype = archetypes_.back().get();
+        archetypeLookup_.emplace(std::move(key), archetype);
+        return archetype;
+    }
+
+    Archetype* World::addTarget(Archetype* source, const ComponentId id)
+    {
+        if (Archetype* cached = source->addTarget(id))
+        {
+            return cached;
+        }
+
+        const std::span<const ComponentId> signature = source->signature();
+        std::vector<ComponentId> extended(signature.begin(), signature.end());
+        extended.insert(std::ranges::upper_bound(extended, id), id);
+        Archetype* target = archetypeFor(extended);
+        source->setAddTarget(id, target);
+        target->setRemoveTarget(id, source);
+        return target;
+    }
+
+    Archetype* World::removeTarget(Archetype* source, const ComponentId id)
+    {
+        if (Archetype* cached = source->removeTarget(id))
+        {
+            return cached;
+        }
+
+        std::vector<ComponentId> reduced;
+        reduced.reserve(source->signature().size());
+        std::ranges::remove_copy(source->signature(), std::back_inserter(reduced), id);
+        Archetype* target = archetypeFor(reduced);
+        source->setRemoveTarget(id, target);
+        target->setAddTarget(id, source);
+        return target;
+    }
+}
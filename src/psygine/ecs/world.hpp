@@ -0,0 +1,558 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#ifndef PSYGINE_WORLD_HPP
+#define PSYGINE_WORLD_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "archetype.hpp"
+#include "command_buffer.hpp"
+#include "component.hpp"
+#include "entity.hpp"
+#include "psygine/debug/assert.hpp"
+
+namespace psygine::ecs
+{
+    class World;
+
+    namespace detail
+    {
+        /**
+         * @brief Index of the first occurrence of `T` in `Ts`.
+         */
+        template <typename T, typename... Ts>
+        consteval std::size_t IndexOf()
+        {
+            constexpr std::array<bool, sizeof...(Ts)> matches{std::is_same_v<T, Ts>...};
+            for (std::size_t i = 0; i < matches.size(); ++i)
+            {
+                if (matches[i])
+                {
+                    return i;
+                }
+            }
+            return matches.size();
+        }
+
+        /**
+         * @brief Hands out the slot each query type occupies in every world's query cache.
+         */
+        [[nodiscard]] std::size_t NextQuerySlot();
+
+        template <typename Q>
+        std::size_t QuerySlot()
+        {
+            static const std::size_t slot = NextQuerySlot();
+            return slot;
+        }
+
+        class QueryBase
+        {
+        public:
+            virtual ~QueryBase() = default;
+        };
+    }
+
+    /**
+     * @brief One chunk's worth of a query's components, as parallel arrays.
+     *
+     * @tparam Ts The query's component types; `const` ones are exposed read-only.
+     */
+    template <typename... Ts>
+    class ChunkView
+    {
+    public:
+        ChunkView(const Entity* entities, const std::size_t size, std::tuple<Ts*...> columns) :
+            entities_{entities},
+            size_{size},
+            columns_{columns}
+        {}
+
+        [[nodiscard]] std::size_t size() const
+        {
+            return size_;
+        }
+
+        [[nodiscard]] std::span<const Entity> entities() const
+        {
+            return {entities_, size_};
+        }
+
+        /**
+         * @brief The column of component `T`, spelled as in the query (including `const`).
+         */
+        template <typename T>
+            requires (detail::IndexOf<T, Ts...>() < sizeof...(Ts))
+        [[nodiscard]] std::span<T> get() const
+        {
+            return {std::get<detail::IndexOf<T, Ts...>()>(columns_), size_};
+        }
+
+        /**
+         * @brief Calls `fn(components...)` or `fn(entity, components...)` for every row of the chunk.
+         */
+        template <typename Fn>
+            requires std::invocable<Fn&, Ts&...> || std::invocable<Fn&, Entity, Ts&...>
+        void each(Fn& fn) const
+        {
+            std::apply([&](Ts*... columns)
+            {
+                for (std::size_t row = 0; row < size_; ++row)
+                {
+                    if constexpr (std::invocable<Fn&, Entity, Ts&...>)
+                    {
+                        std::invoke(fn, entities_[row], columns[row]...);
+                    }
+                    else
+                    {
+                        std::invoke(fn, columns[row]...);
+                    }
+                }
+            }, columns_);
+        }
+
+        /**
+         * @brief All columns as raw pointers, in query order.
+         */
+        [[nodiscard]] const std::tuple<Ts*...>& columns() const
+        {
+            return columns_;
+        }
+
+    private:
+        const Entity* entities_;
+        std::size_t size_;
+        std::tuple<Ts*...> columns_;
+    };
+
+    template <typename... Ts>
+        requires (sizeof...(Ts) > 0) && (Component<std::remove_const_t<Ts>> && ...) &&
+                 detail::UNIQUE_TYPES<std::remove_const_t<Ts>...>
+    class Query;
+
+    /**
+     * @brief Owns entities and their components, stored by archetype.
+     *
+     * Each distinct set of components gets an `Archetype` table. Adding or removing a component moves
+     * the entity's row to the neighbouring table, found in O(1) through the edges cached on each
+     * archetype, and queries walk the matching tables chunk by chunk.
+     *
+     * Structural changes (creating and destroying entities, adding and removing components) are not
+     * allowed while a query iterates; record them in `commands()` or another `CommandBuffer` and apply
+     * them afterwards with `flush` or `apply`. Reading and writing component values is always allowed.
+     * Structural changes and `query` are single-threaded; iterating queries may happen on several
+     * threads at once as long as they touch different components or chunks, which `SystemScheduler`
+     * arranges.
+     */
+    class World
+    {
+    public:
+        World();
+        ~World();
+
+        /**
+         * @brief Creates an entity without components.
+         */
+        Entity create();
+
+        /**
+         * @brief Creates an entity directly in the archetype of the given components.
+         *
+         * Cheaper than `create` followed by `add`, which would move the entity once per component.
+         */
+        template <Component... Ts>
+            requires detail::UNIQUE_TYPES<Ts...>
+        Entity spawn(Ts... components)
+        {
+            static const std::array<ComponentId, sizeof...(Ts)> signature = []
+            {
+                std::array<ComponentId, sizeof...(Ts)> ids{ComponentIdOf<Ts>()...};
+                std::ranges::sort(ids);
+                return ids;
+            }();
+            Archetype* archetype = archetypeFor(signature);
+            const Entity entity = allocate(archetype);
+            const RowLocation location = records_[entity.index].location;
+            (std::construct_at(static_cast<Ts*>(archetype->component(
+                 location, archetype->columnIndex(ComponentIdOf<Ts>()))), std::move(components)), ...);
+            return entity;
+        }
+
+        /**
+         * @brief Destroys an entity and its components.
+         */
+        void destroy(Entity entity);
+
+        /**
+         * @brief Checks whether an entity has been created and not destroyed.
+         */
+        [[nodiscard]] bool alive(Entity entity) const;
+
+        /**
+         * @brief Adds a component, or replaces its value if the entity already has one.
+         *
+         * @return The stored component; the reference is invalidated by the next structural change.
+         */
+        template <Component T, typename... Args>
+            requires std::constructible_from<T, Args&&...>
+        T& add(const Entity entity, Args&&... args)
+        {
+            if constexpr (std::is_nothrow_constructible_v<T, Args&&...>)
+            {
+                return *std::construct_at(static_cast<T*>(emplace(entity, ComponentIdOf<T>())),
+                                          std::forward<Args>(args)...);
+            }
+            else
+            {
+                T value(std::forward<Args>(args)...);
+                return *std::construct_at(static_cast<T*>(emplace(entity, ComponentIdOf<T>())), std::move(value));
+            }
+        }
+
+        /**
+         * @brief Removes a component; nothing happens if the entity does not have it.
+         */
+        template <Component T>
+        void remove(const Entity entity)
+        {
+            erase(entity, ComponentIdOf<T>());
+        }
+
+        template <Component T>
+        [[nodiscard]] bool has(const Entity entity) const
+        {
+            return find(entity, ComponentIdOf<T>()) != nullptr;
+        }
+
+        /**
+         * @brief The entity's component, or null when it does not have one.
+         */
+        template <Component T>
+        [[nodiscard]] T* tryGet(const Entity entity)
+        {
+            return static_cast<T*>(find(entity, ComponentIdOf<T>()));
+        }
+
+        template <Component T>
+        [[nodiscard]] const T* tryGet(const Entity entity) const
+        {
+            return static_cast<const T*>(find(entity, ComponentIdOf<T>()));
+        }
+
+        /**
+         * @brief The entity's component, which must exist.
+         */
+        template <Component T>
+        [[nodiscard]] T& get(const Entity entity)
+        {
+            T* component = tryGet<T>(entity);
+            PSYGINE_ASSERT(component != nullptr, "World::get: entity does not have the component");
+            return *component;
+        }
+
+        template <Component T>
+        [[nodiscard]] const T& get(const Entity entity) const
+        {
+            const T* component = tryGet<T>(entity);
+            PSYGINE_ASSERT(component != nullptr, "World::get: entity does not have the component");
+            return *component;
+        }
+
+        /**
+         * @brief The cached query over entities that have all of `Ts`.
+         *
+         * The query is built on first use and kept up to date as archetypes are added, so calling this
+         * every frame only costs a table lookup.
+         */
+        template <typename... Ts>
+        Query<Ts...>& query();
+
+        /**
+         * @brief The world's own command buffer, applied by `flush`.
+         */
+        [[nodiscard]] CommandBuffer& commands()
+        {
+            return commands_;
+        }
+
+        /**
+         * @brief Applies the world's command buffer. Call between systems or at the end of a frame.
+         */
+        void flush()
+        {
+            apply(commands_);
+        }
+
+        /**
+         * @brief Applies a command buffer's operations in the order they were recorded, then empties it.
+         */
+        void apply(CommandBuffer& buffer);
+
+        /**
+         * @brief The number of living entities.
+         */
+        [[nodiscard]] std::size_t size() const
+        {
+            return size_;
+        }
+
+        /**
+         * @brief Every archetype created so far. Archetypes are never removed, so pointers stay valid.
+         */
+        [[nodiscard]] std::span<const std::unique_ptr<Archetype>> archetypes() const
+        {
+            return archetypes_;
+        }
+
+        /**
+         * @brief Whether a query is iterating, which forbids structural changes.
+         */
+        [[nodiscard]] bool iterating() const
+        {
+            return iterating_.load(std::memory_order_relaxed) > 0;
+        }
+
+        /**
+         * @brief Marks the world as being iterated for its lifetime, which forbids structural changes.
+         *
+         * Queries take one while they run. Scopes nest and may be held from several threads at once.
+         */
+        class IterationScope
+        {
+        public:
+            explicit IterationScope(World& world) :
+                world_{world}
+            {
+                world_.iterating_.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            ~IterationScope()
+            {
+                world_.iterating_.fetch_sub(1, std::memory_order_relaxed);
+            }
+
+            IterationScope(const IterationScope& other) = delete;
+            IterationScope& operator=(const IterationScope& other) = delete;
+
+        private:
+            World& world_;
+        };
+
+        World(const World& other) = delete;
+        World(World&& other) noexcept = delete;
+        World& operator=(const World& other) = delete;
+        World& operator=(World&& other) noexcept = delete;
+
+    private:
+        static constexpr std::uint32_t NIL = Entity::INVALID_INDEX;
+
+        struct EntityRecord
+        {
+            Archetype* archetype = nullptr; // null while the record is free
+            RowLocation location;
+            std::uint32_t generation = 0;
+            std::uint32_t nextFree = NIL;
+        };
+
+        // Transparent, so archetypes can be looked up by a span without building a vector.
+        struct SignatureHash
+        {
+            using is_transparent = void;
+
+            std::size_t operator()(std::span<const ComponentId> signature) const;
+        };
+
+        struct SignatureEqual
+        {
+            using is_transparent = void;
+
+            bool operator()(const std::span<const ComponentId> a, const std::span<const ComponentId> b) const
+            {
+                return std::ranges::equal(a, b);
+            }
+        };
+
+        [[nodiscard]] const EntityRecord* record(Entity entity) const;
+        [[nodiscard]] void* find(Entity entity, ComponentId id) const;
+        // Returns uninitialized storage for the component, destroying the old value if there was one.
+        [[nodiscard]] void* emplace(Entity entity, ComponentId id);
+        void erase(Entity entity, ComponentId id);
+
+        Entity allocate(Archetype* archetype);
+        void move(EntityRecord& record, Archetype* target);
+        [[nodiscard]] Archetype* archetypeFor(std::span<const ComponentId> signature);
+        [[nodiscard]] Archetype* addTarget(Archetype* source, ComponentId id);
+        [[nodiscard]] Archetype* removeTarget(Archetype* source, ComponentId id);
+
+        std::vector<EntityRecord> records_;
+        std::uint32_t freeHead_ = NIL;
+        std::size_t size_ = 0;
+
+        std::vector<std::unique_ptr<Archetype>> archetypes_;
+        std::unordered_map<std::vector<ComponentId>, Archetype*, SignatureHash, SignatureEqual> archetypeLookup_;
+        Archetype* root_ = nullptr;
+
+        std::vector<std::unique_ptr<detail::QueryBase>> queries_;
+        CommandBuffer commands_;
+        std::atomic<std::uint32_t> iterating_{0};
+    };
+
+    /**
+     * @brief Cached list of the archetypes that contain all of `Ts`, iterated chunk by chunk.
+     *
+     * Matching archetypes are found once and new archetypes are checked as they appear, so iteration
+     * never re-tests archetypes that were already seen. Obtain queries from `World::query`.
+     *
+     * @tparam Ts The components to read and write; declare read-only ones as `const`.
+     */
+    template <typename... Ts>
+        requires (sizeof...(Ts) > 0) && (Component<std::remove_const_t<Ts>> && ...) &&
+                 detail::UNIQUE_TYPES<std::remove_const_t<Ts>...>
+    class Query final : public detail::QueryBase
+    {
+    public:
+        using View = ChunkView<Ts...>;
+
+        explicit Query(World& world) :
+            world_{&world},
+            required_{ComponentIdOf<Ts>()...}
+        {
+            std::ranges::sort(required_);
+        }
+
+        /**
+         * @brief Calls `fn(components...)` or `fn(entity, components...)` for every matching entity.
+         */
+        template <typename Fn>
+            requires std::invocable<Fn&, Ts&...> || std::invocable<Fn&, Entity, Ts&...>
+        void each(Fn&& fn)
+        {
+            eachChunk([&fn](const View& view)
+            {
+                view.each(fn);
+            });
+        }
+
+        /**
+         * @brief Calls `fn(view)` for every non-empty chunk of every matching archetype.
+         */
+        template <typename Fn>
+            requires std::invocable<Fn&, const View&>
+        void eachChunk(Fn&& fn)
+        {
+            refresh();
+            World::IterationScope scope(*world_);
+            for (const Match& match : matches_)
+            {
+                const Archetype& archetype = *match.archetype;
+                for (std::size_t chunk = 0; chunk < archetype.chunkCount(); ++chunk)
+                {
+                    std::invoke(fn, chunkView(match, chunk));
+                }
+            }
+        }
+
+        /**
+         * @brief The number of matching entities.
+         */
+        [[nodiscard]] std::size_t count()
+        {
+            refresh();
+            std::size_t total = 0;
+            for (const Match& match : matches_)
+            {
+                total += match.archetype->size();
+            }
+            return total;
+        }
+
+        /**
+         * @brief Appends a view of every non-empty matching chunk to `out`, for splitting work by chunk.
+         *
+         * The views stay valid until the next structural change to the world.
+         */
+        void gatherChunks(std::vector<View>& out)
+        {
+            refresh();
+            for (const Match& match : matches_)
+            {
+                for (std::size_t chunk = 0; chunk < match.archetype->chunkCount(); ++chunk)
+                {
+                    out.push_back(chunkView(match, chunk));
+                }
+            }
+        }
+
+        /**
+         * @brief Picks up archetypes created since the last call. Iteration does this on its own.
+         *
+         * Safe to call from several threads at once only when no archetypes were created since the
+         * previous call, which holds while the world is being iterated.
+         */
+        void refresh()
+        {
+            const auto archetypes = world_->archetypes();
+            for (; seen_ < archetypes.size(); ++seen_)
+            {
+                Archetype* archetype = archetypes[seen_].get();
+                if (std::ranges::includes(archetype->signature(), required_))
+                {
+                    matches_.push_back(Match{archetype, {archetype->columnIndex(ComponentIdOf<Ts>())...}});
+                }
+            }
+        }
+
+    private:
+        struct Match
+        {
+            Archetype* archetype = nullptr;
+            std::array<std::size_t, sizeof...(Ts)> columns{}; // column of each of Ts, in query order
+        };
+
+        [[nodiscard]] View chunkView(const Match& match, const std::size_t chunk) const
+        {
+            const Archetype& archetype = *match.archetype;
+            return [&]<std::size_t... I>(std::index_sequence<I...>)
+            {
+                return View(archetype.entities(chunk), archetype.chunkSize(chunk),
+                            std::tuple<Ts*...>{static_cast<Ts*>(archetype.columnData(chunk, match.columns[I]))...});
+            }(std::index_sequence_for<Ts...>{});
+        }
+
+        World* world_;
+        std::array<ComponentId, sizeof...(Ts)> required_;
+        std::vector<Match> matches_;
+        std::size_t seen_ = 0;
+    };
+
+    template <typename... Ts>
+    Query<Ts...>& World::query()
+    {
+        const std::size_t slot = detail::QuerySlot<Query<Ts...>>();
+        if (slot >= queries_.size())
+        {
+            queries_.resize(slot + 1);
+        }
+        if (!queries_[slot])
+        {
+            queries_[slot] = std::make_unique<Query<Ts...>>(*this);
+        }
+        return static_cast<Query<Ts...>&>(*queries_[slot]);
+    }
+}
+
+#endif //PSYGINE_WORLD_HPP
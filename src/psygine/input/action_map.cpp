@@ -0,0 +1,174 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#include "action_map.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "psygine/debug/assert.hpp"
+
+namespace psygine::input
+{
+    ActionId ActionMap::add(const std::string_view name)
+    {
+        PSYGINE_ASSERT(!find(name).valid(), "ActionMap::add: an action with this name already exists");
+        const auto index = static_cast<std::uint32_t>(names_.size());
+        names_.emplace_back(name);
+        lookup_.emplace(names_.back(), index);
+        buttons_.emplace_back();
+        compiled_ = false;
+        return ActionId{index};
+    }
+
+    ActionId ActionMap::find(const std::string_view name) const
+    {
+        const auto it = lookup_.find(std::string(name));
+        return it == lookup_.end() ? ActionId{} : ActionId{it->second};
+    }
+
+    const std::string& ActionMap::name(const ActionId action) const
+    {
+        PSYGINE_DEBUG_ASSERT(action.index < names_.size(), "ActionMap::name: unknown action");
+        return names_[action.index];
+    }
+
+    void ActionMap::bind(const ActionId action, const Button button)
+    {
+        PSYGINE_ASSERT(action.index < names_.size(), "ActionMap::bind: unknown action");
+        PSYGINE_ASSERT(button < BUTTON_COUNT, "ActionMap::bind: button out of range");
+        buttons_[action.index].push_back(button);
+        compiled_ = false;
+    }
+
+    void ActionMap::bindAxis(const ActionId action, const Axis axis, const float scale, const float deadzone)
+    {
+        PSYGINE_ASSERT(action.index < names_.size(), "ActionMap::bindAxis: unknown action");
+        PSYGINE_ASSERT(axis < AXIS_COUNT, "ActionMap::bindAxis: axis out of range");
+        PSYGINE_ASSERT(deadzone >= 0.0F && deadzone < 1.0F, "ActionMap::bindAxis: deadzone must be in [0, 1)");
+        axes_.push_back({action, axis, scale, deadzone});
+        compiled_ = false;
+    }
+
+    void ActionMap::bindButtons(const ActionId action, const Button negative, const Button positive)
+    {
+        PSYGINE_ASSERT(action.index < names_.size(), "ActionMap::bindButtons: unknown action");
+        PSYGINE_ASSERT(negative < BUTTON_COUNT && positive < BUTTON_COUNT,
+                       "ActionMap::bindButtons: button out of range");
+        pairs_.push_back({action, negative, positive});
+        compiled_ = false;
+    }
+
+    void ActionMap::compile()
+    {
+        // One dense row of words per action, then only its non-zero words are kept.
+        std::vector<InputSnapshot::Words> held(names_.size());
+        std::vector<InputSnapshot::Words> edges(names_.size());
+        const auto set = [](InputSnapshot::Words& words, const Button button)
+        { words[button >> 6] |= std::uint64_t{1} << (button & 63U); };
+
+        for (std::size_t action = 0; action < names_.size(); ++action)
+        {
+            for (const Button button : buttons_[action])
+            {
+                set(held[action], button);
+                set(edges[action], button);
+            }
+        }
+        for (const ButtonPair& pair : pairs_)
+        {
+            set(edges[pair.action.index], pair.negative);
+            set(edges[pair.action.index], pair.positive);
+        }
+
+        masks_.clear();
+        maskStart_.assign(names_.size() + 1, 0);
+        for (std::size_t action = 0; action < names_.size(); ++action)
+        {
+            maskStart_[action] = static_cast<std::uint32_t>(masks_.size());
+            for (std::uint32_t word = 0; word < BUTTON_WORDS; ++word)
+            {
+                if (edges[action][word] != 0)
+                {
+                    masks_.push_back({word, held[action][word], edges[action][word]});
+                }
+            }
+        }
+        maskStart_[names_.size()] = static_cast<std::uint32_t>(masks_.size());
+        compiled_ = true;
+    }
+
+    void ActionMap::evaluate(const InputSnapshot& input, ActionState& state) const
+    {
+        PSYGINE_ASSERT(compiled_, "ActionMap::evaluate: bindings changed since the last compile");
+
+        const std::size_t count = names_.size();
+        const std::size_t words = (count + 63) / 64;
+        if (state.values_.size() != count)
+        {
+            state.held_.assign(words, 0);
+            state.pressed_.assign(words, 0);
+            state.released_.assign(words, 0);
+            state.values_.assign(count, 0.0F);
+        }
+        std::ranges::fill(state.values_, 0.0F);
+
+        for (const AxisBinding& binding : axes_)
+        {
+            const float reading = input.axis(binding.axis);
+            const float magnitude = std::abs(reading);
+            if (magnitude > binding.deadzone)
+            {
+                const float rescaled = (magnitude - binding.deadzone) / (1.0F - binding.deadzone);
+                state.values_[binding.action.index] += std::copysign(rescaled, reading) * binding.scale;
+            }
+        }
+        for (const ButtonPair& pair : pairs_)
+        {
+            float& value = state.values_[pair.action.index];
+            value += (input.held(pair.positive) ? 1.0F : 0.0F) - (input.held(pair.negative) ? 1.0F : 0.0F);
+        }
+
+        const InputSnapshot::Words& heldWords = input.heldWords();
+        const InputSnapshot::Words& pressedWords = input.pressedWords();
+        const InputSnapshot::Words& releasedWords = input.releasedWords();
+        for (std::size_t word = 0; word < words; ++word)
+        {
+            const std::uint64_t wasHeld = state.held_[word];
+            std::uint64_t held = 0;
+            std::uint64_t pressedEdges = 0;
+            std::uint64_t releasedEdges = 0;
+
+            const std::size_t end = std::min(count, (word + 1) * 64);
+            for (std::size_t action = word * 64; action < end; ++action)
+            {
+                std::uint64_t down = 0;
+                std::uint64_t wentDown = 0;
+                std::uint64_t wentUp = 0;
+                for (std::uint32_t m = maskStart_[action]; m < maskStart_[action + 1]; ++m)
+                {
+                    const MaskEntry& entry = masks_[m];
+                    down |= heldWords[entry.word] & entry.held;
+                    wentDown |= pressedWords[entry.word] & entry.edges;
+                    wentUp |= releasedWords[entry.word] & entry.edges;
+                }
+
+                float& value = state.values_[action];
+                if (down != 0)
+                {
+                    value += 1.0F;
+                }
+                value = std::clamp(value, -1.0F, 1.0F);
+
+                const std::uint64_t bit = std::uint64_t{1} << (action & 63U);
+                held |= (down != 0 || value != 0.0F) ? bit : 0;
+                pressedEdges |= wentDown != 0 ? bit : 0;
+                releasedEdges |= wentUp != 0 ? bit : 0;
+            }
+
+            state.held_[word] = held;
+            state.pressed_[word] = (held & ~wasHeld) | pressedEdges;
+            state.released_[word] = (wasHeld & ~held) | (releasedEdges & ~held);
+        }
+    }
+}
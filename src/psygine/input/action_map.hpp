@@ -0,0 +1,177 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#ifndef PSYGINE_ACTION_MAP_HPP
+#define PSYGINE_ACTION_MAP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "input_snapshot.hpp"
+
+namespace psygine::input
+{
+    struct ActionId
+    {
+        static constexpr std::uint32_t INVALID_INDEX = std::numeric_limits<std::uint32_t>::max();
+
+        std::uint32_t index = INVALID_INDEX;
+
+        [[nodiscard]] constexpr bool valid() const
+        {
+            return index != INVALID_INDEX;
+        }
+
+        friend constexpr bool operator==(const ActionId& lhs, const ActionId& rhs) = default;
+    };
+
+    /**
+     * @brief Every action of an `ActionMap` evaluated against one input snapshot.
+     */
+    class ActionState
+    {
+    public:
+        /**
+         * @brief Whether a bound button is down or the value is not zero.
+         */
+        [[nodiscard]] bool held(const ActionId action) const
+        {
+            return Test(held_, action);
+        }
+
+        /**
+         * @brief Whether the action became active since the previous evaluation, or a bound button
+         * went down in between.
+         */
+        [[nodiscard]] bool pressed(const ActionId action) const
+        {
+            return Test(pressed_, action);
+        }
+
+        /**
+         * @brief Whether the action stopped being active since the previous evaluation, or a bound
+         * button went up in between and the action is not held.
+         */
+        [[nodiscard]] bool released(const ActionId action) const
+        {
+            return Test(released_, action);
+        }
+
+        /**
+         * @brief The summed axis bindings, button pairs and buttons (1 while held), clamped to [-1, 1].
+         */
+        [[nodiscard]] float value(const ActionId action) const
+        {
+            return values_[action.index];
+        }
+
+    private:
+        friend class ActionMap;
+
+        static bool Test(const std::vector<std::uint64_t>& words, const ActionId action)
+        {
+            return ((words[action.index >> 6] >> (action.index & 63U)) & 1U) != 0;
+        }
+
+        std::vector<std::uint64_t> held_;
+        std::vector<std::uint64_t> pressed_;
+        std::vector<std::uint64_t> released_;
+        std::vector<float> values_;
+    };
+
+    /**
+     * @brief Named actions bound to buttons and axes, compiled into flat lookup tables.
+     *
+     * Actions are added and bound by name while setting up; `compile` then turns the bindings into one
+     * run of `(word, mask)` pairs per action over the snapshot bitsets and flat arrays of axis and button
+     * pair bindings, so evaluating every action each tick is a handful of AND and OR operations, and
+     * gameplay code queries an `ActionState` by `ActionId` instead of matching events.
+     */
+    class ActionMap
+    {
+    public:
+        /**
+         * @brief Adds an action; names are unique.
+         */
+        ActionId add(std::string_view name);
+
+        /**
+         * @brief The action called `name`, or an invalid id.
+         */
+        [[nodiscard]] ActionId find(std::string_view name) const;
+
+        [[nodiscard]] const std::string& name(ActionId action) const;
+
+        void bind(ActionId action, Button button);
+
+        /**
+         * @brief Adds `axis * scale` to the value. Readings within `deadzone` of zero count as zero, and
+         * the rest of the range is rescaled to start from zero.
+         */
+        void bindAxis(ActionId action, Axis axis, float scale = 1.0F, float deadzone = 0.0F);
+
+        /**
+         * @brief Adds -1 while `negative` is held and +1 while `positive` is held, as for movement keys.
+         */
+        void bindButtons(ActionId action, Button negative, Button positive);
+
+        /**
+         * @brief Builds the lookup tables from the bindings. Must be called after binding and before
+         * `evaluate`.
+         */
+        void compile();
+
+        /**
+         * @brief Evaluates every action against `input`, updating `state` from its previous evaluation.
+         */
+        void evaluate(const InputSnapshot& input, ActionState& state) const;
+
+        [[nodiscard]] std::size_t size() const
+        {
+            return names_.size();
+        }
+
+    private:
+        struct AxisBinding
+        {
+            ActionId action;
+            Axis axis = 0;
+            float scale = 1.0F;
+            float deadzone = 0.0F;
+        };
+
+        struct ButtonPair
+        {
+            ActionId action;
+            Button negative = 0;
+            Button positive = 0;
+        };
+
+        struct MaskEntry
+        {
+            std::uint32_t word = 0;
+            // Buttons that hold the action, and those whose edges press and release it, which adds the
+            // button pairs.
+            std::uint64_t held = 0;
+            std::uint64_t edges = 0;
+        };
+
+        std::vector<std::string> names_;
+        std::unordered_map<std::string, std::uint32_t> lookup_;
+        std::vector<std::vector<Button>> buttons_;
+        std::vector<AxisBinding> axes_;
+        std::vector<ButtonPair> pairs_;
+
+        // Compiled: the mask entries of action a are [maskStart_[a], maskStart_[a + 1]).
+        std::vector<MaskEntry> masks_;
+        std::vector<std::uint32_t> maskStart_;
+        bool compiled_ = false;
+    };
+}
+
+#endif //PSYGINE_ACTION_MAP_HPP
@@ -0,0 +1,130 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#include "gamepad_poller.hpp"
+
+#include <chrono>
+#include <utility>
+
+#include <SDL3/SDL_timer.h>
+
+#include "psygine/debug/assert.hpp"
+
+namespace
+{
+    using psygine::input::GamepadSample;
+
+    bool SameState(const GamepadSample& lhs, const GamepadSample& rhs)
+    {
+        return lhs.buttons == rhs.buttons && lhs.axes == rhs.axes;
+    }
+}
+
+namespace psygine::input
+{
+    GamepadPoller::GamepadPoller(const std::uint32_t rate) : rate_{rate}
+    {
+        PSYGINE_ASSERT(rate > 0, "GamepadPoller::GamepadPoller: rate must be greater than 0");
+        thread_ = std::thread(&GamepadPoller::run, this);
+    }
+
+    GamepadPoller::~GamepadPoller()
+    {
+        stopping_.store(true, std::memory_order_release);
+        thread_.join();
+    }
+
+    void GamepadPoller::attach(const std::size_t pad, const SDL_JoystickID id)
+    {
+        PSYGINE_DEBUG_ASSERT(pad < MAX_GAMEPADS, "GamepadPoller::attach: pad out of range");
+
+        // A second reference to the open gamepad, so closing the caller's does not pull it from under
+        // the thread. Opened outside the lock to keep the thread's wait short.
+        core::SdlGamepadPtr handle = core::sdl_raii::OpenGamepad(id);
+        if (handle == nullptr)
+        {
+            return;
+        }
+
+        const std::scoped_lock lock(mutex_);
+        slots_[pad].handle = std::move(handle);
+        slots_[pad].last = {};
+        slots_[pad].last.id = id;
+        slots_[pad].last.pad = static_cast<std::uint8_t>(pad);
+        slots_[pad].fresh = true;
+    }
+
+    void GamepadPoller::detach(const std::size_t pad)
+    {
+        PSYGINE_DEBUG_ASSERT(pad < MAX_GAMEPADS, "GamepadPoller::detach: pad out of range");
+
+        core::SdlGamepadPtr handle{nullptr, &SDL_CloseGamepad};
+        {
+            const std::scoped_lock lock(mutex_);
+            handle = std::move(slots_[pad].handle);
+        }
+        // Closed here, after the thread can no longer reach it.
+    }
+
+    void GamepadPoller::run()
+    {
+        const auto period = std::chrono::duration_cast<utilities::time::types::Duration>(
+            std::chrono::duration<double>(1.0 / rate_));
+        auto next = utilities::time::Now();
+
+        while (!stopping_.load(std::memory_order_acquire))
+        {
+            poll();
+
+            next += period;
+            const auto now = utilities::time::Now();
+            if (next <= now)
+            {
+                // Fell behind, e.g. the thread was descheduled: skip the missed polls instead of
+                // running them back to back.
+                next = now;
+                continue;
+            }
+            SDL_DelayNS(static_cast<Uint64>((next - now).count()));
+        }
+    }
+
+    void GamepadPoller::poll()
+    {
+        const std::scoped_lock lock(mutex_);
+        SDL_UpdateGamepads();
+        const auto time = utilities::time::Now();
+
+        for (Slot& slot : slots_)
+        {
+            SDL_Gamepad* gamepad = slot.handle.get();
+            if (gamepad == nullptr)
+            {
+                continue;
+            }
+
+            GamepadSample sample = slot.last;
+            sample.time = time;
+            sample.buttons = 0;
+            for (int button = 0; button < SDL_GAMEPAD_BUTTON_COUNT; ++button)
+            {
+                if (SDL_GetGamepadButton(gamepad, static_cast<SDL_GamepadButton>(button)))
+                {
+                    sample.buttons |= std::uint32_t{1} << button;
+                }
+            }
+            for (int axis = 0; axis < SDL_GAMEPAD_AXIS_COUNT; ++axis)
+            {
+                sample.axes[static_cast<std::size_t>(axis)] =
+                    SDL_GetGamepadAxis(gamepad, static_cast<SDL_GamepadAxis>(axis));
+            }
+
+            // A change that does not fit is compared against the old state again on the next poll.
+            if ((slot.fresh || !SameState(sample, slot.last)) && ring_.tryPush(sample))
+            {
+                slot.last = sample;
+                slot.fresh = false;
+            }
+        }
+    }
+}
@@ -0,0 +1,131 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#ifndef PSYGINE_GAMEPAD_POLLER_HPP
+#define PSYGINE_GAMEPAD_POLLER_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include <SDL3/SDL_gamepad.h>
+
+#include "input_snapshot.hpp"
+#include "psygine/core/sdl_raii.hpp"
+#include "psygine/core/spsc_ring.hpp"
+#include "psygine/utilities/time.hpp"
+
+namespace psygine::input
+{
+    /**
+     * @brief The full state of one gamepad at the moment it was polled.
+     */
+    struct GamepadSample
+    {
+        utilities::time::types::TimePoint time;
+        // The joystick id the slot held when polled, so samples from a since disconnected gamepad are
+        // recognised.
+        SDL_JoystickID id = 0;
+        // Bit `b` is `SDL_GamepadButton` `b`.
+        std::uint32_t buttons = 0;
+        std::array<std::int16_t, SDL_GAMEPAD_AXIS_COUNT> axes{};
+        std::uint8_t pad = 0;
+    };
+
+    static_assert(SDL_GAMEPAD_BUTTON_COUNT <= 32, "GamepadSample::buttons holds one bit per gamepad button");
+
+    /**
+     * @brief Polls the attached gamepads on a dedicated thread at a fixed rate and queues a timestamped
+     * sample whenever one of them changes.
+     *
+     * Frame-rate event handling only sees the latest gamepad state once per frame; polling at 500 to
+     * 1000 Hz keeps presses between frames in order and gives each its own time, so the fixed update
+     * can hand them to the tick whose time span they fall in. Samples go through a single-producer,
+     * single-consumer ring read by the thread that owns the `InputSystem`. When the ring is full the
+     * change is retried on the next poll, so a stalled consumer loses timing but never state.
+     *
+     * The thread calls `SDL_UpdateGamepads`, which SDL serialises against the event pump with its
+     * joystick lock, and reads the gamepads through its own references, so `attach` and `detach` are
+     * the only calls that wait on it.
+     */
+    class GamepadPoller
+    {
+    public:
+        static constexpr std::size_t RING_CAPACITY = 1024;
+
+        /**
+         * @brief Starts the polling thread.
+         *
+         * @param rate Polls per second.
+         */
+        explicit GamepadPoller(std::uint32_t rate);
+
+        /**
+         * @brief Stops and joins the polling thread; queued samples are discarded.
+         */
+        ~GamepadPoller();
+
+        /**
+         * @brief Starts polling the gamepad with joystick id `id` into slot `pad`. Its first poll is always
+         * queued, so the consumer learns about buttons released since it last saw the gamepad.
+         */
+        void attach(std::size_t pad, SDL_JoystickID id);
+
+        /**
+         * @brief Stops polling slot `pad`. Samples it already queued keep their old id.
+         */
+        void detach(std::size_t pad);
+
+        /**
+         * @brief Consumer: the oldest queued sample, or nullptr. It stays valid until `pop`.
+         */
+        [[nodiscard]] const GamepadSample* front()
+        {
+            return ring_.front();
+        }
+
+        /**
+         * @brief Consumer: removes the sample returned by `front`.
+         */
+        void pop()
+        {
+            ring_.pop();
+        }
+
+        [[nodiscard]] std::uint32_t rate() const
+        {
+            return rate_;
+        }
+
+        GamepadPoller(const GamepadPoller& other) = delete;
+        GamepadPoller(GamepadPoller&& other) noexcept = delete;
+        GamepadPoller& operator=(const GamepadPoller& other) = delete;
+        GamepadPoller& operator=(GamepadPoller&& other) noexcept = delete;
+
+    private:
+        struct Slot
+        {
+            core::SdlGamepadPtr handle{nullptr, &SDL_CloseGamepad};
+            // The last state queued, which new polls are compared against.
+            GamepadSample last;
+            // Set by `attach` until the first sample is queued.
+            bool fresh = false;
+        };
+
+        void run();
+        void poll();
+
+        core::SpscRing<GamepadSample, RING_CAPACITY> ring_;
+        std::array<Slot, MAX_GAMEPADS> slots_{};
+        std::mutex mutex_;
+        std::atomic<bool> stopping_{false};
+        std::uint32_t rate_;
+        // Last, so the thread starts after everything it touches is constructed.
+        std::thread thread_;
+    };
+}
+
+#endif //PSYGINE_GAMEPAD_POLLER_HPP
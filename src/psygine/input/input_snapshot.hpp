@@ -0,0 +1,152 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#ifndef PSYGINE_INPUT_SNAPSHOT_HPP
+#define PSYGINE_INPUT_SNAPSHOT_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include <SDL3/SDL_gamepad.h>
+#include <SDL3/SDL_scancode.h>
+
+namespace psygine::input
+{
+    /**
+     * @brief Index of a digital input. Keys, mouse buttons and the buttons of every gamepad share one
+     * index space so one bitset holds them all; build indices with `KeyButton`, `MouseButton` and
+     * `GamepadButton`.
+     */
+    using Button = std::uint16_t;
+
+    /**
+     * @brief Index of an analog input: the mouse axes or a gamepad axis.
+     */
+    using Axis = std::uint16_t;
+
+    inline constexpr std::size_t MAX_GAMEPADS = 4;
+
+    inline constexpr Button MOUSE_BUTTON_BASE = SDL_SCANCODE_COUNT;
+    inline constexpr Button MOUSE_BUTTON_COUNT = 8;
+    inline constexpr Button GAMEPAD_BUTTON_BASE = MOUSE_BUTTON_BASE + MOUSE_BUTTON_COUNT;
+    inline constexpr Button GAMEPAD_BUTTON_STRIDE = 32;
+    inline constexpr Button BUTTON_COUNT = GAMEPAD_BUTTON_BASE + (GAMEPAD_BUTTON_STRIDE * MAX_GAMEPADS);
+    inline constexpr std::size_t BUTTON_WORDS = (BUTTON_COUNT + 63) / 64;
+
+    // Pointer position in window coordinates.
+    inline constexpr Axis AXIS_MOUSE_X = 0;
+    inline constexpr Axis AXIS_MOUSE_Y = 1;
+    // Pointer motion and wheel scrolling summed since the previous snapshot.
+    inline constexpr Axis AXIS_MOUSE_DELTA_X = 2;
+    inline constexpr Axis AXIS_MOUSE_DELTA_Y = 3;
+    inline constexpr Axis AXIS_WHEEL_X = 4;
+    inline constexpr Axis AXIS_WHEEL_Y = 5;
+    inline constexpr Axis GAMEPAD_AXIS_BASE = 8;
+    inline constexpr Axis GAMEPAD_AXIS_STRIDE = 8;
+    inline constexpr Axis AXIS_COUNT = GAMEPAD_AXIS_BASE + (GAMEPAD_AXIS_STRIDE * MAX_GAMEPADS);
+
+    static_assert(SDL_GAMEPAD_BUTTON_COUNT <= GAMEPAD_BUTTON_STRIDE && SDL_GAMEPAD_AXIS_COUNT <= GAMEPAD_AXIS_STRIDE);
+
+    constexpr Button KeyButton(const SDL_Scancode key)
+    {
+        return static_cast<Button>(key);
+    }
+
+    /**
+     * @param button An SDL mouse button number, starting at `SDL_BUTTON_LEFT`.
+     */
+    constexpr Button MouseButton(const std::uint8_t button)
+    {
+        return static_cast<Button>(MOUSE_BUTTON_BASE + button - 1);
+    }
+
+    /**
+     * @param pad The gamepad slot, in connection order, below `MAX_GAMEPADS`.
+     */
+    constexpr Button GamepadButton(const std::size_t pad, const SDL_GamepadButton button)
+    {
+        return static_cast<Button>(GAMEPAD_BUTTON_BASE + (pad * GAMEPAD_BUTTON_STRIDE) +
+                                   static_cast<std::size_t>(button));
+    }
+
+    /**
+     * @brief A gamepad axis; sticks read in [-1, 1] and triggers in [0, 1].
+     */
+    constexpr Axis GamepadAxis(const std::size_t pad, const SDL_GamepadAxis axis)
+    {
+        return static_cast<Axis>(GAMEPAD_AXIS_BASE + (pad * GAMEPAD_AXIS_STRIDE) + static_cast<std::size_t>(axis));
+    }
+
+    /**
+     * @brief The state of every input at one instant, with the edges seen since the previous snapshot.
+     *
+     * `pressed` stays set for a button that went down and up again between two snapshots, so taps
+     * shorter than a fixed tick are still seen by exactly one tick. Every query is a bit or array load.
+     * The snapshot is trivially copyable, so it can be recorded for replays and rollback.
+     */
+    class InputSnapshot
+    {
+    public:
+        using Words = std::array<std::uint64_t, BUTTON_WORDS>;
+
+        /**
+         * @brief Whether the button is down at the snapshot.
+         */
+        [[nodiscard]] bool held(const Button button) const
+        {
+            return Test(held_, button);
+        }
+
+        /**
+         * @brief Whether the button went down since the previous snapshot.
+         */
+        [[nodiscard]] bool pressed(const Button button) const
+        {
+            return Test(pressed_, button);
+        }
+
+        /**
+         * @brief Whether the button went up since the previous snapshot.
+         */
+        [[nodiscard]] bool released(const Button button) const
+        {
+            return Test(released_, button);
+        }
+
+        [[nodiscard]] float axis(const Axis axis) const
+        {
+            return axes_[axis];
+        }
+
+        [[nodiscard]] const Words& heldWords() const
+        {
+            return held_;
+        }
+
+        [[nodiscard]] const Words& pressedWords() const
+        {
+            return pressed_;
+        }
+
+        [[nodiscard]] const Words& releasedWords() const
+        {
+            return released_;
+        }
+
+    private:
+        friend class InputSystem;
+
+        static bool Test(const Words& words, const Button button)
+        {
+            return ((words[static_cast<std::size_t>(button >> 6)] >> (button & 63U)) & 1U) != 0;
+        }
+
+        Words held_{};
+        Words pressed_{};
+        Words released_{};
+        std::array<float, AXIS_COUNT> axes_{};
+    };
+}
+
+#endif //PSYGINE_INPUT_SNAPSHOT_HPP
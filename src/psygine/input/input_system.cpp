@@ -0,0 +1,338 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#include "input_system.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+#include <SDL3/SDL_events.h>
+
+#include "psygine/debug/assert.hpp"
+
+namespace
+{
+    using psygine::input::Axis;
+    using psygine::input::AXIS_MOUSE_DELTA_X;
+    using psygine::input::AXIS_WHEEL_Y;
+
+    // SDL reports gamepad axes as signed 16-bit values.
+    constexpr float GAMEPAD_AXIS_SCALE = 1.0F / 32767.0F;
+
+    float GamepadAxisValue(const std::int16_t value)
+    {
+        return std::max(static_cast<float>(value) * GAMEPAD_AXIS_SCALE, -1.0F);
+    }
+
+    // The axes that accumulate motion between snapshots instead of holding a position.
+    constexpr bool IsRelative(const Axis axis)
+    {
+        return axis >= AXIS_MOUSE_DELTA_X && axis <= AXIS_WHEEL_Y;
+    }
+}
+
+namespace psygine::input
+{
+    void InputSystem::handleEvent(const SDL_Event& event)
+    {
+        switch (event.type)
+        {
+            case SDL_EVENT_KEY_DOWN:
+            case SDL_EVENT_KEY_UP:
+                // Repeats are not new presses.
+                if (!event.key.repeat && event.key.scancode < SDL_SCANCODE_COUNT)
+                {
+                    setButton(KeyButton(event.key.scancode), event.type == SDL_EVENT_KEY_DOWN);
+                }
+                break;
+
+            case SDL_EVENT_MOUSE_MOTION:
+                axes_[AXIS_MOUSE_X] = event.motion.x;
+                axes_[AXIS_MOUSE_Y] = event.motion.y;
+                addMotion(AXIS_MOUSE_DELTA_X, event.motion.xrel);
+                addMotion(AXIS_MOUSE_DELTA_Y, event.motion.yrel);
+                break;
+
+            case SDL_EVENT_MOUSE_BUTTON_DOWN:
+            case SDL_EVENT_MOUSE_BUTTON_UP:
+                if (event.button.button >= 1 && event.button.button <= MOUSE_BUTTON_COUNT)
+                {
+                    setButton(MouseButton(event.button.button), event.type == SDL_EVENT_MOUSE_BUTTON_DOWN);
+                }
+                break;
+
+            case SDL_EVENT_MOUSE_WHEEL:
+            {
+                const float direction = event.wheel.direction == SDL_MOUSEWHEEL_FLIPPED ? -1.0F : 1.0F;
+                addMotion(AXIS_WHEEL_X, event.wheel.x * direction);
+                addMotion(AXIS_WHEEL_Y, event.wheel.y * direction);
+                break;
+            }
+
+            case SDL_EVENT_GAMEPAD_ADDED:
+                connect(event.gdevice.which);
+                break;
+
+            case SDL_EVENT_GAMEPAD_REMOVED:
+                disconnect(event.gdevice.which);
+                break;
+
+            // While polling, the poller's samples are the gamepad state; these arrive later and all at once.
+            case SDL_EVENT_GAMEPAD_BUTTON_DOWN:
+            case SDL_EVENT_GAMEPAD_BUTTON_UP:
+            {
+                const std::size_t pad = slotOf(event.gbutton.which);
+                if (poller_ == nullptr && pad < MAX_GAMEPADS && event.gbutton.button < SDL_GAMEPAD_BUTTON_COUNT)
+                {
+                    setButton(GamepadButton(pad, static_cast<SDL_GamepadButton>(event.gbutton.button)),
+                              event.type == SDL_EVENT_GAMEPAD_BUTTON_DOWN);
+                }
+                break;
+            }
+
+            case SDL_EVENT_GAMEPAD_AXIS_MOTION:
+            {
+                const std::size_t pad = slotOf(event.gaxis.which);
+                if (poller_ == nullptr && pad < MAX_GAMEPADS && event.gaxis.axis < SDL_GAMEPAD_AXIS_COUNT)
+                {
+                    axes_[GamepadAxis(pad, static_cast<SDL_GamepadAxis>(event.gaxis.axis))] =
+                        GamepadAxisValue(event.gaxis.value);
+                }
+                break;
+            }
+
+            case SDL_EVENT_WINDOW_FOCUS_LOST:
+                releaseAll();
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    void InputSystem::setButton(const Button button, const bool down)
+    {
+        PSYGINE_DEBUG_ASSERT(button < BUTTON_COUNT, "InputSystem::setButton: button out of range");
+        const std::size_t word = button >> 6;
+        const std::uint64_t bit = std::uint64_t{1} << (button & 63U);
+        if (((held_[word] & bit) != 0) == down)
+        {
+            return;
+        }
+
+        held_[word] ^= bit;
+        for (Consumer* consumer : {&tick_, &frame_})
+        {
+            (down ? consumer->pressed : consumer->released)[word] |= bit;
+        }
+    }
+
+    void InputSystem::setAxis(const Axis axis, const float value)
+    {
+        PSYGINE_DEBUG_ASSERT(axis < AXIS_COUNT, "InputSystem::setAxis: axis out of range");
+        if (IsRelative(axis))
+        {
+            addMotion(axis, value);
+        }
+        else
+        {
+            axes_[axis] = value;
+        }
+    }
+
+    void InputSystem::releaseAll()
+    {
+        for (std::size_t word = 0; word < BUTTON_WORDS; ++word)
+        {
+            for (std::uint64_t bits = held_[word]; bits != 0; bits &= bits - 1)
+            {
+                setButton(static_cast<Button>((word * 64) + static_cast<std::size_t>(std::countr_zero(bits))), false);
+            }
+        }
+    }
+
+    void InputSystem::startGamepadPolling(const std::uint32_t rate)
+    {
+        stopGamepadPolling();
+        poller_ = std::make_unique<GamepadPoller>(rate);
+
+        for (std::size_t pad = 0; pad < MAX_GAMEPADS; ++pad)
+        {
+            // The first sample is compared against the buttons the events left held.
+            padButtons_[pad] = 0;
+            for (int button = 0; button < SDL_GAMEPAD_BUTTON_COUNT; ++button)
+            {
+                const Button bit = GamepadButton(pad, static_cast<SDL_GamepadButton>(button));
+                if (((held_[bit >> 6] >> (bit & 63U)) & 1U) != 0)
+                {
+                    padButtons_[pad] |= std::uint32_t{1} << button;
+                }
+            }
+            if (gamepads_[pad].id != 0)
+            {
+                poller_->attach(pad, gamepads_[pad].id);
+            }
+        }
+    }
+
+    void InputSystem::stopGamepadPolling()
+    {
+        if (poller_ == nullptr)
+        {
+            return;
+        }
+        applySamples(utilities::time::types::TimePoint::max());
+        poller_.reset();
+    }
+
+    void InputSystem::beginTick(const utilities::time::types::TimePoint until)
+    {
+        applySamples(until);
+        tickSamples_.swap(pendingSamples_);
+        pendingSamples_.clear();
+        capture(tick_);
+    }
+
+    void InputSystem::beginTick()
+    {
+        beginTick(utilities::time::Now());
+    }
+
+    void InputSystem::beginFrame(const utilities::time::types::TimePoint until)
+    {
+        applySamples(until);
+        capture(frame_);
+    }
+
+    void InputSystem::beginFrame()
+    {
+        beginFrame(utilities::time::Now());
+    }
+
+    void InputSystem::setActions(ActionMap actions)
+    {
+        actions_ = std::move(actions);
+        actions_.compile();
+        tick_.actions = {};
+        frame_.actions = {};
+    }
+
+    void InputSystem::addMotion(const Axis axis, const float amount)
+    {
+        tick_.motion[axis - AXIS_MOUSE_DELTA_X] += amount;
+        frame_.motion[axis - AXIS_MOUSE_DELTA_X] += amount;
+    }
+
+    void InputSystem::applySamples(const utilities::time::types::TimePoint until)
+    {
+        if (poller_ == nullptr)
+        {
+            return;
+        }
+
+        for (const GamepadSample* sample = poller_->front(); sample != nullptr && sample->time <= until;
+             sample = poller_->front())
+        {
+            const std::size_t pad = sample->pad;
+            // Samples queued before a disconnect are dropped, even if another gamepad took the slot since.
+            if (gamepads_[pad].id == sample->id)
+            {
+                for (std::uint32_t changed = padButtons_[pad] ^ sample->buttons; changed != 0; changed &= changed - 1)
+                {
+                    const int button = std::countr_zero(changed);
+                    setButton(GamepadButton(pad, static_cast<SDL_GamepadButton>(button)),
+                              ((sample->buttons >> button) & 1U) != 0);
+                }
+                padButtons_[pad] = sample->buttons;
+
+                for (std::size_t axis = 0; axis < sample->axes.size(); ++axis)
+                {
+                    axes_[GamepadAxis(pad, static_cast<SDL_GamepadAxis>(axis))] = GamepadAxisValue(sample->axes[axis]);
+                }
+                pendingSamples_.push_back(*sample);
+            }
+            poller_->pop();
+        }
+    }
+
+    void InputSystem::capture(Consumer& consumer)
+    {
+        InputSnapshot& snapshot = consumer.snapshot;
+        snapshot.held_ = held_;
+        snapshot.pressed_ = std::exchange(consumer.pressed, {});
+        snapshot.released_ = std::exchange(consumer.released, {});
+        snapshot.axes_ = axes_;
+        for (std::size_t i = 0; i < consumer.motion.size(); ++i)
+        {
+            snapshot.axes_[AXIS_MOUSE_DELTA_X + i] = std::exchange(consumer.motion[i], 0.0F);
+        }
+
+        if (actions_.size() != 0)
+        {
+            actions_.evaluate(snapshot, consumer.actions);
+        }
+    }
+
+    void InputSystem::connect(const SDL_JoystickID id)
+    {
+        if (slotOf(id) < MAX_GAMEPADS)
+        {
+            return;
+        }
+        const auto free = std::ranges::find(gamepads_, SDL_JoystickID{0}, &GamepadSlot::id);
+        if (free == gamepads_.end())
+        {
+            return;
+        }
+
+        core::SdlGamepadPtr handle = core::sdl_raii::OpenGamepad(id);
+        if (handle == nullptr)
+        {
+            return;
+        }
+        free->id = id;
+        free->handle = std::move(handle);
+
+        if (poller_ != nullptr)
+        {
+            const auto pad = static_cast<std::size_t>(free - gamepads_.begin());
+            padButtons_[pad] = 0;
+            poller_->attach(pad, id);
+        }
+    }
+
+    void InputSystem::disconnect(const SDL_JoystickID id)
+    {
+        const std::size_t pad = slotOf(id);
+        if (pad >= MAX_GAMEPADS)
+        {
+            return;
+        }
+        if (poller_ != nullptr)
+        {
+            poller_->detach(pad);
+        }
+
+        // Buttons held on the lost gamepad are released, so they report their release edge.
+        for (int button = 0; button < SDL_GAMEPAD_BUTTON_COUNT; ++button)
+        {
+            setButton(GamepadButton(pad, static_cast<SDL_GamepadButton>(button)), false);
+        }
+        for (int axis = 0; axis < SDL_GAMEPAD_AXIS_COUNT; ++axis)
+        {
+            axes_[GamepadAxis(pad, static_cast<SDL_GamepadAxis>(axis))] = 0.0F;
+        }
+        gamepads_[pad] = {};
+    }
+
+    std::size_t InputSystem::slotOf(const SDL_JoystickID id) const
+    {
+        if (id == 0)
+        {
+            return MAX_GAMEPADS;
+        }
+        const auto it = std::ranges::find(gamepads_, id, &GamepadSlot::id);
+        return static_cast<std::size_t>(it - gamepads_.begin());
+    }
+}
@@ -0,0 +1,197 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#ifndef PSYGINE_INPUT_SYSTEM_HPP
+#define PSYGINE_INPUT_SYSTEM_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include <SDL3/SDL_joystick.h>
+
+#include "action_map.hpp"
+#include "gamepad_poller.hpp"
+#include "input_snapshot.hpp"
+#include "psygine/core/sdl_raii.hpp"
+#include "psygine/utilities/time.hpp"
+
+// ReSharper disable once CppInconsistentNaming
+union SDL_Event;
+
+namespace psygine::input
+{
+    /**
+     * @brief Accumulates keyboard, mouse and gamepad events into bitsets and axis arrays, and snapshots
+     * them once per fixed tick and once per frame.
+     *
+     * Events arrive once per frame, while zero or more fixed ticks run after them. Edges and relative
+     * motion are therefore kept per consumer until it takes a snapshot: the first tick after an event
+     * sees it, later ticks in the same frame see only the held state, and a frame without ticks passes
+     * its edges on to the next tick. `Runtime` feeds it every event and takes the snapshots before
+     * `onFixedUpdate` and `onUpdate`.
+     *
+     * Gamepads are opened as they connect and take the lowest free slot below `MAX_GAMEPADS`. While
+     * gamepad polling runs, their buttons and axes come from a `GamepadPoller` instead of events: each
+     * snapshot applies the samples taken up to its time, and `tickSamples` lists them for gameplay code
+     * that wants the timing within the tick.
+     */
+    class InputSystem
+    {
+    public:
+        InputSystem() = default;
+
+        /**
+         * @brief Records an SDL event; events that are not input are ignored.
+         */
+        void handleEvent(const SDL_Event& event);
+
+        /**
+         * @brief Sets a button directly, as events do; for synthetic input and replays.
+         */
+        void setButton(Button button, bool down);
+
+        /**
+         * @brief Sets an absolute axis directly, as events do; for synthetic input and replays.
+         */
+        void setAxis(Axis axis, float value);
+
+        /**
+         * @brief Releases every held button, for when the window loses focus and the matching release
+         * events would never arrive.
+         */
+        void releaseAll();
+
+        /**
+         * @brief Polls gamepads on a dedicated thread `rate` times per second instead of reading their
+         * events; gamepads already connected are carried over.
+         */
+        void startGamepadPolling(std::uint32_t rate);
+
+        /**
+         * @brief Applies every queued sample, stops the polling thread and goes back to gamepad events.
+         */
+        void stopGamepadPolling();
+
+        [[nodiscard]] bool pollingGamepads() const
+        {
+            return poller_ != nullptr;
+        }
+
+        /**
+         * @brief Takes the snapshot for the next fixed tick and evaluates the actions against it.
+         *
+         * @param until Gamepad samples polled up to this time are applied first.
+         */
+        void beginTick(utilities::time::types::TimePoint until);
+
+        /**
+         * @brief Takes the snapshot for the next fixed tick with the gamepad samples polled until now.
+         */
+        void beginTick();
+
+        /**
+         * @brief Takes the snapshot for the next frame and evaluates the actions against it.
+         *
+         * @param until Gamepad samples polled up to this time are applied first; a frame that is not
+         * followed by a tick leaves them to the next tick's `tickSamples`.
+         */
+        void beginFrame(utilities::time::types::TimePoint until);
+
+        /**
+         * @brief Takes the snapshot for the next frame with the gamepad samples polled until now.
+         */
+        void beginFrame();
+
+        [[nodiscard]] const InputSnapshot& tick() const
+        {
+            return tick_.snapshot;
+        }
+
+        [[nodiscard]] const InputSnapshot& frame() const
+        {
+            return frame_.snapshot;
+        }
+
+        /**
+         * @brief The gamepad samples applied since the previous tick, oldest first; empty unless gamepad
+         * polling runs.
+         */
+        [[nodiscard]] std::span<const GamepadSample> tickSamples() const
+        {
+            return tickSamples_;
+        }
+
+        [[nodiscard]] const ActionState& tickActions() const
+        {
+            return tick_.actions;
+        }
+
+        [[nodiscard]] const ActionState& frameActions() const
+        {
+            return frame_.actions;
+        }
+
+        /**
+         * @brief Replaces the action map and compiles it; actions are evaluated from the next snapshot on.
+         */
+        void setActions(ActionMap actions);
+
+        [[nodiscard]] const ActionMap& actions() const
+        {
+            return actions_;
+        }
+
+        /**
+         * @brief The joystick id of the gamepad in `pad`, or 0 when the slot is free.
+         */
+        [[nodiscard]] SDL_JoystickID gamepad(const std::size_t pad) const
+        {
+            return gamepads_[pad].id;
+        }
+
+    private:
+        struct Consumer
+        {
+            // Edges and relative motion seen since this consumer's last snapshot.
+            InputSnapshot::Words pressed{};
+            InputSnapshot::Words released{};
+            std::array<float, 4> motion{};
+
+            InputSnapshot snapshot;
+            ActionState actions;
+        };
+
+        struct GamepadSlot
+        {
+            SDL_JoystickID id = 0;
+            core::SdlGamepadPtr handle{nullptr, &SDL_CloseGamepad};
+        };
+
+        void addMotion(Axis axis, float amount);
+        void applySamples(utilities::time::types::TimePoint until);
+        void capture(Consumer& consumer);
+        void connect(SDL_JoystickID id);
+        void disconnect(SDL_JoystickID id);
+        [[nodiscard]] std::size_t slotOf(SDL_JoystickID id) const;
+
+        InputSnapshot::Words held_{};
+        std::array<float, AXIS_COUNT> axes_{};
+        Consumer tick_;
+        Consumer frame_;
+        ActionMap actions_;
+        std::array<GamepadSlot, MAX_GAMEPADS> gamepads_{};
+
+        // Polled gamepads: the buttons of each slot as last applied, and the samples applied since the
+        // last tick and during it.
+        std::unique_ptr<GamepadPoller> poller_;
+        std::array<std::uint32_t, MAX_GAMEPADS> padButtons_{};
+        std::vector<GamepadSample> pendingSamples_;
+        std::vector<GamepadSample> tickSamples_;
+    };
+}
+
+#endif //PSYGINE_INPUT_SYSTEM_HPP
@@ -0,0 +1,101 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#ifndef PSYGINE_AABB_HPP
+#define PSYGINE_AABB_HPP
+
+#include "vector.hpp"
+
+namespace psygine::math
+{
+    /**
+     * @brief Axis-aligned bounding box spanning [min, max] on every axis.
+     *
+     * @tparam V The corner type, `Vector2<T>` or `Vector3<T>`.
+     */
+    template <typename V>
+    struct Aabb
+    {
+        V min{};
+        V max{};
+
+        friend constexpr bool operator==(const Aabb& lhs, const Aabb& rhs) = default;
+    };
+
+    using Aabb2 = Aabb<Vec2>;
+    using Aabb3 = Aabb<Vec3>;
+
+    template <typename V>
+    constexpr Aabb<V> Merge(const Aabb<V>& a, const Aabb<V>& b)
+    {
+        return {Min(a.min, b.min), Max(a.max, b.max)};
+    }
+
+    /**
+     * @brief The box grown by `amount` on every side.
+     */
+    template <typename V, typename T>
+    constexpr Aabb<V> Expand(const Aabb<V>& box, const T amount)
+    {
+        V offset{};
+        if constexpr (requires { offset.z; })
+        {
+            offset = {amount, amount, amount};
+        }
+        else
+        {
+            offset = {amount, amount};
+        }
+        return {box.min - offset, box.max + offset};
+    }
+
+    template <typename V>
+    constexpr V Center(const Aabb<V>& box)
+    {
+        return (box.min + box.max) * decltype(box.min.x){0.5};
+    }
+
+    template <typename T>
+    constexpr bool Overlaps(const Aabb<Vector2<T>>& a, const Aabb<Vector2<T>>& b)
+    {
+        return a.min.x <= b.max.x && b.min.x <= a.max.x && a.min.y <= b.max.y && b.min.y <= a.max.y;
+    }
+
+    template <typename T>
+    constexpr bool Overlaps(const Aabb<Vector3<T>>& a, const Aabb<Vector3<T>>& b)
+    {
+        return a.min.x <= b.max.x && b.min.x <= a.max.x && a.min.y <= b.max.y && b.min.y <= a.max.y &&
+               a.min.z <= b.max.z && b.min.z <= a.max.z;
+    }
+
+    /**
+     * @brief Whether `inner` lies entirely inside `outer`.
+     */
+    template <typename V>
+    constexpr bool Contains(const Aabb<V>& outer, const Aabb<V>& inner)
+    {
+        return Min(outer.min, inner.min) == outer.min && Max(outer.max, inner.max) == outer.max;
+    }
+
+    /**
+     * @brief The perimeter of a 2D box; the surface-area-heuristic cost of a bounding rectangle.
+     */
+    template <typename T>
+    constexpr T SurfaceArea(const Aabb<Vector2<T>>& box)
+    {
+        const Vector2<T> d = box.max - box.min;
+        return T{2} * (d.x + d.y);
+    }
+
+    /**
+     * @brief The surface area of a 3D box.
+     */
+    template <typename T>
+    constexpr T SurfaceArea(const Aabb<Vector3<T>>& box)
+    {
+        const Vector3<T> d = box.max - box.min;
+        return T{2} * ((d.x * d.y) + (d.y * d.z) + (d.z * d.x));
+    }
+}
+
+#endif //PSYGINE_AABB_HPP
@@ -0,0 +1,246 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#include "fixed.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <limits>
+#include <type_traits>
+
+#include "psygine/debug/assert.hpp"
+#include "psygine/utilities/simd.hpp"
+
+namespace
+{
+    namespace simd = psygine::utilities::simd;
+    using psygine::math::Fixed16;
+
+    constexpr std::size_t W = simd::NATIVE_WIDTH;
+    using Vf = simd::Float<W>;
+    using Vi = simd::Int<W>;
+
+    // Q2.30: two integer bits cover +-pi, thirty fraction bits match the CORDIC iteration count.
+    constexpr int CORDIC_ITERATIONS = 30;
+    constexpr std::int64_t PI = 3373259426;
+    constexpr std::int64_t HALF_PI = 1686629713;
+    constexpr std::int64_t TWO_PI = 6746518852;
+
+    // atan(2^-i) in Q2.30.
+    constexpr std::array<std::int64_t, CORDIC_ITERATIONS> ATAN_TABLE{
+        843314857, 497837829, 263043837, 133525159, 67021687, 33543516, 16775851, 8388437, 4194283, 2097149,
+        1048576,   524288,    262144,    131072,    65536,    32768,    16384,    8192,    4096,    2048,
+        1024,      512,       256,       128,       64,       32,       16,       8,       4,       2};
+
+    // The product of cos(atan(2^-i)) over all iterations in Q2.30; starting the rotation at this length
+    // cancels the growth of the vector.
+    constexpr std::int64_t CORDIC_GAIN = 652032874;
+
+    static_assert(sizeof(Fixed16) == sizeof(std::int32_t) && std::is_standard_layout_v<Fixed16>,
+                  "Fixed16 arrays are processed as arrays of their raw values");
+
+    // `value` when `sign` is 0, `-value` when it is -1.
+    constexpr std::int64_t Negate(const std::int64_t value, const std::int64_t sign)
+    {
+        return (value ^ sign) - sign;
+    }
+
+    const std::int32_t* RawOf(const Fixed16* values)
+    {
+        return reinterpret_cast<const std::int32_t*>(values);
+    }
+
+    std::int32_t* RawOf(Fixed16* values)
+    {
+        return reinterpret_cast<std::int32_t*>(values);
+    }
+}
+
+namespace psygine::math
+{
+    Vector2<std::int64_t> detail::CordicRotate(std::int64_t angle)
+    {
+        angle %= TWO_PI;
+        if (angle > PI)
+        {
+            angle -= TWO_PI;
+        }
+        else if (angle < -PI)
+        {
+            angle += TWO_PI;
+        }
+
+        // Folds into [-pi/2, pi/2], where the rotation converges; the sine is unchanged by the fold.
+        std::int64_t cosineSign = 1;
+        if (angle > HALF_PI)
+        {
+            angle = PI - angle;
+            cosineSign = -1;
+        }
+        else if (angle < -HALF_PI)
+        {
+            angle = -PI - angle;
+            cosineSign = -1;
+        }
+
+        std::int64_t x = CORDIC_GAIN;
+        std::int64_t y = 0;
+        for (int i = 0; i < CORDIC_ITERATIONS; ++i)
+        {
+            // Rotates toward the remaining angle; the direction is data-dependent, so it is applied
+            // without a branch.
+            const std::int64_t sign = angle >> 63;
+            const std::int64_t dx = Negate(y >> i, sign);
+            const std::int64_t dy = Negate(x >> i, sign);
+            x -= dx;
+            y += dy;
+            angle -= Negate(ATAN_TABLE[static_cast<std::size_t>(i)], sign);
+        }
+        return {x * cosineSign, y};
+    }
+
+    std::int64_t detail::CordicAngle(std::int64_t y, std::int64_t x)
+    {
+        // The axes are exact, so headings along them compare equal and +pi is kept on the branch cut.
+        if (y == 0)
+        {
+            return x < 0 ? PI : 0;
+        }
+        if (x == 0)
+        {
+            return y > 0 ? HALF_PI : -HALF_PI;
+        }
+
+        // Scales both onto 30 bits: the angle only depends on their ratio, and the rotation grows the
+        // vector by about 1.65 without overflowing.
+        const auto magnitude = [](const std::int64_t v)
+        { return v < 0 ? 0 - static_cast<std::uint64_t>(v) : static_cast<std::uint64_t>(v); };
+        const auto width = static_cast<int>(std::bit_width(std::max(magnitude(x), magnitude(y))));
+        if (width > 30)
+        {
+            x >>= width - 30;
+            y >>= width - 30;
+        }
+        else
+        {
+            x *= std::int64_t{1} << (30 - width);
+            y *= std::int64_t{1} << (30 - width);
+        }
+
+        // Turns the left half-plane over so the rotation starts within pi/2 of zero.
+        std::int64_t angle = 0;
+        if (x < 0)
+        {
+            angle = y >= 0 ? PI : -PI;
+            x = -x;
+            y = -y;
+        }
+
+        for (int i = 0; i < CORDIC_ITERATIONS; ++i)
+        {
+            // Rotates toward the x axis, accumulating the angle turned.
+            const std::int64_t sign = y > 0 ? 0 : -1;
+            const std::int64_t dx = Negate(y >> i, sign);
+            const std::int64_t dy = Negate(x >> i, sign);
+            x += dx;
+            y -= dy;
+            angle += Negate(ATAN_TABLE[static_cast<std::size_t>(i)], sign);
+        }
+
+        // The flip already picked the half-plane, so rounding that carries the angle past the branch cut
+        // is clamped rather than wrapped to the other side.
+        return std::clamp(angle, -PI + 1, PI);
+    }
+
+    void ToFixed(const std::span<const float> values, const std::span<Fixed16> out)
+    {
+        PSYGINE_DEBUG_ASSERT(out.size() >= values.size(), "ToFixed: output is smaller than the input");
+        const std::size_t count = values.size();
+        std::int32_t* result = RawOf(out.data());
+
+        const Vf scale(65536.0F);
+        const Vf upper(2147483648.0F);
+        const Vf lower(-2147483648.0F);
+        const Vf half(0.5F);
+        const Vf minusHalf(-0.5F);
+        std::size_t i = 0;
+        for (; i + W <= count; i += W)
+        {
+            const Vf scaled = simd::Load(values.data() + i, Vf{}) * scale;
+            const Vi above = scaled >= upper;
+            const Vi below = scaled < lower;
+            // NaN fails both range tests as well as this one and converts as zero.
+            const Vf inRange = simd::Select((scaled >= lower) & (scaled < upper), scaled, Vf(0.0F));
+            Vi whole = simd::ToInt(inRange);
+            const Vf fraction = inRange - simd::ToFloat(whole);
+            whole = whole - (fraction >= half) + (fraction <= minusHalf);
+            whole = simd::Select(above, Vi(std::numeric_limits<std::int32_t>::max()), whole);
+            whole = simd::Select(below, Vi(std::numeric_limits<std::int32_t>::min()), whole);
+            simd::Store(result + i, whole);
+        }
+        for (; i < count; ++i)
+        {
+            out[i] = Fixed16::FromFloat(values[i]);
+        }
+    }
+
+    void ToFloat(const std::span<const Fixed16> values, const std::span<float> out)
+    {
+        PSYGINE_DEBUG_ASSERT(out.size() >= values.size(), "ToFloat: output is smaller than the input");
+        const std::size_t count = values.size();
+        const std::int32_t* raw = RawOf(values.data());
+
+        const Vf scale(1.0F / 65536.0F);
+        std::size_t i = 0;
+        for (; i + W <= count; i += W)
+        {
+            simd::Store(out.data() + i, simd::ToFloat(simd::Load(raw + i, Vi{})) * scale);
+        }
+        for (; i < count; ++i)
+        {
+            out[i] = values[i].toFloat();
+        }
+    }
+
+    void Multiply(const std::span<const Fixed16> a, const std::span<const Fixed16> b, const std::span<Fixed16> out)
+    {
+        PSYGINE_DEBUG_ASSERT(b.size() >= a.size() && out.size() >= a.size(), "Multiply: spans differ in size");
+        const std::size_t count = a.size();
+        const std::int32_t* lhs = RawOf(a.data());
+        const std::int32_t* rhs = RawOf(b.data());
+        std::int32_t* result = RawOf(out.data());
+
+        std::size_t i = 0;
+        for (; i + W <= count; i += W)
+        {
+            const Vi product = simd::MultiplyRoundShift(simd::Load(lhs + i, Vi{}), simd::Load(rhs + i, Vi{}),
+                                                        Fixed16::FRACTION_BITS);
+            simd::Store(result + i, product);
+        }
+        for (; i < count; ++i)
+        {
+            out[i] = a[i] * b[i];
+        }
+    }
+
+    void MultiplyAdd(const std::span<const Fixed16> values, const Fixed16 scale, const std::span<Fixed16> accumulator)
+    {
+        PSYGINE_DEBUG_ASSERT(accumulator.size() >= values.size(), "MultiplyAdd: accumulator is smaller than the input");
+        const std::size_t count = values.size();
+        const std::int32_t* raw = RawOf(values.data());
+        std::int32_t* result = RawOf(accumulator.data());
+
+        const Vi factor(scale.raw());
+        std::size_t i = 0;
+        for (; i + W <= count; i += W)
+        {
+            const Vi product = simd::MultiplyRoundShift(simd::Load(raw + i, Vi{}), factor, Fixed16::FRACTION_BITS);
+            simd::Store(result + i, simd::Load(result + i, Vi{}) + product);
+        }
+        for (; i < count; ++i)
+        {
+            accumulator[i] += values[i] * scale;
+        }
+    }
+}
@@ -0,0 +1,544 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#ifndef PSYGINE_FIXED_HPP
+#define PSYGINE_FIXED_HPP
+
+#include <cmath>
+#include <compare>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <type_traits>
+
+#include "vector.hpp"
+#include "psygine/debug/assert.hpp"
+
+namespace psygine::math
+{
+    namespace detail
+    {
+        struct UInt128
+        {
+            std::uint64_t hi = 0;
+            std::uint64_t lo = 0;
+        };
+
+        /**
+         * @brief The full 128-bit product of two 64-bit words.
+         */
+        constexpr UInt128 MultiplyWide(const std::uint64_t a, const std::uint64_t b)
+        {
+#if defined(__SIZEOF_INT128__)
+            __extension__ using Native = unsigned __int128;
+            const Native product = static_cast<Native>(a) * b;
+            return {static_cast<std::uint64_t>(product >> 64), static_cast<std::uint64_t>(product)};
+#else
+            const std::uint64_t aLo = a & 0xFFFFFFFFU;
+            const std::uint64_t aHi = a >> 32;
+            const std::uint64_t bLo = b & 0xFFFFFFFFU;
+            const std::uint64_t bHi = b >> 32;
+            const std::uint64_t low = aLo * bLo;
+            const std::uint64_t middle = (aHi * bLo) + (low >> 32);
+            const std::uint64_t cross = (aLo * bHi) + (middle & 0xFFFFFFFFU);
+            return {(aHi * bHi) + (middle >> 32) + (cross >> 32), (cross << 32) | (low & 0xFFFFFFFFU)};
+#endif
+        }
+
+        /**
+         * @brief `(a * b + 2^(shift - 1)) >> shift` on the exact 128-bit product, keeping the low 64 bits.
+         */
+        constexpr std::int64_t MultiplyRoundShift(const std::int64_t a, const std::int64_t b, const int shift)
+        {
+            const auto ua = static_cast<std::uint64_t>(a);
+            const auto ub = static_cast<std::uint64_t>(b);
+            UInt128 product = MultiplyWide(ua, ub);
+            // The unsigned product of the two's complement words, corrected to the signed product.
+            product.hi -= (a < 0 ? ub : 0) + (b < 0 ? ua : 0);
+            const std::uint64_t lo = product.lo + (std::uint64_t{1} << (shift - 1));
+            product.hi += lo < product.lo ? 1 : 0;
+            return static_cast<std::int64_t>((product.hi << (64 - shift)) | (lo >> shift));
+        }
+
+        /**
+         * @brief `(a << shift) / b` rounded toward zero on the exact 128-bit dividend, keeping the low 64
+         * bits. `b` is not zero and `shift` is in [1, 63].
+         */
+        constexpr std::int64_t ShiftDivide(const std::int64_t a, const std::int64_t b, const int shift)
+        {
+#if defined(__SIZEOF_INT128__)
+            __extension__ using Native = __int128;
+            return static_cast<std::int64_t>((static_cast<Native>(a) * (std::int64_t{1} << shift)) / b);
+#else
+            const std::uint64_t n = a < 0 ? 0 - static_cast<std::uint64_t>(a) : static_cast<std::uint64_t>(a);
+            const std::uint64_t d = b < 0 ? 0 - static_cast<std::uint64_t>(b) : static_cast<std::uint64_t>(b);
+            // Long division of n * 2^shift; the high word only contributes its remainder to the low 64
+            // quotient bits, and the remainder stays below d <= 2^63, so doubling it cannot overflow.
+            std::uint64_t remainder = (n >> (64 - shift)) % d;
+            const std::uint64_t low = n << shift;
+            std::uint64_t quotient = 0;
+            for (int bit = 63; bit >= 0; --bit)
+            {
+                remainder = (remainder << 1) | ((low >> bit) & 1U);
+                quotient <<= 1;
+                if (remainder >= d)
+                {
+                    remainder -= d;
+                    quotient |= 1U;
+                }
+            }
+            return static_cast<std::int64_t>((a < 0) != (b < 0) ? 0 - quotient : quotient);
+#endif
+        }
+
+        /**
+         * @brief The square root of `n`, rounded to nearest.
+         */
+        inline std::uint64_t SquareRoot(const UInt128 n)
+        {
+            // The double estimate is within a few units; the integer correction makes the result exact,
+            // so it does not depend on how the platform rounds.
+            auto root = static_cast<std::uint64_t>(
+                std::sqrt((static_cast<double>(n.hi) * 18446744073709551616.0) + static_cast<double>(n.lo)));
+            const auto above = [&n](const std::uint64_t r)
+            {
+                const UInt128 square = MultiplyWide(r, r);
+                return square.hi > n.hi || (square.hi == n.hi && square.lo > n.lo);
+            };
+            while (above(root))
+            {
+                --root;
+            }
+            while (!above(root + 1))
+            {
+                ++root;
+            }
+            // n - root^2 <= 2 * root fits the low word.
+            const std::uint64_t remainder = n.lo - MultiplyWide(root, root).lo;
+            return remainder > root ? root + 1 : root;
+        }
+
+        /**
+         * @brief `(cos, sin)` of an angle in Q2.30 radians, in Q2.30.
+         */
+        Vector2<std::int64_t> CordicRotate(std::int64_t angle);
+
+        /**
+         * @brief The angle of `(x, y)` in Q2.30 radians, in (-pi, pi]; zero for the zero vector.
+         */
+        std::int64_t CordicAngle(std::int64_t y, std::int64_t x);
+
+        constexpr std::int64_t RoundShiftRight(const std::int64_t value, const int shift)
+        {
+            return shift == 0 ? value : (value >> shift) + ((value >> (shift - 1)) & 1);
+        }
+    } // namespace detail
+
+    /**
+     * @brief A signed fixed-point number: `Raw` holds the value times 2^FractionBits.
+     *
+     * Every operation is integer arithmetic with one defined result, so a simulation stepped in fixed
+     * point stays bit-identical across compilers, CPUs and optimization levels, which floats do not
+     * guarantee. Addition and subtraction wrap on overflow; multiplication rounds to nearest on the
+     * exact double-width product, division rounds toward zero, and the conversions from floating point
+     * round halves away from zero and saturate. Use the `Fixed16` (Q16.16) and `Fixed32` (Q32.32)
+     * aliases.
+     */
+    template <std::signed_integral Raw, int FractionBits>
+        requires(sizeof(Raw) == 4 || sizeof(Raw) == 8) && (FractionBits > 0) &&
+        (FractionBits < std::numeric_limits<Raw>::digits)
+    class Fixed
+    {
+    public:
+        using RawType = Raw;
+        static constexpr int FRACTION_BITS = FractionBits;
+
+        constexpr Fixed() = default;
+
+        [[nodiscard]] static constexpr Fixed FromRaw(const Raw raw)
+        {
+            Fixed result;
+            result.raw_ = raw;
+            return result;
+        }
+
+        /**
+         * @brief The integer `value`, wrapping if it is out of range.
+         */
+        [[nodiscard]] static constexpr Fixed FromInt(const Raw value)
+        {
+            return FromRaw(static_cast<Raw>(static_cast<Unsigned>(value) << FractionBits));
+        }
+
+        /**
+         * @brief The nearest fixed-point value, halves away from zero; out-of-range values saturate and
+         * NaN becomes zero.
+         */
+        [[nodiscard]] static constexpr Fixed FromDouble(const double value)
+        {
+            const double scaled = value * ONE;
+            if (scaled != scaled)
+            {
+                return {};
+            }
+            if (scaled >= ROUNDS_ABOVE)
+            {
+                return Highest();
+            }
+            if (scaled <= ROUNDS_BELOW)
+            {
+                return Lowest();
+            }
+            const auto whole = static_cast<Raw>(scaled);
+            const double fraction = scaled - static_cast<double>(whole);
+            return FromRaw(static_cast<Raw>(whole + (fraction >= 0.5 ? 1 : 0) - (fraction <= -0.5 ? 1 : 0)));
+        }
+
+        [[nodiscard]] static constexpr Fixed FromFloat(const float value)
+        {
+            return FromDouble(static_cast<double>(value));
+        }
+
+        [[nodiscard]] static constexpr Fixed Highest()
+        {
+            return FromRaw(std::numeric_limits<Raw>::max());
+        }
+
+        [[nodiscard]] static constexpr Fixed Lowest()
+        {
+            return FromRaw(std::numeric_limits<Raw>::min());
+        }
+
+        /**
+         * @brief The smallest positive value, 2^-FractionBits.
+         */
+        [[nodiscard]] static constexpr Fixed Epsilon()
+        {
+            return FromRaw(1);
+        }
+
+        [[nodiscard]] static constexpr Fixed Pi()
+        {
+            return FromDouble(3.14159265358979323846);
+        }
+
+        [[nodiscard]] constexpr Raw raw() const
+        {
+            return raw_;
+        }
+
+        /**
+         * @brief The integer part, rounded toward negative infinity.
+         */
+        [[nodiscard]] constexpr Raw toInt() const
+        {
+            return raw_ >> FractionBits;
+        }
+
+        [[nodiscard]] constexpr float toFloat() const
+        {
+            return static_cast<float>(raw_) * static_cast<float>(1.0 / ONE);
+        }
+
+        [[nodiscard]] constexpr double toDouble() const
+        {
+            return static_cast<double>(raw_) * (1.0 / ONE);
+        }
+
+        constexpr Fixed& operator+=(const Fixed other)
+        {
+            raw_ = static_cast<Raw>(static_cast<Unsigned>(raw_) + static_cast<Unsigned>(other.raw_));
+            return *this;
+        }
+
+        constexpr Fixed& operator-=(const Fixed other)
+        {
+            raw_ = static_cast<Raw>(static_cast<Unsigned>(raw_) - static_cast<Unsigned>(other.raw_));
+            return *this;
+        }
+
+        constexpr Fixed& operator*=(const Fixed other)
+        {
+            if constexpr (sizeof(Raw) == 4)
+            {
+                const std::int64_t product = std::int64_t{raw_} * other.raw_;
+                raw_ = static_cast<Raw>((product + (std::int64_t{1} << (FractionBits - 1))) >> FractionBits);
+            }
+            else
+            {
+                raw_ = detail::MultiplyRoundShift(raw_, other.raw_, FractionBits);
+            }
+            return *this;
+        }
+
+        /**
+         * @brief Divides, rounding toward zero. Dividing by zero saturates toward the sign of the dividend.
+         */
+        constexpr Fixed& operator/=(const Fixed other)
+        {
+            if (other.raw_ == 0)
+            {
+                *this = raw_ < 0 ? Lowest() : Highest();
+            }
+            else if constexpr (sizeof(Raw) == 4)
+            {
+                raw_ = static_cast<Raw>((std::int64_t{raw_} * (std::int64_t{1} << FractionBits)) / other.raw_);
+            }
+            else
+            {
+                raw_ = detail::ShiftDivide(raw_, other.raw_, FractionBits);
+            }
+            return *this;
+        }
+
+        friend constexpr Fixed operator+(Fixed lhs, const Fixed rhs)
+        {
+            return lhs += rhs;
+        }
+
+        friend constexpr Fixed operator-(Fixed lhs, const Fixed rhs)
+        {
+            return lhs -= rhs;
+        }
+
+        friend constexpr Fixed operator*(Fixed lhs, const Fixed rhs)
+        {
+            return lhs *= rhs;
+        }
+
+        friend constexpr Fixed operator/(Fixed lhs, const Fixed rhs)
+        {
+            return lhs /= rhs;
+        }
+
+        friend constexpr Fixed operator-(const Fixed value)
+        {
+            return FromRaw(static_cast<Raw>(Unsigned{0} - static_cast<Unsigned>(value.raw_)));
+        }
+
+        friend constexpr bool operator==(Fixed lhs, Fixed rhs) = default;
+        friend constexpr auto operator<=>(Fixed lhs, Fixed rhs) = default;
+
+    private:
+        using Unsigned = std::make_unsigned_t<Raw>;
+
+        // 2^FractionBits and the lowest raw value; both are exact in a double.
+        static constexpr double ONE = static_cast<double>(std::uint64_t{1} << FractionBits);
+        // The scaled values that round past the raw range. For 64-bit raws, no double lies between the
+        // limit and the half step beyond it, and these round to +-2^63.
+        static constexpr double ROUNDS_ABOVE = static_cast<double>(std::numeric_limits<Raw>::max()) + 0.5;
+        static constexpr double ROUNDS_BELOW = static_cast<double>(std::numeric_limits<Raw>::min()) - 0.5;
+
+        Raw raw_ = 0;
+    };
+
+    using Fixed16 = Fixed<std::int32_t, 16>;
+    using Fixed32 = Fixed<std::int64_t, 32>;
+
+    using Vec2x16 = Vector2<Fixed16>;
+    using Vec3x16 = Vector3<Fixed16>;
+    using Vec2x32 = Vector2<Fixed32>;
+    using Vec3x32 = Vector3<Fixed32>;
+
+    template <typename T>
+    inline constexpr bool IS_FIXED = false;
+
+    template <std::signed_integral Raw, int FractionBits>
+    inline constexpr bool IS_FIXED<Fixed<Raw, FractionBits>> = true;
+
+    template <typename T>
+    concept FixedPoint = IS_FIXED<T>;
+
+    template <FixedPoint T>
+    constexpr T Abs(const T value)
+    {
+        return value.raw() < 0 ? -value : value;
+    }
+
+    template <FixedPoint T>
+    constexpr T Min(const T a, const T b)
+    {
+        return b < a ? b : a;
+    }
+
+    template <FixedPoint T>
+    constexpr T Max(const T a, const T b)
+    {
+        return a < b ? b : a;
+    }
+
+    template <FixedPoint T>
+    constexpr T Floor(const T value)
+    {
+        using Raw = typename T::RawType;
+        return T::FromRaw(static_cast<Raw>(value.raw() & ~((Raw{1} << T::FRACTION_BITS) - 1)));
+    }
+
+    template <FixedPoint T>
+    constexpr T Ceil(const T value)
+    {
+        return -Floor(-value);
+    }
+
+    /**
+     * @brief The square root rounded to nearest; zero for negative values.
+     */
+    template <FixedPoint T>
+    T Sqrt(const T value)
+    {
+        PSYGINE_DEBUG_ASSERT(value.raw() >= 0, "Sqrt: negative fixed-point value");
+        if (value.raw() <= 0)
+        {
+            return {};
+        }
+        // sqrt(raw / 2^F) * 2^F = sqrt(raw * 2^F).
+        const auto raw = static_cast<std::uint64_t>(value.raw());
+        const detail::UInt128 scaled{raw >> (64 - T::FRACTION_BITS), raw << T::FRACTION_BITS};
+        return T::FromRaw(static_cast<typename T::RawType>(detail::SquareRoot(scaled)));
+    }
+
+    /**
+     * @brief `Sqrt` under the name `Length` and `Normalize` find by argument-dependent lookup, so fixed
+     * vectors work with them.
+     */
+    template <FixedPoint T>
+    T sqrt(const T value) // NOLINT(*-identifier-naming) - must match std::sqrt for ADL
+    {
+        return Sqrt(value);
+    }
+
+    namespace detail
+    {
+        template <FixedPoint T>
+        constexpr std::int64_t ToQ30(const T value)
+        {
+            if constexpr (T::FRACTION_BITS <= 30)
+            {
+                return std::int64_t{value.raw()} * (std::int64_t{1} << (30 - T::FRACTION_BITS));
+            }
+            else
+            {
+                return RoundShiftRight(value.raw(), T::FRACTION_BITS - 30);
+            }
+        }
+
+        template <FixedPoint T>
+        constexpr T FromQ30(const std::int64_t value)
+        {
+            if constexpr (T::FRACTION_BITS <= 30)
+            {
+                using Raw = typename T::RawType;
+                return T::FromRaw(static_cast<Raw>(RoundShiftRight(value, 30 - T::FRACTION_BITS)));
+            }
+            else
+            {
+                return T::FromRaw(value * (std::int64_t{1} << (T::FRACTION_BITS - 30)));
+            }
+        }
+    } // namespace detail
+
+    /**
+     * @brief `(cos(angle), sin(angle))` for an angle in radians, by CORDIC on 30 fraction bits.
+     */
+    template <FixedPoint T>
+    Vector2<T> CosSin(const T angle)
+    {
+        const Vector2<std::int64_t> unit = detail::CordicRotate(detail::ToQ30(angle));
+        return {detail::FromQ30<T>(unit.x), detail::FromQ30<T>(unit.y)};
+    }
+
+    template <FixedPoint T>
+    T Sin(const T angle)
+    {
+        return detail::FromQ30<T>(detail::CordicRotate(detail::ToQ30(angle)).y);
+    }
+
+    template <FixedPoint T>
+    T Cos(const T angle)
+    {
+        return detail::FromQ30<T>(detail::CordicRotate(detail::ToQ30(angle)).x);
+    }
+
+    /**
+     * @brief The angle of `(x, y)` in radians, in (-pi, pi]; zero when both are zero.
+     */
+    template <FixedPoint T>
+    T Atan2(const T y, const T x)
+    {
+        const T angle = detail::FromQ30<T>(detail::CordicAngle(y.raw(), x.raw()));
+        // An angle just above -pi can round onto it; the next value up keeps it in range.
+        return angle.raw() <= -T::Pi().raw() ? T::FromRaw(-T::Pi().raw() + 1) : angle;
+    }
+
+    /**
+     * @brief Converts a float vector, such as a physics body or steering agent position, to fixed point.
+     */
+    template <FixedPoint T>
+    constexpr Vector2<T> ToFixed(const Vec2& v)
+    {
+        return {T::FromFloat(v.x), T::FromFloat(v.y)};
+    }
+
+    template <FixedPoint T>
+    constexpr Vec2 ToFloat(const Vector2<T>& v)
+    {
+        return {v.x.toFloat(), v.y.toFloat()};
+    }
+
+    /**
+     * @brief A uniform value in [min, max) built from the engine's raw output bits only.
+     *
+     * Unlike the `std` distributions, whose algorithms differ between standard libraries, the result
+     * depends only on the engine sequence, so seeded replays draw the same values everywhere. The
+     * engine must produce full 32-bit or 64-bit words, as `std::mt19937` and `std::mt19937_64` do.
+     */
+    template <FixedPoint T>
+    [[nodiscard]] T RandomFixed(auto& rng, const T min, const T max)
+    {
+        PSYGINE_DEBUG_ASSERT(min < max, "RandomFixed: empty range");
+        using Engine = std::remove_cvref_t<decltype(rng)>;
+        constexpr auto RANGE = static_cast<std::uint64_t>(Engine::max() - Engine::min());
+        static_assert(RANGE == 0xFFFFFFFFU || RANGE == std::numeric_limits<std::uint64_t>::max(),
+                      "RandomFixed needs an engine producing full 32-bit or 64-bit words");
+
+        auto bits = static_cast<std::uint64_t>(rng() - Engine::min());
+        if constexpr (RANGE == 0xFFFFFFFFU)
+        {
+            bits = (bits << 32) | static_cast<std::uint64_t>(rng() - Engine::min());
+        }
+        // Scales the 64 random bits onto the raw span, which never exceeds 2^64 - 1.
+        using Raw = typename T::RawType;
+        using Unsigned = std::make_unsigned_t<Raw>;
+        const auto span =
+            static_cast<std::uint64_t>(static_cast<Unsigned>(max.raw()) - static_cast<Unsigned>(min.raw()));
+        const auto offset = static_cast<Unsigned>(detail::MultiplyWide(bits, span).hi);
+        return T::FromRaw(static_cast<Raw>(static_cast<Unsigned>(min.raw()) + offset));
+    }
+
+    /**
+     * @brief Converts floats to Q16.16 exactly like `Fixed16::FromFloat`, a SIMD pack at a time.
+     *
+     * Together with `ToFloat` and the batch arithmetic below this lets float SoA state, such as the
+     * agent arrays of `steering::Flock`, cross into a fixed-point step and back.
+     */
+    void ToFixed(std::span<const float> values, std::span<Fixed16> out);
+
+    /**
+     * @brief Converts Q16.16 values to floats exactly like `Fixed16::toFloat`, a SIMD pack at a time.
+     */
+    void ToFloat(std::span<const Fixed16> values, std::span<float> out);
+
+    /**
+     * @brief `out[i] = a[i] * b[i]` with the same rounding as `Fixed16::operator*`, a SIMD pack at a time.
+     */
+    void Multiply(std::span<const Fixed16> a, std::span<const Fixed16> b, std::span<Fixed16> out);
+
+    /**
+     * @brief `accumulator[i] += values[i] * scale`, a SIMD pack at a time; integrates positions from
+     * velocities when `scale` is the step length.
+     */
+    void MultiplyAdd(std::span<const Fixed16> values, Fixed16 scale, std::span<Fixed16> accumulator);
+}
+
+#endif //PSYGINE_FIXED_HPP
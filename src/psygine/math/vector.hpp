@@ -0,0 +1,295 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#ifndef PSYGINE_VECTOR_HPP
+#define PSYGINE_VECTOR_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace psygine::math
+{
+    /**
+     * @brief Plain two-component vector.
+     *
+     * An aggregate with no invariants so it can live in arrays, be copied with `memcpy` and be
+     * brace-initialized. `T` may be any arithmetic-like type providing the usual operators.
+     *
+     * @tparam T The component type.
+     */
+    template <typename T>
+    struct Vector2
+    {
+        T x{};
+        T y{};
+
+        constexpr Vector2& operator+=(const Vector2& other)
+        {
+            x += other.x;
+            y += other.y;
+            return *this;
+        }
+
+        constexpr Vector2& operator-=(const Vector2& other)
+        {
+            x -= other.x;
+            y -= other.y;
+            return *this;
+        }
+
+        constexpr Vector2& operator*=(const T scalar)
+        {
+            x *= scalar;
+            y *= scalar;
+            return *this;
+        }
+
+        constexpr Vector2& operator/=(const T scalar)
+        {
+            x /= scalar;
+            y /= scalar;
+            return *this;
+        }
+
+        friend constexpr bool operator==(const Vector2& lhs, const Vector2& rhs) = default;
+    };
+
+    /**
+     * @brief Plain three-component vector.
+     *
+     * @tparam T The component type.
+     */
+    template <typename T>
+    struct Vector3
+    {
+        T x{};
+        T y{};
+        T z{};
+
+        constexpr Vector3& operator+=(const Vector3& other)
+        {
+            x += other.x;
+            y += other.y;
+            z += other.z;
+            return *this;
+        }
+
+        constexpr Vector3& operator-=(const Vector3& other)
+        {
+            x -= other.x;
+            y -= other.y;
+            z -= other.z;
+            return *this;
+        }
+
+        constexpr Vector3& operator*=(const T scalar)
+        {
+            x *= scalar;
+            y *= scalar;
+            z *= scalar;
+            return *this;
+        }
+
+        constexpr Vector3& operator/=(const T scalar)
+        {
+            x /= scalar;
+            y /= scalar;
+            z /= scalar;
+            return *this;
+        }
+
+        friend constexpr bool operator==(const Vector3& lhs, const Vector3& rhs) = default;
+    };
+
+    using Vec2 = Vector2<float>;
+    using Vec3 = Vector3<float>;
+    using Vec2d = Vector2<double>;
+    using Vec3d = Vector3<double>;
+    using Vec2i = Vector2<std::int32_t>;
+    using Vec3i = Vector3<std::int32_t>;
+
+    // ---------------- Vector2 ----------------
+
+    template <typename T>
+    constexpr Vector2<T> operator+(Vector2<T> lhs, const Vector2<T>& rhs)
+    {
+        return lhs += rhs;
+    }
+
+    template <typename T>
+    constexpr Vector2<T> operator-(Vector2<T> lhs, const Vector2<T>& rhs)
+    {
+        return lhs -= rhs;
+    }
+
+    template <typename T>
+    constexpr Vector2<T> operator-(const Vector2<T>& v)
+    {
+        return {-v.x, -v.y};
+    }
+
+    template <typename T>
+    constexpr Vector2<T> operator*(Vector2<T> v, const T scalar)
+    {
+        return v *= scalar;
+    }
+
+    template <typename T>
+    constexpr Vector2<T> operator*(const T scalar, Vector2<T> v)
+    {
+        return v *= scalar;
+    }
+
+    template <typename T>
+    constexpr Vector2<T> operator/(Vector2<T> v, const T scalar)
+    {
+        return v /= scalar;
+    }
+
+    template <typename T>
+    constexpr T Dot(const Vector2<T>& a, const Vector2<T>& b)
+    {
+        return (a.x * b.x) + (a.y * b.y);
+    }
+
+    /**
+     * @brief The z component of the 3D cross product of two vectors in the xy plane.
+     */
+    template <typename T>
+    constexpr T Cross(const Vector2<T>& a, const Vector2<T>& b)
+    {
+        return (a.x * b.y) - (a.y * b.x);
+    }
+
+    /**
+     * @brief The vector rotated 90 degrees counter-clockwise.
+     */
+    template <typename T>
+    constexpr Vector2<T> Perp(const Vector2<T>& v)
+    {
+        return {-v.y, v.x};
+    }
+
+    template <typename T>
+    constexpr T LengthSquared(const Vector2<T>& v)
+    {
+        return Dot(v, v);
+    }
+
+    template <typename T>
+    T Length(const Vector2<T>& v)
+    {
+        using std::sqrt; // ADL picks up sqrt for custom scalar types
+        return sqrt(LengthSquared(v));
+    }
+
+    /**
+     * @brief Returns the unit vector in the direction of `v`, or zero when `v` is zero.
+     */
+    template <typename T>
+    Vector2<T> Normalize(const Vector2<T>& v)
+    {
+        const T length = Length(v);
+        return length > T{} ? v / length : Vector2<T>{};
+    }
+
+    template <typename T>
+    constexpr Vector2<T> Min(const Vector2<T>& a, const Vector2<T>& b)
+    {
+        return {std::min(a.x, b.x), std::min(a.y, b.y)};
+    }
+
+    template <typename T>
+    constexpr Vector2<T> Max(const Vector2<T>& a, const Vector2<T>& b)
+    {
+        return {std::max(a.x, b.x), std::max(a.y, b.y)};
+    }
+
+    // ---------------- Vector3 ----------------
+
+    template <typename T>
+    constexpr Vector3<T> operator+(Vector3<T> lhs, const Vector3<T>& rhs)
+    {
+        return lhs += rhs;
+    }
+
+    template <typename T>
+    constexpr Vector3<T> operator-(Vector3<T> lhs, const Vector3<T>& rhs)
+    {
+        return lhs -= rhs;
+    }
+
+    template <typename T>
+    constexpr Vector3<T> operator-(const Vector3<T>& v)
+    {
+        return {-v.x, -v.y, -v.z};
+    }
+
+    template <typename T>
+    constexpr Vector3<T> operator*(Vector3<T> v, const T scalar)
+    {
+        return v *= scalar;
+    }
+
+    template <typename T>
+    constexpr Vector3<T> operator*(const T scalar, Vector3<T> v)
+    {
+        return v *= scalar;
+    }
+
+    template <typename T>
+    constexpr Vector3<T> operator/(Vector3<T> v, const T scalar)
+    {
+        return v /= scalar;
+    }
+
+    template <typename T>
+    constexpr T Dot(const Vector3<T>& a, const Vector3<T>& b)
+    {
+        return (a.x * b.x) + (a.y * b.y) + (a.z * b.z);
+    }
+
+    template <typename T>
+    constexpr Vector3<T> Cross(const Vector3<T>& a, const Vector3<T>& b)
+    {
+        return {(a.y * b.z) - (a.z * b.y), (a.z * b.x) - (a.x * b.z), (a.x * b.y) - (a.y * b.x)};
+    }
+
+    template <typename T>
+    constexpr T LengthSquared(const Vector3<T>& v)
+    {
+        return Dot(v, v);
+    }
+
+    template <typename T>
+    T Length(const Vector3<T>& v)
+    {
+        using std::sqrt; // ADL picks up sqrt for custom scalar types
+        return sqrt(LengthSquared(v));
+    }
+
+    /**
+     * @brief Returns the unit vector in the direction of `v`, or zero when `v` is zero.
+     */
+    template <typename T>
+    Vector3<T> Normalize(const Vector3<T>& v)
+    {
+        const T length = Length(v);
+        return length > T{} ? v / length : Vector3<T>{};
+    }
+
+    template <typename T>
+    constexpr Vector3<T> Min(const Vector3<T>& a, const Vector3<T>& b)
+    {
+        return {std::min(a.x, b.x), std::min(a.y, b.y), std::min(a.z, b.z)};
+    }
+
+    template <typename T>
+    constexpr Vector3<T> Max(const Vector3<T>& a, const Vector3<T>& b)
+    {
+        return {std::max(a.x, b.x), std::max(a.y, b.y), std::max(a.z, b.z)};
+    }
+}
+
+#endif //PSYGINE_VECTOR_HPP
@@ -0,0 +1,498 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#include "flow_field.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <numbers>
+
+#include "psygine/debug/assert.hpp"
+
+namespace
+{
+    using psygine::math::Vec2;
+    using psygine::math::Vec2i;
+
+    constexpr std::array<Vec2i, 8> DIRECTIONS{{{1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1}}};
+
+    constexpr float DIAGONAL = std::numbers::sqrt2_v<float> / 2.0F;
+    constexpr std::array<Vec2, 8> UNIT_DIRECTIONS{{{1.0F, 0.0F}, {-1.0F, 0.0F}, {0.0F, 1.0F}, {0.0F, -1.0F},
+                                                  {DIAGONAL, DIAGONAL}, {DIAGONAL, -DIAGONAL},
+                                                  {-DIAGONAL, DIAGONAL}, {-DIAGONAL, -DIAGONAL}}};
+
+    constexpr std::uint8_t NO_DIRECTION = 0xFF;
+
+    // Why a sector needs solving: new distances on the far side of its border, or changes inside it,
+    // after which every cell it knows a distance for has to be spread again.
+    constexpr std::uint8_t ACTIVE_BORDER = 1;
+    constexpr std::uint8_t ACTIVE_INSIDE = 2;
+
+    constexpr float UNREACHED = std::numeric_limits<float>::infinity();
+
+    // Sectors solved per claimed chunk; a sector is already a whole Dijkstra run.
+    constexpr std::size_t SECTOR_GRAIN = 1;
+
+    constexpr float StepCost(const Vec2i& step)
+    {
+        return step.x != 0 && step.y != 0 ? std::numbers::sqrt2_v<float> : 1.0F;
+    }
+
+    void ForEachSector(psygine::core::ThreadPool* pool, const std::size_t count,
+                       const psygine::core::ThreadPool::RangeFunction& fn)
+    {
+        if (pool == nullptr || count <= SECTOR_GRAIN)
+        {
+            fn(0, count);
+        }
+        else
+        {
+            pool->parallelFor(count, SECTOR_GRAIN, fn);
+        }
+    }
+}
+
+namespace psygine::navigation
+{
+    FlowField::FlowField(const NavGrid& grid, const std::span<const math::Vec2i> goals, const std::int32_t sectorSize) :
+        grid_{&grid},
+        goals_{goals.begin(), goals.end()},
+        sectorSize_{sectorSize}
+    {
+        PSYGINE_ASSERT(sectorSize > 0, "FlowField: sector size must be positive");
+        sectorsX_ = (grid.width() + sectorSize - 1) / sectorSize;
+        sectorsY_ = (grid.height() + sectorSize - 1) / sectorSize;
+        const auto sectorCount = static_cast<std::size_t>(sectorsX_) * static_cast<std::size_t>(sectorsY_);
+        active_.assign(sectorCount, 0);
+        solved_.assign(sectorCount, 0);
+        spread_.assign(sectorCount, 0);
+    }
+
+    void FlowField::cellChanged(const math::Vec2i& cell)
+    {
+        PSYGINE_DEBUG_ASSERT(grid_->inBounds(cell), "FlowField::cellChanged: cell is outside the grid");
+        if (built_)
+        {
+            edits_.push_back(cell);
+        }
+    }
+
+    void FlowField::update(core::ThreadPool* pool)
+    {
+        if (!built_)
+        {
+            const std::size_t cellCount = grid_->cells().size();
+            distance_.assign(cellCount, UNREACHED);
+            direction_.assign(cellCount, NO_DIRECTION);
+            for (const math::Vec2i& goal : goals_)
+            {
+                if (grid_->walkable(goal))
+                {
+                    distance_[grid_->index(goal)] = 0.0F;
+                    active_[sectorOf(goal)] |= ACTIVE_INSIDE;
+                }
+            }
+            built_ = true;
+        }
+        else
+        {
+            if (edits_.empty())
+            {
+                return;
+            }
+            // Blocked cells first, while the directions still describe the old shortest paths.
+            for (const math::Vec2i& cell : edits_)
+            {
+                if (!grid_->walkable(cell))
+                {
+                    invalidate(cell);
+                }
+            }
+            for (const math::Vec2i& cell : edits_)
+            {
+                if (grid_->walkable(cell))
+                {
+                    if (std::ranges::find(goals_, cell) != goals_.end())
+                    {
+                        distance_[grid_->index(cell)] = 0.0F;
+                    }
+                    // An opened cell may also open diagonal steps between its neighbours.
+                    activateAround(cell);
+                }
+            }
+            edits_.clear();
+        }
+
+        solve(pool);
+
+        batch_.clear();
+        for (std::uint32_t sector = 0; sector < solved_.size(); ++sector)
+        {
+            if (solved_[sector] != 0)
+            {
+                solved_[sector] = 0;
+                batch_.push_back(sector);
+            }
+        }
+        ForEachSector(pool, batch_.size(), [&](const std::size_t begin, const std::size_t end)
+        {
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                orientSector(batch_[i]);
+            }
+        });
+    }
+
+    float FlowField::distance(const math::Vec2i& cell) const
+    {
+        PSYGINE_DEBUG_ASSERT(built_, "FlowField::distance: update the field first");
+        return grid_->inBounds(cell) ? distance_[grid_->index(cell)] : UNREACHED;
+    }
+
+    math::Vec2i FlowField::direction(const math::Vec2i& cell) const
+    {
+        PSYGINE_DEBUG_ASSERT(built_, "FlowField::direction: update the field first");
+        if (!grid_->inBounds(cell))
+        {
+            return {};
+        }
+        const std::uint8_t direction = direction_[grid_->index(cell)];
+        return direction != NO_DIRECTION ? DIRECTIONS[direction] : math::Vec2i{};
+    }
+
+    math::Vec2 FlowField::sample(const math::Vec2& position) const
+    {
+        PSYGINE_DEBUG_ASSERT(built_, "FlowField::sample: update the field first");
+        const math::Vec2i cell{static_cast<std::int32_t>(std::floor(position.x)),
+                               static_cast<std::int32_t>(std::floor(position.y))};
+        if (!grid_->inBounds(cell))
+        {
+            return {};
+        }
+        const std::uint8_t direction = direction_[grid_->index(cell)];
+        return direction != NO_DIRECTION ? UNIT_DIRECTIONS[direction] : math::Vec2{};
+    }
+
+    std::uint32_t FlowField::sectorOf(const math::Vec2i& cell) const
+    {
+        return static_cast<std::uint32_t>((cell.y / sectorSize_) * sectorsX_ + (cell.x / sectorSize_));
+    }
+
+    CellRect FlowField::sectorRect(const std::uint32_t sector) const
+    {
+        const auto index = static_cast<std::int32_t>(sector);
+        const math::Vec2i min{(index % sectorsX_) * sectorSize_, (index / sectorsX_) * sectorSize_};
+        return {min, math::Min(min + math::Vec2i{sectorSize_, sectorSize_}, grid_->bounds().max)};
+    }
+
+    bool FlowField::canStep(const math::Vec2i& cell, const math::Vec2i& step) const
+    {
+        if (!grid_->walkable(cell + step))
+        {
+            return false;
+        }
+        return step.x == 0 || step.y == 0 ||
+            (grid_->walkable({cell.x + step.x, cell.y}) && grid_->walkable({cell.x, cell.y + step.y}));
+    }
+
+    void FlowField::activateAround(const math::Vec2i& cell)
+    {
+        for (std::int32_t y = cell.y - 1; y <= cell.y + 1; ++y)
+        {
+            for (std::int32_t x = cell.x - 1; x <= cell.x + 1; ++x)
+            {
+                if (grid_->inBounds({x, y}))
+                {
+                    active_[sectorOf({x, y})] |= ACTIVE_INSIDE;
+                }
+            }
+        }
+    }
+
+    void FlowField::invalidate(const math::Vec2i& blocked)
+    {
+        // Every distance that was reached through the blocked cell is gone: the cell itself, neighbours
+        // whose diagonal step squeezed past it, and everything downstream of those.
+        dropped_.clear();
+        drop(blocked);
+        for (const math::Vec2i& step : DIRECTIONS)
+        {
+            const math::Vec2i neighbour = blocked + step;
+            if (!grid_->inBounds(neighbour))
+            {
+                continue;
+            }
+            const std::uint8_t direction = direction_[grid_->index(neighbour)];
+            if (direction == NO_DIRECTION)
+            {
+                continue;
+            }
+            const math::Vec2i next = DIRECTIONS[direction];
+            if (next.x != 0 && next.y != 0 && (neighbour + math::Vec2i{next.x, 0} == blocked ||
+                neighbour + math::Vec2i{0, next.y} == blocked))
+            {
+                drop(neighbour);
+            }
+        }
+
+        while (!dropped_.empty())
+        {
+            const math::Vec2i cell = dropped_.back();
+            dropped_.pop_back();
+            for (const math::Vec2i& step : DIRECTIONS)
+            {
+                const math::Vec2i upstream = cell - step;
+                if (!grid_->inBounds(upstream))
+                {
+                    continue;
+                }
+                const std::uint8_t direction = direction_[grid_->index(upstream)];
+                if (direction != NO_DIRECTION && DIRECTIONS[direction] == step)
+                {
+                    drop(upstream);
+                }
+            }
+        }
+    }
+
+    void FlowField::drop(const math::Vec2i& cell)
+    {
+        const std::uint32_t index = grid_->index(cell);
+        if (distance_[index] == UNREACHED)
+        {
+            return;
+        }
+        distance_[index] = UNREACHED;
+        direction_[index] = NO_DIRECTION;
+        active_[sectorOf(cell)] |= ACTIVE_INSIDE;
+        dropped_.push_back(cell);
+    }
+
+    void FlowField::solve(core::ThreadPool* pool)
+    {
+        // Sectors of one colour are two apart in both axes, so none of them reads a cell another writes.
+        for (bool any = true; any;)
+        {
+            any = false;
+            for (std::int32_t colour = 0; colour < 4; ++colour)
+            {
+                batch_.clear();
+                for (std::int32_t sy = colour / 2; sy < sectorsY_; sy += 2)
+                {
+                    for (std::int32_t sx = colour % 2; sx < sectorsX_; sx += 2)
+                    {
+                        const auto sector = static_cast<std::uint32_t>(sy * sectorsX_ + sx);
+                        if (active_[sector] != 0)
+                        {
+                            solved_[sector] = active_[sector];
+                            active_[sector] = 0;
+                            batch_.push_back(sector);
+                        }
+                    }
+                }
+                if (batch_.empty())
+                {
+                    continue;
+                }
+                any = true;
+
+                ForEachSector(pool, batch_.size(), [&](const std::size_t begin, const std::size_t end)
+                {
+                    std::vector<std::pair<float, std::uint32_t>> open;
+                    open.reserve(static_cast<std::size_t>(sectorSize_) * static_cast<std::size_t>(sectorSize_));
+                    for (std::size_t i = begin; i < end; ++i)
+                    {
+                        const std::uint32_t sector = batch_[i];
+                        spread_[sector] = solveSector(sector, (solved_[sector] & ACTIVE_INSIDE) != 0, open);
+                    }
+                });
+
+                for (const std::uint32_t sector : batch_)
+                {
+                    const auto index = static_cast<std::int32_t>(sector);
+                    const math::Vec2i position{index % sectorsX_, index / sectorsX_};
+                    for (std::size_t bit = 0; bit < DIRECTIONS.size(); ++bit)
+                    {
+                        const math::Vec2i neighbour = position + DIRECTIONS[bit];
+                        if ((spread_[sector] & (1U << bit)) != 0 && neighbour.x >= 0 && neighbour.y >= 0 &&
+                            neighbour.x < sectorsX_ && neighbour.y < sectorsY_)
+                        {
+                            active_[static_cast<std::uint32_t>(neighbour.y * sectorsX_ + neighbour.x)] |=
+                                ACTIVE_BORDER;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    std::uint8_t FlowField::solveSector(const std::uint32_t sector, const bool inside,
+                                        std::vector<std::pair<float, std::uint32_t>>& open)
+    {
+        const CellRect rect = sectorRect(sector);
+        std::uint8_t spread = 0;
+        const auto lower = [&](const math::Vec2i& cell, const float value)
+        {
+            distance_[grid_->index(cell)] = value;
+            const bool left = cell.x == rect.min.x;
+            const bool right = cell.x == rect.max.x - 1;
+            const bool top = cell.y == rect.min.y;
+            const bool bottom = cell.y == rect.max.y - 1;
+            if (!(left || right || top || bottom))
+            {
+                return;
+            }
+            for (std::size_t bit = 0; bit < DIRECTIONS.size(); ++bit)
+            {
+                const math::Vec2i& d = DIRECTIONS[bit];
+                if ((d.x == 0 || (d.x < 0 ? left : right)) && (d.y == 0 || (d.y < 0 ? top : bottom)))
+                {
+                    spread |= static_cast<std::uint8_t>(1U << bit);
+                }
+            }
+        };
+
+        // Seed with what the neighbours offer across the border and, after changes inside, with every
+        // distance the sector already knows. Otherwise the inside is settled and only the border can
+        // bring anything new, so the walk sticks to the border cells.
+        open.clear();
+        for (std::int32_t y = rect.min.y; y < rect.max.y; ++y)
+        {
+            const bool edgeRow = y == rect.min.y || y == rect.max.y - 1;
+            const std::int32_t stride = inside || edgeRow ? 1 : std::max(rect.max.x - rect.min.x - 1, 1);
+            for (std::int32_t x = rect.min.x; x < rect.max.x; x += stride)
+            {
+                const math::Vec2i cell{x, y};
+                if (!grid_->walkable(cell))
+                {
+                    continue;
+                }
+                const float current = distance_[grid_->index(cell)];
+                float best = current;
+                if (edgeRow || x == rect.min.x || x == rect.max.x - 1)
+                {
+                    for (const math::Vec2i& step : DIRECTIONS)
+                    {
+                        const math::Vec2i neighbour = cell + step;
+                        if (!rect.contains(neighbour) && canStep(cell, step))
+                        {
+                            best = std::min(best, distance_[grid_->index(neighbour)] + StepCost(step));
+                        }
+                    }
+                }
+                if (best < current)
+                {
+                    lower(cell, best);
+                    open.emplace_back(best, grid_->index(cell));
+                }
+                else if (inside && best != UNREACHED)
+                {
+                    open.emplace_back(best, grid_->index(cell));
+                }
+            }
+        }
+
+        std::ranges::make_heap(open, std::greater{});
+        while (!open.empty())
+        {
+            std::ranges::pop_heap(open, std::greater{});
+            const auto [value, index] = open.back();
+            open.pop_back();
+            if (value > distance_[index])
+            {
+                continue;
+            }
+            const math::Vec2i cell = grid_->cell(index);
+            for (const math::Vec2i& step : DIRECTIONS)
+            {
+                const math::Vec2i next = cell + step;
+                if (!rect.contains(next) || !canStep(cell, step))
+                {
+                    continue;
+                }
+                const float reached = value + StepCost(step);
+                const std::uint32_t to = grid_->index(next);
+                if (reached < distance_[to])
+                {
+                    lower(next, reached);
+                    open.emplace_back(reached, to);
+                    std::ranges::push_heap(open, std::greater{});
+                }
+            }
+        }
+        return spread;
+    }
+
+    void FlowField::orientSector(const std::uint32_t sector)
+    {
+        const CellRect rect = sectorRect(sector);
+        for (std::int32_t y = rect.min.y; y < rect.max.y; ++y)
+        {
+            for (std::int32_t x = rect.min.x; x < rect.max.x; ++x)
+            {
+                const math::Vec2i cell{x, y};
+                const std::uint32_t index = grid_->index(cell);
+                std::uint8_t direction = NO_DIRECTION;
+                float best = distance_[index];
+                if (best != 0.0F && best != UNREACHED)
+                {
+                    for (std::size_t i = 0; i < DIRECTIONS.size(); ++i)
+                    {
+                        if (!canStep(cell, DIRECTIONS[i]))
+                        {
+                            continue;
+                        }
+                        const float through = distance_[grid_->index(cell + DIRECTIONS[i])] + StepCost(DIRECTIONS[i]);
+                        if (through < best || (direction == NO_DIRECTION && through == best))
+                        {
+                            best = through;
+                            direction = static_cast<std::uint8_t>(i);
+                        }
+                    }
+                }
+                direction_[index] = direction;
+            }
+        }
+    }
+
+    FlowFieldCache::FlowFieldCache(const NavGrid& grid, const std::size_t capacity, const std::int32_t sectorSize) :
+        grid_{&grid},
+        capacity_{capacity},
+        sectorSize_{sectorSize}
+    {
+        PSYGINE_ASSERT(capacity > 0, "FlowFieldCache: capacity must be positive");
+        entries_.reserve(capacity);
+    }
+
+    const FlowField& FlowFieldCache::field(const math::Vec2i& goal, core::ThreadPool* pool)
+    {
+        auto entry = std::ranges::find(entries_, goal, &Entry::goal);
+        if (entry == entries_.end())
+        {
+            if (entries_.size() < capacity_)
+            {
+                entry = entries_.emplace(entries_.end());
+            }
+            else
+            {
+                entry = std::ranges::min_element(entries_, {}, &Entry::lastUse);
+            }
+            entry->goal = goal;
+            entry->field = std::make_unique<FlowField>(*grid_, std::span{&goal, 1}, sectorSize_);
+        }
+        entry->lastUse = ++clock_;
+        entry->field->update(pool);
+        return *entry->field;
+    }
+
+    void FlowFieldCache::cellChanged(const math::Vec2i& cell)
+    {
+        for (const Entry& entry : entries_)
+        {
+            entry.field->cellChanged(cell);
+        }
+    }
+}
@@ -0,0 +1,163 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#ifndef PSYGINE_FLOW_FIELD_HPP
+#define PSYGINE_FLOW_FIELD_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "nav_grid.hpp"
+#include "psygine/core/thread_pool.hpp"
+#include "psygine/math/vector.hpp"
+
+namespace psygine::navigation
+{
+    /**
+     * @brief The distance from every cell of a `NavGrid` to the nearest of a set of goals, and the step
+     * each cell should take toward it.
+     *
+     * One field serves any number of agents heading for the same goals: each looks up the direction of
+     * the cell it stands on, in constant time. The distances are built by Dijkstra wavefronts over square
+     * sectors. Sectors exchange distances across their borders and are solved in four interleaved colour
+     * classes, so sectors solved at the same time never share a border and can run on separate threads.
+     * The result does not depend on the thread count.
+     *
+     * Edits are incremental: report changed cells with `cellChanged`, and the next `update` clears only
+     * the distances that ran through newly blocked cells and re-solves only the sectors involved.
+     */
+    class FlowField
+    {
+    public:
+        static constexpr std::int32_t DEFAULT_SECTOR_SIZE = 32;
+
+        /**
+         * @brief A field toward `goals` over `grid`, which must outlive it. Nothing is computed until the
+         * first `update`.
+         */
+        FlowField(const NavGrid& grid, std::span<const math::Vec2i> goals,
+                  std::int32_t sectorSize = DEFAULT_SECTOR_SIZE);
+
+        /**
+         * @brief Queues a changed cell for the next `update`.
+         */
+        void cellChanged(const math::Vec2i& cell);
+
+        /**
+         * @brief Brings the field up to date: builds it on first use, otherwise applies the queued edits.
+         *
+         * @param pool Solves independent sectors on its threads. Null solves them on the calling thread.
+         */
+        void update(core::ThreadPool* pool = nullptr);
+
+        /**
+         * @brief Whether edits or the first build are waiting for `update`.
+         */
+        [[nodiscard]] bool dirty() const
+        {
+            return !built_ || !edits_.empty();
+        }
+
+        /**
+         * @brief Path cost from `cell` to the nearest goal; infinity where no goal can be reached.
+         */
+        [[nodiscard]] float distance(const math::Vec2i& cell) const;
+
+        /**
+         * @brief The neighbour step to take from `cell`; zero at a goal or where no goal can be reached.
+         */
+        [[nodiscard]] math::Vec2i direction(const math::Vec2i& cell) const;
+
+        /**
+         * @brief The unit direction to move in from a position in cell units (cell `(x, y)` spans
+         * `[x, x + 1)` by `[y, y + 1)`); zero at a goal, off the grid, or where no goal can be reached.
+         */
+        [[nodiscard]] math::Vec2 sample(const math::Vec2& position) const;
+
+        [[nodiscard]] std::span<const math::Vec2i> goals() const
+        {
+            return goals_;
+        }
+
+    private:
+        [[nodiscard]] std::uint32_t sectorOf(const math::Vec2i& cell) const;
+        [[nodiscard]] CellRect sectorRect(std::uint32_t sector) const;
+        [[nodiscard]] bool canStep(const math::Vec2i& cell, const math::Vec2i& step) const;
+        void activateAround(const math::Vec2i& cell);
+        void invalidate(const math::Vec2i& blocked);
+        void drop(const math::Vec2i& cell);
+        void solve(core::ThreadPool* pool);
+        std::uint8_t solveSector(std::uint32_t sector, bool inside, std::vector<std::pair<float, std::uint32_t>>& open);
+        void orientSector(std::uint32_t sector);
+
+        const NavGrid* grid_;
+        std::vector<math::Vec2i> goals_;
+        std::int32_t sectorSize_;
+        std::int32_t sectorsX_;
+        std::int32_t sectorsY_;
+
+        std::vector<float> distance_;
+        // Index into the neighbour directions, or 0xFF for none.
+        std::vector<std::uint8_t> direction_;
+
+        // Per sector: why it waits to be solved, why it was solved during this update, and after solving,
+        // one bit per neighbouring sector whose shared border got shorter distances.
+        std::vector<std::uint8_t> active_;
+        std::vector<std::uint8_t> solved_;
+        std::vector<std::uint8_t> spread_;
+
+        std::vector<math::Vec2i> edits_;
+        std::vector<std::uint32_t> batch_;
+        std::vector<math::Vec2i> dropped_;
+        bool built_ = false;
+    };
+
+    /**
+     * @brief Flow fields toward single goal cells, built on demand and kept up to date, evicting the
+     * least recently used beyond the capacity.
+     */
+    class FlowFieldCache
+    {
+    public:
+        static constexpr std::size_t DEFAULT_CAPACITY = 16;
+
+        explicit FlowFieldCache(const NavGrid& grid, std::size_t capacity = DEFAULT_CAPACITY,
+                                std::int32_t sectorSize = FlowField::DEFAULT_SECTOR_SIZE);
+
+        /**
+         * @brief The up-to-date field toward `goal`, built if it is not cached. The reference stays valid
+         * until the field is evicted by a call for another goal.
+         */
+        const FlowField& field(const math::Vec2i& goal, core::ThreadPool* pool = nullptr);
+
+        /**
+         * @brief Queues a changed cell for every cached field; each applies it the next time it is used.
+         */
+        void cellChanged(const math::Vec2i& cell);
+
+        [[nodiscard]] std::size_t size() const
+        {
+            return entries_.size();
+        }
+
+    private:
+        struct Entry
+        {
+            math::Vec2i goal{};
+            std::uint64_t lastUse = 0;
+            std::unique_ptr<FlowField> field;
+        };
+
+        const NavGrid* grid_;
+        std::size_t capacity_;
+        std::int32_t sectorSize_;
+        std::vector<Entry> entries_;
+        std::uint64_t clock_ = 0;
+    };
+}
+
+#endif //PSYGINE_FLOW_FIELD_HPP
@@ -0,0 +1,281 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#include "grid_search.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace
+{
+    using psygine::math::Vec2i;
+
+    constexpr std::array<Vec2i, 8> DIRECTIONS{{{1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1}}};
+
+    // Heap order: lowest f first, then the deeper node, then the lower cell index.
+    struct OpenOrder
+    {
+        template <typename Node>
+        bool operator()(const Node& a, const Node& b) const
+        {
+            if (a.f != b.f)
+            {
+                return a.f > b.f;
+            }
+            if (a.g != b.g)
+            {
+                return a.g < b.g;
+            }
+            return a.cell > b.cell;
+        }
+    };
+
+    constexpr std::int32_t Sign(const std::int32_t x)
+    {
+        return (x > 0) - (x < 0);
+    }
+}
+
+namespace psygine::navigation
+{
+    bool GridSearch::findPath(const NavGrid& grid, const math::Vec2i& start, const math::Vec2i& goal,
+                              std::vector<math::Vec2i>& path, const SearchAlgorithm algorithm, const CellRect* bounds)
+    {
+        path.clear();
+        cost_ = 0.0F;
+        expanded_ = 0;
+        grid_ = &grid;
+        region_ = grid.bounds();
+        if (bounds != nullptr)
+        {
+            region_.min = math::Max(region_.min, bounds->min);
+            region_.max = math::Min(region_.max, bounds->max);
+        }
+        goal_ = goal;
+        if (!passable(start) || !passable(goal))
+        {
+            return false;
+        }
+        if (start == goal)
+        {
+            path.push_back(start);
+            return true;
+        }
+
+        prepare(static_cast<std::size_t>(grid.width()) * static_cast<std::size_t>(grid.height()));
+        const std::uint32_t startIndex = grid.index(start);
+        const std::uint32_t goalIndex = grid.index(goal);
+        push(startIndex, INVALID_INDEX, 0.0F, OctileDistance(start, goal));
+
+        // Successor directions of the node being expanded.
+        std::array<Vec2i, 8> directions{};
+        while (!open_.empty())
+        {
+            std::ranges::pop_heap(open_, OpenOrder{});
+            const OpenNode node = open_.back();
+            open_.pop_back();
+            if (closed_[node.cell] == generation_)
+            {
+                continue;
+            }
+            closed_[node.cell] = generation_;
+            ++expanded_;
+            if (node.cell == goalIndex)
+            {
+                break;
+            }
+
+            const Vec2i cell = grid.cell(node.cell);
+            std::size_t count = 0;
+            const std::uint32_t parent = parent_[node.cell];
+            if (algorithm == SearchAlgorithm::AStar || parent == INVALID_INDEX)
+            {
+                for (const Vec2i& d : DIRECTIONS)
+                {
+                    directions[count++] = d;
+                }
+            }
+            else
+            {
+                // Only the directions a shortest path through this node can continue in.
+                const Vec2i from = grid.cell(parent);
+                const Vec2i d{Sign(cell.x - from.x), Sign(cell.y - from.y)};
+                if (d.x != 0 && d.y != 0)
+                {
+                    directions[count++] = {d.x, 0};
+                    directions[count++] = {0, d.y};
+                    directions[count++] = d;
+                }
+                else if (d.x != 0)
+                {
+                    directions[count++] = d;
+                    directions[count++] = {d.x, 1};
+                    directions[count++] = {d.x, -1};
+                    directions[count++] = {0, 1};
+                    directions[count++] = {0, -1};
+                }
+                else
+                {
+                    directions[count++] = d;
+                    directions[count++] = {1, d.y};
+                    directions[count++] = {-1, d.y};
+                    directions[count++] = {1, 0};
+                    directions[count++] = {-1, 0};
+                }
+            }
+
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const Vec2i d = directions[i];
+                const Vec2i next{cell.x + d.x, cell.y + d.y};
+                if (!passable(next) || (d.x != 0 && d.y != 0 && (!passable({cell.x + d.x, cell.y}) ||
+                    !passable({cell.x, cell.y + d.y}))))
+                {
+                    continue;
+                }
+
+                std::uint32_t successor;
+                if (algorithm == SearchAlgorithm::AStar)
+                {
+                    successor = grid.index(next);
+                }
+                else
+                {
+                    successor = jump(next, d);
+                    if (successor == INVALID_INDEX)
+                    {
+                        continue;
+                    }
+                }
+                if (closed_[successor] == generation_)
+                {
+                    continue;
+                }
+                const Vec2i target = grid.cell(successor);
+                const float g = node.g + OctileDistance(cell, target);
+                if (reached_[successor] != generation_ || g < g_[successor])
+                {
+                    push(successor, node.cell, g, OctileDistance(target, goal));
+                }
+            }
+        }
+
+        if (closed_[goalIndex] != generation_)
+        {
+            return false;
+        }
+        cost_ = g_[goalIndex];
+
+        // Walk back over the expanded nodes, then fill in the straight and diagonal runs between them.
+        for (std::uint32_t i = goalIndex; i != INVALID_INDEX; i = parent_[i])
+        {
+            path.push_back(grid.cell(i));
+        }
+        std::ranges::reverse(path);
+        if (algorithm == SearchAlgorithm::JumpPoint)
+        {
+            const std::size_t jumpPoints = path.size();
+            path.push_back(start);
+            for (std::size_t i = 0; i + 1 < jumpPoints; ++i)
+            {
+                const Vec2i a = path[i];
+                const Vec2i b = path[i + 1];
+                const Vec2i d{Sign(b.x - a.x), Sign(b.y - a.y)};
+                for (Vec2i c{a.x + d.x, a.y + d.y}; c != b; c = {c.x + d.x, c.y + d.y})
+                {
+                    path.push_back(c);
+                }
+                path.push_back(b);
+            }
+            path.erase(path.begin(), path.begin() + static_cast<std::ptrdiff_t>(jumpPoints));
+        }
+        return true;
+    }
+
+    void GridSearch::prepare(const std::size_t cellCount)
+    {
+        if (reached_.size() != cellCount)
+        {
+            reached_.assign(cellCount, 0);
+            closed_.assign(cellCount, 0);
+            g_.resize(cellCount);
+            parent_.resize(cellCount);
+            generation_ = 0;
+        }
+        // Stamps start at 0, so a wrapped generation has to clear them once.
+        if (++generation_ == 0)
+        {
+            std::ranges::fill(reached_, 0);
+            std::ranges::fill(closed_, 0);
+            generation_ = 1;
+        }
+        open_.clear();
+    }
+
+    void GridSearch::push(const std::uint32_t cell, const std::uint32_t parent, const float g, const float h)
+    {
+        reached_[cell] = generation_;
+        g_[cell] = g;
+        parent_[cell] = parent;
+        open_.push_back({g + h, g, cell});
+        std::ranges::push_heap(open_, OpenOrder{});
+    }
+
+    std::uint32_t GridSearch::jump(math::Vec2i cell, const math::Vec2i direction) const
+    {
+        if (direction.x == 0 || direction.y == 0)
+        {
+            return jumpStraight(cell, direction);
+        }
+        for (;; cell += direction)
+        {
+            if (!passable(cell))
+            {
+                return INVALID_INDEX;
+            }
+            if (cell == goal_)
+            {
+                return grid_->index(cell);
+            }
+            // A diagonal run stops where one of its straight branches finds something.
+            if (jumpStraight({cell.x + direction.x, cell.y}, {direction.x, 0}) != INVALID_INDEX ||
+                jumpStraight({cell.x, cell.y + direction.y}, {0, direction.y}) != INVALID_INDEX)
+            {
+                return grid_->index(cell);
+            }
+            if (!passable({cell.x + direction.x, cell.y}) || !passable({cell.x, cell.y + direction.y}))
+            {
+                return INVALID_INDEX;
+            }
+        }
+    }
+
+    std::uint32_t GridSearch::jumpStraight(math::Vec2i cell, const math::Vec2i direction) const
+    {
+        for (;; cell += direction)
+        {
+            if (!passable(cell))
+            {
+                return INVALID_INDEX;
+            }
+            if (cell == goal_)
+            {
+                return grid_->index(cell);
+            }
+            // A forced neighbour: a side cell that only opens up past an obstacle behind us.
+            if (direction.x != 0)
+            {
+                if ((passable({cell.x, cell.y + 1}) && !passable({cell.x - direction.x, cell.y + 1})) ||
+                    (passable({cell.x, cell.y - 1}) && !passable({cell.x - direction.x, cell.y - 1})))
+                {
+                    return grid_->index(cell);
+                }
+            }
+            else if ((passable({cell.x + 1, cell.y}) && !passable({cell.x + 1, cell.y - direction.y})) ||
+                (passable({cell.x - 1, cell.y}) && !passable({cell.x - 1, cell.y - direction.y})))
+            {
+                return grid_->index(cell);
+            }
+        }
+    }
+}
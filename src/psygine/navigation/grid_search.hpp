@@ -0,0 +1,104 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#ifndef PSYGINE_GRID_SEARCH_HPP
+#define PSYGINE_GRID_SEARCH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "nav_grid.hpp"
+#include "psygine/math/vector.hpp"
+
+namespace psygine::navigation
+{
+    enum class SearchAlgorithm : std::uint8_t
+    {
+        // Plain A*, expanding every neighbour.
+        AStar,
+        // Jump Point Search: A* that skips along straight and diagonal runs of open cells and only
+        // stops where a shorter path could branch off, typically expanding far fewer nodes.
+        JumpPoint
+    };
+
+    /**
+     * @brief Reusable state for shortest-path searches on a `NavGrid`.
+     *
+     * Per-cell search data is stamped with a search generation instead of being cleared, so a search
+     * only touches the cells it reaches and a context can run searches back to back without any
+     * per-search setup. The open list is a binary heap; ties are broken by cell index, so results do
+     * not depend on anything but the inputs.
+     *
+     * A context is not thread-safe; give every worker its own.
+     */
+    class GridSearch
+    {
+    public:
+        /**
+         * @brief Finds a shortest path from `start` to `goal`.
+         *
+         * @param path Receives every cell of the path, `start` and `goal` included; empty when there is
+         *             no path.
+         * @param bounds Confines the search; cells outside it count as blocked. Null searches the whole
+         *               grid.
+         * @return Whether a path was found.
+         */
+        bool findPath(const NavGrid& grid, const math::Vec2i& start, const math::Vec2i& goal,
+                      std::vector<math::Vec2i>& path, SearchAlgorithm algorithm = SearchAlgorithm::JumpPoint,
+                      const CellRect* bounds = nullptr);
+
+        /**
+         * @brief The cost of the last path found.
+         */
+        [[nodiscard]] float cost() const
+        {
+            return cost_;
+        }
+
+        /**
+         * @brief Nodes the last search expanded.
+         */
+        [[nodiscard]] std::size_t expanded() const
+        {
+            return expanded_;
+        }
+
+    private:
+        static constexpr std::uint32_t INVALID_INDEX = 0xFFFFFFFFU;
+
+        struct OpenNode
+        {
+            float f;
+            float g;
+            std::uint32_t cell;
+        };
+
+        void prepare(std::size_t cellCount);
+        void push(std::uint32_t cell, std::uint32_t parent, float g, float h);
+        std::uint32_t jump(math::Vec2i cell, math::Vec2i direction) const;
+        std::uint32_t jumpStraight(math::Vec2i cell, math::Vec2i direction) const;
+        [[nodiscard]] bool passable(const math::Vec2i& cell) const
+        {
+            return region_.contains(cell) && grid_->walkable(cell);
+        }
+
+        // Stamped with `generation_` when the cell was reached or closed in the current search.
+        std::vector<std::uint32_t> reached_;
+        std::vector<std::uint32_t> closed_;
+        std::vector<float> g_;
+        std::vector<std::uint32_t> parent_;
+        std::vector<OpenNode> open_;
+        std::uint32_t generation_ = 0;
+
+        // The search in progress.
+        const NavGrid* grid_ = nullptr;
+        CellRect region_{};
+        math::Vec2i goal_{};
+
+        float cost_ = 0.0F;
+        std::size_t expanded_ = 0;
+    };
+}
+
+#endif //PSYGINE_GRID_SEARCH_HPP
@@ -0,0 +1,42 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#include "nav_grid.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <numbers>
+
+#include "psygine/debug/assert.hpp"
+
+namespace psygine::navigation
+{
+    NavGrid::NavGrid(const std::int32_t width, const std::int32_t height) :
+        width_{width},
+        height_{height}
+    {
+        PSYGINE_ASSERT(width > 0 && height > 0, "NavGrid: dimensions must be positive");
+        walkable_.assign(static_cast<std::size_t>(width) * static_cast<std::size_t>(height), 1);
+    }
+
+    void NavGrid::setWalkable(const math::Vec2i& cell, const bool walkable)
+    {
+        PSYGINE_ASSERT(inBounds(cell), "NavGrid::setWalkable: cell is outside the grid");
+        std::uint8_t& value = walkable_[index(cell)];
+        const std::uint8_t next = walkable ? 1 : 0;
+        if (value != next)
+        {
+            value = next;
+            ++version_;
+        }
+    }
+
+    float OctileDistance(const math::Vec2i& a, const math::Vec2i& b)
+    {
+        const std::int32_t dx = std::abs(a.x - b.x);
+        const std::int32_t dy = std::abs(a.y - b.y);
+        const auto straight = static_cast<float>(std::max(dx, dy) - std::min(dx, dy));
+        const auto diagonal = static_cast<float>(std::min(dx, dy));
+        return straight + (diagonal * std::numbers::sqrt2_v<float>);
+    }
+}
@@ -0,0 +1,118 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#ifndef PSYGINE_NAV_GRID_HPP
+#define PSYGINE_NAV_GRID_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "psygine/math/vector.hpp"
+
+namespace psygine::navigation
+{
+    /**
+     * @brief An axis-aligned range of cells, `min` inclusive and `max` exclusive.
+     */
+    struct CellRect
+    {
+        math::Vec2i min{};
+        math::Vec2i max{};
+
+        [[nodiscard]] constexpr bool contains(const math::Vec2i& cell) const
+        {
+            return cell.x >= min.x && cell.y >= min.y && cell.x < max.x && cell.y < max.y;
+        }
+    };
+
+    /**
+     * @brief A walkability map of square cells for pathfinding.
+     *
+     * Movement is 8-connected: straight steps cost 1 and diagonal steps cost sqrt(2). A diagonal step
+     * needs both cells it passes between to be walkable, so paths never cut corners.
+     */
+    class NavGrid
+    {
+    public:
+        /**
+         * @brief A grid of `width` by `height` cells, all walkable.
+         */
+        NavGrid(std::int32_t width, std::int32_t height);
+
+        [[nodiscard]] std::int32_t width() const
+        {
+            return width_;
+        }
+
+        [[nodiscard]] std::int32_t height() const
+        {
+            return height_;
+        }
+
+        [[nodiscard]] CellRect bounds() const
+        {
+            return {{0, 0}, {width_, height_}};
+        }
+
+        [[nodiscard]] bool inBounds(const math::Vec2i& cell) const
+        {
+            return bounds().contains(cell);
+        }
+
+        /**
+         * @brief Row-major index of an in-bounds cell.
+         */
+        [[nodiscard]] std::uint32_t index(const math::Vec2i& cell) const
+        {
+            return static_cast<std::uint32_t>(cell.y) * static_cast<std::uint32_t>(width_) +
+                static_cast<std::uint32_t>(cell.x);
+        }
+
+        [[nodiscard]] math::Vec2i cell(const std::uint32_t index) const
+        {
+            return {static_cast<std::int32_t>(index % static_cast<std::uint32_t>(width_)),
+                    static_cast<std::int32_t>(index / static_cast<std::uint32_t>(width_))};
+        }
+
+        /**
+         * @brief Whether a cell can be entered; cells outside the grid cannot.
+         */
+        [[nodiscard]] bool walkable(const math::Vec2i& cell) const
+        {
+            return inBounds(cell) && walkable_[index(cell)] != 0;
+        }
+
+        void setWalkable(const math::Vec2i& cell, bool walkable);
+
+        /**
+         * @brief Incremented by every change, so derived data can tell it is out of date.
+         */
+        [[nodiscard]] std::uint64_t version() const
+        {
+            return version_;
+        }
+
+        /**
+         * @brief One byte per cell, row-major, non-zero where walkable.
+         */
+        [[nodiscard]] std::span<const std::uint8_t> cells() const
+        {
+            return walkable_;
+        }
+
+    private:
+        std::int32_t width_;
+        std::int32_t height_;
+        std::vector<std::uint8_t> walkable_;
+        std::uint64_t version_ = 0;
+    };
+
+    /**
+     * @brief The octile distance: the cost of the shortest unobstructed 8-connected path.
+     */
+    float OctileDistance(const math::Vec2i& a, const math::Vec2i& b);
+}
+
+#endif //PSYGINE_NAV_GRID_HPP
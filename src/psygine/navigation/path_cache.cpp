@@ -0,0 +1,155 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#include "path_cache.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include "psygine/debug/assert.hpp"
+
+namespace psygine::navigation
+{
+    PathCache::PathCache(const std::size_t capacity) :
+        entries_(capacity)
+    {
+        PSYGINE_ASSERT(capacity > 0, "PathCache: capacity must be positive");
+        lookup_.reserve(capacity);
+        clear();
+    }
+
+    const std::vector<math::Vec2i>* PathCache::find(const math::Vec2i& start, const math::Vec2i& goal)
+    {
+        const auto found = lookup_.find(Key(start, goal));
+        if (found == lookup_.end())
+        {
+            return nullptr;
+        }
+        unlink(found->second);
+        linkFront(found->second);
+        return &entries_[found->second].path;
+    }
+
+    float PathCache::cost(const math::Vec2i& start, const math::Vec2i& goal) const
+    {
+        const auto found = lookup_.find(Key(start, goal));
+        PSYGINE_ASSERT(found != lookup_.end(), "PathCache::cost: path is not cached");
+        return entries_[found->second].cost;
+    }
+
+    void PathCache::insert(const math::Vec2i& start, const math::Vec2i& goal, const std::span<const math::Vec2i> path,
+                           const float cost)
+    {
+        PSYGINE_ASSERT(!path.empty(), "PathCache::insert: only found paths are cached");
+        const std::uint64_t key = Key(start, goal);
+        std::uint32_t index;
+        if (const auto found = lookup_.find(key); found != lookup_.end())
+        {
+            index = found->second;
+            unlink(index);
+        }
+        else
+        {
+            if (free_.empty())
+            {
+                erase(tail_);
+            }
+            index = free_.back();
+            free_.pop_back();
+            lookup_.emplace(key, index);
+        }
+
+        Entry& entry = entries_[index];
+        entry.start = start;
+        entry.goal = goal;
+        entry.path.assign(path.begin(), path.end());
+        entry.cost = cost;
+        entry.bounds = {path.front(), path.front()};
+        for (const math::Vec2i& cell : path)
+        {
+            entry.bounds.min = math::Min(entry.bounds.min, cell);
+            entry.bounds.max = math::Max(entry.bounds.max, cell);
+        }
+        entry.bounds.max += math::Vec2i{1, 1};
+        linkFront(index);
+    }
+
+    void PathCache::cellChanged(const math::Vec2i& cell, const bool walkable)
+    {
+        // An opened cell also unblocks the diagonal moves past its corners, so a new path may only
+        // pass one of its neighbours; the cheapest route through any of the nine cells bounds them all.
+        const auto throughNeighbourhood = [&cell](const Entry& entry)
+        {
+            float best = std::numeric_limits<float>::infinity();
+            for (std::int32_t dy = -1; dy <= 1; ++dy)
+            {
+                for (std::int32_t dx = -1; dx <= 1; ++dx)
+                {
+                    const math::Vec2i via{cell.x + dx, cell.y + dy};
+                    best = std::min(best, OctileDistance(entry.start, via) + OctileDistance(via, entry.goal));
+                }
+            }
+            return best;
+        };
+
+        for (std::uint32_t index = head_; index != INVALID_INDEX;)
+        {
+            const Entry& entry = entries_[index];
+            const std::uint32_t next = entry.next;
+            const bool stale = walkable ? throughNeighbourhood(entry) < entry.cost : entry.bounds.contains(cell);
+            if (stale)
+            {
+                erase(index);
+            }
+            index = next;
+        }
+    }
+
+    void PathCache::clear()
+    {
+        lookup_.clear();
+        free_.clear();
+        for (std::size_t i = entries_.size(); i-- > 0;)
+        {
+            entries_[i].path.clear();
+            free_.push_back(static_cast<std::uint32_t>(i));
+        }
+        head_ = INVALID_INDEX;
+        tail_ = INVALID_INDEX;
+    }
+
+    std::uint64_t PathCache::Key(const math::Vec2i& start, const math::Vec2i& goal)
+    {
+        PSYGINE_DEBUG_ASSERT(std::max({start.x, start.y, goal.x, goal.y}) < 0x10000 &&
+                             std::min({start.x, start.y, goal.x, goal.y}) >= 0,
+                             "PathCache::Key: cells must lie within a 65536 by 65536 grid");
+        return (static_cast<std::uint64_t>(start.x) << 48) | (static_cast<std::uint64_t>(start.y) << 32) |
+            (static_cast<std::uint64_t>(goal.x) << 16) | static_cast<std::uint64_t>(goal.y);
+    }
+
+    void PathCache::unlink(const std::uint32_t index)
+    {
+        Entry& entry = entries_[index];
+        (entry.previous != INVALID_INDEX ? entries_[entry.previous].next : head_) = entry.next;
+        (entry.next != INVALID_INDEX ? entries_[entry.next].previous : tail_) = entry.previous;
+        entry.previous = INVALID_INDEX;
+        entry.next = INVALID_INDEX;
+    }
+
+    void PathCache::linkFront(const std::uint32_t index)
+    {
+        Entry& entry = entries_[index];
+        entry.next = head_;
+        (head_ != INVALID_INDEX ? entries_[head_].previous : tail_) = index;
+        head_ = index;
+    }
+
+    void PathCache::erase(const std::uint32_t index)
+    {
+        unlink(index);
+        Entry& entry = entries_[index];
+        lookup_.erase(Key(entry.start, entry.goal));
+        entry.path.clear();
+        free_.push_back(index);
+    }
+}
@@ -0,0 +1,92 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#ifndef PSYGINE_PATH_CACHE_HPP
+#define PSYGINE_PATH_CACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "nav_grid.hpp"
+#include "psygine/math/vector.hpp"
+
+namespace psygine::navigation
+{
+    /**
+     * @brief A least-recently-used cache of found paths, keyed by start and goal cell.
+     *
+     * Grid edits are reported with `cellChanged`, which drops exactly the entries the edit could affect:
+     * blocking a cell drops the paths whose bounding box holds it, and opening one drops the paths that
+     * a route through it or past its corners could beat, those where the octile distance from start to
+     * the cell or one of its neighbours to goal is below the cached cost.
+     */
+    class PathCache
+    {
+    public:
+        explicit PathCache(std::size_t capacity);
+
+        /**
+         * @brief The cached path from `start` to `goal`, marked most recently used; null on a miss.
+         */
+        [[nodiscard]] const std::vector<math::Vec2i>* find(const math::Vec2i& start, const math::Vec2i& goal);
+
+        /**
+         * @brief The cost of the cached path from `start` to `goal`, which `find` must have returned.
+         */
+        [[nodiscard]] float cost(const math::Vec2i& start, const math::Vec2i& goal) const;
+
+        /**
+         * @brief Caches a found path, evicting the least recently used entry when full.
+         */
+        void insert(const math::Vec2i& start, const math::Vec2i& goal, std::span<const math::Vec2i> path,
+                    float cost);
+
+        /**
+         * @brief Drops the entries a change of `cell` to `walkable` may have made stale.
+         */
+        void cellChanged(const math::Vec2i& cell, bool walkable);
+
+        void clear();
+
+        [[nodiscard]] std::size_t size() const
+        {
+            return lookup_.size();
+        }
+
+        [[nodiscard]] std::size_t capacity() const
+        {
+            return entries_.size();
+        }
+
+    private:
+        static constexpr std::uint32_t INVALID_INDEX = 0xFFFFFFFFU;
+
+        struct Entry
+        {
+            math::Vec2i start{};
+            math::Vec2i goal{};
+            std::vector<math::Vec2i> path;
+            CellRect bounds{};
+            float cost = 0.0F;
+            // Recency list, most recent at `head_`.
+            std::uint32_t previous = INVALID_INDEX;
+            std::uint32_t next = INVALID_INDEX;
+        };
+
+        static std::uint64_t Key(const math::Vec2i& start, const math::Vec2i& goal);
+        void unlink(std::uint32_t index);
+        void linkFront(std::uint32_t index);
+        void erase(std::uint32_t index);
+
+        std::vector<Entry> entries_;
+        std::vector<std::uint32_t> free_;
+        std::unordered_map<std::uint64_t, std::uint32_t> lookup_;
+        std::uint32_t head_ = INVALID_INDEX;
+        std::uint32_t tail_ = INVALID_INDEX;
+    };
+}
+
+#endif //PSYGINE_PATH_CACHE_HPP
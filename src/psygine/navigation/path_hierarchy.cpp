@@ -0,0 +1,503 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#include "path_hierarchy.hpp"
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <limits>
+#include <numbers>
+
+#include "psygine/debug/assert.hpp"
+
+namespace
+{
+    using psygine::math::Vec2i;
+
+    constexpr std::array<Vec2i, 8> DIRECTIONS{{{1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1}}};
+
+    // Open stretches of border up to this long get one transition in the middle; longer ones get one at
+    // each end, so paths along a wide opening do not all funnel through its centre.
+    constexpr std::int32_t MAX_SINGLE_TRANSITION = 5;
+
+    constexpr float UNREACHED = std::numeric_limits<float>::infinity();
+
+    // Heap order for the abstract search, matching `GridSearch`'s.
+    struct OpenOrder
+    {
+        template <typename Node>
+        bool operator()(const Node& a, const Node& b) const
+        {
+            if (a.f != b.f)
+            {
+                return a.f > b.f;
+            }
+            if (a.g != b.g)
+            {
+                return a.g < b.g;
+            }
+            return a.node > b.node;
+        }
+    };
+}
+
+namespace psygine::navigation
+{
+    PathHierarchy::PathHierarchy(const NavGrid& grid, const std::int32_t clusterSize) :
+        grid_{&grid},
+        clusterSize_{clusterSize}
+    {
+        PSYGINE_ASSERT(clusterSize > 1, "PathHierarchy: cluster size must be at least 2");
+        clustersX_ = (grid.width() + clusterSize - 1) / clusterSize;
+        clustersY_ = (grid.height() + clusterSize - 1) / clusterSize;
+        const auto clusterCount = static_cast<std::size_t>(clustersX_) * static_cast<std::size_t>(clustersY_);
+        clusterNodes_.resize(clusterCount);
+        borderNodes_.resize(clusterCount * 2);
+        clusterDirty_.assign(clusterCount, 0);
+        borderDirty_.assign(clusterCount * 2, 0);
+
+        for (std::int32_t cy = 0; cy < clustersY_; ++cy)
+        {
+            for (std::int32_t cx = 0; cx < clustersX_; ++cx)
+            {
+                const auto cluster = static_cast<std::uint32_t>(cy * clustersX_ + cx);
+                if (cx + 1 < clustersX_)
+                {
+                    markBorder(cluster, 0);
+                }
+                if (cy + 1 < clustersY_)
+                {
+                    markBorder(cluster, 1);
+                }
+                markCluster(cluster);
+            }
+        }
+        refresh();
+    }
+
+    void PathHierarchy::cellChanged(const math::Vec2i& cell)
+    {
+        PSYGINE_DEBUG_ASSERT(grid_->inBounds(cell), "PathHierarchy::cellChanged: cell is outside the grid");
+        const std::uint32_t cluster = clusterOf(cell);
+        markCluster(cluster);
+
+        const std::int32_t cx = cell.x / clusterSize_;
+        const std::int32_t cy = cell.y / clusterSize_;
+        const std::int32_t lx = cell.x - (cx * clusterSize_);
+        const std::int32_t ly = cell.y - (cy * clusterSize_);
+        if (lx == 0 && cx > 0)
+        {
+            markBorder(cluster - 1, 0);
+        }
+        if (lx == clusterSize_ - 1 && cx + 1 < clustersX_)
+        {
+            markBorder(cluster, 0);
+        }
+        if (ly == 0 && cy > 0)
+        {
+            markBorder(cluster - static_cast<std::uint32_t>(clustersX_), 1);
+        }
+        if (ly == clusterSize_ - 1 && cy + 1 < clustersY_)
+        {
+            markBorder(cluster, 1);
+        }
+    }
+
+    void PathHierarchy::refresh()
+    {
+        // Borders first: rebuilding one marks the clusters on both sides.
+        for (const std::uint32_t border : dirtyBorders_)
+        {
+            rebuildBorder(border);
+            borderDirty_[border] = 0;
+        }
+        dirtyBorders_.clear();
+
+        for (const std::uint32_t cluster : dirtyClusters_)
+        {
+            rebuildCluster(cluster);
+            clusterDirty_[cluster] = 0;
+        }
+        dirtyClusters_.clear();
+    }
+
+    bool PathHierarchy::findPath(Context& context, const math::Vec2i& start, const math::Vec2i& goal,
+                                 std::vector<math::Vec2i>& path) const
+    {
+        PSYGINE_DEBUG_ASSERT(!dirty(), "PathHierarchy::findPath: refresh after editing the grid");
+        path.clear();
+        context.cost_ = 0.0F;
+        if (!grid_->walkable(start) || !grid_->walkable(goal))
+        {
+            return false;
+        }
+
+        const std::uint32_t startCluster = clusterOf(start);
+        const std::uint32_t goalCluster = clusterOf(goal);
+        if (startCluster == goalCluster)
+        {
+            const CellRect rect = clusterRect(startCluster);
+            if (context.search_.findPath(*grid_, start, goal, path, SearchAlgorithm::JumpPoint, &rect))
+            {
+                context.cost_ = context.search_.cost();
+                return true;
+            }
+        }
+
+        // The start and goal join the abstract graph as two extra nodes past the real ones.
+        const std::size_t count = nodes_.size() + 2;
+        const auto startNode = static_cast<std::uint32_t>(nodes_.size());
+        const std::uint32_t goalNode = startNode + 1;
+        if (context.reached_.size() != count)
+        {
+            context.reached_.assign(count, 0);
+            context.closed_.assign(count, 0);
+            context.exitStamp_.assign(count, 0);
+            context.g_.resize(count);
+            context.parent_.resize(count);
+            context.exitCost_.resize(count);
+            context.generation_ = 0;
+        }
+        if (++context.generation_ == 0)
+        {
+            std::ranges::fill(context.reached_, 0);
+            std::ranges::fill(context.closed_, 0);
+            std::ranges::fill(context.exitStamp_, 0);
+            context.generation_ = 1;
+        }
+        const std::uint32_t generation = context.generation_;
+
+        flood(context.flood_, goalCluster, goal);
+        for (const std::uint32_t id : clusterNodes_[goalCluster])
+        {
+            const float distance = floodDistance(context.flood_, goalCluster, nodes_[id].cell);
+            if (distance != UNREACHED)
+            {
+                context.exitStamp_[id] = generation;
+                context.exitCost_[id] = distance;
+            }
+        }
+        flood(context.flood_, startCluster, start);
+        context.entries_.clear();
+        for (const std::uint32_t id : clusterNodes_[startCluster])
+        {
+            const float distance = floodDistance(context.flood_, startCluster, nodes_[id].cell);
+            if (distance != UNREACHED)
+            {
+                context.entries_.emplace_back(id, distance);
+            }
+        }
+
+        auto& open = context.open_;
+        open.clear();
+        const auto relax = [&](const std::uint32_t from, const std::uint32_t to, const float cost)
+        {
+            if (context.closed_[to] == generation)
+            {
+                return;
+            }
+            const float g = context.g_[from] + cost;
+            if (context.reached_[to] != generation || g < context.g_[to])
+            {
+                context.reached_[to] = generation;
+                context.g_[to] = g;
+                context.parent_[to] = from;
+                const float h = to == goalNode ? 0.0F : OctileDistance(nodes_[to].cell, goal);
+                open.push_back({g + h, g, to});
+                std::ranges::push_heap(open, OpenOrder{});
+            }
+        };
+
+        context.reached_[startNode] = generation;
+        context.g_[startNode] = 0.0F;
+        context.parent_[startNode] = INVALID_INDEX;
+        open.push_back({OctileDistance(start, goal), 0.0F, startNode});
+        while (!open.empty())
+        {
+            std::ranges::pop_heap(open, OpenOrder{});
+            const std::uint32_t id = open.back().node;
+            open.pop_back();
+            if (context.closed_[id] == generation)
+            {
+                continue;
+            }
+            context.closed_[id] = generation;
+            if (id == goalNode)
+            {
+                break;
+            }
+            if (id == startNode)
+            {
+                for (const auto& [to, cost] : context.entries_)
+                {
+                    relax(id, to, cost);
+                }
+                continue;
+            }
+            const Node& node = nodes_[id];
+            relax(id, node.partner, 1.0F);
+            for (const Edge& edge : node.edges)
+            {
+                relax(id, edge.to, edge.cost);
+            }
+            if (context.exitStamp_[id] == generation)
+            {
+                relax(id, goalNode, context.exitCost_[id]);
+            }
+        }
+        if (context.closed_[goalNode] != generation)
+        {
+            return false;
+        }
+
+        auto& route = context.route_;
+        route.clear();
+        for (std::uint32_t id = goalNode; id != INVALID_INDEX; id = context.parent_[id])
+        {
+            route.push_back(id);
+        }
+        std::ranges::reverse(route);
+
+        // Refine: border crossings are single steps, everything else a search confined to one cluster.
+        const auto cellOf = [&](const std::uint32_t id)
+        {
+            return id == startNode ? start : id == goalNode ? goal : nodes_[id].cell;
+        };
+        path.push_back(start);
+        for (std::size_t i = 0; i + 1 < route.size(); ++i)
+        {
+            const std::uint32_t from = route[i];
+            const std::uint32_t to = route[i + 1];
+            if (from < startNode && nodes_[from].partner == to)
+            {
+                path.push_back(nodes_[to].cell);
+                context.cost_ += 1.0F;
+                continue;
+            }
+            const math::Vec2i a = cellOf(from);
+            const CellRect rect = clusterRect(clusterOf(a));
+            const bool found = context.search_.findPath(*grid_, a, cellOf(to), context.segment_,
+                                                        SearchAlgorithm::JumpPoint, &rect);
+            PSYGINE_DEBUG_ASSERT(found, "PathHierarchy::findPath: refinement failed");
+            if (!found)
+            {
+                path.clear();
+                context.cost_ = 0.0F;
+                return false;
+            }
+            path.insert(path.end(), context.segment_.begin() + 1, context.segment_.end());
+            context.cost_ += context.search_.cost();
+        }
+        return true;
+    }
+
+    std::uint32_t PathHierarchy::clusterOf(const math::Vec2i& cell) const
+    {
+        return static_cast<std::uint32_t>((cell.y / clusterSize_) * clustersX_ + (cell.x / clusterSize_));
+    }
+
+    CellRect PathHierarchy::clusterRect(const std::uint32_t cluster) const
+    {
+        const auto index = static_cast<std::int32_t>(cluster);
+        const math::Vec2i min{(index % clustersX_) * clusterSize_, (index / clustersX_) * clusterSize_};
+        return {min, math::Min(min + math::Vec2i{clusterSize_, clusterSize_}, grid_->bounds().max)};
+    }
+
+    void PathHierarchy::markBorder(const std::uint32_t cluster, const std::uint32_t side)
+    {
+        const std::uint32_t border = (cluster * 2) + side;
+        if (borderDirty_[border] == 0)
+        {
+            borderDirty_[border] = 1;
+            dirtyBorders_.push_back(border);
+        }
+    }
+
+    void PathHierarchy::markCluster(const std::uint32_t cluster)
+    {
+        if (clusterDirty_[cluster] == 0)
+        {
+            clusterDirty_[cluster] = 1;
+            dirtyClusters_.push_back(cluster);
+        }
+    }
+
+    void PathHierarchy::rebuildBorder(const std::uint32_t border)
+    {
+        for (const std::uint32_t id : borderNodes_[border])
+        {
+            Node& node = nodes_[id];
+            std::erase(clusterNodes_[node.cluster], id);
+            node.edges.clear();
+            node.cluster = INVALID_INDEX;
+            node.partner = INVALID_INDEX;
+            freeNodes_.push_back(id);
+        }
+        borderNodes_[border].clear();
+
+        const std::uint32_t cluster = border / 2;
+        const bool east = border % 2 == 0;
+        markCluster(cluster);
+        markCluster(east ? cluster + 1 : cluster + static_cast<std::uint32_t>(clustersX_));
+
+        // Walk the cluster's last column or row alongside the first one of its neighbour.
+        const CellRect rect = clusterRect(cluster);
+        const math::Vec2i along = east ? math::Vec2i{0, 1} : math::Vec2i{1, 0};
+        const math::Vec2i across = east ? math::Vec2i{1, 0} : math::Vec2i{0, 1};
+        const math::Vec2i first = east ? math::Vec2i{rect.max.x - 1, rect.min.y}
+                                       : math::Vec2i{rect.min.x, rect.max.y - 1};
+        const std::int32_t length = east ? rect.max.y - rect.min.y : rect.max.x - rect.min.x;
+
+        const auto addTransition = [&](const std::int32_t offset)
+        {
+            const math::Vec2i inside = first + (along * offset);
+            const std::uint32_t a = addNode(inside);
+            const std::uint32_t b = addNode(inside + across);
+            nodes_[a].partner = b;
+            nodes_[b].partner = a;
+            borderNodes_[border].push_back(a);
+            borderNodes_[border].push_back(b);
+        };
+        std::int32_t runStart = -1;
+        for (std::int32_t i = 0; i <= length; ++i)
+        {
+            const math::Vec2i cell = first + (along * i);
+            const bool open = i < length && grid_->walkable(cell) && grid_->walkable(cell + across);
+            if (open && runStart < 0)
+            {
+                runStart = i;
+            }
+            else if (!open && runStart >= 0)
+            {
+                const std::int32_t run = i - runStart;
+                if (run <= MAX_SINGLE_TRANSITION)
+                {
+                    addTransition(runStart + (run / 2));
+                }
+                else
+                {
+                    addTransition(runStart);
+                    addTransition(i - 1);
+                }
+                runStart = -1;
+            }
+        }
+    }
+
+    void PathHierarchy::rebuildCluster(const std::uint32_t cluster)
+    {
+        const std::vector<std::uint32_t>& ids = clusterNodes_[cluster];
+        for (const std::uint32_t id : ids)
+        {
+            nodes_[id].edges.clear();
+        }
+        for (const std::uint32_t from : ids)
+        {
+            flood(flood_, cluster, nodes_[from].cell);
+            for (const std::uint32_t to : ids)
+            {
+                const float distance = floodDistance(flood_, cluster, nodes_[to].cell);
+                if (to != from && distance != UNREACHED)
+                {
+                    nodes_[from].edges.push_back({to, distance});
+                }
+            }
+        }
+    }
+
+    std::uint32_t PathHierarchy::addNode(const math::Vec2i& cell)
+    {
+        std::uint32_t id;
+        if (freeNodes_.empty())
+        {
+            id = static_cast<std::uint32_t>(nodes_.size());
+            nodes_.emplace_back();
+        }
+        else
+        {
+            id = freeNodes_.back();
+            freeNodes_.pop_back();
+        }
+        Node& node = nodes_[id];
+        node.cell = cell;
+        node.cluster = clusterOf(cell);
+        clusterNodes_[node.cluster].push_back(id);
+        return id;
+    }
+
+    void PathHierarchy::flood(Context::Flood& flood, const std::uint32_t cluster, const math::Vec2i& source) const
+    {
+        const auto capacity = static_cast<std::size_t>(clusterSize_) * static_cast<std::size_t>(clusterSize_);
+        if (flood.stamp.size() != capacity)
+        {
+            flood.stamp.assign(capacity, 0);
+            flood.distance.resize(capacity);
+            flood.generation = 0;
+        }
+        if (++flood.generation == 0)
+        {
+            std::ranges::fill(flood.stamp, 0);
+            flood.generation = 1;
+        }
+
+        // Dijkstra over the cluster alone, with the same movement rules as the grid searches.
+        const CellRect rect = clusterRect(cluster);
+        const auto width = static_cast<std::uint32_t>(rect.max.x - rect.min.x);
+        const auto local = [&](const math::Vec2i& cell)
+        {
+            return (static_cast<std::uint32_t>(cell.y - rect.min.y) * width) +
+                static_cast<std::uint32_t>(cell.x - rect.min.x);
+        };
+        const auto passable = [&](const math::Vec2i& cell)
+        {
+            return rect.contains(cell) && grid_->walkable(cell);
+        };
+
+        auto& open = flood.open;
+        open.clear();
+        flood.stamp[local(source)] = flood.generation;
+        flood.distance[local(source)] = 0.0F;
+        open.emplace_back(0.0F, local(source));
+        while (!open.empty())
+        {
+            std::ranges::pop_heap(open, std::greater{});
+            const auto [distance, index] = open.back();
+            open.pop_back();
+            if (distance > flood.distance[index])
+            {
+                continue;
+            }
+            const math::Vec2i cell = rect.min + math::Vec2i{static_cast<std::int32_t>(index % width),
+                                                            static_cast<std::int32_t>(index / width)};
+            for (const math::Vec2i& d : DIRECTIONS)
+            {
+                const math::Vec2i next = cell + d;
+                const bool diagonal = d.x != 0 && d.y != 0;
+                if (!passable(next) || (diagonal && (!passable({cell.x + d.x, cell.y}) ||
+                    !passable({cell.x, cell.y + d.y}))))
+                {
+                    continue;
+                }
+                const float reached = distance + (diagonal ? std::numbers::sqrt2_v<float> : 1.0F);
+                const std::uint32_t to = local(next);
+                if (flood.stamp[to] != flood.generation || reached < flood.distance[to])
+                {
+                    flood.stamp[to] = flood.generation;
+                    flood.distance[to] = reached;
+                    open.emplace_back(reached, to);
+                    std::ranges::push_heap(open, std::greater{});
+                }
+            }
+        }
+    }
+
+    float PathHierarchy::floodDistance(const Context::Flood& flood, const std::uint32_t cluster,
+                                       const math::Vec2i& cell) const
+    {
+        const CellRect rect = clusterRect(cluster);
+        const auto index = (static_cast<std::uint32_t>(cell.y - rect.min.y) *
+            static_cast<std::uint32_t>(rect.max.x - rect.min.x)) + static_cast<std::uint32_t>(cell.x - rect.min.x);
+        return flood.stamp[index] == flood.generation ? flood.distance[index] : UNREACHED;
+    }
+}
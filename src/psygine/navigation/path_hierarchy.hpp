@@ -0,0 +1,185 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#ifndef PSYGINE_PATH_HIERARCHY_HPP
+#define PSYGINE_PATH_HIERARCHY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "grid_search.hpp"
+#include "nav_grid.hpp"
+#include "psygine/math/vector.hpp"
+
+namespace psygine::navigation
+{
+    /**
+     * @brief A hierarchical abstraction of a `NavGrid` (HPA*) for long paths.
+     *
+     * The grid is cut into square clusters. Where two neighbouring clusters share an open stretch of
+     * border, a pair of transition nodes links them, and the nodes inside each cluster are linked by
+     * their shortest in-cluster distances. A long search then runs over this small graph and is refined
+     * cluster by cluster into grid cells, trading a few percent of path length for a search that no
+     * longer grows with the area between the endpoints.
+     *
+     * Edits are incremental: report changed cells with `cellChanged` and only the touched borders and
+     * clusters are rebuilt by the next `refresh`.
+     */
+    class PathHierarchy
+    {
+    public:
+        static constexpr std::int32_t DEFAULT_CLUSTER_SIZE = 16;
+
+        /**
+         * @brief Per-thread search state. `findPath` only reads the hierarchy, so any number of contexts
+         * can search it at once.
+         */
+        class Context
+        {
+        public:
+            /**
+             * @brief The cost of the last path found.
+             */
+            [[nodiscard]] float cost() const
+            {
+                return cost_;
+            }
+
+        private:
+            friend class PathHierarchy;
+
+            struct OpenNode
+            {
+                float f;
+                float g;
+                std::uint32_t node;
+            };
+
+            struct Flood
+            {
+                std::vector<float> distance;
+                std::vector<std::uint32_t> stamp;
+                std::vector<std::pair<float, std::uint32_t>> open;
+                std::uint32_t generation = 0;
+            };
+
+            GridSearch search_;
+            Flood flood_;
+
+            // Abstract search state, stamped like `GridSearch`'s.
+            std::vector<std::uint32_t> reached_;
+            std::vector<std::uint32_t> closed_;
+            std::vector<float> g_;
+            std::vector<std::uint32_t> parent_;
+            std::vector<std::uint32_t> exitStamp_;
+            std::vector<float> exitCost_;
+            std::vector<OpenNode> open_;
+            std::uint32_t generation_ = 0;
+
+            std::vector<std::pair<std::uint32_t, float>> entries_;
+            std::vector<std::uint32_t> route_;
+            std::vector<math::Vec2i> segment_;
+            float cost_ = 0.0F;
+        };
+
+        /**
+         * @brief Builds the hierarchy over `grid`, which must outlive it.
+         */
+        explicit PathHierarchy(const NavGrid& grid, std::int32_t clusterSize = DEFAULT_CLUSTER_SIZE);
+
+        /**
+         * @brief Marks the parts of the hierarchy a changed cell affects for the next `refresh`.
+         */
+        void cellChanged(const math::Vec2i& cell);
+
+        /**
+         * @brief Rebuilds what changed since the last refresh. Must not run alongside `findPath`.
+         */
+        void refresh();
+
+        /**
+         * @brief Whether changes are waiting for `refresh`.
+         */
+        [[nodiscard]] bool dirty() const
+        {
+            return !dirtyClusters_.empty() || !dirtyBorders_.empty();
+        }
+
+        /**
+         * @brief Finds a path from `start` to `goal` through the hierarchy.
+         *
+         * Endpoints in the same cluster are first tried with a search confined to it. The result is a
+         * valid path but not always a shortest one.
+         *
+         * @param path Receives every cell of the path, `start` and `goal` included; empty when there is
+         *             no path.
+         * @return Whether a path was found.
+         */
+        bool findPath(Context& context, const math::Vec2i& start, const math::Vec2i& goal,
+                      std::vector<math::Vec2i>& path) const;
+
+        [[nodiscard]] std::int32_t clusterSize() const
+        {
+            return clusterSize_;
+        }
+
+        /**
+         * @brief Number of transition nodes in the abstract graph.
+         */
+        [[nodiscard]] std::size_t nodeCount() const
+        {
+            return nodes_.size() - freeNodes_.size();
+        }
+
+    private:
+        static constexpr std::uint32_t INVALID_INDEX = 0xFFFFFFFFU;
+
+        struct Edge
+        {
+            std::uint32_t to;
+            float cost;
+        };
+
+        struct Node
+        {
+            math::Vec2i cell{};
+            std::uint32_t cluster = INVALID_INDEX;
+            // The node across the border, one straight step away.
+            std::uint32_t partner = INVALID_INDEX;
+            std::vector<Edge> edges;
+        };
+
+        [[nodiscard]] std::uint32_t clusterOf(const math::Vec2i& cell) const;
+        [[nodiscard]] CellRect clusterRect(std::uint32_t cluster) const;
+        void markBorder(std::uint32_t cluster, std::uint32_t side);
+        void markCluster(std::uint32_t cluster);
+        void rebuildBorder(std::uint32_t border);
+        void rebuildCluster(std::uint32_t cluster);
+        std::uint32_t addNode(const math::Vec2i& cell);
+        void flood(Context::Flood& flood, std::uint32_t cluster, const math::Vec2i& source) const;
+        [[nodiscard]] float floodDistance(const Context::Flood& flood, std::uint32_t cluster,
+                                          const math::Vec2i& cell) const;
+
+        const NavGrid* grid_;
+        std::int32_t clusterSize_;
+        std::int32_t clustersX_;
+        std::int32_t clustersY_;
+
+        std::vector<Node> nodes_;
+        std::vector<std::uint32_t> freeNodes_;
+        // Transition nodes inside each cluster.
+        std::vector<std::vector<std::uint32_t>> clusterNodes_;
+        // Border `cluster * 2` is a cluster's east border and `cluster * 2 + 1` its south border.
+        std::vector<std::vector<std::uint32_t>> borderNodes_;
+
+        std::vector<std::uint8_t> clusterDirty_;
+        std::vector<std::uint8_t> borderDirty_;
+        std::vector<std::uint32_t> dirtyClusters_;
+        std::vector<std::uint32_t> dirtyBorders_;
+        Context::Flood flood_;
+    };
+}
+
+#endif //PSYGINE_PATH_HIERARCHY_HPP
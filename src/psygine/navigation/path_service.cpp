@@ -0,0 +1,223 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#include "path_service.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+#include "psygine/debug/assert.hpp"
+#include "psygine/utilities/time.hpp"
+
+namespace psygine::navigation
+{
+    PathService::PathService(const std::int32_t width, const std::int32_t height, const std::size_t cacheCapacity,
+                             const std::int32_t clusterSize) :
+        grid_{width, height},
+        hierarchy_{grid_, clusterSize},
+        cache_{cacheCapacity}
+    {
+    }
+
+    void PathService::setWalkable(const math::Vec2i& cell, const bool walkable)
+    {
+        if (grid_.walkable(cell) == walkable)
+        {
+            return;
+        }
+        grid_.setWalkable(cell, walkable);
+        hierarchy_.cellChanged(cell);
+        cache_.cellChanged(cell, walkable);
+    }
+
+    PathHandle PathService::request(const math::Vec2i& start, const math::Vec2i& goal)
+    {
+        std::uint32_t index;
+        if (freeRequests_.empty())
+        {
+            index = static_cast<std::uint32_t>(requests_.size());
+            requests_.emplace_back();
+        }
+        else
+        {
+            index = freeRequests_.back();
+            freeRequests_.pop_back();
+        }
+        Request& request = requests_[index];
+        request.start = start;
+        request.goal = goal;
+        request.path.clear();
+        request.cost = 0.0F;
+        request.status = PathStatus::Pending;
+
+        const PathHandle handle{index, request.generation};
+        queue_.push_back(handle);
+        return handle;
+    }
+
+    PathStatus PathService::status(const PathHandle handle) const
+    {
+        const Request* request = find(handle);
+        return request != nullptr ? request->status : PathStatus::Invalid;
+    }
+
+    std::span<const math::Vec2i> PathService::path(const PathHandle handle) const
+    {
+        const Request* request = find(handle);
+        if (request == nullptr)
+        {
+            return {};
+        }
+        return request->path;
+    }
+
+    float PathService::cost(const PathHandle handle) const
+    {
+        const Request* request = find(handle);
+        PSYGINE_ASSERT(request != nullptr && request->status == PathStatus::Found,
+                       "PathService::cost: no path was found for this request");
+        return request->cost;
+    }
+
+    void PathService::release(const PathHandle handle)
+    {
+        Request* request = find(handle);
+        if (request == nullptr)
+        {
+            return;
+        }
+        if (request->status == PathStatus::Pending)
+        {
+            std::erase(queue_, handle);
+        }
+        request->status = PathStatus::Invalid;
+        request->path.clear();
+        ++request->generation;
+        freeRequests_.push_back(handle.index);
+    }
+
+    void PathService::update(core::ThreadPool* pool, const double budgetMilliseconds)
+    {
+        const auto start = utilities::time::Now();
+        hierarchy_.refresh();
+
+        // Answer what the cache and the grid bounds can, and give every distinct start and goal one job.
+        jobs_.clear();
+        waiting_.clear();
+        jobLookup_.clear();
+        for (const PathHandle handle : queue_)
+        {
+            Request& request = requests_[handle.index];
+            if (!grid_.inBounds(request.start) || !grid_.inBounds(request.goal))
+            {
+                request.status = PathStatus::NotFound;
+                continue;
+            }
+            if (const std::vector<math::Vec2i>* cached = cache_.find(request.start, request.goal))
+            {
+                request.path = *cached;
+                request.cost = cache_.cost(request.start, request.goal);
+                request.status = PathStatus::Found;
+                continue;
+            }
+            const std::uint64_t key = (static_cast<std::uint64_t>(grid_.index(request.start)) << 32) |
+                grid_.index(request.goal);
+            const auto [job, added] = jobLookup_.try_emplace(key, static_cast<std::uint32_t>(jobs_.size()));
+            if (added)
+            {
+                jobs_.push_back({handle.index, {}, 0.0F, false, false});
+            }
+            waiting_.emplace_back(handle, job->second);
+        }
+        queue_.clear();
+        if (jobs_.empty())
+        {
+            return;
+        }
+
+        // Workers claim jobs one at a time and stop claiming once the budget is spent.
+        const std::size_t workerCount = pool != nullptr ? std::min(pool->concurrency(), jobs_.size()) : 1;
+        if (contexts_.size() < workerCount)
+        {
+            contexts_.resize(workerCount);
+        }
+        std::atomic<std::size_t> next{0};
+        const auto solve = [&](const std::size_t worker)
+        {
+            PathHierarchy::Context& context = contexts_[worker];
+            for (;;)
+            {
+                const std::size_t index = next.fetch_add(1, std::memory_order_relaxed);
+                if (index >= jobs_.size())
+                {
+                    return;
+                }
+                Job& job = jobs_[index];
+                const Request& request = requests_[job.request];
+                job.found = hierarchy_.findPath(context, request.start, request.goal, job.path);
+                job.cost = context.cost();
+                job.done = true;
+                if (utilities::time::ElapsedSinceMilliseconds(start) >= budgetMilliseconds)
+                {
+                    return;
+                }
+            }
+        };
+        if (workerCount == 1)
+        {
+            solve(0);
+        }
+        else
+        {
+            pool->parallelFor(workerCount, 1, [&](const std::size_t begin, const std::size_t end)
+            {
+                for (std::size_t worker = begin; worker < end; ++worker)
+                {
+                    solve(worker);
+                }
+            });
+        }
+
+        // Publish serially and in request order, so the cache ends up the same however the work was split.
+        for (const Job& job : jobs_)
+        {
+            if (job.done && job.found)
+            {
+                const Request& request = requests_[job.request];
+                cache_.insert(request.start, request.goal, job.path, job.cost);
+            }
+        }
+        for (const auto& [handle, index] : waiting_)
+        {
+            const Job& job = jobs_[index];
+            if (!job.done)
+            {
+                queue_.push_back(handle);
+                continue;
+            }
+            Request& request = requests_[handle.index];
+            request.path = job.path;
+            request.cost = job.cost;
+            request.status = job.found ? PathStatus::Found : PathStatus::NotFound;
+        }
+    }
+
+    PathService::Request* PathService::find(const PathHandle handle)
+    {
+        return const_cast<Request*>(std::as_const(*this).find(handle));
+    }
+
+    const PathService::Request* PathService::find(const PathHandle handle) const
+    {
+        if (handle.index >= requests_.size())
+        {
+            return nullptr;
+        }
+        const Request& request = requests_[handle.index];
+        if (request.generation != handle.generation || request.status == PathStatus::Invalid)
+        {
+            return nullptr;
+        }
+        return &request;
+    }
+}
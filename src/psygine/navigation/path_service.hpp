@@ -0,0 +1,163 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#ifndef PSYGINE_PATH_SERVICE_HPP
+#define PSYGINE_PATH_SERVICE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "nav_grid.hpp"
+#include "path_cache.hpp"
+#include "path_hierarchy.hpp"
+#include "psygine/core/thread_pool.hpp"
+#include "psygine/math/vector.hpp"
+
+namespace psygine::navigation
+{
+    /**
+     * @brief Identifies a path request. A released request's slot gets a new generation when reused, so
+     * stale handles report `PathStatus::Invalid`.
+     */
+    struct PathHandle
+    {
+        static constexpr std::uint32_t INVALID_INDEX = std::numeric_limits<std::uint32_t>::max();
+
+        std::uint32_t index = INVALID_INDEX;
+        std::uint32_t generation = 0;
+
+        [[nodiscard]] bool valid() const
+        {
+            return index != INVALID_INDEX;
+        }
+
+        bool operator==(const PathHandle&) const = default;
+    };
+
+    enum class PathStatus : std::uint8_t
+    {
+        Invalid,
+        Pending,
+        Found,
+        NotFound
+    };
+
+    /**
+     * @brief Asynchronous pathfinding over a `NavGrid`: requests are queued, then solved in time-sliced
+     * batches by `update`.
+     *
+     * Each update first serves what it can from the path cache and folds duplicate requests together,
+     * then solves the rest through the `PathHierarchy` on the thread pool until the time budget runs out.
+     * Requests not reached stay pending, in order, for the next update. Results are the same whatever the
+     * pool size; only how many requests fit in the budget changes.
+     */
+    class PathService
+    {
+    public:
+        static constexpr std::size_t DEFAULT_CACHE_CAPACITY = 1024;
+        static constexpr double DEFAULT_BUDGET_MILLISECONDS = 2.0;
+
+        PathService(std::int32_t width, std::int32_t height, std::size_t cacheCapacity = DEFAULT_CACHE_CAPACITY,
+                    std::int32_t clusterSize = PathHierarchy::DEFAULT_CLUSTER_SIZE);
+
+        [[nodiscard]] const NavGrid& grid() const
+        {
+            return grid_;
+        }
+
+        /**
+         * @brief Edits the grid, keeping the hierarchy and cache in step. Paths already found are left
+         * as they are.
+         */
+        void setWalkable(const math::Vec2i& cell, bool walkable);
+
+        /**
+         * @brief Queues a path request from `start` to `goal`.
+         */
+        [[nodiscard]] PathHandle request(const math::Vec2i& start, const math::Vec2i& goal);
+
+        [[nodiscard]] PathStatus status(PathHandle handle) const;
+
+        /**
+         * @brief Every cell of a found path, start and goal included; empty otherwise.
+         */
+        [[nodiscard]] std::span<const math::Vec2i> path(PathHandle handle) const;
+
+        /**
+         * @brief The cost of a found path.
+         */
+        [[nodiscard]] float cost(PathHandle handle) const;
+
+        /**
+         * @brief Frees a request, pending or not. The handle becomes invalid.
+         */
+        void release(PathHandle handle);
+
+        /**
+         * @brief Solves queued requests until `budgetMilliseconds` have passed; every worker finishes the
+         * request it is on, so at least one is solved per update.
+         *
+         * @param pool Spreads the searches over its threads. Null solves them on the calling thread.
+         */
+        void update(core::ThreadPool* pool = nullptr, double budgetMilliseconds = DEFAULT_BUDGET_MILLISECONDS);
+
+        /**
+         * @brief Requests still waiting to be solved.
+         */
+        [[nodiscard]] std::size_t pending() const
+        {
+            return queue_.size();
+        }
+
+        // The hierarchy refers to the grid it was built over, so the service stays where it is.
+        PathService(const PathService& other) = delete;
+        PathService(PathService&& other) noexcept = delete;
+        PathService& operator=(const PathService& other) = delete;
+        PathService& operator=(PathService&& other) noexcept = delete;
+
+    private:
+        struct Request
+        {
+            math::Vec2i start{};
+            math::Vec2i goal{};
+            std::vector<math::Vec2i> path;
+            float cost = 0.0F;
+            std::uint32_t generation = 0;
+            PathStatus status = PathStatus::Invalid;
+        };
+
+        // A distinct start and goal being solved this update, shared by every request asking for it.
+        struct Job
+        {
+            std::uint32_t request;
+            std::vector<math::Vec2i> path;
+            float cost;
+            bool found;
+            bool done;
+        };
+
+        [[nodiscard]] Request* find(PathHandle handle);
+        [[nodiscard]] const Request* find(PathHandle handle) const;
+
+        NavGrid grid_;
+        PathHierarchy hierarchy_;
+        PathCache cache_;
+
+        std::vector<Request> requests_;
+        std::vector<std::uint32_t> freeRequests_;
+        std::vector<PathHandle> queue_;
+
+        std::vector<Job> jobs_;
+        // Pending requests this update, with the job solving each.
+        std::vector<std::pair<PathHandle, std::uint32_t>> waiting_;
+        std::unordered_map<std::uint64_t, std::uint32_t> jobLookup_;
+        std::vector<PathHierarchy::Context> contexts_;
+    };
+}
+
+#endif //PSYGINE_PATH_SERVICE_HPP
@@ -0,0 +1,271 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#include "collision.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+    using psygine::math::Vec2;
+    using psygine::physics::MAX_POLYGON_VERTICES;
+
+    // Feature kinds stored in contact ids.
+    constexpr std::uint32_t FEATURE_VERTEX = 0;
+    constexpr std::uint32_t FEATURE_FACE = 1;
+
+    constexpr std::uint32_t MakeId(const std::uint32_t indexA, const std::uint32_t indexB, const std::uint32_t typeA,
+                                   const std::uint32_t typeB)
+    {
+        return indexA | (indexB << 8) | (typeA << 16) | (typeB << 24);
+    }
+
+    // Swaps the A and B halves of an id, for manifolds computed with the shapes swapped.
+    constexpr std::uint32_t FlipId(const std::uint32_t id)
+    {
+        return ((id & 0xFFU) << 8) | ((id >> 8) & 0xFFU) | ((id & 0xFF0000U) << 8) | ((id >> 8) & 0xFF0000U);
+    }
+
+    struct WorldPolygon
+    {
+        std::array<Vec2, MAX_POLYGON_VERTICES> vertices;
+        std::array<Vec2, MAX_POLYGON_VERTICES> normals;
+        std::uint32_t count;
+    };
+
+    WorldPolygon ToWorld(const psygine::physics::Polygon& polygon, const psygine::physics::Transform& xf)
+    {
+        WorldPolygon world{};
+        world.count = polygon.count;
+        for (std::uint32_t i = 0; i < polygon.count; ++i)
+        {
+            world.vertices[i] = TransformPoint(xf, polygon.vertices[i]);
+            world.normals[i] = Rotate(xf.rotation, polygon.normals[i]);
+        }
+        return world;
+    }
+
+    // The largest distance from an edge of `p1` to the deepest vertex of `p2`, and that edge.
+    float FindMaxSeparation(const WorldPolygon& p1, const WorldPolygon& p2, std::uint32_t& edge)
+    {
+        float best = -std::numeric_limits<float>::max();
+        edge = 0;
+        for (std::uint32_t i = 0; i < p1.count; ++i)
+        {
+            const Vec2 n = p1.normals[i];
+            const Vec2 v = p1.vertices[i];
+            float deepest = std::numeric_limits<float>::max();
+            for (std::uint32_t j = 0; j < p2.count; ++j)
+            {
+                deepest = std::min(deepest, psygine::math::Dot(n, p2.vertices[j] - v));
+            }
+            if (deepest > best)
+            {
+                best = deepest;
+                edge = i;
+            }
+        }
+        return best;
+    }
+
+    struct ClipVertex
+    {
+        Vec2 v;
+        std::uint32_t id;
+    };
+
+    // Keeps the part of the segment behind the plane dot(normal, x) = offset. A point moved onto the
+    // plane keeps the id of the vertex it replaces, so contact ids do not change as a resting body
+    // rocks across the reference face's corners.
+    std::uint32_t ClipSegment(std::array<ClipVertex, 2>& out, const std::array<ClipVertex, 2>& in, const Vec2& normal,
+                              const float offset)
+    {
+        std::uint32_t count = 0;
+        const float distance0 = psygine::math::Dot(normal, in[0].v) - offset;
+        const float distance1 = psygine::math::Dot(normal, in[1].v) - offset;
+        if (distance0 <= 0.0F)
+        {
+            out[count++] = in[0];
+        }
+        if (distance1 <= 0.0F)
+        {
+            out[count++] = in[1];
+        }
+        if (distance0 * distance1 < 0.0F)
+        {
+            const float t = distance0 / (distance0 - distance1);
+            out[count].v = in[0].v + ((in[1].v - in[0].v) * t);
+            out[count].id = distance0 > 0.0F ? in[0].id : in[1].id;
+            ++count;
+        }
+        return count;
+    }
+}
+
+namespace psygine::physics
+{
+    Manifold CollideCircles(const Circle& circleA, const Transform& xfA, const Circle& circleB, const Transform& xfB,
+                            const float speculativeDistance)
+    {
+        Manifold manifold;
+        const math::Vec2 pA = TransformPoint(xfA, circleA.center);
+        const math::Vec2 pB = TransformPoint(xfB, circleB.center);
+        const math::Vec2 d = pB - pA;
+        const float distance = math::Length(d);
+        const float separation = distance - circleA.radius - circleB.radius;
+        if (separation > speculativeDistance)
+        {
+            return manifold;
+        }
+
+        manifold.normal = distance > std::numeric_limits<float>::epsilon() ? d / distance : math::Vec2{0.0F, 1.0F};
+        const math::Vec2 cA = pA + (manifold.normal * circleA.radius);
+        const math::Vec2 cB = pB - (manifold.normal * circleB.radius);
+        manifold.points[0].point = (cA + cB) * 0.5F;
+        manifold.points[0].separation = separation;
+        manifold.pointCount = 1;
+        return manifold;
+    }
+
+    Manifold CollidePolygonAndCircle(const Polygon& polygonA, const Transform& xfA, const Circle& circleB,
+                                     const Transform& xfB, const float speculativeDistance)
+    {
+        Manifold manifold;
+        const WorldPolygon polygon = ToWorld(polygonA, xfA);
+        const math::Vec2 c = TransformPoint(xfB, circleB.center);
+        const float radius = circleB.radius;
+
+        // The face the circle center is furthest in front of.
+        std::uint32_t face = 0;
+        float separation = -std::numeric_limits<float>::max();
+        for (std::uint32_t i = 0; i < polygon.count; ++i)
+        {
+            const float s = math::Dot(polygon.normals[i], c - polygon.vertices[i]);
+            if (s > radius + speculativeDistance)
+            {
+                return manifold;
+            }
+            if (s > separation)
+            {
+                separation = s;
+                face = i;
+            }
+        }
+
+        const math::Vec2 v1 = polygon.vertices[face];
+        const math::Vec2 v2 = polygon.vertices[(face + 1) % polygon.count];
+        math::Vec2 normal = polygon.normals[face];
+        math::Vec2 cA = c - (normal * separation);
+        std::uint32_t id = MakeId(face, 0, FEATURE_FACE, FEATURE_VERTEX);
+
+        // Outside the polygon, past either end of the face, the closest feature is a vertex.
+        const bool beforeFirst = math::Dot(c - v1, v2 - v1) <= 0.0F;
+        const bool pastSecond = math::Dot(c - v2, v1 - v2) <= 0.0F;
+        if (separation > std::numeric_limits<float>::epsilon() && (beforeFirst || pastSecond))
+        {
+            const std::uint32_t vertexIndex = beforeFirst ? face : (face + 1) % polygon.count;
+            const math::Vec2 d = c - polygon.vertices[vertexIndex];
+            const float distance = math::Length(d);
+            if (distance - radius > speculativeDistance)
+            {
+                return manifold;
+            }
+            if (distance > std::numeric_limits<float>::epsilon())
+            {
+                normal = d / distance;
+            }
+            cA = polygon.vertices[vertexIndex];
+            separation = distance;
+            id = MakeId(vertexIndex, 0, FEATURE_VERTEX, FEATURE_VERTEX);
+        }
+
+        const math::Vec2 cB = c - (normal * radius);
+        manifold.normal = normal;
+        manifold.points[0].point = (cA + cB) * 0.5F;
+        manifold.points[0].separation = separation - radius;
+        manifold.points[0].id = id;
+        manifold.pointCount = 1;
+        return manifold;
+    }
+
+    Manifold CollidePolygons(const Polygon& polygonA, const Transform& xfA, const Polygon& polygonB,
+                             const Transform& xfB, const float speculativeDistance)
+    {
+        Manifold manifold;
+        const WorldPolygon a = ToWorld(polygonA, xfA);
+        const WorldPolygon b = ToWorld(polygonB, xfB);
+
+        std::uint32_t edgeA = 0;
+        const float separationA = FindMaxSeparation(a, b, edgeA);
+        if (separationA > speculativeDistance)
+        {
+            return manifold;
+        }
+
+        std::uint32_t edgeB = 0;
+        const float separationB = FindMaxSeparation(b, a, edgeB);
+        if (separationB > speculativeDistance)
+        {
+            return manifold;
+        }
+
+        // Prefer A's face unless B's is clearly better, so the choice does not flicker between steps.
+        const bool flip = separationB > separationA + (0.1F * LINEAR_SLOP);
+        const WorldPolygon& reference = flip ? b : a;
+        const WorldPolygon& incident = flip ? a : b;
+        const std::uint32_t referenceEdge = flip ? edgeB : edgeA;
+
+        // The incident edge is the one whose normal is most anti-parallel to the reference normal.
+        const math::Vec2 referenceNormal = reference.normals[referenceEdge];
+        std::uint32_t incidentEdge = 0;
+        float minDot = std::numeric_limits<float>::max();
+        for (std::uint32_t i = 0; i < incident.count; ++i)
+        {
+            const float d = math::Dot(referenceNormal, incident.normals[i]);
+            if (d < minDot)
+            {
+                minDot = d;
+                incidentEdge = i;
+            }
+        }
+        const std::uint32_t incidentNext = (incidentEdge + 1) % incident.count;
+        const std::array<ClipVertex, 2> incidentSegment{
+            ClipVertex{
+                incident.vertices[incidentEdge], MakeId(referenceEdge, incidentEdge, FEATURE_FACE, FEATURE_VERTEX)
+            },
+            ClipVertex{
+                incident.vertices[incidentNext], MakeId(referenceEdge, incidentNext, FEATURE_FACE, FEATURE_VERTEX)
+            },
+        };
+
+        const std::uint32_t referenceNext = (referenceEdge + 1) % reference.count;
+        const math::Vec2 v11 = reference.vertices[referenceEdge];
+        const math::Vec2 v12 = reference.vertices[referenceNext];
+        const math::Vec2 tangent = math::Normalize(v12 - v11);
+
+        std::array<ClipVertex, 2> clip1{};
+        std::array<ClipVertex, 2> clip2{};
+        if (ClipSegment(clip1, incidentSegment, -tangent, -math::Dot(tangent, v11)) < 2 ||
+            ClipSegment(clip2, clip1, tangent, math::Dot(tangent, v12)) < 2)
+        {
+            return manifold;
+        }
+
+        const float frontOffset = math::Dot(referenceNormal, v11);
+        for (const ClipVertex& vertex : clip2)
+        {
+            const float separation = math::Dot(referenceNormal, vertex.v) - frontOffset;
+            if (separation > speculativeDistance)
+            {
+                continue;
+            }
+            ManifoldPoint& point = manifold.points[manifold.pointCount++];
+            point.point = vertex.v - (referenceNormal * (0.5F * separation));
+            point.separation = separation;
+            point.id = flip ? FlipId(vertex.id) : vertex.id;
+        }
+        manifold.normal = flip ? -referenceNormal : referenceNormal;
+        return manifold;
+    }
+}
@@ -0,0 +1,67 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#ifndef PSYGINE_COLLISION_HPP
+#define PSYGINE_COLLISION_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "geometry.hpp"
+#include "psygine/math/vector.hpp"
+
+namespace psygine::physics
+{
+    inline constexpr std::size_t MAX_MANIFOLD_POINTS = 2;
+
+    /**
+     * @brief One contact point, in world space.
+     */
+    struct ManifoldPoint
+    {
+        // Midway between the two surfaces.
+        math::Vec2 point{};
+        // Negative when the shapes overlap; positive for speculative points.
+        float separation = 0.0F;
+        // Accumulated solver impulses, carried over between steps for warm starting.
+        float normalImpulse = 0.0F;
+        float tangentImpulse = 0.0F;
+        // Identifies the pair of features that produced the point, so it can be matched next step.
+        std::uint32_t id = 0;
+    };
+
+    /**
+     * @brief The contact points between two shapes, with a normal pointing from the first shape to the second.
+     */
+    struct Manifold
+    {
+        math::Vec2 normal{};
+        std::array<ManifoldPoint, MAX_MANIFOLD_POINTS> points{};
+        std::uint32_t pointCount = 0;
+    };
+
+    /**
+     * @brief Contact between two circles.
+     *
+     * Every collider reports points up to `speculativeDistance` apart as well, so the solver can stop
+     * approaching shapes before they overlap.
+     */
+    Manifold CollideCircles(const Circle& circleA, const Transform& xfA, const Circle& circleB, const Transform& xfB,
+                            float speculativeDistance);
+
+    /**
+     * @brief Contact between a polygon and a circle.
+     */
+    Manifold CollidePolygonAndCircle(const Polygon& polygonA, const Transform& xfA, const Circle& circleB,
+                                     const Transform& xfB, float speculativeDistance);
+
+    /**
+     * @brief Contact between two convex polygons: separating axis test, then clipping the incident
+     * edge against the reference face for up to two points.
+     */
+    Manifold CollidePolygons(const Polygon& polygonA, const Transform& xfA, const Polygon& polygonB,
+                             const Transform& xfB, float speculativeDistance);
+}
+
+#endif //PSYGINE_COLLISION_HPP
@@ -0,0 +1,184 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#include "geometry.hpp"
+
+#include <algorithm>
+#include <numbers>
+#include <vector>
+
+#include "psygine/debug/assert.hpp"
+
+namespace
+{
+    using psygine::math::Vec2;
+
+    // Area-weighted centroid of a counter-clockwise polygon.
+    Vec2 PolygonCentroid(const psygine::physics::Polygon& polygon)
+    {
+        const Vec2 origin = polygon.vertices[0];
+        Vec2 center{};
+        float area = 0.0F;
+        for (std::uint32_t i = 1; i + 1 < polygon.count; ++i)
+        {
+            const Vec2 e1 = polygon.vertices[i] - origin;
+            const Vec2 e2 = polygon.vertices[i + 1] - origin;
+            const float triangleArea = 0.5F * psygine::math::Cross(e1, e2);
+            center += (e1 + e2) * (triangleArea / 3.0F);
+            area += triangleArea;
+        }
+        PSYGINE_ASSERT(area > 0.0F, "Polygon: degenerate polygon");
+        return origin + (center / area);
+    }
+
+    void FinishPolygon(psygine::physics::Polygon& polygon)
+    {
+        for (std::uint32_t i = 0; i < polygon.count; ++i)
+        {
+            const Vec2 edge = polygon.vertices[(i + 1) % polygon.count] - polygon.vertices[i];
+            polygon.normals[i] = psygine::math::Normalize(Vec2{edge.y, -edge.x});
+        }
+        polygon.centroid = PolygonCentroid(polygon);
+    }
+}
+
+namespace psygine::physics
+{
+    Polygon MakeBox(const float halfWidth, const float halfHeight)
+    {
+        return MakeOffsetBox(halfWidth, halfHeight, {}, {});
+    }
+
+    Polygon MakeOffsetBox(const float halfWidth, const float halfHeight, const math::Vec2& center,
+                          const Rotation& rotation)
+    {
+        PSYGINE_ASSERT(halfWidth > 0.0F && halfHeight > 0.0F, "MakeBox: extents must be positive");
+
+        const Transform xf{center, rotation};
+        Polygon polygon;
+        polygon.count = 4;
+        polygon.vertices[0] = TransformPoint(xf, {-halfWidth, -halfHeight});
+        polygon.vertices[1] = TransformPoint(xf, {halfWidth, -halfHeight});
+        polygon.vertices[2] = TransformPoint(xf, {halfWidth, halfHeight});
+        polygon.vertices[3] = TransformPoint(xf, {-halfWidth, halfHeight});
+        polygon.normals[0] = Rotate(rotation, {0.0F, -1.0F});
+        polygon.normals[1] = Rotate(rotation, {1.0F, 0.0F});
+        polygon.normals[2] = Rotate(rotation, {0.0F, 1.0F});
+        polygon.normals[3] = Rotate(rotation, {-1.0F, 0.0F});
+        polygon.centroid = center;
+        return polygon;
+    }
+
+    Polygon MakePolygon(const std::span<const math::Vec2> points)
+    {
+        PSYGINE_ASSERT(points.size() >= 3, "MakePolygon: at least 3 points are needed");
+
+        std::vector<math::Vec2> welded;
+        welded.reserve(points.size());
+        for (const math::Vec2& p : points)
+        {
+            const bool duplicate = std::ranges::any_of(welded, [&p](const math::Vec2& q)
+            {
+                return math::LengthSquared(p - q) < LINEAR_SLOP * LINEAR_SLOP;
+            });
+            if (!duplicate)
+            {
+                welded.push_back(p);
+            }
+        }
+        std::ranges::sort(welded, [](const math::Vec2& a, const math::Vec2& b)
+        {
+            return a.x < b.x || (a.x == b.x && a.y < b.y);
+        });
+
+        // Andrew's monotone chain; popping on non-left turns also drops collinear points.
+        std::vector<math::Vec2> hull(2 * welded.size());
+        std::size_t size = 0;
+        const auto addPoint = [&](const math::Vec2& p, const std::size_t floor)
+        {
+            while (size >= floor && math::Cross(hull[size - 1] - hull[size - 2], p - hull[size - 2]) <= 0.0F)
+            {
+                --size;
+            }
+            hull[size++] = p;
+        };
+        for (const math::Vec2& p : welded)
+        {
+            addPoint(p, 2);
+        }
+        const std::size_t lower = size + 1;
+        for (std::size_t i = welded.size() - 1; i-- > 0;)
+        {
+            addPoint(welded[i], lower);
+        }
+        --size; // The last point repeats the first.
+
+        PSYGINE_ASSERT(size >= 3, "MakePolygon: points are collinear");
+        PSYGINE_ASSERT(size <= MAX_POLYGON_VERTICES, "MakePolygon: hull has too many vertices");
+
+        Polygon polygon;
+        polygon.count = static_cast<std::uint32_t>(size);
+        std::copy_n(hull.begin(), size, polygon.vertices.begin());
+        FinishPolygon(polygon);
+        return polygon;
+    }
+
+    MassData ComputeMass(const Circle& circle, const float density)
+    {
+        const float radiusSquared = circle.radius * circle.radius;
+        MassData data;
+        data.mass = density * std::numbers::pi_v<float> * radiusSquared;
+        data.center = circle.center;
+        data.rotationalInertia = data.mass * 0.5F * radiusSquared;
+        return data;
+    }
+
+    MassData ComputeMass(const Polygon& polygon, const float density)
+    {
+        // Sum over the triangle fan from the first vertex, then move the inertia to the centroid.
+        const math::Vec2 origin = polygon.vertices[0];
+        math::Vec2 center{};
+        float area = 0.0F;
+        float inertia = 0.0F;
+        for (std::uint32_t i = 1; i + 1 < polygon.count; ++i)
+        {
+            const math::Vec2 e1 = polygon.vertices[i] - origin;
+            const math::Vec2 e2 = polygon.vertices[i + 1] - origin;
+            const float d = math::Cross(e1, e2);
+            const float triangleArea = 0.5F * d;
+            area += triangleArea;
+            center += (e1 + e2) * (triangleArea / 3.0F);
+
+            const float intX2 = (e1.x * e1.x) + (e2.x * e1.x) + (e2.x * e2.x);
+            const float intY2 = (e1.y * e1.y) + (e2.y * e1.y) + (e2.y * e2.y);
+            inertia += (0.25F / 3.0F * d) * (intX2 + intY2);
+        }
+
+        MassData data;
+        data.mass = density * area;
+        center /= area;
+        data.center = origin + center;
+        data.rotationalInertia = (density * inertia) - (data.mass * math::Dot(center, center));
+        return data;
+    }
+
+    math::Aabb2 ComputeAabb(const Circle& circle, const Transform& xf)
+    {
+        const math::Vec2 p = TransformPoint(xf, circle.center);
+        const math::Vec2 r{circle.radius, circle.radius};
+        return {p - r, p + r};
+    }
+
+    math::Aabb2 ComputeAabb(const Polygon& polygon, const Transform& xf)
+    {
+        math::Vec2 lo = TransformPoint(xf, polygon.vertices[0]);
+        math::Vec2 hi = lo;
+        for (std::uint32_t i = 1; i < polygon.count; ++i)
+        {
+            const math::Vec2 p = TransformPoint(xf, polygon.vertices[i]);
+            lo = math::Min(lo, p);
+            hi = math::Max(hi, p);
+        }
+        return {lo, hi};
+    }
+}
@@ -0,0 +1,159 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#ifndef PSYGINE_GEOMETRY_HPP
+#define PSYGINE_GEOMETRY_HPP
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "psygine/math/aabb.hpp"
+#include "psygine/math/vector.hpp"
+
+namespace psygine::physics
+{
+    /**
+     * @brief Most vertices a convex polygon may have.
+     */
+    inline constexpr std::size_t MAX_POLYGON_VERTICES = 8;
+
+    /**
+     * @brief Collision and constraint tolerance, in meters: shapes may overlap this much at rest.
+     */
+    inline constexpr float LINEAR_SLOP = 0.005F;
+
+    /**
+     * @brief A 2D rotation stored as its cosine and sine.
+     *
+     * Bodies integrate rotations with `IntegrateRotation`, which only needs multiplies and a square
+     * root, so a simulation never calls into the platform's trigonometry and stays reproducible.
+     */
+    struct Rotation
+    {
+        float c = 1.0F;
+        float s = 0.0F;
+
+        friend constexpr bool operator==(const Rotation& lhs, const Rotation& rhs) = default;
+    };
+
+    /**
+     * @brief The rotation by `angle` radians. Uses `std::cos`/`std::sin`; fine for setup, but keep it
+     * out of simulation code that has to match across platforms.
+     */
+    inline Rotation MakeRotation(const float angle)
+    {
+        return {std::cos(angle), std::sin(angle)};
+    }
+
+    inline float Angle(const Rotation& q)
+    {
+        return std::atan2(q.s, q.c);
+    }
+
+    constexpr math::Vec2 Rotate(const Rotation& q, const math::Vec2& v)
+    {
+        return {(q.c * v.x) - (q.s * v.y), (q.s * v.x) + (q.c * v.y)};
+    }
+
+    constexpr math::Vec2 InverseRotate(const Rotation& q, const math::Vec2& v)
+    {
+        return {(q.c * v.x) + (q.s * v.y), (-q.s * v.x) + (q.c * v.y)};
+    }
+
+    /**
+     * @brief Advances `q` by `deltaAngle` radians to first order and renormalizes.
+     *
+     * Accurate for the small per-step angles a solver produces, which is why bodies clamp their
+     * rotation per step.
+     */
+    inline Rotation IntegrateRotation(const Rotation& q, const float deltaAngle)
+    {
+        const float c = q.c - (deltaAngle * q.s);
+        const float s = q.s + (deltaAngle * q.c);
+        const float length = std::sqrt((c * c) + (s * s));
+        const float inverse = length > 0.0F ? 1.0F / length : 0.0F;
+        return {c * inverse, s * inverse};
+    }
+
+    /**
+     * @brief A rigid transform: rotate, then translate.
+     */
+    struct Transform
+    {
+        math::Vec2 position{};
+        Rotation rotation{};
+    };
+
+    constexpr math::Vec2 TransformPoint(const Transform& xf, const math::Vec2& p)
+    {
+        return Rotate(xf.rotation, p) + xf.position;
+    }
+
+    constexpr math::Vec2 InverseTransformPoint(const Transform& xf, const math::Vec2& p)
+    {
+        return InverseRotate(xf.rotation, p - xf.position);
+    }
+
+    /**
+     * @brief A circle in body-local coordinates.
+     */
+    struct Circle
+    {
+        math::Vec2 center{};
+        float radius = 0.5F;
+    };
+
+    /**
+     * @brief A convex polygon in body-local coordinates, counter-clockwise, with outward edge normals.
+     *
+     * Build one with `MakeBox` or `MakePolygon`; they fill in the normals and centroid.
+     */
+    struct Polygon
+    {
+        std::array<math::Vec2, MAX_POLYGON_VERTICES> vertices{};
+        std::array<math::Vec2, MAX_POLYGON_VERTICES> normals{};
+        math::Vec2 centroid{};
+        std::uint32_t count = 0;
+    };
+
+    /**
+     * @brief A box centered on the body origin.
+     */
+    Polygon MakeBox(float halfWidth, float halfHeight);
+
+    /**
+     * @brief A box centered on `center` and rotated by `rotation` in body space.
+     */
+    Polygon MakeOffsetBox(float halfWidth, float halfHeight, const math::Vec2& center, const Rotation& rotation);
+
+    /**
+     * @brief The convex hull of `points`.
+     *
+     * Points closer together than the linear slop are merged and collinear points are dropped; the
+     * hull must keep between 3 and `MAX_POLYGON_VERTICES` vertices.
+     */
+    Polygon MakePolygon(std::span<const math::Vec2> points);
+
+    /**
+     * @brief Mass properties of a shape.
+     */
+    struct MassData
+    {
+        float mass = 0.0F;
+        // Center of mass in body space.
+        math::Vec2 center{};
+        // Rotational inertia about the center of mass.
+        float rotationalInertia = 0.0F;
+    };
+
+    MassData ComputeMass(const Circle& circle, float density);
+    MassData ComputeMass(const Polygon& polygon, float density);
+
+    math::Aabb2 ComputeAabb(const Circle& circle, const Transform& xf);
+    math::Aabb2 ComputeAabb(const Polygon& polygon, const Transform& xf);
+}
+
+#endif //PSYGINE_GEOMETRY_HPP
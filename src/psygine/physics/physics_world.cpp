@@ -0,0 +1,1186 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#include "physics_world.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <initializer_list>
+#include <limits>
+#include <utility>
+
+#include "psygine/debug/assert.hpp"
+
+namespace
+{
+    using psygine::math::Vec2;
+
+    // Angular velocity times an offset: the velocity that spin adds at that offset.
+    constexpr Vec2 CrossSV(const float w, const Vec2& r)
+    {
+        return psygine::math::Perp(r) * w;
+    }
+
+    // Islands solved per claimed chunk; islands vary wildly in size, so hand them out one by one.
+    constexpr std::size_t ISLAND_GRAIN = 1;
+
+    // Contacts updated per claimed chunk.
+    constexpr std::size_t CONTACT_GRAIN = 256;
+
+    // Largest condition number for which a two-point contact is solved as a block.
+    constexpr float MAX_BLOCK_CONDITION = 1000.0F;
+}
+
+namespace psygine::physics
+{
+    World::World(const WorldDef& def) :
+        def_{def}
+    {
+        PSYGINE_ASSERT(def.velocityIterations > 0, "physics::World: at least one velocity iteration is needed");
+    }
+
+    BodyId World::createBody(const BodyDef& def)
+    {
+        std::uint32_t index;
+        if (freeBodies_.empty())
+        {
+            index = static_cast<std::uint32_t>(bodies_.size());
+            bodies_.emplace_back();
+        }
+        else
+        {
+            index = freeBodies_.back();
+            freeBodies_.pop_back();
+        }
+
+        Body& body = bodies_[index];
+        const std::uint32_t generation = body.generation;
+        body = Body{};
+        body.generation = generation;
+        body.alive = true;
+        body.type = def.type;
+        body.xf = {def.position, def.rotation};
+        body.center = def.position;
+        body.linearDamping = def.linearDamping;
+        body.angularDamping = def.angularDamping;
+        body.gravityScale = def.gravityScale;
+        body.fixedRotation = def.fixedRotation;
+        body.allowSleep = def.allowSleep;
+        body.userData = def.userData;
+        if (def.type != BodyType::Static)
+        {
+            body.linearVelocity = def.linearVelocity;
+            body.angularVelocity = def.angularVelocity;
+        }
+        if (def.type == BodyType::Dynamic)
+        {
+            body.mass = 1.0F;
+            body.inverseMass = 1.0F;
+            body.awake = def.awake;
+        }
+        else if (def.type == BodyType::Kinematic)
+        {
+            body.awake = body.linearVelocity != Vec2{} || body.angularVelocity != 0.0F;
+        }
+        ++bodyCount_;
+        return {index, generation};
+    }
+
+    void World::destroyBody(const BodyId id)
+    {
+        Body& body = this->body(id);
+
+        // Whatever rests on the body has to notice it is gone.
+        for (std::uint32_t shapeIndex = body.firstShape; shapeIndex != INVALID_INDEX;
+             shapeIndex = shapes_[shapeIndex].nextShape)
+        {
+            Shape& shape = shapes_[shapeIndex];
+            tree_.query(tree_.fatBox(shape.proxy), [&](const std::uint32_t proxy)
+            {
+                Body& other = bodies_[shapes_[tree_.userData(proxy)].body];
+                if (other.type == BodyType::Dynamic)
+                {
+                    wake(other);
+                }
+            });
+        }
+
+        // Contacts naming the shapes are dropped by the next step, which also frees the slots.
+        for (std::uint32_t shapeIndex = body.firstShape; shapeIndex != INVALID_INDEX;
+             shapeIndex = shapes_[shapeIndex].nextShape)
+        {
+            Shape& shape = shapes_[shapeIndex];
+            tree_.destroyProxy(shape.proxy);
+            shape.alive = false;
+            ++shape.generation;
+            deadShapes_.push_back(shapeIndex);
+        }
+        body.firstShape = INVALID_INDEX;
+        body.alive = false;
+        body.awake = false;
+        ++body.generation;
+        deadBodies_.push_back(id.index);
+        --bodyCount_;
+    }
+
+    ShapeId World::createShape(const BodyId body, const ShapeDef& def, const Circle& circle)
+    {
+        PSYGINE_ASSERT(circle.radius > 0.0F, "physics::World::createShape: radius must be positive");
+        return addShape(body, def, circle);
+    }
+
+    ShapeId World::createShape(const BodyId body, const ShapeDef& def, const Polygon& polygon)
+    {
+        PSYGINE_ASSERT(polygon.count >= 3, "physics::World::createShape: polygon has too few vertices");
+        return addShape(body, def, polygon);
+    }
+
+    ShapeId World::addShape(const BodyId bodyId, const ShapeDef& def, const std::variant<Circle, Polygon>& geometry)
+    {
+        PSYGINE_ASSERT(def.density >= 0.0F, "physics::World::createShape: density must not be negative");
+        Body& body = this->body(bodyId);
+
+        std::uint32_t index;
+        if (freeShapes_.empty())
+        {
+            index = static_cast<std::uint32_t>(shapes_.size());
+            shapes_.emplace_back();
+        }
+        else
+        {
+            index = freeShapes_.back();
+            freeShapes_.pop_back();
+        }
+
+        Shape& shape = shapes_[index];
+        shape.geometry = geometry;
+        shape.density = def.density;
+        shape.friction = def.friction;
+        shape.restitution = def.restitution;
+        shape.categoryBits = def.categoryBits;
+        shape.maskBits = def.maskBits;
+        shape.userData = def.userData;
+        shape.body = bodyId.index;
+        shape.nextShape = INVALID_INDEX;
+        shape.alive = true;
+        shape.proxy = tree_.createProxy(shapeAabb(shape, body.xf), index);
+
+        // Append, so shapes are visited in creation order.
+        std::uint32_t* link = &body.firstShape;
+        while (*link != INVALID_INDEX)
+        {
+            link = &shapes_[*link].nextShape;
+        }
+        *link = index;
+        updateMass(body);
+        return {index, shape.generation};
+    }
+
+    void World::updateMass(Body& body)
+    {
+        body.mass = 0.0F;
+        body.inverseMass = 0.0F;
+        body.inertia = 0.0F;
+        body.inverseInertia = 0.0F;
+        body.localCenter = {};
+        if (body.type != BodyType::Dynamic)
+        {
+            body.center = body.xf.position;
+            return;
+        }
+
+        // Inertia is summed about the body origin, then moved to the center of mass.
+        Vec2 weightedCenter{};
+        for (std::uint32_t shapeIndex = body.firstShape; shapeIndex != INVALID_INDEX;
+             shapeIndex = shapes_[shapeIndex].nextShape)
+        {
+            const Shape& shape = shapes_[shapeIndex];
+            const MassData data = std::visit([&shape](const auto& geometry)
+            {
+                return ComputeMass(geometry, shape.density);
+            }, shape.geometry);
+            body.mass += data.mass;
+            weightedCenter += data.center * data.mass;
+            body.inertia += data.rotationalInertia + (data.mass * math::Dot(data.center, data.center));
+        }
+
+        if (body.mass > 0.0F)
+        {
+            body.inverseMass = 1.0F / body.mass;
+            body.localCenter = weightedCenter * body.inverseMass;
+        }
+        else
+        {
+            body.mass = 1.0F;
+            body.inverseMass = 1.0F;
+        }
+
+        if (body.inertia > 0.0F && !body.fixedRotation)
+        {
+            body.inertia -= body.mass * math::Dot(body.localCenter, body.localCenter);
+            PSYGINE_ASSERT(body.inertia > 0.0F, "physics::World: body has no rotational inertia");
+            body.inverseInertia = 1.0F / body.inertia;
+        }
+        else
+        {
+            body.inertia = 0.0F;
+        }
+
+        // Keep the velocity of the center of mass consistent with the spin about the old one.
+        const Vec2 oldCenter = body.center;
+        body.center = TransformPoint(body.xf, body.localCenter);
+        body.linearVelocity += CrossSV(body.angularVelocity, body.center - oldCenter);
+    }
+
+    void World::step(const double dt, core::ThreadPool* pool)
+    {
+        PSYGINE_ASSERT(dt > 0.0, "physics::World::step: dt must be positive");
+        const auto h = static_cast<float>(dt);
+
+        findNewContacts(pool);
+        updateContacts(pool);
+        buildIslands();
+
+        // Largest islands first so one big pile does not start last and hold up the step.
+        islandOrder_.resize(islands_.size());
+        for (std::uint32_t i = 0; i < islandOrder_.size(); ++i)
+        {
+            islandOrder_[i] = i;
+        }
+        std::ranges::stable_sort(islandOrder_, [this](const std::uint32_t a, const std::uint32_t b)
+        {
+            const Island& lhs = islands_[a];
+            const Island& rhs = islands_[b];
+            return lhs.contactEnd - lhs.contactBegin > rhs.contactEnd - rhs.contactBegin;
+        });
+        const auto solve = [this, h](const std::size_t begin, const std::size_t end)
+        {
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                solveIsland(islands_[islandOrder_[i]], h);
+            }
+        };
+        if (pool == nullptr || islands_.size() <= 1)
+        {
+            solve(0, islands_.size());
+        }
+        else
+        {
+            pool->parallelFor(islands_.size(), ISLAND_GRAIN, solve);
+        }
+
+        integrateKinematic(h);
+
+        // The tree is not thread-safe, so the broadphase catches up serially.
+        for (const std::uint32_t index : islandBodies_)
+        {
+            Body& body = bodies_[index];
+            synchronizeShapes(body, body.linearVelocity * h);
+            body.solverIndex = INVALID_INDEX;
+            body.force = {};
+            body.torque = 0.0F;
+        }
+    }
+
+    void World::saveState(core::SnapshotWriter& writer) const
+    {
+        writer.write(def_);
+        writer.writeArray(bodies_);
+        writer.writeArray(freeBodies_);
+        writer.write(static_cast<std::uint64_t>(bodyCount_));
+        writer.writeArray(shapes_);
+        writer.writeArray(freeShapes_);
+        writer.writeArray(deadBodies_);
+        writer.writeArray(deadShapes_);
+        writer.writeArray(contacts_);
+        tree_.saveState(writer);
+    }
+
+    void World::loadState(core::SnapshotReader& reader)
+    {
+        reader.read(def_);
+        reader.readArray(bodies_);
+        reader.readArray(freeBodies_);
+        bodyCount_ = static_cast<std::size_t>(reader.read<std::uint64_t>());
+        reader.readArray(shapes_);
+        reader.readArray(freeShapes_);
+        reader.readArray(deadBodies_);
+        reader.readArray(deadShapes_);
+        reader.readArray(contacts_);
+        tree_.loadState(reader);
+
+        // The pair map only indexes contacts_, so it is rebuilt rather than stored.
+        pairMap_.clear();
+        for (std::size_t i = 0; i < contacts_.size(); ++i)
+        {
+            pairMap_.emplace(PairKey(contacts_[i].shapeA, contacts_[i].shapeB), static_cast<std::uint32_t>(i));
+        }
+    }
+
+    void World::findNewContacts(core::ThreadPool* pool)
+    {
+        tree_.updatePairs(pairs_, pool);
+        for (const spatial::AabbTree2D::Pair& pair : pairs_)
+        {
+            std::uint32_t shapeA = tree_.userData(pair.a);
+            std::uint32_t shapeB = tree_.userData(pair.b);
+            const Shape& a = shapes_[shapeA];
+            const Shape& b = shapes_[shapeB];
+            if (a.body == b.body || !shouldCollide(a, b))
+            {
+                continue;
+            }
+            const Body& bodyA = bodies_[a.body];
+            const Body& bodyB = bodies_[b.body];
+            if (bodyA.type != BodyType::Dynamic && bodyB.type != BodyType::Dynamic)
+            {
+                continue;
+            }
+
+            const std::uint64_t key = PairKey(shapeA, shapeB);
+            if (pairMap_.contains(key))
+            {
+                continue;
+            }
+            if (std::holds_alternative<Circle>(a.geometry) && std::holds_alternative<Polygon>(b.geometry))
+            {
+                std::swap(shapeA, shapeB);
+            }
+
+            Contact contact;
+            contact.shapeA = shapeA;
+            contact.shapeB = shapeB;
+            contact.bodyA = shapes_[shapeA].body;
+            contact.bodyB = shapes_[shapeB].body;
+            contact.friction = std::sqrt(a.friction * b.friction);
+            contact.restitution = std::max(a.restitution, b.restitution);
+            pairMap_.emplace(key, static_cast<std::uint32_t>(contacts_.size()));
+            contacts_.push_back(contact);
+        }
+    }
+
+    void World::updateContacts(core::ThreadPool* pool)
+    {
+        const auto update = [this](const std::size_t begin, const std::size_t end)
+        {
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                updateContact(contacts_[i]);
+            }
+        };
+        if (pool == nullptr || contacts_.size() <= CONTACT_GRAIN)
+        {
+            update(0, contacts_.size());
+        }
+        else
+        {
+            pool->parallelFor(contacts_.size(), CONTACT_GRAIN, update);
+        }
+
+        // Swap-remove in index order, which depends only on the contact list itself.
+        for (std::size_t i = 0; i < contacts_.size();)
+        {
+            Contact& contact = contacts_[i];
+            if (!contact.remove)
+            {
+                ++i;
+                continue;
+            }
+            pairMap_.erase(PairKey(contact.shapeA, contact.shapeB));
+            if (i + 1 != contacts_.size())
+            {
+                contact = contacts_.back();
+                pairMap_[PairKey(contact.shapeA, contact.shapeB)] = static_cast<std::uint32_t>(i);
+            }
+            contacts_.pop_back();
+        }
+
+        // No contact names a destroyed body or shape any more.
+        freeBodies_.insert(freeBodies_.end(), deadBodies_.begin(), deadBodies_.end());
+        freeShapes_.insert(freeShapes_.end(), deadShapes_.begin(), deadShapes_.end());
+        deadBodies_.clear();
+        deadShapes_.clear();
+    }
+
+    void World::updateContact(Contact& contact) const
+    {
+        const Shape& shapeA = shapes_[contact.shapeA];
+        const Shape& shapeB = shapes_[contact.shapeB];
+        if (!shapeA.alive || !shapeB.alive)
+        {
+            contact.remove = true;
+            return;
+        }
+
+        const Body& bodyA = bodies_[contact.bodyA];
+        const Body& bodyB = bodies_[contact.bodyB];
+        if (!bodyA.awake && !bodyB.awake)
+        {
+            return;
+        }
+        if (!math::Overlaps(tree_.fatBox(shapeA.proxy), tree_.fatBox(shapeB.proxy)))
+        {
+            contact.remove = true;
+            return;
+        }
+
+        Manifold manifold;
+        const float speculative = def_.speculativeDistance;
+        if (const Polygon* polygonA = std::get_if<Polygon>(&shapeA.geometry))
+        {
+            if (const Polygon* polygonB = std::get_if<Polygon>(&shapeB.geometry))
+            {
+                manifold = CollidePolygons(*polygonA, bodyA.xf, *polygonB, bodyB.xf, speculative);
+            }
+            else
+            {
+                manifold = CollidePolygonAndCircle(*polygonA, bodyA.xf, std::get<Circle>(shapeB.geometry), bodyB.xf,
+                                                   speculative);
+            }
+        }
+        else
+        {
+            manifold = CollideCircles(std::get<Circle>(shapeA.geometry), bodyA.xf, std::get<Circle>(shapeB.geometry),
+                                      bodyB.xf, speculative);
+        }
+
+        // Points that survived from the last step keep their impulses for warm starting.
+        for (std::uint32_t i = 0; i < manifold.pointCount; ++i)
+        {
+            ManifoldPoint& point = manifold.points[i];
+            for (std::uint32_t j = 0; j < contact.manifold.pointCount; ++j)
+            {
+                const ManifoldPoint& old = contact.manifold.points[j];
+                if (old.id == point.id)
+                {
+                    point.normalImpulse = old.normalImpulse;
+                    point.tangentImpulse = old.tangentImpulse;
+                    break;
+                }
+            }
+        }
+        contact.manifold = manifold;
+        contact.touching = manifold.pointCount > 0;
+    }
+
+    void World::buildIslands()
+    {
+        islands_.clear();
+        islandBodies_.clear();
+        islandContacts_.clear();
+
+        // A sleeping body touched by something awake wakes up; from there it joins that island.
+        for (const Contact& contact : contacts_)
+        {
+            if (!contact.touching)
+            {
+                continue;
+            }
+            Body& bodyA = bodies_[contact.bodyA];
+            Body& bodyB = bodies_[contact.bodyB];
+            if (bodyA.awake != bodyB.awake)
+            {
+                wake(bodyA.awake ? bodyB : bodyA);
+            }
+        }
+
+        // Touching contacts per dynamic body, in contact order. Static and kinematic bodies are
+        // left out: they do not join islands together.
+        adjacencyStart_.assign(bodies_.size() + 1, 0);
+        for (const Contact& contact : contacts_)
+        {
+            if (!contact.touching)
+            {
+                continue;
+            }
+            if (bodies_[contact.bodyA].type == BodyType::Dynamic)
+            {
+                ++adjacencyStart_[contact.bodyA + 1];
+            }
+            if (bodies_[contact.bodyB].type == BodyType::Dynamic)
+            {
+                ++adjacencyStart_[contact.bodyB + 1];
+            }
+        }
+        for (std::size_t i = 1; i < adjacencyStart_.size(); ++i)
+        {
+            adjacencyStart_[i] += adjacencyStart_[i - 1];
+        }
+        adjacency_.resize(adjacencyStart_.back());
+        for (std::uint32_t c = 0; c < contacts_.size(); ++c)
+        {
+            const Contact& contact = contacts_[c];
+            if (!contact.touching)
+            {
+                continue;
+            }
+            for (const std::uint32_t b : {contact.bodyA, contact.bodyB})
+            {
+                if (bodies_[b].type == BodyType::Dynamic)
+                {
+                    adjacency_[adjacencyStart_[b]++] = c;
+                }
+            }
+        }
+        for (std::size_t i = adjacencyStart_.size() - 1; i > 0; --i)
+        {
+            adjacencyStart_[i] = adjacencyStart_[i - 1];
+        }
+        adjacencyStart_[0] = 0;
+
+        // Depth-first search from each awake dynamic body, in index order.
+        visited_.assign(bodies_.size() + contacts_.size(), 0);
+        std::uint8_t* bodyVisited = visited_.data();
+        std::uint8_t* contactVisited = visited_.data() + bodies_.size();
+        for (std::uint32_t seed = 0; seed < bodies_.size(); ++seed)
+        {
+            const Body& seedBody = bodies_[seed];
+            if (bodyVisited[seed] != 0 || !seedBody.alive || !seedBody.awake || seedBody.type != BodyType::Dynamic)
+            {
+                continue;
+            }
+
+            Island island{};
+            island.bodyBegin = static_cast<std::uint32_t>(islandBodies_.size());
+            island.contactBegin = static_cast<std::uint32_t>(islandContacts_.size());
+            stack_.clear();
+            stack_.push_back(seed);
+            bodyVisited[seed] = 1;
+            while (!stack_.empty())
+            {
+                const std::uint32_t index = stack_.back();
+                stack_.pop_back();
+                Body& body = bodies_[index];
+                body.awake = true;
+                body.solverIndex = static_cast<std::uint32_t>(islandBodies_.size());
+                islandBodies_.push_back(index);
+
+                for (std::uint32_t e = adjacencyStart_[index]; e < adjacencyStart_[index + 1]; ++e)
+                {
+                    const std::uint32_t c = adjacency_[e];
+                    if (contactVisited[c] != 0)
+                    {
+                        continue;
+                    }
+                    contactVisited[c] = 1;
+                    islandContacts_.push_back(c);
+
+                    const Contact& contact = contacts_[c];
+                    const std::uint32_t other = contact.bodyA == index ? contact.bodyB : contact.bodyA;
+                    const Body& otherBody = bodies_[other];
+                    if (otherBody.type == BodyType::Kinematic && otherBody.awake)
+                    {
+                        island.pinnedAwake = true;
+                    }
+                    if (otherBody.type == BodyType::Dynamic && bodyVisited[other] == 0)
+                    {
+                        bodyVisited[other] = 1;
+                        stack_.push_back(other);
+                    }
+                }
+            }
+            island.bodyEnd = static_cast<std::uint32_t>(islandBodies_.size());
+            island.contactEnd = static_cast<std::uint32_t>(islandContacts_.size());
+            islands_.push_back(island);
+        }
+
+        solverBodies_.resize(islandBodies_.size());
+        constraints_.resize(islandContacts_.size());
+    }
+
+    void World::solveIsland(const Island& island, const float dt)
+    {
+        const float inverseDt = 1.0F / dt;
+
+        // Integrate velocities.
+        for (std::uint32_t i = island.bodyBegin; i < island.bodyEnd; ++i)
+        {
+            const Body& body = bodies_[islandBodies_[i]];
+            Vec2 v = body.linearVelocity +
+                     (((def_.gravity * body.gravityScale) + (body.force * body.inverseMass)) * dt);
+            float w = body.angularVelocity + (dt * body.inverseInertia * body.torque);
+            v *= 1.0F / (1.0F + (dt * body.linearDamping));
+            w *= 1.0F / (1.0F + (dt * body.angularDamping));
+            solverBodies_[i] = {v, w, body.inverseMass, body.inverseInertia};
+        }
+
+        // Prepare the contact constraints.
+        for (std::uint32_t i = island.contactBegin; i < island.contactEnd; ++i)
+        {
+            const Contact& contact = contacts_[islandContacts_[i]];
+            const Body& bodyA = bodies_[contact.bodyA];
+            const Body& bodyB = bodies_[contact.bodyB];
+            ContactConstraint& constraint = constraints_[i];
+            constraint.bodyA = bodyA.type == BodyType::Dynamic ? bodyA.solverIndex : INVALID_INDEX;
+            constraint.bodyB = bodyB.type == BodyType::Dynamic ? bodyB.solverIndex : INVALID_INDEX;
+            constraint.fixedA = {bodyA.linearVelocity, bodyA.angularVelocity, 0.0F, 0.0F};
+            constraint.fixedB = {bodyB.linearVelocity, bodyB.angularVelocity, 0.0F, 0.0F};
+            constraint.normal = contact.manifold.normal;
+            constraint.friction = contact.friction;
+            constraint.pointCount = contact.manifold.pointCount;
+
+            const SolverBody& a =
+                constraint.bodyA != INVALID_INDEX ? solverBodies_[constraint.bodyA] : constraint.fixedA;
+            const SolverBody& b =
+                constraint.bodyB != INVALID_INDEX ? solverBodies_[constraint.bodyB] : constraint.fixedB;
+            const Vec2 normal = constraint.normal;
+            const Vec2 tangent{normal.y, -normal.x};
+            for (std::uint32_t p = 0; p < constraint.pointCount; ++p)
+            {
+                const ManifoldPoint& mp = contact.manifold.points[p];
+                ConstraintPoint& cp = constraint.points[p];
+                cp.rA = mp.point - bodyA.center;
+                cp.rB = mp.point - bodyB.center;
+                cp.normalImpulse = mp.normalImpulse;
+                cp.tangentImpulse = mp.tangentImpulse;
+
+                const float rnA = math::Cross(cp.rA, normal);
+                const float rnB = math::Cross(cp.rB, normal);
+                const float kNormal = a.inverseMass + b.inverseMass + (a.inverseInertia * rnA * rnA) +
+                                      (b.inverseInertia * rnB * rnB);
+                cp.normalMass = kNormal > 0.0F ? 1.0F / kNormal : 0.0F;
+
+                const float rtA = math::Cross(cp.rA, tangent);
+                const float rtB = math::Cross(cp.rB, tangent);
+                const float kTangent = a.inverseMass + b.inverseMass + (a.inverseInertia * rtA * rtA) +
+                                       (b.inverseInertia * rtB * rtB);
+                cp.tangentMass = kTangent > 0.0F ? 1.0F / kTangent : 0.0F;
+
+                // A speculative point lets the bodies close the gap this step and no more; an
+                // overlapping one is pushed apart a fraction at a time, beyond the slop. The push is
+                // left out of the relax pass so it moves the bodies without leaving them any velocity.
+                if (mp.separation > 0.0F)
+                {
+                    cp.bias = mp.separation * inverseDt;
+                    cp.relaxBias = cp.bias;
+                }
+                else
+                {
+                    cp.bias = -def_.baumgarte * inverseDt * std::max(0.0F, -mp.separation - LINEAR_SLOP);
+                    cp.relaxBias = 0.0F;
+                }
+
+                const Vec2 dv = b.linearVelocity + CrossSV(b.angularVelocity, cp.rB) - a.linearVelocity -
+                                CrossSV(a.angularVelocity, cp.rA);
+                const float vn = math::Dot(dv, normal);
+                if (contact.restitution > 0.0F && mp.separation <= LINEAR_SLOP && vn < -def_.restitutionThreshold)
+                {
+                    cp.bias = std::min(cp.bias, contact.restitution * vn);
+                    cp.relaxBias = std::min(cp.relaxBias, contact.restitution * vn);
+                }
+            }
+
+            // Two points are solved as a block unless they are so close to redundant that the
+            // 2x2 system is ill-conditioned.
+            constraint.block = false;
+            if (constraint.pointCount == 2)
+            {
+                const ConstraintPoint& cp1 = constraint.points[0];
+                const ConstraintPoint& cp2 = constraint.points[1];
+                const float rn1A = math::Cross(cp1.rA, normal);
+                const float rn1B = math::Cross(cp1.rB, normal);
+                const float rn2A = math::Cross(cp2.rA, normal);
+                const float rn2B = math::Cross(cp2.rB, normal);
+                const float mass = a.inverseMass + b.inverseMass;
+                constraint.k11 = mass + (a.inverseInertia * rn1A * rn1A) + (b.inverseInertia * rn1B * rn1B);
+                constraint.k22 = mass + (a.inverseInertia * rn2A * rn2A) + (b.inverseInertia * rn2B * rn2B);
+                constraint.k12 = mass + (a.inverseInertia * rn1A * rn2A) + (b.inverseInertia * rn1B * rn2B);
+                const float determinant = (constraint.k11 * constraint.k22) - (constraint.k12 * constraint.k12);
+                if (constraint.k11 * constraint.k11 < MAX_BLOCK_CONDITION * determinant)
+                {
+                    const float inverse = 1.0F / determinant;
+                    constraint.m11 = constraint.k22 * inverse;
+                    constraint.m12 = -constraint.k12 * inverse;
+                    constraint.m22 = constraint.k11 * inverse;
+                    constraint.block = true;
+                }
+            }
+        }
+
+        const auto bodyOf = [this](const std::uint32_t index, SolverBody& fixed) -> SolverBody&
+        {
+            return index != INVALID_INDEX ? solverBodies_[index] : fixed;
+        };
+
+        // Warm start with last step's impulses.
+        for (std::uint32_t i = island.contactBegin; i < island.contactEnd; ++i)
+        {
+            ContactConstraint& constraint = constraints_[i];
+            SolverBody& a = bodyOf(constraint.bodyA, constraint.fixedA);
+            SolverBody& b = bodyOf(constraint.bodyB, constraint.fixedB);
+            const Vec2 normal = constraint.normal;
+            const Vec2 tangent{normal.y, -normal.x};
+            for (std::uint32_t p = 0; p < constraint.pointCount; ++p)
+            {
+                const ConstraintPoint& cp = constraint.points[p];
+                const Vec2 impulse = (normal * cp.normalImpulse) + (tangent * cp.tangentImpulse);
+                a.linearVelocity -= impulse * a.inverseMass;
+                a.angularVelocity -= a.inverseInertia * math::Cross(cp.rA, impulse);
+                b.linearVelocity += impulse * b.inverseMass;
+                b.angularVelocity += b.inverseInertia * math::Cross(cp.rB, impulse);
+            }
+        }
+
+        // Sequential impulses, pushing overlapping bodies apart.
+        solveContacts(island, def_.velocityIterations, true);
+
+        // Integrate positions with the biased velocities.
+        for (std::uint32_t i = island.bodyBegin; i < island.bodyEnd; ++i)
+        {
+            Body& body = bodies_[islandBodies_[i]];
+            SolverBody& solverBody = solverBodies_[i];
+            const float translationSquared = math::LengthSquared(solverBody.linearVelocity * dt);
+            if (translationSquared > def_.maxTranslation * def_.maxTranslation)
+            {
+                solverBody.linearVelocity *= def_.maxTranslation / std::sqrt(translationSquared);
+            }
+            const float rotation = solverBody.angularVelocity * dt;
+            if (rotation * rotation > def_.maxRotation * def_.maxRotation)
+            {
+                solverBody.angularVelocity *= def_.maxRotation / std::abs(rotation);
+            }
+
+            body.center += solverBody.linearVelocity * dt;
+            body.xf.rotation = IntegrateRotation(body.xf.rotation, solverBody.angularVelocity * dt);
+            body.xf.position = body.center - Rotate(body.xf.rotation, body.localCenter);
+        }
+
+        // Relax without the push, so the velocities carried into the next step hold no separation
+        // energy and a resting stack settles instead of jittering.
+        solveContacts(island, def_.relaxIterations, false);
+
+        // Keep the impulses for the next step.
+        for (std::uint32_t i = island.contactBegin; i < island.contactEnd; ++i)
+        {
+            const ContactConstraint& constraint = constraints_[i];
+            Contact& contact = contacts_[islandContacts_[i]];
+            for (std::uint32_t p = 0; p < constraint.pointCount; ++p)
+            {
+                contact.manifold.points[p].normalImpulse = constraint.points[p].normalImpulse;
+                contact.manifold.points[p].tangentImpulse = constraint.points[p].tangentImpulse;
+            }
+        }
+
+        // Store the velocities and track how long the island has been at rest.
+        const float linearTolerance = def_.linearSleepTolerance * def_.linearSleepTolerance;
+        const float angularTolerance = def_.angularSleepTolerance * def_.angularSleepTolerance;
+        float minSleepTime = std::numeric_limits<float>::max();
+        for (std::uint32_t i = island.bodyBegin; i < island.bodyEnd; ++i)
+        {
+            Body& body = bodies_[islandBodies_[i]];
+            const Vec2 v = solverBodies_[i].linearVelocity;
+            const float w = solverBodies_[i].angularVelocity;
+            body.linearVelocity = v;
+            body.angularVelocity = w;
+
+            if (!body.allowSleep || w * w > angularTolerance || math::LengthSquared(v) > linearTolerance)
+            {
+                body.sleepTime = 0.0F;
+            }
+            else
+            {
+                body.sleepTime += dt;
+            }
+            minSleepTime = std::min(minSleepTime, body.sleepTime);
+        }
+
+        if (def_.enableSleep && !island.pinnedAwake && minSleepTime >= def_.timeToSleep)
+        {
+            for (std::uint32_t i = island.bodyBegin; i < island.bodyEnd; ++i)
+            {
+                Body& body = bodies_[islandBodies_[i]];
+                body.awake = false;
+                body.linearVelocity = {};
+                body.angularVelocity = 0.0F;
+            }
+        }
+    }
+
+    void World::solveContacts(const Island& island, const std::uint32_t iterations, const bool useBias)
+    {
+        const auto bodyOf = [this](const std::uint32_t index, SolverBody& fixed) -> SolverBody&
+        {
+            return index != INVALID_INDEX ? solverBodies_[index] : fixed;
+        };
+
+        // Friction first, so the non-penetration impulses get the last word.
+        for (std::uint32_t iteration = 0; iteration < iterations; ++iteration)
+        {
+            for (std::uint32_t i = island.contactBegin; i < island.contactEnd; ++i)
+            {
+                ContactConstraint& constraint = constraints_[i];
+                SolverBody& a = bodyOf(constraint.bodyA, constraint.fixedA);
+                SolverBody& b = bodyOf(constraint.bodyB, constraint.fixedB);
+                const Vec2 normal = constraint.normal;
+                const Vec2 tangent{normal.y, -normal.x};
+
+                for (std::uint32_t p = 0; p < constraint.pointCount; ++p)
+                {
+                    ConstraintPoint& cp = constraint.points[p];
+                    const Vec2 dv = b.linearVelocity + CrossSV(b.angularVelocity, cp.rB) - a.linearVelocity -
+                                    CrossSV(a.angularVelocity, cp.rA);
+                    const float maxFriction = constraint.friction * cp.normalImpulse;
+                    const float newImpulse = std::clamp(cp.tangentImpulse - (cp.tangentMass * math::Dot(dv, tangent)),
+                                                        -maxFriction, maxFriction);
+                    const Vec2 impulse = tangent * (newImpulse - cp.tangentImpulse);
+                    cp.tangentImpulse = newImpulse;
+                    a.linearVelocity -= impulse * a.inverseMass;
+                    a.angularVelocity -= a.inverseInertia * math::Cross(cp.rA, impulse);
+                    b.linearVelocity += impulse * b.inverseMass;
+                    b.angularVelocity += b.inverseInertia * math::Cross(cp.rB, impulse);
+                }
+
+                if (constraint.block)
+                {
+                    solveBlock(constraint, a, b, useBias);
+                    continue;
+                }
+
+                for (std::uint32_t p = 0; p < constraint.pointCount; ++p)
+                {
+                    ConstraintPoint& cp = constraint.points[p];
+                    const Vec2 dv = b.linearVelocity + CrossSV(b.angularVelocity, cp.rB) - a.linearVelocity -
+                                    CrossSV(a.angularVelocity, cp.rA);
+                    const float vn = math::Dot(dv, normal);
+                    const float bias = useBias ? cp.bias : cp.relaxBias;
+                    const float newImpulse = std::max(cp.normalImpulse - (cp.normalMass * (vn + bias)), 0.0F);
+                    const Vec2 impulse = normal * (newImpulse - cp.normalImpulse);
+                    cp.normalImpulse = newImpulse;
+                    a.linearVelocity -= impulse * a.inverseMass;
+                    a.angularVelocity -= a.inverseInertia * math::Cross(cp.rA, impulse);
+                    b.linearVelocity += impulse * b.inverseMass;
+                    b.angularVelocity += b.inverseInertia * math::Cross(cp.rB, impulse);
+                }
+            }
+        }
+    }
+
+    void World::solveBlock(ContactConstraint& constraint, SolverBody& a, SolverBody& b, const bool useBias)
+    {
+        // Solves both normal impulses together as a two-variable LCP by trying each combination of
+        // active points, so the two ends of a resting face get symmetric impulses instead of the
+        // second point correcting the first.
+        ConstraintPoint& cp1 = constraint.points[0];
+        ConstraintPoint& cp2 = constraint.points[1];
+        const Vec2 normal = constraint.normal;
+
+        const float vn1 = math::Dot(b.linearVelocity + CrossSV(b.angularVelocity, cp1.rB) - a.linearVelocity -
+                                    CrossSV(a.angularVelocity, cp1.rA), normal);
+        const float vn2 = math::Dot(b.linearVelocity + CrossSV(b.angularVelocity, cp2.rB) - a.linearVelocity -
+                                    CrossSV(a.angularVelocity, cp2.rA), normal);
+
+        // With x the new impulses and x0 the old ones: vn = K * (x - x0) + (vn0 + bias) must be >= 0,
+        // x >= 0, and each point is either separating or pushing.
+        const float old1 = cp1.normalImpulse;
+        const float old2 = cp2.normalImpulse;
+        const float b1 = vn1 + (useBias ? cp1.bias : cp1.relaxBias) - (constraint.k11 * old1) - (constraint.k12 * old2);
+        const float b2 = vn2 + (useBias ? cp2.bias : cp2.relaxBias) - (constraint.k12 * old1) - (constraint.k22 * old2);
+
+        float x1 = -((constraint.m11 * b1) + (constraint.m12 * b2));
+        float x2 = -((constraint.m12 * b1) + (constraint.m22 * b2));
+        if (x1 < 0.0F || x2 < 0.0F)
+        {
+            x1 = -b1 / constraint.k11;
+            x2 = 0.0F;
+            if (x1 < 0.0F || (constraint.k12 * x1) + b2 < 0.0F)
+            {
+                x1 = 0.0F;
+                x2 = -b2 / constraint.k22;
+                if (x2 < 0.0F || (constraint.k12 * x2) + b1 < 0.0F)
+                {
+                    // Both separating; if even that is violated the system is degenerate, and
+                    // leaving the impulses alone is the safe answer.
+                    if (b1 < 0.0F || b2 < 0.0F)
+                    {
+                        return;
+                    }
+                    x2 = 0.0F;
+                }
+            }
+        }
+
+        const Vec2 impulse1 = normal * (x1 - old1);
+        const Vec2 impulse2 = normal * (x2 - old2);
+        cp1.normalImpulse = x1;
+        cp2.normalImpulse = x2;
+        a.linearVelocity -= (impulse1 + impulse2) * a.inverseMass;
+        a.angularVelocity -= a.inverseInertia * (math::Cross(cp1.rA, impulse1) + math::Cross(cp2.rA, impulse2));
+        b.linearVelocity += (impulse1 + impulse2) * b.inverseMass;
+        b.angularVelocity += b.inverseInertia * (math::Cross(cp1.rB, impulse1) + math::Cross(cp2.rB, impulse2));
+    }
+
+    void World::integrateKinematic(const float dt)
+    {
+        for (Body& body : bodies_)
+        {
+            if (!body.alive || body.type != BodyType::Kinematic || !body.awake)
+            {
+                continue;
+            }
+            body.center += body.linearVelocity * dt;
+            body.xf.rotation = IntegrateRotation(body.xf.rotation, body.angularVelocity * dt);
+            body.xf.position = body.center;
+            synchronizeShapes(body, body.linearVelocity * dt);
+        }
+    }
+
+    math::Aabb2 World::shapeAabb(const Shape& shape, const Transform& xf) const
+    {
+        return std::visit([&xf](const auto& geometry)
+        {
+            return ComputeAabb(geometry, xf);
+        }, shape.geometry);
+    }
+
+    void World::synchronizeShapes(const Body& body, const Vec2& displacement)
+    {
+        for (std::uint32_t shapeIndex = body.firstShape; shapeIndex != INVALID_INDEX;
+             shapeIndex = shapes_[shapeIndex].nextShape)
+        {
+            const Shape& shape = shapes_[shapeIndex];
+            tree_.moveProxy(shape.proxy, shapeAabb(shape, body.xf), displacement);
+        }
+    }
+
+    bool World::shouldCollide(const Shape& a, const Shape& b) const
+    {
+        return (a.categoryBits & b.maskBits) != 0 && (b.categoryBits & a.maskBits) != 0;
+    }
+
+    std::uint64_t World::PairKey(const std::uint32_t shapeA, const std::uint32_t shapeB)
+    {
+        return (static_cast<std::uint64_t>(std::min(shapeA, shapeB)) << 32) | std::max(shapeA, shapeB);
+    }
+
+    void World::wake(Body& body)
+    {
+        if (body.type == BodyType::Dynamic)
+        {
+            body.awake = true;
+            body.sleepTime = 0.0F;
+        }
+    }
+
+    World::Body& World::body(const BodyId id)
+    {
+        PSYGINE_ASSERT(alive(id), "physics::World: stale or invalid body id");
+        return bodies_[id.index];
+    }
+
+    const World::Body& World::body(const BodyId id) const
+    {
+        PSYGINE_ASSERT(alive(id), "physics::World: stale or invalid body id");
+        return bodies_[id.index];
+    }
+
+    const World::Shape& World::shape(const ShapeId id) const
+    {
+        PSYGINE_ASSERT(alive(id), "physics::World: stale or invalid shape id");
+        return shapes_[id.index];
+    }
+
+    bool World::alive(const BodyId body) const
+    {
+        return body.index < bodies_.size() && bodies_[body.index].alive &&
+               bodies_[body.index].generation == body.generation;
+    }
+
+    bool World::alive(const ShapeId shape) const
+    {
+        return shape.index < shapes_.size() && shapes_[shape.index].alive &&
+               shapes_[shape.index].generation == shape.generation;
+    }
+
+    BodyType World::type(const BodyId body) const
+    {
+        return this->body(body).type;
+    }
+
+    Transform World::transform(const BodyId body) const
+    {
+        return this->body(body).xf;
+    }
+
+    math::Vec2 World::position(const BodyId body) const
+    {
+        return this->body(body).xf.position;
+    }
+
+    Rotation World::rotation(const BodyId body) const
+    {
+        return this->body(body).xf.rotation;
+    }
+
+    math::Vec2 World::worldCenter(const BodyId body) const
+    {
+        return this->body(body).center;
+    }
+
+    math::Vec2 World::linearVelocity(const BodyId body) const
+    {
+        return this->body(body).linearVelocity;
+    }
+
+    float World::angularVelocity(const BodyId body) const
+    {
+        return this->body(body).angularVelocity;
+    }
+
+    float World::mass(const BodyId body) const
+    {
+        return this->body(body).type == BodyType::Dynamic ? this->body(body).mass : 0.0F;
+    }
+
+    float World::rotationalInertia(const BodyId body) const
+    {
+        return this->body(body).inertia;
+    }
+
+    bool World::awake(const BodyId body) const
+    {
+        return this->body(body).awake;
+    }
+
+    std::uint64_t World::userData(const BodyId body) const
+    {
+        return this->body(body).userData;
+    }
+
+    void World::setTransform(const BodyId id, const math::Vec2& position, const Rotation& rotation)
+    {
+        Body& body = this->body(id);
+        body.xf = {position, rotation};
+        body.center = TransformPoint(body.xf, body.localCenter);
+        wake(body);
+        synchronizeShapes(body, {});
+    }
+
+    void World::setLinearVelocity(const BodyId id, const math::Vec2& velocity)
+    {
+        Body& body = this->body(id);
+        if (body.type == BodyType::Static)
+        {
+            return;
+        }
+        body.linearVelocity = velocity;
+        if (body.type == BodyType::Kinematic)
+        {
+            body.awake = body.linearVelocity != Vec2{} || body.angularVelocity != 0.0F;
+        }
+        else if (velocity != Vec2{})
+        {
+            wake(body);
+        }
+    }
+
+    void World::setAngularVelocity(const BodyId id, const float velocity)
+    {
+        Body& body = this->body(id);
+        if (body.type == BodyType::Static || (body.type == BodyType::Dynamic && body.fixedRotation))
+        {
+            return;
+        }
+        body.angularVelocity = velocity;
+        if (body.type == BodyType::Kinematic)
+        {
+            body.awake = body.linearVelocity != Vec2{} || body.angularVelocity != 0.0F;
+        }
+        else if (velocity != 0.0F)
+        {
+            wake(body);
+        }
+    }
+
+    void World::setAwake(const BodyId id, const bool awake)
+    {
+        Body& body = this->body(id);
+        if (body.type != BodyType::Dynamic)
+        {
+            return;
+        }
+        if (awake)
+        {
+            wake(body);
+            return;
+        }
+        // Sleeps on its own; the island it belongs to wakes it again next step if it is still touching
+        // something awake.
+        body.awake = false;
+        body.sleepTime = 0.0F;
+        body.linearVelocity = {};
+        body.angularVelocity = 0.0F;
+        body.force = {};
+        body.torque = 0.0F;
+    }
+
+    void World::applyForce(const BodyId id, const math::Vec2& force, const math::Vec2& point)
+    {
+        Body& body = this->body(id);
+        if (body.type != BodyType::Dynamic)
+        {
+            return;
+        }
+        wake(body);
+        body.force += force;
+        body.torque += math::Cross(point - body.center, force);
+    }
+
+    void World::applyForceToCenter(const BodyId id, const math::Vec2& force)
+    {
+        Body& body = this->body(id);
+        if (body.type != BodyType::Dynamic)
+        {
+            return;
+        }
+        wake(body);
+        body.force += force;
+    }
+
+    void World::applyTorque(const BodyId id, const float torque)
+    {
+        Body& body = this->body(id);
+        if (body.type != BodyType::Dynamic)
+        {
+            return;
+        }
+        wake(body);
+        body.torque += torque;
+    }
+
+    void World::applyLinearImpulse(const BodyId id, const math::Vec2& impulse, const math::Vec2& point)
+    {
+        Body& body = this->body(id);
+        if (body.type != BodyType::Dynamic)
+        {
+            return;
+        }
+        wake(body);
+        body.linearVelocity += impulse * body.inverseMass;
+        body.angularVelocity += body.inverseInertia * math::Cross(point - body.center, impulse);
+    }
+
+    BodyId World::shapeBody(const ShapeId shape) const
+    {
+        const std::uint32_t index = this->shape(shape).body;
+        return {index, bodies_[index].generation};
+    }
+
+    std::uint64_t World::userData(const ShapeId shape) const
+    {
+        return this->shape(shape).userData;
+    }
+
+    const std::variant<Circle, Polygon>& World::geometry(const ShapeId shape) const
+    {
+        return this->shape(shape).geometry;
+    }
+
+    ShapeView World::proxyShape(const std::uint32_t proxy) const
+    {
+        const std::uint32_t index = tree_.userData(proxy);
+        const Shape& shape = shapes_[index];
+        const Body& body = bodies_[shape.body];
+        return {{index, shape.generation}, {shape.body, body.generation}, &shape.geometry, body.xf, shape.categoryBits,
+                shape.maskBits};
+    }
+}
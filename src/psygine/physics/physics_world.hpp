@@ -0,0 +1,450 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#ifndef PSYGINE_PHYSICS_WORLD_HPP
+#define PSYGINE_PHYSICS_WORLD_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numbers>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+#include "collision.hpp"
+#include "geometry.hpp"
+#include "psygine/core/snapshot.hpp"
+#include "psygine/core/thread_pool.hpp"
+#include "psygine/math/aabb.hpp"
+#include "psygine/math/vector.hpp"
+#include "psygine/spatial/aabb_tree.hpp"
+
+namespace psygine::physics
+{
+    /**
+     * @brief Identifies a body in a `World`; a stale handle reports the body as gone.
+     */
+    struct BodyId
+    {
+        static constexpr std::uint32_t INVALID_INDEX = std::numeric_limits<std::uint32_t>::max();
+
+        std::uint32_t index = INVALID_INDEX;
+        std::uint32_t generation = 0;
+
+        [[nodiscard]] bool valid() const
+        {
+            return index != INVALID_INDEX;
+        }
+
+        bool operator==(const BodyId&) const = default;
+    };
+
+    /**
+     * @brief Identifies a shape in a `World`; a stale handle reports the shape as gone.
+     */
+    struct ShapeId
+    {
+        static constexpr std::uint32_t INVALID_INDEX = std::numeric_limits<std::uint32_t>::max();
+
+        std::uint32_t index = INVALID_INDEX;
+        std::uint32_t generation = 0;
+
+        [[nodiscard]] bool valid() const
+        {
+            return index != INVALID_INDEX;
+        }
+
+        bool operator==(const ShapeId&) const = default;
+    };
+
+    enum class BodyType : std::uint8_t
+    {
+        // Never moves; infinite mass.
+        Static,
+        // Moved only by its velocity; pushes dynamic bodies but is not pushed back.
+        Kinematic,
+        // Moved by forces and contacts.
+        Dynamic
+    };
+
+    struct BodyDef
+    {
+        BodyType type = BodyType::Static;
+        math::Vec2 position{};
+        Rotation rotation{};
+        math::Vec2 linearVelocity{};
+        float angularVelocity = 0.0F;
+        float linearDamping = 0.0F;
+        float angularDamping = 0.0F;
+        float gravityScale = 1.0F;
+        bool fixedRotation = false;
+        bool allowSleep = true;
+        bool awake = true;
+        std::uint64_t userData = 0;
+    };
+
+    struct ShapeDef
+    {
+        float density = 1.0F;
+        float friction = 0.6F;
+        float restitution = 0.0F;
+        // Two shapes collide when each one's category is in the other's mask.
+        std::uint32_t categoryBits = 1;
+        std::uint32_t maskBits = std::numeric_limits<std::uint32_t>::max();
+        std::uint64_t userData = 0;
+    };
+
+    struct WorldDef
+    {
+        math::Vec2 gravity{0.0F, -10.0F};
+        std::uint32_t velocityIterations = 8;
+        // Extra iterations after the positions are integrated, without the push that separates
+        // overlapping shapes.
+        std::uint32_t relaxIterations = 2;
+        // Fraction of the overlap beyond the slop that is pushed out per step.
+        float baumgarte = 0.2F;
+        // Closing speeds below this do not bounce.
+        float restitutionThreshold = 1.0F;
+        // Contact points are kept up to this far apart so fast bodies stop before they overlap.
+        float speculativeDistance = 4.0F * LINEAR_SLOP;
+        // Per-step limits that keep a body from tunnelling through everything after a huge impulse.
+        float maxTranslation = 4.0F;
+        float maxRotation = 0.25F * std::numbers::pi_v<float>;
+        bool enableSleep = true;
+        // An island sleeps once every body in it has been slower than the tolerances for this long.
+        float timeToSleep = 0.5F;
+        float linearSleepTolerance = 0.01F;
+        float angularSleepTolerance = 2.0F / 180.0F * std::numbers::pi_v<float>;
+    };
+
+    /**
+     * @brief A shape as queries see it: what it is, where it is, and what it collides with.
+     */
+    struct ShapeView
+    {
+        ShapeId shape;
+        BodyId body;
+        const std::variant<Circle, Polygon>* geometry;
+        Transform transform;
+        std::uint32_t categoryBits;
+        std::uint32_t maskBits;
+    };
+
+    /**
+     * @brief 2D rigid-body simulation: a dynamic AABB tree broadphase, circle and convex polygon
+     * contacts, and a sequential impulse solver with warm starting.
+     *
+     * Step it from `onFixedUpdate` with `RuntimeConfig::fixedTimestep`. Bodies connected by touching
+     * contacts form islands; each island is solved on its own, so with a pool the islands of a step
+     * are spread over the workers, and an island whose bodies have all come to rest goes to sleep
+     * until something touches it or it is changed through the API.
+     *
+     * The simulation is deterministic: given the same calls, the state after each step is
+     * bit-identical whatever the pool or its worker count. Every stage either runs serially or
+     * writes only to data owned by one item, and stepping never calls the platform's trigonometry.
+     */
+    class World
+    {
+    public:
+        explicit World(const WorldDef& def = {});
+
+        BodyId createBody(const BodyDef& def);
+
+        /**
+         * @brief Destroys a body with its shapes and contacts, waking whatever was touching it.
+         */
+        void destroyBody(BodyId body);
+
+        /**
+         * @brief Attaches a shape to a body and updates the body's mass.
+         *
+         * A dynamic body whose shapes have no mass is given a mass of 1 so it still responds to
+         * contacts.
+         */
+        ShapeId createShape(BodyId body, const ShapeDef& def, const Circle& circle);
+        ShapeId createShape(BodyId body, const ShapeDef& def, const Polygon& polygon);
+
+        /**
+         * @brief Advances the simulation by `dt` seconds.
+         *
+         * @param dt The step length; keep it fixed.
+         * @param pool Pool to update contacts and solve islands on; null runs on the calling thread.
+         */
+        void step(double dt, core::ThreadPool* pool = nullptr);
+
+        /**
+         * @brief Writes everything a step depends on: bodies, shapes, contacts with their accumulated
+         * impulses, and the broadphase.
+         *
+         * Loading it with `loadState` and making the same calls replays the original run bit for bit,
+         * which is what rollback needs. Statistics such as `islandCount` keep describing the last step
+         * actually taken.
+         */
+        void saveState(core::SnapshotWriter& writer) const;
+        void loadState(core::SnapshotReader& reader);
+
+        [[nodiscard]] bool alive(BodyId body) const;
+        [[nodiscard]] bool alive(ShapeId shape) const;
+
+        [[nodiscard]] BodyType type(BodyId body) const;
+        [[nodiscard]] Transform transform(BodyId body) const;
+        [[nodiscard]] math::Vec2 position(BodyId body) const;
+        [[nodiscard]] Rotation rotation(BodyId body) const;
+        [[nodiscard]] math::Vec2 worldCenter(BodyId body) const;
+        [[nodiscard]] math::Vec2 linearVelocity(BodyId body) const;
+        [[nodiscard]] float angularVelocity(BodyId body) const;
+        [[nodiscard]] float mass(BodyId body) const;
+        [[nodiscard]] float rotationalInertia(BodyId body) const;
+        [[nodiscard]] bool awake(BodyId body) const;
+        [[nodiscard]] std::uint64_t userData(BodyId body) const;
+
+        /**
+         * @brief Teleports a body. Contacts are not resolved until the next step.
+         */
+        void setTransform(BodyId body, const math::Vec2& position, const Rotation& rotation);
+        void setLinearVelocity(BodyId body, const math::Vec2& velocity);
+        void setAngularVelocity(BodyId body, float velocity);
+        void setAwake(BodyId body, bool awake);
+
+        /**
+         * @brief Adds a force at a world point for the next step; it is cleared afterwards.
+         */
+        void applyForce(BodyId body, const math::Vec2& force, const math::Vec2& point);
+        void applyForceToCenter(BodyId body, const math::Vec2& force);
+        void applyTorque(BodyId body, float torque);
+
+        /**
+         * @brief Changes a body's velocity at once, as if hit at a world point.
+         */
+        void applyLinearImpulse(BodyId body, const math::Vec2& impulse, const math::Vec2& point);
+
+        [[nodiscard]] BodyId shapeBody(ShapeId shape) const;
+        [[nodiscard]] std::uint64_t userData(ShapeId shape) const;
+
+        /**
+         * @brief The shape's geometry in body space: a `Circle` or a `Polygon`.
+         */
+        [[nodiscard]] const std::variant<Circle, Polygon>& geometry(ShapeId shape) const;
+
+        /**
+         * @brief The shape behind a broadphase proxy.
+         */
+        [[nodiscard]] ShapeView proxyShape(std::uint32_t proxy) const;
+
+        /**
+         * @brief The broadphase; proxy user data is the shape index.
+         */
+        [[nodiscard]] const spatial::AabbTree2D& broadphase() const
+        {
+            return tree_;
+        }
+
+        [[nodiscard]] const WorldDef& def() const
+        {
+            return def_;
+        }
+
+        void setGravity(const math::Vec2& gravity)
+        {
+            def_.gravity = gravity;
+        }
+
+        [[nodiscard]] std::size_t bodyCount() const
+        {
+            return bodyCount_;
+        }
+
+        [[nodiscard]] std::size_t contactCount() const
+        {
+            return contacts_.size();
+        }
+
+        /**
+         * @brief Islands solved by the last step.
+         */
+        [[nodiscard]] std::size_t islandCount() const
+        {
+            return islands_.size();
+        }
+
+        /**
+         * @brief Dynamic bodies solved by the last step.
+         */
+        [[nodiscard]] std::size_t awakeBodyCount() const
+        {
+            return islandBodies_.size();
+        }
+
+    private:
+        static constexpr std::uint32_t INVALID_INDEX = std::numeric_limits<std::uint32_t>::max();
+
+        struct Body
+        {
+            Transform xf;
+            // Center of mass, in world and body space.
+            math::Vec2 center{};
+            math::Vec2 localCenter{};
+            math::Vec2 linearVelocity{};
+            float angularVelocity = 0.0F;
+            math::Vec2 force{};
+            float torque = 0.0F;
+            float mass = 0.0F;
+            float inverseMass = 0.0F;
+            float inertia = 0.0F;
+            float inverseInertia = 0.0F;
+            float linearDamping = 0.0F;
+            float angularDamping = 0.0F;
+            float gravityScale = 1.0F;
+            float sleepTime = 0.0F;
+            // Head of the list of the body's shapes, linked through Shape::nextShape.
+            std::uint32_t firstShape = INVALID_INDEX;
+            std::uint64_t userData = 0;
+            std::uint32_t generation = 0;
+            // Index into solverBodies_ while the body is part of an island this step.
+            std::uint32_t solverIndex = INVALID_INDEX;
+            BodyType type = BodyType::Static;
+            bool awake = false;
+            bool fixedRotation = false;
+            bool allowSleep = true;
+            bool alive = false;
+        };
+
+        struct Shape
+        {
+            std::variant<Circle, Polygon> geometry;
+            float density = 0.0F;
+            float friction = 0.0F;
+            float restitution = 0.0F;
+            std::uint32_t categoryBits = 0;
+            std::uint32_t maskBits = 0;
+            std::uint64_t userData = 0;
+            std::uint32_t body = INVALID_INDEX;
+            std::uint32_t nextShape = INVALID_INDEX;
+            std::uint32_t proxy = INVALID_INDEX;
+            std::uint32_t generation = 0;
+            bool alive = false;
+        };
+
+        struct Contact
+        {
+            Manifold manifold;
+            // When one shape is a circle and the other a polygon, the polygon is `shapeA`.
+            std::uint32_t shapeA;
+            std::uint32_t shapeB;
+            std::uint32_t bodyA;
+            std::uint32_t bodyB;
+            float friction;
+            float restitution;
+            bool touching = false;
+            bool remove = false;
+        };
+
+        struct Island
+        {
+            // Ranges in islandBodies_ and islandContacts_.
+            std::uint32_t bodyBegin;
+            std::uint32_t bodyEnd;
+            std::uint32_t contactBegin;
+            std::uint32_t contactEnd;
+            // Touches a kinematic body that is moving, so it must stay awake.
+            bool pinnedAwake;
+        };
+
+        struct SolverBody
+        {
+            math::Vec2 linearVelocity;
+            float angularVelocity;
+            float inverseMass;
+            float inverseInertia;
+        };
+
+        struct ConstraintPoint
+        {
+            math::Vec2 rA;
+            math::Vec2 rB;
+            float normalImpulse;
+            float tangentImpulse;
+            float normalMass;
+            float tangentMass;
+            float bias;
+            float relaxBias;
+        };
+
+        struct ContactConstraint
+        {
+            // Indices into solverBodies_, or INVALID_INDEX for a static or kinematic body, which then
+            // uses the fixed copy.
+            std::uint32_t bodyA;
+            std::uint32_t bodyB;
+            SolverBody fixedA;
+            SolverBody fixedB;
+            math::Vec2 normal;
+            float friction;
+            std::uint32_t pointCount;
+            std::array<ConstraintPoint, MAX_MANIFOLD_POINTS> points;
+            // Normal mass matrix of a two-point contact and its inverse, when solved as a block.
+            float k11;
+            float k12;
+            float k22;
+            float m11;
+            float m12;
+            float m22;
+            bool block;
+        };
+
+        static std::uint64_t PairKey(std::uint32_t shapeA, std::uint32_t shapeB);
+
+        Body& body(BodyId id);
+        [[nodiscard]] const Body& body(BodyId id) const;
+        [[nodiscard]] const Shape& shape(ShapeId id) const;
+
+        ShapeId addShape(BodyId body, const ShapeDef& def, const std::variant<Circle, Polygon>& geometry);
+        void updateMass(Body& body);
+        void wake(Body& body);
+        [[nodiscard]] math::Aabb2 shapeAabb(const Shape& shape, const Transform& xf) const;
+        void synchronizeShapes(const Body& body, const math::Vec2& displacement);
+        [[nodiscard]] bool shouldCollide(const Shape& a, const Shape& b) const;
+
+        void findNewContacts(core::ThreadPool* pool);
+        void updateContacts(core::ThreadPool* pool);
+        void updateContact(Contact& contact) const;
+        void buildIslands();
+        void solveIsland(const Island& island, float dt);
+        void solveContacts(const Island& island, std::uint32_t iterations, bool useBias);
+        static void solveBlock(ContactConstraint& constraint, SolverBody& a, SolverBody& b, bool useBias);
+        void integrateKinematic(float dt);
+
+        WorldDef def_;
+        spatial::AabbTree2D tree_;
+
+        std::vector<Body> bodies_;
+        std::vector<std::uint32_t> freeBodies_;
+        std::size_t bodyCount_ = 0;
+        std::vector<Shape> shapes_;
+        std::vector<std::uint32_t> freeShapes_;
+        // Destroyed slots that contacts may still name; freed once the next step has dropped those contacts.
+        std::vector<std::uint32_t> deadBodies_;
+        std::vector<std::uint32_t> deadShapes_;
+
+        std::vector<Contact> contacts_;
+        // Contact index by PairKey of its shapes.
+        std::unordered_map<std::uint64_t, std::uint32_t> pairMap_;
+
+        // Per-step scratch.
+        std::vector<spatial::AabbTree2D::Pair> pairs_;
+        std::vector<std::uint32_t> adjacencyStart_;
+        std::vector<std::uint32_t> adjacency_;
+        std::vector<std::uint8_t> visited_;
+        std::vector<std::uint32_t> stack_;
+        std::vector<Island> islands_;
+        std::vector<std::uint32_t> islandOrder_;
+        std::vector<std::uint32_t> islandBodies_;
+        std::vector<std::uint32_t> islandContacts_;
+        std::vector<SolverBody> solverBodies_;
+        std::vector<ContactConstraint> constraints_;
+    };
+}
+
+#endif //PSYGINE_PHYSICS_WORLD_HPP
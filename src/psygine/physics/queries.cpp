@@ -0,0 +1,527 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#include "queries.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <variant>
+
+#include "psygine/debug/assert.hpp"
+#include "psygine/utilities/simd.hpp"
+
+namespace
+{
+    namespace physics = psygine::physics;
+    namespace simd = psygine::utilities::simd;
+    using psygine::math::Vec2;
+
+    constexpr std::size_t LANES = simd::NATIVE_WIDTH;
+    using FloatPack = simd::Float<LANES>;
+
+    // Packets handed to a worker at a time; also the unit overlap results are gathered in.
+    constexpr std::size_t PACKETS_PER_CHUNK = 16;
+
+    // Finite stand-in for 1/0 in the slab test, so an axis-parallel ray never computes 0 * inf.
+    constexpr float HUGE_INVERSE = 1e30F;
+
+    // Bits of each axis in the Morton code that orders queries.
+    constexpr std::uint32_t MORTON_BITS = 15;
+
+    bool Accepts(const physics::QueryFilter& filter, const physics::ShapeView& view)
+    {
+        return (filter.maskBits & view.categoryBits) != 0 && (view.maskBits & filter.categoryBits) != 0;
+    }
+
+    // Moves the low 15 bits of `x` to the even bits.
+    std::uint32_t SpreadBits(std::uint32_t x)
+    {
+        x &= (1U << MORTON_BITS) - 1;
+        x = (x | (x << 8)) & 0x00FF00FFU;
+        x = (x | (x << 4)) & 0x0F0F0F0FU;
+        x = (x | (x << 2)) & 0x33333333U;
+        x = (x | (x << 1)) & 0x55555555U;
+        return x;
+    }
+
+    // Query indices sorted so neighbouring queries start close together and head the same way: the
+    // direction's quadrant, then the Morton code of the start point over the bounds of all of them.
+    template <typename Point, typename Direction>
+    std::vector<std::uint32_t> CoherentOrder(const std::size_t count, Point point, Direction direction)
+    {
+        Vec2 lower{std::numeric_limits<float>::max(), std::numeric_limits<float>::max()};
+        Vec2 upper{-std::numeric_limits<float>::max(), -std::numeric_limits<float>::max()};
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const Vec2 p = point(i);
+            lower = {std::min(lower.x, p.x), std::min(lower.y, p.y)};
+            upper = {std::max(upper.x, p.x), std::max(upper.y, p.y)};
+        }
+        constexpr auto CELLS = static_cast<float>((1U << MORTON_BITS) - 1);
+        const Vec2 extent = upper - lower;
+        const Vec2 scale{extent.x > 0.0F ? CELLS / extent.x : 0.0F, extent.y > 0.0F ? CELLS / extent.y : 0.0F};
+
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> keys(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const Vec2 p = point(i) - lower;
+            const Vec2 d = direction(i);
+            const auto x = static_cast<std::uint32_t>(std::clamp(p.x * scale.x, 0.0F, CELLS));
+            const auto y = static_cast<std::uint32_t>(std::clamp(p.y * scale.y, 0.0F, CELLS));
+            const std::uint32_t quadrant = (d.x < 0.0F ? 2U : 0U) | (d.y < 0.0F ? 1U : 0U);
+            keys[i] = {(quadrant << (2 * MORTON_BITS)) | SpreadBits(x) | (SpreadBits(y) << 1),
+                       static_cast<std::uint32_t>(i)};
+        }
+        std::ranges::sort(keys);
+
+        std::vector<std::uint32_t> order(count);
+        std::ranges::transform(keys, order.begin(), [](const auto& key)
+        {
+            return key.second;
+        });
+        return order;
+    }
+
+    // Runs `fn(chunk, first, last)` over fixed chunks of packets, on the pool when there is more than one.
+    // Chunk boundaries do not depend on the thread count.
+    template <typename Fn>
+    void ForEachChunk(const std::size_t packets, psygine::core::ThreadPool* pool, Fn fn)
+    {
+        const std::size_t chunks = (packets + PACKETS_PER_CHUNK - 1) / PACKETS_PER_CHUNK;
+        const auto run = [&](const std::size_t begin, const std::size_t end)
+        {
+            for (std::size_t chunk = begin; chunk < end; ++chunk)
+            {
+                fn(chunk, chunk * PACKETS_PER_CHUNK, std::min(packets, (chunk + 1) * PACKETS_PER_CHUNK));
+            }
+        };
+        if (pool == nullptr || chunks <= 1)
+        {
+            run(0, chunks);
+        }
+        else
+        {
+            pool->parallelFor(chunks, 1, run);
+        }
+    }
+
+    struct Sweep
+    {
+        Vec2 origin;
+        Vec2 translation;
+        float radius;
+    };
+
+    // Up to `LANES` sweeps walked through the tree together, one lane each.
+    struct SweepPacket
+    {
+        std::array<float, LANES> originX{};
+        std::array<float, LANES> originY{};
+        std::array<float, LANES> inverseX{};
+        std::array<float, LANES> inverseY{};
+        std::array<float, LANES> radius{};
+        std::array<float, LANES> maxFraction{};
+        std::array<std::uint32_t, LANES> query{};
+        std::uint32_t active = 0;
+    };
+
+    float SafeInverse(const float x)
+    {
+        return std::clamp(1.0F / x, -HUGE_INVERSE, HUGE_INVERSE);
+    }
+
+    void CastPacket(const physics::World& world, const std::span<const Sweep> sweeps,
+                    const std::span<const std::uint32_t> queries, const std::span<physics::CastResult> results,
+                    const physics::QueryFilter& filter)
+    {
+        SweepPacket packet;
+        for (std::size_t lane = 0; lane < queries.size(); ++lane)
+        {
+            const Sweep& sweep = sweeps[queries[lane]];
+            packet.originX[lane] = sweep.origin.x;
+            packet.originY[lane] = sweep.origin.y;
+            packet.inverseX[lane] = SafeInverse(sweep.translation.x);
+            packet.inverseY[lane] = SafeInverse(sweep.translation.y);
+            packet.radius[lane] = sweep.radius;
+            packet.maxFraction[lane] = 1.0F;
+            packet.query[lane] = queries[lane];
+            packet.active |= 1U << lane;
+        }
+
+        const FloatPack originX = simd::Load(packet.originX.data(), FloatPack{});
+        const FloatPack originY = simd::Load(packet.originY.data(), FloatPack{});
+        const FloatPack inverseX = simd::Load(packet.inverseX.data(), FloatPack{});
+        const FloatPack inverseY = simd::Load(packet.inverseY.data(), FloatPack{});
+        const FloatPack radius = simd::Load(packet.radius.data(), FloatPack{});
+
+        // Slab test of every lane against the box grown by the lane's radius, clipped to the part of
+        // the sweep that is still closer than its best hit.
+        const auto test = [&](const psygine::math::Aabb2& box)
+        {
+            const FloatPack maxFraction = simd::Load(packet.maxFraction.data(), FloatPack{});
+            const FloatPack x1 = (FloatPack(box.min.x) - radius - originX) * inverseX;
+            const FloatPack x2 = (FloatPack(box.max.x) + radius - originX) * inverseX;
+            const FloatPack y1 = (FloatPack(box.min.y) - radius - originY) * inverseY;
+            const FloatPack y2 = (FloatPack(box.max.y) + radius - originY) * inverseY;
+            const FloatPack enter = simd::Max(simd::Max(simd::Min(x1, x2), simd::Min(y1, y2)), FloatPack(0.0F));
+            const FloatPack exit = simd::Min(simd::Min(simd::Max(x1, x2), simd::Max(y1, y2)), maxFraction);
+            return simd::MoveMask(enter <= exit) & packet.active;
+        };
+
+        const auto leaf = [&](const std::uint32_t proxy, std::uint32_t mask)
+        {
+            const physics::ShapeView view = world.proxyShape(proxy);
+            if (!Accepts(filter, view))
+            {
+                return;
+            }
+            for (; mask != 0; mask &= mask - 1)
+            {
+                const auto lane = static_cast<std::size_t>(std::countr_zero(mask));
+                const Sweep& sweep = sweeps[packet.query[lane]];
+                const physics::CastOutput output = std::visit([&](const auto& geometry)
+                {
+                    return physics::CastShape(geometry, view.transform, sweep.origin, sweep.radius,
+                                              sweep.translation, packet.maxFraction[lane]);
+                }, *view.geometry);
+                if (output.hit)
+                {
+                    packet.maxFraction[lane] = output.fraction;
+                    results[packet.query[lane]] = {view.shape, output.point, output.normal, output.fraction};
+                }
+            }
+        };
+
+        world.broadphase().traversePacket(test, leaf);
+    }
+
+    void CastSweeps(const physics::World& world, const std::span<const Sweep> sweeps,
+                    const std::span<physics::CastResult> results, const physics::QueryFilter& filter,
+                    psygine::core::ThreadPool* pool)
+    {
+        std::ranges::fill(results, physics::CastResult{});
+        const std::vector<std::uint32_t> order = CoherentOrder(sweeps.size(), [&](const std::size_t i)
+        {
+            return sweeps[i].origin;
+        }, [&](const std::size_t i)
+        {
+            return sweeps[i].translation;
+        });
+
+        const std::size_t packets = (sweeps.size() + LANES - 1) / LANES;
+        ForEachChunk(packets, pool, [&](std::size_t, const std::size_t first, const std::size_t last)
+        {
+            for (std::size_t p = first; p < last; ++p)
+            {
+                const std::size_t begin = p * LANES;
+                const std::size_t end = std::min(sweeps.size(), begin + LANES);
+                CastPacket(world, sweeps, std::span(order).subspan(begin, end - begin), results, filter);
+            }
+        });
+    }
+
+    struct Hit
+    {
+        std::uint32_t query;
+        physics::ShapeId shape;
+    };
+
+    // Walks packets of query boxes through the tree and keeps the shapes `exact(query, view)` accepts.
+    template <typename Exact>
+    void OverlapBounds(const physics::World& world, const std::span<const psygine::math::Aabb2> bounds,
+                       physics::OverlapResults& results, const physics::QueryFilter& filter,
+                       psygine::core::ThreadPool* pool, Exact exact)
+    {
+        const std::vector<std::uint32_t> order = CoherentOrder(bounds.size(), [&](const std::size_t i)
+        {
+            return bounds[i].min;
+        }, [](std::size_t)
+        {
+            return Vec2{};
+        });
+
+        const std::size_t packets = (bounds.size() + LANES - 1) / LANES;
+        std::vector<std::vector<Hit>> chunkHits((packets + PACKETS_PER_CHUNK - 1) / PACKETS_PER_CHUNK);
+        ForEachChunk(packets, pool, [&](const std::size_t chunk, const std::size_t first, const std::size_t last)
+        {
+            std::vector<Hit>& hits = chunkHits[chunk];
+            for (std::size_t p = first; p < last; ++p)
+            {
+                const std::size_t begin = p * LANES;
+                const std::size_t count = std::min(bounds.size() - begin, LANES);
+                std::array<float, LANES> minX{};
+                std::array<float, LANES> minY{};
+                std::array<float, LANES> maxX{};
+                std::array<float, LANES> maxY{};
+                for (std::size_t lane = 0; lane < count; ++lane)
+                {
+                    const psygine::math::Aabb2& box = bounds[order[begin + lane]];
+                    minX[lane] = box.min.x;
+                    minY[lane] = box.min.y;
+                    maxX[lane] = box.max.x;
+                    maxY[lane] = box.max.y;
+                }
+                const std::uint32_t active = (1U << count) - 1;
+                const FloatPack lowerX = simd::Load(minX.data(), FloatPack{});
+                const FloatPack lowerY = simd::Load(minY.data(), FloatPack{});
+                const FloatPack upperX = simd::Load(maxX.data(), FloatPack{});
+                const FloatPack upperY = simd::Load(maxY.data(), FloatPack{});
+
+                const auto test = [&](const psygine::math::Aabb2& box)
+                {
+                    const auto overlap = (lowerX <= FloatPack(box.max.x)) & (FloatPack(box.min.x) <= upperX) &
+                        (lowerY <= FloatPack(box.max.y)) & (FloatPack(box.min.y) <= upperY);
+                    return simd::MoveMask(overlap) & active;
+                };
+                const auto leaf = [&](const std::uint32_t proxy, std::uint32_t mask)
+                {
+                    const physics::ShapeView view = world.proxyShape(proxy);
+                    if (!Accepts(filter, view))
+                    {
+                        return;
+                    }
+                    for (; mask != 0; mask &= mask - 1)
+                    {
+                        const std::uint32_t query = order[begin + static_cast<std::size_t>(std::countr_zero(mask))];
+                        if (exact(query, view))
+                        {
+                            hits.push_back({query, view.shape});
+                        }
+                    }
+                };
+                world.broadphase().traversePacket(test, leaf);
+            }
+        });
+
+        results.offsets.assign(bounds.size() + 1, 0);
+        for (const std::vector<Hit>& hits : chunkHits)
+        {
+            for (const Hit& hit : hits)
+            {
+                ++results.offsets[hit.query + 1];
+            }
+        }
+        std::partial_sum(results.offsets.begin(), results.offsets.end(), results.offsets.begin());
+        results.shapes.resize(results.offsets.back());
+
+        std::vector<std::uint32_t> cursor(results.offsets.begin(), results.offsets.end() - 1);
+        for (const std::vector<Hit>& hits : chunkHits)
+        {
+            for (const Hit& hit : hits)
+            {
+                results.shapes[cursor[hit.query]++] = hit.shape;
+            }
+        }
+    }
+
+    physics::CastOutput CastCircle(const Vec2& center, const float radius, const Vec2& origin, const Vec2& translation,
+                                   const float maxFraction)
+    {
+        // Solves |origin + t * translation - center| = radius for the entering root.
+        physics::CastOutput output;
+        const Vec2 s = origin - center;
+        const float c = psygine::math::Dot(s, s) - (radius * radius);
+        if (c < 0.0F)
+        {
+            return output;
+        }
+        const float a = psygine::math::Dot(translation, translation);
+        const float b = psygine::math::Dot(s, translation);
+        const float discriminant = (b * b) - (a * c);
+        if (a < std::numeric_limits<float>::epsilon() || discriminant < 0.0F)
+        {
+            return output;
+        }
+        const float t = (-b - std::sqrt(discriminant)) / a;
+        if (t < 0.0F || t > maxFraction)
+        {
+            return output;
+        }
+        output.fraction = t;
+        output.normal = psygine::math::Normalize(s + (translation * t));
+        output.point = center + (output.normal * radius);
+        output.hit = true;
+        return output;
+    }
+}
+
+namespace psygine::physics
+{
+    CastOutput CastShape(const Circle& circle, const Transform& xf, const math::Vec2& origin, const float radius,
+                         const math::Vec2& translation, const float maxFraction)
+    {
+        const math::Vec2 center = TransformPoint(xf, circle.center);
+        CastOutput output = CastCircle(center, circle.radius + radius, origin, translation, maxFraction);
+        if (output.hit)
+        {
+            output.point = center + (output.normal * circle.radius);
+        }
+        return output;
+    }
+
+    CastOutput CastShape(const Polygon& polygon, const Transform& xf, const math::Vec2& origin, const float radius,
+                         const math::Vec2& translation, const float maxFraction)
+    {
+        // Work in the polygon's frame.
+        const math::Vec2 p = InverseTransformPoint(xf, origin);
+        const math::Vec2 d = InverseRotate(xf.rotation, translation);
+        CastOutput output;
+
+        if (radius == 0.0F)
+        {
+            // Clip the ray against every face's half-plane; the last face it enters is the one hit.
+            float lower = 0.0F;
+            float upper = maxFraction;
+            std::uint32_t face = MAX_POLYGON_VERTICES;
+            for (std::uint32_t i = 0; i < polygon.count; ++i)
+            {
+                const float numerator = math::Dot(polygon.normals[i], polygon.vertices[i] - p);
+                const float denominator = math::Dot(polygon.normals[i], d);
+                if (denominator == 0.0F)
+                {
+                    if (numerator < 0.0F)
+                    {
+                        return output;
+                    }
+                }
+                else if (denominator < 0.0F && numerator < lower * denominator)
+                {
+                    lower = numerator / denominator;
+                    face = i;
+                }
+                else if (denominator > 0.0F && numerator < upper * denominator)
+                {
+                    upper = numerator / denominator;
+                }
+                if (upper < lower)
+                {
+                    return output;
+                }
+            }
+            if (face == MAX_POLYGON_VERTICES)
+            {
+                return output;
+            }
+            output.fraction = lower;
+            output.normal = Rotate(xf.rotation, polygon.normals[face]);
+            output.point = TransformPoint(xf, p + (d * lower));
+            output.hit = true;
+            return output;
+        }
+
+        // A circle hits the polygon grown by its radius: faces pushed out along their normals, joined
+        // by arcs around the vertices. The earliest of those is the hit.
+        float best = maxFraction;
+        math::Vec2 normal{};
+        math::Vec2 contact{};
+        for (std::uint32_t i = 0; i < polygon.count; ++i)
+        {
+            const math::Vec2 n = polygon.normals[i];
+            const float denominator = math::Dot(n, d);
+            if (denominator >= 0.0F)
+            {
+                continue;
+            }
+            const math::Vec2 v1 = polygon.vertices[i];
+            const math::Vec2 v2 = polygon.vertices[(i + 1) % polygon.count];
+            const float t = math::Dot(n, v1 + (n * radius) - p) / denominator;
+            if (t < 0.0F || t > best)
+            {
+                continue;
+            }
+            const math::Vec2 center = p + (d * t);
+            const math::Vec2 edge = v2 - v1;
+            const float s = math::Dot(center - v1, edge);
+            if (s < 0.0F || s > math::Dot(edge, edge))
+            {
+                continue;
+            }
+            best = t;
+            normal = n;
+            contact = center - (n * radius);
+            output.hit = true;
+        }
+        for (std::uint32_t i = 0; i < polygon.count; ++i)
+        {
+            const CastOutput corner = CastCircle(polygon.vertices[i], radius, p, d, best);
+            if (corner.hit)
+            {
+                best = corner.fraction;
+                normal = corner.normal;
+                contact = polygon.vertices[i];
+                output.hit = true;
+            }
+        }
+        if (output.hit)
+        {
+            output.fraction = best;
+            output.normal = Rotate(xf.rotation, normal);
+            output.point = TransformPoint(xf, contact);
+        }
+        return output;
+    }
+
+    void CastRays(const World& world, const std::span<const RayInput> rays, const std::span<CastResult> results,
+                  const QueryFilter& filter, core::ThreadPool* pool)
+    {
+        PSYGINE_ASSERT(results.size() == rays.size(), "CastRays: one result per ray is needed");
+        std::vector<Sweep> sweeps(rays.size());
+        std::ranges::transform(rays, sweeps.begin(), [](const RayInput& ray)
+        {
+            return Sweep{ray.origin, ray.translation, 0.0F};
+        });
+        CastSweeps(world, sweeps, results, filter, pool);
+    }
+
+    void CastCircles(const World& world, const std::span<const CircleCastInput> casts,
+                     const std::span<CastResult> results, const QueryFilter& filter, core::ThreadPool* pool)
+    {
+        PSYGINE_ASSERT(results.size() == casts.size(), "CastCircles: one result per cast is needed");
+        std::vector<Sweep> sweeps(casts.size());
+        std::ranges::transform(casts, sweeps.begin(), [](const CircleCastInput& cast)
+        {
+            PSYGINE_ASSERT(cast.radius >= 0.0F, "CastCircles: radius must not be negative");
+            return Sweep{cast.center, cast.translation, cast.radius};
+        });
+        CastSweeps(world, sweeps, results, filter, pool);
+    }
+
+    void OverlapBoxes(const World& world, const std::span<const math::Aabb2> boxes, OverlapResults& results,
+                      const QueryFilter& filter, core::ThreadPool* pool)
+    {
+        OverlapBounds(world, boxes, results, filter, pool, [&](const std::uint32_t query, const ShapeView& view)
+        {
+            const math::Aabb2 box = std::visit([&](const auto& geometry)
+            {
+                return ComputeAabb(geometry, view.transform);
+            }, *view.geometry);
+            return math::Overlaps(boxes[query], box);
+        });
+    }
+
+    void OverlapCircles(const World& world, const std::span<const Circle> circles, OverlapResults& results,
+                        const QueryFilter& filter, core::ThreadPool* pool)
+    {
+        std::vector<math::Aabb2> bounds(circles.size());
+        std::ranges::transform(circles, bounds.begin(), [](const Circle& circle)
+        {
+            return ComputeAabb(circle, Transform{});
+        });
+        OverlapBounds(world, bounds, results, filter, pool, [&](const std::uint32_t query, const ShapeView& view)
+        {
+            const Circle& circle = circles[query];
+            if (const auto* target = std::get_if<Circle>(view.geometry))
+            {
+                return CollideCircles(*target, view.transform, circle, Transform{}, 0.0F).pointCount > 0;
+            }
+            return CollidePolygonAndCircle(std::get<Polygon>(*view.geometry), view.transform, circle, Transform{},
+                                           0.0F).pointCount > 0;
+        });
+    }
+}
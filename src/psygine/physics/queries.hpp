@@ -0,0 +1,133 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#ifndef PSYGINE_QUERIES_HPP
+#define PSYGINE_QUERIES_HPP
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "geometry.hpp"
+#include "physics_world.hpp"
+#include "psygine/core/thread_pool.hpp"
+#include "psygine/math/aabb.hpp"
+#include "psygine/math/vector.hpp"
+
+namespace psygine::physics
+{
+    /**
+     * @brief Which shapes a query sees, with the same rule as contacts: each side's category must be
+     * in the other's mask.
+     */
+    struct QueryFilter
+    {
+        std::uint32_t categoryBits = 1;
+        std::uint32_t maskBits = ~0U;
+    };
+
+    /**
+     * @brief A ray from `origin` to `origin + translation`.
+     */
+    struct RayInput
+    {
+        math::Vec2 origin{};
+        math::Vec2 translation{};
+    };
+
+    /**
+     * @brief A circle swept from `center` to `center + translation`.
+     */
+    struct CircleCastInput
+    {
+        math::Vec2 center{};
+        float radius = 0.0F;
+        math::Vec2 translation{};
+    };
+
+    /**
+     * @brief The first hit along a cast.
+     *
+     * `point` is on the surface of the shape that was hit and `normal` is that surface's outward
+     * normal. `fraction` is the part of the translation travelled before the hit; it stays 1 on a miss.
+     */
+    struct CastResult
+    {
+        ShapeId shape{};
+        math::Vec2 point{};
+        math::Vec2 normal{};
+        float fraction = 1.0F;
+
+        [[nodiscard]] bool hit() const
+        {
+            return shape.valid();
+        }
+    };
+
+    /**
+     * @brief The shapes each overlap query found, in one flat array.
+     *
+     * Query `i` found `shapes[offsets[i]]` up to `shapes[offsets[i + 1]]`.
+     */
+    struct OverlapResults
+    {
+        std::vector<std::uint32_t> offsets;
+        std::vector<ShapeId> shapes;
+
+        [[nodiscard]] std::span<const ShapeId> operator[](const std::size_t query) const
+        {
+            return std::span(shapes).subspan(offsets[query], offsets[query + 1] - offsets[query]);
+        }
+    };
+
+    /**
+     * @brief Where a cast first touches one shape.
+     */
+    struct CastOutput
+    {
+        math::Vec2 point{};
+        math::Vec2 normal{};
+        float fraction = 0.0F;
+        bool hit = false;
+    };
+
+    /**
+     * @brief Casts a circle of `radius` (0 for a ray) from `origin` along `translation` against one
+     * shape, reporting hits up to `maxFraction`. A cast that starts inside the shape misses, so rays
+     * fired from inside a body see past it.
+     */
+    CastOutput CastShape(const Circle& circle, const Transform& xf, const math::Vec2& origin, float radius,
+                         const math::Vec2& translation, float maxFraction);
+    CastOutput CastShape(const Polygon& polygon, const Transform& xf, const math::Vec2& origin, float radius,
+                         const math::Vec2& translation, float maxFraction);
+
+    /**
+     * @brief The closest hit of every ray, written to the matching entry of `results`.
+     *
+     * Rays are sorted by direction and origin and walked through the broadphase in SIMD packets, so
+     * coherent batches share most of their traversal. Packets are spread over `pool` when given;
+     * every packet writes only its own results, so the output does not depend on the thread count.
+     */
+    void CastRays(const World& world, std::span<const RayInput> rays, std::span<CastResult> results,
+                  const QueryFilter& filter = {}, core::ThreadPool* pool = nullptr);
+
+    /**
+     * @brief The first hit of every swept circle; see `CastRays`.
+     */
+    void CastCircles(const World& world, std::span<const CircleCastInput> casts, std::span<CastResult> results,
+                     const QueryFilter& filter = {}, core::ThreadPool* pool = nullptr);
+
+    /**
+     * @brief The shapes whose bounding boxes overlap each box, in broadphase order.
+     */
+    void OverlapBoxes(const World& world, std::span<const math::Aabb2> boxes, OverlapResults& results,
+                      const QueryFilter& filter = {}, core::ThreadPool* pool = nullptr);
+
+    /**
+     * @brief The shapes touching each world-space circle, tested exactly.
+     */
+    void OverlapCircles(const World& world, std::span<const Circle> circles, OverlapResults& results,
+                        const QueryFilter& filter = {}, core::ThreadPool* pool = nullptr);
+}
+
+#endif //PSYGINE_QUERIES_HPP
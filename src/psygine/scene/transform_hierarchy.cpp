@@ -0,0 +1,337 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#include "transform_hierarchy.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <utility>
+
+#include "psygine/debug/assert.hpp"
+
+namespace
+{
+    // Nodes updated per claimed chunk; depths smaller than this run on the calling thread.
+    constexpr std::size_t NODE_GRAIN = 1024;
+
+    template <typename T>
+    void Permute(std::vector<T>& values, const std::vector<std::uint32_t>& order)
+    {
+        std::vector<T> sorted;
+        sorted.reserve(order.size());
+        for (const std::uint32_t i : order)
+        {
+            sorted.push_back(values[i]);
+        }
+        values = std::move(sorted);
+    }
+}
+
+namespace psygine::scene
+{
+    Affine2 MakeAffine(const LocalTransform& local)
+    {
+        const float c = std::cos(local.rotation);
+        const float s = std::sin(local.rotation);
+        return {{c * local.scale.x, s * local.scale.x}, {-s * local.scale.y, c * local.scale.y}, local.position};
+    }
+
+    NodeId TransformHierarchy::create(const LocalTransform& local, const NodeId parent)
+    {
+        const std::uint32_t parentIndex = parent.valid() ? dense(parent) : INVALID_INDEX;
+
+        std::uint32_t slot;
+        if (freeSlots_.empty())
+        {
+            slot = static_cast<std::uint32_t>(slots_.size());
+            slots_.emplace_back();
+        }
+        else
+        {
+            slot = freeSlots_.back();
+            freeSlots_.pop_back();
+        }
+
+        const NodeId id{slot, slots_[slot].generation};
+        slots_[slot].dense = static_cast<std::uint32_t>(nodes_.size());
+        nodes_.push_back(id);
+        parent_.push_back(parentIndex);
+        local_.push_back(local);
+        world_.emplace_back();
+        dirty_.push_back(1);
+        changed_.push_back(0);
+
+        ++size_;
+        layoutDirty_ = true;
+        anyDirty_ = true;
+        return id;
+    }
+
+    void TransformHierarchy::destroy(const NodeId node)
+    {
+        PSYGINE_ASSERT(alive(node), "TransformHierarchy::destroy: stale or invalid node");
+        if (orderBroken_)
+        {
+            sortLayout();
+        }
+
+        const auto kill = [this](const std::uint32_t index)
+        {
+            Slot& slot = slots_[nodes_[index].index];
+            slot.dense = INVALID_INDEX;
+            ++slot.generation;
+            freeSlots_.push_back(nodes_[index].index);
+            nodes_[index] = {};
+            --size_;
+        };
+
+        // Descendants come after the node, and a node whose parent is gone is a descendant. Nodes
+        // destroyed earlier took their own subtrees with them, so they never match twice.
+        const std::uint32_t root = slots_[node.index].dense;
+        kill(root);
+        for (std::size_t i = root + 1; i < nodes_.size(); ++i)
+        {
+            const std::uint32_t p = parent_[i];
+            if (nodes_[i].valid() && p != INVALID_INDEX && !nodes_[p].valid())
+            {
+                kill(static_cast<std::uint32_t>(i));
+            }
+        }
+        layoutDirty_ = true;
+    }
+
+    bool TransformHierarchy::alive(const NodeId node) const
+    {
+        return node.index < slots_.size() && slots_[node.index].generation == node.generation &&
+            slots_[node.index].dense != INVALID_INDEX;
+    }
+
+    void TransformHierarchy::setParent(const NodeId node, const NodeId parent)
+    {
+        const std::uint32_t index = dense(node);
+        const std::uint32_t parentIndex = parent.valid() ? dense(parent) : INVALID_INDEX;
+        for (std::uint32_t ancestor = parentIndex; ancestor != INVALID_INDEX; ancestor = parent_[ancestor])
+        {
+            PSYGINE_ASSERT(ancestor != index, "TransformHierarchy::setParent: a node cannot be its own ancestor");
+        }
+        if (parent_[index] == parentIndex)
+        {
+            return;
+        }
+
+        parent_[index] = parentIndex;
+        dirty_[index] = 1;
+        layoutDirty_ = true;
+        anyDirty_ = true;
+        // The subtree below keeps its order; only the node itself can end up before its parent.
+        if (parentIndex != INVALID_INDEX && parentIndex > index)
+        {
+            orderBroken_ = true;
+        }
+    }
+
+    NodeId TransformHierarchy::parent(const NodeId node) const
+    {
+        const std::uint32_t p = parent_[dense(node)];
+        return p == INVALID_INDEX ? NodeId{} : nodes_[p];
+    }
+
+    const LocalTransform& TransformHierarchy::local(const NodeId node) const
+    {
+        return local_[dense(node)];
+    }
+
+    void TransformHierarchy::setLocal(const NodeId node, const LocalTransform& local)
+    {
+        const std::uint32_t index = dense(node);
+        local_[index] = local;
+        dirty_[index] = 1;
+        anyDirty_ = true;
+    }
+
+    void TransformHierarchy::setPosition(const NodeId node, const math::Vec2& position)
+    {
+        const std::uint32_t index = dense(node);
+        local_[index].position = position;
+        dirty_[index] = 1;
+        anyDirty_ = true;
+    }
+
+    void TransformHierarchy::setRotation(const NodeId node, const float rotation)
+    {
+        const std::uint32_t index = dense(node);
+        local_[index].rotation = rotation;
+        dirty_[index] = 1;
+        anyDirty_ = true;
+    }
+
+    void TransformHierarchy::setScale(const NodeId node, const math::Vec2& scale)
+    {
+        const std::uint32_t index = dense(node);
+        local_[index].scale = scale;
+        dirty_[index] = 1;
+        anyDirty_ = true;
+    }
+
+    const Affine2& TransformHierarchy::world(const NodeId node) const
+    {
+        return world_[dense(node)];
+    }
+
+    bool TransformHierarchy::worldChanged(const NodeId node) const
+    {
+        return changed_[dense(node)] != 0;
+    }
+
+    void TransformHierarchy::update(core::ThreadPool* pool)
+    {
+        if (layoutDirty_)
+        {
+            sortLayout();
+        }
+        if (!anyDirty_)
+        {
+            if (anyChanged_)
+            {
+                std::ranges::fill(changed_, 0);
+                anyChanged_ = false;
+            }
+            return;
+        }
+
+        // A node is recomputed when it was changed or its parent was recomputed earlier in this pass.
+        const auto updateRange = [this](const std::size_t begin, const std::size_t end)
+        {
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                const std::uint32_t p = parent_[i];
+                const bool parentChanged = p != INVALID_INDEX && changed_[p] != 0;
+                if (dirty_[i] != 0 || parentChanged)
+                {
+                    const Affine2 local = MakeAffine(local_[i]);
+                    world_[i] = p == INVALID_INDEX ? local : world_[p] * local;
+                    changed_[i] = 1;
+                }
+                else
+                {
+                    changed_[i] = 0;
+                }
+                dirty_[i] = 0;
+            }
+        };
+
+        for (std::size_t level = 0; level + 1 < levels_.size(); ++level)
+        {
+            const std::size_t begin = levels_[level];
+            const std::size_t count = levels_[level + 1] - begin;
+            if (pool == nullptr || count <= NODE_GRAIN)
+            {
+                updateRange(begin, begin + count);
+            }
+            else
+            {
+                pool->parallelFor(count, NODE_GRAIN, [&](const std::size_t first, const std::size_t last)
+                {
+                    updateRange(begin + first, begin + last);
+                });
+            }
+        }
+        anyDirty_ = false;
+        anyChanged_ = true;
+    }
+
+    std::uint32_t TransformHierarchy::dense(const NodeId node) const
+    {
+        PSYGINE_ASSERT(alive(node), "TransformHierarchy: stale or invalid node");
+        return slots_[node.index].dense;
+    }
+
+    void TransformHierarchy::sortLayout()
+    {
+        const std::size_t count = nodes_.size();
+
+        // Depth of every live node. A re-parented node may still sit before its parent here, so walk
+        // up to the nearest node with a known depth and fill in the path on the way back.
+        std::vector<std::uint32_t> depth(count, INVALID_INDEX);
+        std::vector<std::uint32_t> path;
+        std::uint32_t depthCount = 0;
+        for (std::uint32_t i = 0; i < count; ++i)
+        {
+            if (!nodes_[i].valid() || depth[i] != INVALID_INDEX)
+            {
+                continue;
+            }
+            std::uint32_t ancestor = i;
+            while (ancestor != INVALID_INDEX && depth[ancestor] == INVALID_INDEX)
+            {
+                path.push_back(ancestor);
+                ancestor = parent_[ancestor];
+            }
+            std::uint32_t d = ancestor == INVALID_INDEX ? 0 : depth[ancestor] + 1;
+            for (auto it = path.rbegin(); it != path.rend(); ++it)
+            {
+                depth[*it] = d++;
+            }
+            depthCount = std::max(depthCount, d);
+            path.clear();
+        }
+
+        // Bucket by depth, keeping the current order within a depth.
+        levels_.assign(depthCount + 1, 0);
+        for (std::uint32_t i = 0; i < count; ++i)
+        {
+            if (nodes_[i].valid())
+            {
+                ++levels_[depth[i] + 1];
+            }
+        }
+        std::partial_sum(levels_.begin(), levels_.end(), levels_.begin());
+        std::vector<std::uint32_t> order(size_);
+        std::vector<std::uint32_t> cursor(levels_.begin(), levels_.end() - 1);
+        for (std::uint32_t i = 0; i < count; ++i)
+        {
+            if (nodes_[i].valid())
+            {
+                order[cursor[depth[i]]++] = i;
+            }
+        }
+
+        // Within a depth, group siblings in the order of their parents, which are already placed.
+        std::vector<std::uint32_t> remap(count, INVALID_INDEX);
+        for (std::size_t level = 0; level < depthCount; ++level)
+        {
+            const auto first = order.begin() + levels_[level];
+            const auto last = order.begin() + levels_[level + 1];
+            if (level > 0)
+            {
+                std::stable_sort(first, last, [&](const std::uint32_t a, const std::uint32_t b)
+                {
+                    return remap[parent_[a]] < remap[parent_[b]];
+                });
+            }
+            for (auto it = first; it != last; ++it)
+            {
+                remap[*it] = static_cast<std::uint32_t>(it - order.begin());
+            }
+        }
+
+        Permute(nodes_, order);
+        Permute(parent_, order);
+        Permute(local_, order);
+        Permute(world_, order);
+        Permute(dirty_, order);
+        Permute(changed_, order);
+        for (std::uint32_t i = 0; i < size_; ++i)
+        {
+            if (parent_[i] != INVALID_INDEX)
+            {
+                parent_[i] = remap[parent_[i]];
+            }
+            slots_[nodes_[i].index].dense = i;
+        }
+
+        layoutDirty_ = false;
+        orderBroken_ = false;
+    }
+}
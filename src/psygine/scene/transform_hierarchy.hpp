@@ -0,0 +1,218 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#ifndef PSYGINE_TRANSFORM_HIERARCHY_HPP
+#define PSYGINE_TRANSFORM_HIERARCHY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+#include "psygine/core/thread_pool.hpp"
+#include "psygine/math/vector.hpp"
+
+namespace psygine::scene
+{
+    /**
+     * @brief Identifies a node in a `TransformHierarchy`. A destroyed node's slot gets a new generation
+     * when reused, so stale handles report the node as gone.
+     */
+    struct NodeId
+    {
+        static constexpr std::uint32_t INVALID_INDEX = std::numeric_limits<std::uint32_t>::max();
+
+        std::uint32_t index = INVALID_INDEX;
+        std::uint32_t generation = 0;
+
+        [[nodiscard]] bool valid() const
+        {
+            return index != INVALID_INDEX;
+        }
+
+        bool operator==(const NodeId&) const = default;
+    };
+
+    /**
+     * @brief A node's placement relative to its parent: scaled, then rotated (radians), then moved.
+     */
+    struct LocalTransform
+    {
+        math::Vec2 position{};
+        float rotation = 0.0F;
+        math::Vec2 scale{1.0F, 1.0F};
+    };
+
+    /**
+     * @brief A 2D affine transform: the images of the x and y axes, then a translation.
+     */
+    struct Affine2
+    {
+        math::Vec2 x{1.0F, 0.0F};
+        math::Vec2 y{0.0F, 1.0F};
+        math::Vec2 translation{};
+
+        friend constexpr bool operator==(const Affine2& lhs, const Affine2& rhs) = default;
+    };
+
+    constexpr math::Vec2 TransformVector(const Affine2& m, const math::Vec2& v)
+    {
+        return (m.x * v.x) + (m.y * v.y);
+    }
+
+    constexpr math::Vec2 TransformPoint(const Affine2& m, const math::Vec2& p)
+    {
+        return TransformVector(m, p) + m.translation;
+    }
+
+    /**
+     * @brief `parent * child` applies `child` first.
+     */
+    constexpr Affine2 operator*(const Affine2& parent, const Affine2& child)
+    {
+        return {TransformVector(parent, child.x), TransformVector(parent, child.y),
+                TransformPoint(parent, child.translation)};
+    }
+
+    Affine2 MakeAffine(const LocalTransform& local);
+
+    /**
+     * @brief A scene graph of 2D transforms kept flat for cheap world-transform updates.
+     *
+     * Nodes live in contiguous arrays sorted breadth-first: by depth, and within a depth by parent,
+     * so every parent precedes its children and siblings sit together. `update` then computes world
+     * transforms in one linear pass per depth, reading each parent's already-final result instead of
+     * chasing pointers, and only recomputes nodes under something that changed. Every node of a depth
+     * is independent of the others, so large depths are spread over a pool.
+     *
+     * Creating, destroying and re-parenting nodes only mark the layout stale; the next `update`
+     * re-sorts it once for the whole batch.
+     */
+    class TransformHierarchy
+    {
+    public:
+        /**
+         * @brief Adds a node, as a root when `parent` is invalid. Its world transform is computed by
+         * the next `update`.
+         */
+        NodeId create(const LocalTransform& local = {}, NodeId parent = {});
+
+        /**
+         * @brief Destroys a node together with all of its descendants, in one pass over the nodes laid
+         * out after it.
+         */
+        void destroy(NodeId node);
+
+        [[nodiscard]] bool alive(NodeId node) const;
+
+        /**
+         * @brief Moves a node with its subtree under `parent`, or makes it a root when `parent` is
+         * invalid. The local transform is kept, so the subtree moves in the world.
+         */
+        void setParent(NodeId node, NodeId parent);
+
+        /**
+         * @brief The node's parent, or an invalid id for a root.
+         */
+        [[nodiscard]] NodeId parent(NodeId node) const;
+
+        [[nodiscard]] const LocalTransform& local(NodeId node) const;
+
+        void setLocal(NodeId node, const LocalTransform& local);
+        void setPosition(NodeId node, const math::Vec2& position);
+        void setRotation(NodeId node, float rotation);
+        void setScale(NodeId node, const math::Vec2& scale);
+
+        /**
+         * @brief The world transform as of the last `update`.
+         */
+        [[nodiscard]] const Affine2& world(NodeId node) const;
+
+        /**
+         * @brief Whether the last `update` recomputed the node's world transform, because it or an
+         * ancestor changed.
+         */
+        [[nodiscard]] bool worldChanged(NodeId node) const;
+
+        /**
+         * @brief Applies pending structural changes and brings every world transform up to date.
+         *
+         * @param pool Pool to spread large depths over; null runs on the calling thread.
+         */
+        void update(core::ThreadPool* pool = nullptr);
+
+        [[nodiscard]] std::size_t size() const
+        {
+            return size_;
+        }
+
+        /**
+         * @brief The number of depths, roots being depth 0. Valid after `update`.
+         */
+        [[nodiscard]] std::size_t depthCount() const
+        {
+            return levels_.empty() ? 0 : levels_.size() - 1;
+        }
+
+        /**
+         * @brief Every node in layout order, parents before children. Valid after `update`.
+         */
+        [[nodiscard]] std::span<const NodeId> nodes() const
+        {
+            return nodes_;
+        }
+
+        /**
+         * @brief World transforms in the same order as `nodes`, for systems that consume all of them.
+         */
+        [[nodiscard]] std::span<const Affine2> worldTransforms() const
+        {
+            return world_;
+        }
+
+    private:
+        static constexpr std::uint32_t INVALID_INDEX = NodeId::INVALID_INDEX;
+
+        struct Slot
+        {
+            std::uint32_t dense = INVALID_INDEX;
+            std::uint32_t generation = 0;
+        };
+
+        [[nodiscard]] std::uint32_t dense(NodeId node) const;
+
+        /**
+         * @brief Drops destroyed nodes and restores breadth-first order.
+         */
+        void sortLayout();
+
+        // Handle slots, pointing into the layout arrays.
+        std::vector<Slot> slots_;
+        std::vector<std::uint32_t> freeSlots_;
+
+        // Layout arrays, indexed alike. `parent_` holds layout indices; a destroyed node's entry in
+        // `nodes_` is invalid until the next sort drops it.
+        std::vector<NodeId> nodes_;
+        std::vector<std::uint32_t> parent_;
+        std::vector<LocalTransform> local_;
+        std::vector<Affine2> world_;
+        std::vector<std::uint8_t> dirty_;
+        std::vector<std::uint8_t> changed_;
+
+        // Start of each depth in the layout, plus the end.
+        std::vector<std::uint32_t> levels_;
+
+        std::size_t size_ = 0;
+        // Nodes were added, destroyed or re-parented since the last sort.
+        bool layoutDirty_ = false;
+        // Some node may sit before its parent, after a re-parent.
+        bool orderBroken_ = false;
+        // Some local transform or parent changed since the last update.
+        bool anyDirty_ = false;
+        // The last update recomputed something, so `changed_` has flags to clear.
+        bool anyChanged_ = false;
+    };
+}
+
+#endif //PSYGINE_TRANSFORM_HIERARCHY_HPP
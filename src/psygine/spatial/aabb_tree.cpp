@@ -0,0 +1,659 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#include "aabb_tree.hpp"
+
+#include <algorithm>
+
+namespace
+{
+    // How far ahead a moving proxy's fat box reaches along its displacement.
+    constexpr float DISPLACEMENT_MULTIPLIER = 4.0F;
+
+    // A fat box this many margins larger than needed on every side is shrunk on the next move.
+    constexpr float SHRINK_MARGINS = 4.0F;
+
+    // Bins per axis for the SAH rebuild.
+    constexpr std::size_t SAH_BINS = 16;
+
+    // Ranges this small are split at the median instead; binning them costs more than it saves.
+    constexpr std::size_t SAH_MIN_ITEMS = 8;
+
+    // Moved proxies per pair-search task.
+    constexpr std::size_t PAIR_BLOCK = 256;
+
+    template <typename V>
+    float Axis(const V& v, const std::size_t axis)
+    {
+        if constexpr (requires { v.z; })
+        {
+            if (axis == 2)
+            {
+                return v.z;
+            }
+        }
+        return axis == 0 ? v.x : v.y;
+    }
+
+    template <typename V>
+    void SetAxis(V& v, const std::size_t axis, const float value)
+    {
+        if constexpr (requires { v.z; })
+        {
+            if (axis == 2)
+            {
+                v.z = value;
+                return;
+            }
+        }
+        (axis == 0 ? v.x : v.y) = value;
+    }
+}
+
+namespace psygine::spatial
+{
+    template <std::size_t D>
+    AabbTree<D>::AabbTree(const float margin) :
+        margin_{margin}
+    {
+        PSYGINE_ASSERT(margin >= 0.0F, "AabbTree: margin must not be negative");
+    }
+
+    template <std::size_t D>
+    std::uint32_t AabbTree<D>::createProxy(const Box& box, const std::uint32_t userData)
+    {
+        refit();
+        const std::uint32_t proxy = allocateNode();
+        Node& node = nodes_[proxy];
+        node.box = math::Expand(box, margin_);
+        node.height = 0;
+        node.userData = userData;
+        insertLeaf(proxy);
+        markMoved(proxy);
+        ++proxyCount_;
+        return proxy;
+    }
+
+    template <std::size_t D>
+    void AabbTree<D>::destroyProxy(const std::uint32_t proxy)
+    {
+        PSYGINE_ASSERT(proxy < nodes_.size() && nodes_[proxy].height == 0, "AabbTree::destroyProxy: invalid proxy");
+        refit();
+        if (nodes_[proxy].moved)
+        {
+            std::erase(moveBuffer_, proxy);
+        }
+        removeLeaf(proxy);
+        freeNode(proxy);
+        --proxyCount_;
+    }
+
+    template <std::size_t D>
+    bool AabbTree<D>::moveProxy(const std::uint32_t proxy, const Box& box, const Vector& displacement)
+    {
+        PSYGINE_ASSERT(proxy < nodes_.size() && nodes_[proxy].height == 0, "AabbTree::moveProxy: invalid proxy");
+
+        Box fat = math::Expand(box, margin_);
+        for (std::size_t a = 0; a < D; ++a)
+        {
+            const float d = Axis(displacement, a) * DISPLACEMENT_MULTIPLIER;
+            if (d < 0.0F)
+            {
+                SetAxis(fat.min, a, Axis(fat.min, a) + d);
+            }
+            else
+            {
+                SetAxis(fat.max, a, Axis(fat.max, a) + d);
+            }
+        }
+
+        const Box& current = nodes_[proxy].box;
+        if (math::Contains(current, box) && math::Contains(math::Expand(fat, SHRINK_MARGINS * margin_), current))
+        {
+            return false;
+        }
+
+        refit();
+        removeLeaf(proxy);
+        nodes_[proxy].box = fat;
+        insertLeaf(proxy);
+        markMoved(proxy);
+        return true;
+    }
+
+    template <std::size_t D>
+    bool AabbTree<D>::setProxyBox(const std::uint32_t proxy, const Box& box)
+    {
+        PSYGINE_ASSERT(proxy < nodes_.size() && nodes_[proxy].height == 0, "AabbTree::setProxyBox: invalid proxy");
+
+        Node& leaf = nodes_[proxy];
+        if (math::Contains(leaf.box, box))
+        {
+            return false;
+        }
+
+        leaf.box = math::Expand(box, margin_);
+        markMoved(proxy);
+        // Marking stops at the first ancestor that is already dirty: everything above it is too.
+        for (std::uint32_t index = leaf.parent; index != INVALID_INDEX && !nodes_[index].dirty;
+             index = nodes_[index].parent)
+        {
+            nodes_[index].dirty = true;
+        }
+        refitPending_ = true;
+        return true;
+    }
+
+    template <std::size_t D>
+    void AabbTree<D>::refit()
+    {
+        if (!refitPending_)
+        {
+            return;
+        }
+        refitPending_ = false;
+
+        // Pre-order over the dirty nodes; walking it backwards visits children before parents.
+        order_.clear();
+        if (root_ != INVALID_INDEX && nodes_[root_].dirty)
+        {
+            order_.push_back(root_);
+        }
+        for (std::size_t i = 0; i < order_.size(); ++i)
+        {
+            const Node& node = nodes_[order_[i]];
+            for (const std::uint32_t child : {node.child1, node.child2})
+            {
+                if (nodes_[child].dirty)
+                {
+                    order_.push_back(child);
+                }
+            }
+        }
+
+        for (auto it = order_.rbegin(); it != order_.rend(); ++it)
+        {
+            Node& node = nodes_[*it];
+            node.box = math::Merge(nodes_[node.child1].box, nodes_[node.child2].box);
+            node.dirty = false;
+        }
+    }
+
+    template <std::size_t D>
+    void AabbTree<D>::rebuild()
+    {
+        refitPending_ = false;
+        build_.clear();
+        for (std::size_t i = 0; i < nodes_.size(); ++i)
+        {
+            const Node& node = nodes_[i];
+            if (node.height == 0)
+            {
+                build_.push_back({node.box, math::Center(node.box), static_cast<std::uint32_t>(i)});
+            }
+            else if (node.height > 0)
+            {
+                freeNode(static_cast<std::uint32_t>(i));
+            }
+        }
+
+        root_ = INVALID_INDEX;
+        if (build_.empty())
+        {
+            return;
+        }
+
+        struct Task
+        {
+            std::size_t begin;
+            std::size_t end;
+            std::uint32_t parent;
+            bool second;
+        };
+        std::vector<Task> tasks{{0, build_.size(), INVALID_INDEX, false}};
+        order_.clear();
+
+        while (!tasks.empty())
+        {
+            const Task task = tasks.back();
+            tasks.pop_back();
+
+            std::uint32_t index = 0;
+            if (task.end - task.begin == 1)
+            {
+                index = build_[task.begin].leaf;
+            }
+            else
+            {
+                index = allocateNode();
+                nodes_[index].height = 1;
+                order_.push_back(index);
+                const std::size_t middle = split(task.begin, task.end);
+                tasks.push_back({middle, task.end, index, true});
+                tasks.push_back({task.begin, middle, index, false});
+            }
+
+            nodes_[index].parent = task.parent;
+            if (task.parent == INVALID_INDEX)
+            {
+                root_ = index;
+            }
+            else if (task.second)
+            {
+                nodes_[task.parent].child2 = index;
+            }
+            else
+            {
+                nodes_[task.parent].child1 = index;
+            }
+        }
+
+        // Internal nodes were created parents first, so walking backwards finishes children first.
+        for (auto it = order_.rbegin(); it != order_.rend(); ++it)
+        {
+            Node& node = nodes_[*it];
+            const Node& child1 = nodes_[node.child1];
+            const Node& child2 = nodes_[node.child2];
+            node.box = math::Merge(child1.box, child2.box);
+            node.height = 1 + std::max(child1.height, child2.height);
+            node.dirty = false;
+        }
+    }
+
+    template <std::size_t D>
+    void AabbTree<D>::saveState(core::SnapshotWriter& writer) const
+    {
+        writer.writeArray(nodes_);
+        writer.write(root_);
+        writer.write(freeList_);
+        writer.write(static_cast<std::uint64_t>(proxyCount_));
+        writer.write(refitPending_);
+        writer.writeArray(moveBuffer_);
+    }
+
+    template <std::size_t D>
+    void AabbTree<D>::loadState(core::SnapshotReader& reader)
+    {
+        reader.readArray(nodes_);
+        reader.read(root_);
+        reader.read(freeList_);
+        proxyCount_ = static_cast<std::size_t>(reader.read<std::uint64_t>());
+        reader.read(refitPending_);
+        reader.readArray(moveBuffer_);
+    }
+
+    template <std::size_t D>
+    void AabbTree<D>::updatePairs(std::vector<Pair>& out, core::ThreadPool* pool)
+    {
+        refit();
+        out.clear();
+
+        const std::size_t blocks = (moveBuffer_.size() + PAIR_BLOCK - 1) / PAIR_BLOCK;
+        std::vector<std::vector<Pair>> blockPairs(blocks);
+        const auto body = [&](const std::size_t begin, const std::size_t end)
+        {
+            for (std::size_t block = begin; block < end; ++block)
+            {
+                std::vector<Pair>& pairs = blockPairs[block];
+                const std::size_t last = std::min((block + 1) * PAIR_BLOCK, moveBuffer_.size());
+                for (std::size_t i = block * PAIR_BLOCK; i < last; ++i)
+                {
+                    const std::uint32_t proxy = moveBuffer_[i];
+                    query(nodes_[proxy].box, [&](const std::uint32_t other)
+                    {
+                        // When both moved, the pair is reported from the lower id only.
+                        if (other != proxy && (!nodes_[other].moved || other > proxy))
+                        {
+                            pairs.push_back(proxy < other ? Pair{proxy, other} : Pair{other, proxy});
+                        }
+                    });
+                }
+            }
+        };
+
+        if (pool == nullptr || blocks <= 1)
+        {
+            body(0, blocks);
+        }
+        else
+        {
+            pool->parallelFor(blocks, 1, body);
+        }
+
+        for (const std::vector<Pair>& pairs : blockPairs)
+        {
+            out.insert(out.end(), pairs.begin(), pairs.end());
+        }
+        std::ranges::sort(out);
+
+        for (const std::uint32_t proxy : moveBuffer_)
+        {
+            nodes_[proxy].moved = false;
+        }
+        moveBuffer_.clear();
+    }
+
+    template <std::size_t D>
+    float AabbTree<D>::areaRatio() const
+    {
+        if (root_ == INVALID_INDEX)
+        {
+            return 0.0F;
+        }
+
+        float total = 0.0F;
+        for (const Node& node : nodes_)
+        {
+            if (node.height >= 0)
+            {
+                total += math::SurfaceArea(node.box);
+            }
+        }
+        const float rootArea = math::SurfaceArea(nodes_[root_].box);
+        return rootArea > 0.0F ? total / rootArea : 0.0F;
+    }
+
+    template <std::size_t D>
+    std::uint32_t AabbTree<D>::allocateNode()
+    {
+        if (freeList_ == INVALID_INDEX)
+        {
+            PSYGINE_ASSERT(nodes_.size() < INVALID_INDEX, "AabbTree: node limit reached");
+            nodes_.emplace_back();
+            return static_cast<std::uint32_t>(nodes_.size() - 1);
+        }
+
+        const std::uint32_t index = freeList_;
+        freeList_ = nodes_[index].parent;
+        nodes_[index] = Node{};
+        return index;
+    }
+
+    template <std::size_t D>
+    void AabbTree<D>::freeNode(const std::uint32_t node)
+    {
+        nodes_[node] = Node{};
+        nodes_[node].parent = freeList_;
+        freeList_ = node;
+    }
+
+    template <std::size_t D>
+    void AabbTree<D>::insertLeaf(const std::uint32_t leaf)
+    {
+        if (root_ == INVALID_INDEX)
+        {
+            root_ = leaf;
+            nodes_[leaf].parent = INVALID_INDEX;
+            return;
+        }
+
+        // Descend towards the sibling that adds the least surface area, stopping when pairing with
+        // the current node is cheaper than pushing the leaf further down.
+        const Box leafBox = nodes_[leaf].box;
+        std::uint32_t index = root_;
+        while (!nodes_[index].leaf())
+        {
+            const Node& node = nodes_[index];
+            const float area = math::SurfaceArea(node.box);
+            const float combinedArea = math::SurfaceArea(math::Merge(node.box, leafBox));
+            const float cost = 2.0F * combinedArea;
+            const float inheritance = 2.0F * (combinedArea - area);
+
+            const auto descendCost = [&](const std::uint32_t child)
+            {
+                const Node& c = nodes_[child];
+                const float merged = math::SurfaceArea(math::Merge(c.box, leafBox));
+                return (c.leaf() ? merged : merged - math::SurfaceArea(c.box)) + inheritance;
+            };
+            const float cost1 = descendCost(node.child1);
+            const float cost2 = descendCost(node.child2);
+            if (cost < cost1 && cost < cost2)
+            {
+                break;
+            }
+            index = cost1 < cost2 ? node.child1 : node.child2;
+        }
+
+        const std::uint32_t sibling = index;
+        const std::uint32_t parent = allocateNode();
+        const std::uint32_t oldParent = nodes_[sibling].parent;
+        Node& newParent = nodes_[parent];
+        newParent.parent = oldParent;
+        newParent.box = math::Merge(leafBox, nodes_[sibling].box);
+        newParent.height = nodes_[sibling].height + 1;
+        newParent.child1 = sibling;
+        newParent.child2 = leaf;
+        nodes_[sibling].parent = parent;
+        nodes_[leaf].parent = parent;
+
+        if (oldParent == INVALID_INDEX)
+        {
+            root_ = parent;
+        }
+        else if (nodes_[oldParent].child1 == sibling)
+        {
+            nodes_[oldParent].child1 = parent;
+        }
+        else
+        {
+            nodes_[oldParent].child2 = parent;
+        }
+
+        for (index = nodes_[leaf].parent; index != INVALID_INDEX; index = nodes_[index].parent)
+        {
+            index = balance(index);
+            Node& node = nodes_[index];
+            node.height = 1 + std::max(nodes_[node.child1].height, nodes_[node.child2].height);
+            node.box = math::Merge(nodes_[node.child1].box, nodes_[node.child2].box);
+        }
+    }
+
+    template <std::size_t D>
+    void AabbTree<D>::removeLeaf(const std::uint32_t leaf)
+    {
+        if (leaf == root_)
+        {
+            root_ = INVALID_INDEX;
+            return;
+        }
+
+        const std::uint32_t parent = nodes_[leaf].parent;
+        const std::uint32_t grandParent = nodes_[parent].parent;
+        const std::uint32_t sibling = nodes_[parent].child1 == leaf ? nodes_[parent].child2 : nodes_[parent].child1;
+        freeNode(parent);
+        nodes_[sibling].parent = grandParent;
+
+        if (grandParent == INVALID_INDEX)
+        {
+            root_ = sibling;
+            return;
+        }
+
+        if (nodes_[grandParent].child1 == parent)
+        {
+            nodes_[grandParent].child1 = sibling;
+        }
+        else
+        {
+            nodes_[grandParent].child2 = sibling;
+        }
+
+        for (std::uint32_t index = grandParent; index != INVALID_INDEX; index = nodes_[index].parent)
+        {
+            index = balance(index);
+            Node& node = nodes_[index];
+            node.height = 1 + std::max(nodes_[node.child1].height, nodes_[node.child2].height);
+            node.box = math::Merge(nodes_[node.child1].box, nodes_[node.child2].box);
+        }
+    }
+
+    template <std::size_t D>
+    std::uint32_t AabbTree<D>::balance(const std::uint32_t a)
+    {
+        Node& nodeA = nodes_[a];
+        if (nodeA.leaf() || nodeA.height < 2)
+        {
+            return a;
+        }
+
+        const std::uint32_t b = nodeA.child1;
+        const std::uint32_t c = nodeA.child2;
+        const std::int32_t skew = nodes_[c].height - nodes_[b].height;
+        if (skew >= -1 && skew <= 1)
+        {
+            return a;
+        }
+
+        // Rotate the taller child `up` into A's place; A keeps the other child and takes the taller
+        // of `up`'s children, `up` keeps the shorter one.
+        const bool rightHeavy = skew > 1;
+        const std::uint32_t up = rightHeavy ? c : b;
+        const std::uint32_t stay = rightHeavy ? b : c;
+        Node& nodeUp = nodes_[up];
+        const std::uint32_t f = nodeUp.child1;
+        const std::uint32_t g = nodeUp.child2;
+
+        nodeUp.child1 = a;
+        nodeUp.parent = nodeA.parent;
+        nodeA.parent = up;
+        if (nodeUp.parent == INVALID_INDEX)
+        {
+            root_ = up;
+        }
+        else if (nodes_[nodeUp.parent].child1 == a)
+        {
+            nodes_[nodeUp.parent].child1 = up;
+        }
+        else
+        {
+            nodes_[nodeUp.parent].child2 = up;
+        }
+
+        const bool fTaller = nodes_[f].height > nodes_[g].height;
+        const std::uint32_t keep = fTaller ? f : g;
+        const std::uint32_t give = fTaller ? g : f;
+        nodeUp.child2 = keep;
+        if (rightHeavy)
+        {
+            nodeA.child2 = give;
+        }
+        else
+        {
+            nodeA.child1 = give;
+        }
+        nodes_[give].parent = a;
+
+        nodeA.box = math::Merge(nodes_[stay].box, nodes_[give].box);
+        nodeA.height = 1 + std::max(nodes_[stay].height, nodes_[give].height);
+        nodeUp.box = math::Merge(nodeA.box, nodes_[keep].box);
+        nodeUp.height = 1 + std::max(nodeA.height, nodes_[keep].height);
+        return up;
+    }
+
+    template <std::size_t D>
+    void AabbTree<D>::markMoved(const std::uint32_t proxy)
+    {
+        if (!nodes_[proxy].moved)
+        {
+            nodes_[proxy].moved = true;
+            moveBuffer_.push_back(proxy);
+        }
+    }
+
+    template <std::size_t D>
+    std::size_t AabbTree<D>::split(const std::size_t begin, const std::size_t end)
+    {
+        Box bounds{build_[begin].centroid, build_[begin].centroid};
+        for (std::size_t i = begin + 1; i < end; ++i)
+        {
+            bounds = math::Merge(bounds, Box{build_[i].centroid, build_[i].centroid});
+        }
+
+        std::size_t axis = 0;
+        for (std::size_t a = 1; a < D; ++a)
+        {
+            if (Axis(bounds.max, a) - Axis(bounds.min, a) > Axis(bounds.max, axis) - Axis(bounds.min, axis))
+            {
+                axis = a;
+            }
+        }
+        const float lo = Axis(bounds.min, axis);
+        const float extent = Axis(bounds.max, axis) - lo;
+        const std::size_t middle = begin + ((end - begin) / 2);
+        if (!(extent > 0.0F))
+        {
+            return middle;
+        }
+
+        const auto first = build_.begin() + static_cast<std::ptrdiff_t>(begin);
+        const auto last = build_.begin() + static_cast<std::ptrdiff_t>(end);
+        if (end - begin <= SAH_MIN_ITEMS)
+        {
+            std::nth_element(first, build_.begin() + static_cast<std::ptrdiff_t>(middle), last,
+                             [axis](const BuildItem& a, const BuildItem& b)
+                             {
+                                 return Axis(a.centroid, axis) < Axis(b.centroid, axis);
+                             });
+            return middle;
+        }
+
+        const float scale = static_cast<float>(SAH_BINS) / extent;
+        const auto binOf = [&](const BuildItem& item)
+        {
+            const auto bin = static_cast<std::size_t>((Axis(item.centroid, axis) - lo) * scale);
+            return std::min(bin, SAH_BINS - 1);
+        };
+
+        std::array<Box, SAH_BINS> boxes{};
+        std::array<std::size_t, SAH_BINS> counts{};
+        for (std::size_t i = begin; i < end; ++i)
+        {
+            const std::size_t bin = binOf(build_[i]);
+            boxes[bin] = counts[bin] == 0 ? build_[i].box : math::Merge(boxes[bin], build_[i].box);
+            ++counts[bin];
+        }
+
+        // Cost of splitting after bin i: left count * left area + right count * right area.
+        std::array<float, SAH_BINS - 1> leftCost{};
+        Box left{};
+        std::size_t leftCount = 0;
+        for (std::size_t i = 0; i + 1 < SAH_BINS; ++i)
+        {
+            if (counts[i] > 0)
+            {
+                left = leftCount == 0 ? boxes[i] : math::Merge(left, boxes[i]);
+                leftCount += counts[i];
+            }
+            leftCost[i] = leftCount == 0 ? 0.0F : static_cast<float>(leftCount) * math::SurfaceArea(left);
+        }
+
+        std::size_t best = 0;
+        float bestCost = std::numeric_limits<float>::infinity();
+        Box right{};
+        std::size_t rightCount = 0;
+        for (std::size_t i = SAH_BINS - 1; i > 0; --i)
+        {
+            if (counts[i] > 0)
+            {
+                right = rightCount == 0 ? boxes[i] : math::Merge(right, boxes[i]);
+                rightCount += counts[i];
+            }
+            const float cost = leftCost[i - 1] + (static_cast<float>(rightCount) * math::SurfaceArea(right));
+            if (rightCount > 0 && rightCount < end - begin && cost < bestCost)
+            {
+                bestCost = cost;
+                best = i - 1;
+            }
+        }
+
+        const auto split = std::partition(first, last, [&](const BuildItem& item)
+        {
+            return binOf(item) <= best;
+        });
+        const auto result = static_cast<std::size_t>(split - build_.begin());
+        return result == begin || result == end ? middle : result;
+    }
+
+    template class AabbTree<2>;
+    template class AabbTree<3>;
+}
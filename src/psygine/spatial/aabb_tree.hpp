@@ -0,0 +1,464 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#ifndef PSYGINE_AABB_TREE_HPP
+#define PSYGINE_AABB_TREE_HPP
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "psygine/core/snapshot.hpp"
+#include "psygine/core/thread_pool.hpp"
+#include "psygine/debug/assert.hpp"
+#include "psygine/math/aabb.hpp"
+#include "psygine/math/vector.hpp"
+
+namespace psygine::spatial
+{
+    namespace detail
+    {
+        /**
+         * @brief Traversal stack that lives on the caller's stack until a tree gets unusually deep.
+         */
+        class NodeStack
+        {
+        public:
+            void push(const std::uint32_t node)
+            {
+                if (size_ < inline_.size())
+                {
+                    inline_[size_++] = node;
+                    return;
+                }
+                spill_.push_back(node);
+            }
+
+            std::uint32_t pop()
+            {
+                if (!spill_.empty())
+                {
+                    const std::uint32_t node = spill_.back();
+                    spill_.pop_back();
+                    return node;
+                }
+                return inline_[--size_];
+            }
+
+            [[nodiscard]] bool empty() const
+            {
+                return size_ == 0 && spill_.empty();
+            }
+
+        private:
+            std::array<std::uint32_t, 64> inline_;
+            std::size_t size_ = 0;
+            std::vector<std::uint32_t> spill_;
+        };
+    }
+
+    /**
+     * @brief Dynamic bounding volume hierarchy over 2D or 3D boxes.
+     *
+     * Each proxy is stored with a fattened box: it is grown by a margin, and along the displacement
+     * when one is given, so small movements stay inside it and cost nothing. A proxy whose box escapes
+     * is removed and reinserted, with the sibling chosen by the surface area heuristic and AVL-style
+     * rotations keeping the tree balanced on the way back up.
+     *
+     * For many small movements per step, `setProxyBox` only updates the leaves and `refit` repairs
+     * the ancestors in one pass afterwards; the topology is left alone, so call `rebuild` now and
+     * then, when `areaRatio` has crept up, to rebuild it top-down with a binned SAH.
+     *
+     * Queries are const and allocate nothing while the tree stays shallow, so any number of worker
+     * threads may run them at once as long as nobody modifies the tree meanwhile.
+     *
+     * Proxy ids are node indices: stable for the proxy's lifetime and reused after it is destroyed.
+     *
+     * @tparam D The dimension, 2 or 3.
+     */
+    template <std::size_t D>
+    class AabbTree
+    {
+        static_assert(D == 2 || D == 3, "AabbTree: only 2D and 3D are supported");
+
+    public:
+        using Vector = std::conditional_t<D == 2, math::Vec2, math::Vec3>;
+        using Box = math::Aabb<Vector>;
+
+        static constexpr std::uint32_t INVALID_INDEX = std::numeric_limits<std::uint32_t>::max();
+
+        /**
+         * @brief Default fattening margin, in world units.
+         */
+        static constexpr float DEFAULT_MARGIN = 0.1F;
+
+        /**
+         * @brief Two proxies whose fat boxes overlap, with `a < b`.
+         */
+        struct Pair
+        {
+            std::uint32_t a;
+            std::uint32_t b;
+
+            auto operator<=>(const Pair&) const = default;
+        };
+
+        explicit AabbTree(float margin = DEFAULT_MARGIN);
+
+        /**
+         * @brief Inserts a proxy for `box`.
+         *
+         * @param box The tight bounds of the object.
+         * @param userData Returned by `userData` for this proxy.
+         * @return The proxy id.
+         */
+        std::uint32_t createProxy(const Box& box, std::uint32_t userData = 0);
+
+        void destroyProxy(std::uint32_t proxy);
+
+        /**
+         * @brief Moves a proxy, reinserting it only when `box` leaves its fat box.
+         *
+         * The new fat box is also stretched along `displacement` (the movement expected over the next
+         * step) so fast objects do not reinsert every step. A fat box that has become far too large for
+         * the object is shrunk the same way.
+         *
+         * @return Whether the proxy was reinserted.
+         */
+        bool moveProxy(std::uint32_t proxy, const Box& box, const Vector& displacement = {});
+
+        /**
+         * @brief Updates a proxy's box without changing the tree's shape; call `refit` before querying.
+         *
+         * Cheaper than `moveProxy` when many proxies move a little: ancestors are only marked here and
+         * repaired together by `refit`.
+         *
+         * @return Whether the fat box had to change.
+         */
+        bool setProxyBox(std::uint32_t proxy, const Box& box);
+
+        /**
+         * @brief Recomputes the boxes of every internal node above a proxy changed by `setProxyBox`.
+         */
+        void refit();
+
+        /**
+         * @brief Rebuilds the whole hierarchy top-down with a binned surface area heuristic.
+         *
+         * Proxy ids and fat boxes are kept; only internal nodes change.
+         */
+        void rebuild();
+
+        /**
+         * @brief Writes the nodes, proxies and pending moves, so `loadState` restores the tree exactly,
+         * proxy ids and pair order included.
+         */
+        void saveState(core::SnapshotWriter& writer) const;
+        void loadState(core::SnapshotReader& reader);
+
+        /**
+         * @brief Collects the pairs of proxies whose fat boxes overlap and where at least one proxy was
+         * created, reinserted or refitted since the last call, then forgets those moves.
+         *
+         * The pairs are sorted, so the result does not depend on the pool.
+         *
+         * @param out Receives the pairs, replacing its contents.
+         * @param pool Pool to search on; null searches on the calling thread.
+         */
+        void updatePairs(std::vector<Pair>& out, core::ThreadPool* pool = nullptr);
+
+        /**
+         * @brief Calls `fn(proxy)` for every proxy whose fat box passes `test(box)`.
+         *
+         * `test` sees internal boxes too and must accept every box that contains an accepted one, so a
+         * frustum or other convex volume check works as is. `fn` may return `false` to stop early.
+         */
+        template <typename Test, typename Fn>
+            requires std::predicate<Test&, const Box&> && std::invocable<Fn&, std::uint32_t>
+        void traverse(Test&& test, Fn&& fn) const
+        {
+            PSYGINE_DEBUG_ASSERT(!refitPending_, "AabbTree::traverse: call refit after setProxyBox");
+            if (root_ == INVALID_INDEX)
+            {
+                return;
+            }
+
+            detail::NodeStack stack;
+            stack.push(root_);
+            while (!stack.empty())
+            {
+                const Node& node = nodes_[stack.pop()];
+                if (!test(node.box))
+                {
+                    continue;
+                }
+                if (node.leaf())
+                {
+                    if constexpr (std::same_as<std::invoke_result_t<Fn&, std::uint32_t>, bool>)
+                    {
+                        if (!fn(static_cast<std::uint32_t>(&node - nodes_.data())))
+                        {
+                            return;
+                        }
+                    }
+                    else
+                    {
+                        fn(static_cast<std::uint32_t>(&node - nodes_.data()));
+                    }
+                    continue;
+                }
+                stack.push(node.child2);
+                stack.push(node.child1);
+            }
+        }
+
+        /**
+         * @brief Calls `fn(proxy)` for every proxy whose fat box overlaps `box`; `fn` may return `false`
+         * to stop early.
+         */
+        template <typename Fn>
+        void query(const Box& box, Fn&& fn) const
+        {
+            traverse([&box](const Box& nodeBox)
+            {
+                return math::Overlaps(nodeBox, box);
+            }, fn);
+        }
+
+        /**
+         * @brief Casts the segment `origin + t * direction`, `t` in [0, maxFraction], through the tree.
+         *
+         * `fn(proxy, maxFraction)` is called for every proxy whose fat box the segment touches, closest
+         * boxes not necessarily first. It returns the new maximum fraction: the hit fraction to clip the
+         * segment to the closest hit so far, the value it was given to keep going unchanged, or 0 to stop.
+         */
+        template <typename Fn>
+            requires std::invocable<Fn&, std::uint32_t, float>
+        void rayCast(const Vector& origin, const Vector& direction, float maxFraction, Fn&& fn) const
+        {
+            PSYGINE_DEBUG_ASSERT(!refitPending_, "AabbTree::rayCast: call refit after setProxyBox");
+            if (root_ == INVALID_INDEX)
+            {
+                return;
+            }
+
+            const std::array<float, D> o = ToArray(origin);
+            std::array<float, D> inverse = ToArray(direction);
+            for (float& c : inverse)
+            {
+                c = 1.0F / c;
+            }
+
+            detail::NodeStack stack;
+            stack.push(root_);
+            while (!stack.empty())
+            {
+                const std::uint32_t index = stack.pop();
+                const Node& node = nodes_[index];
+                if (!SegmentHits(node.box, o, inverse, maxFraction))
+                {
+                    continue;
+                }
+                if (node.leaf())
+                {
+                    const float value = static_cast<float>(fn(index, maxFraction));
+                    if (value <= 0.0F)
+                    {
+                        return;
+                    }
+                    maxFraction = std::min(maxFraction, value);
+                    continue;
+                }
+                stack.push(node.child2);
+                stack.push(node.child1);
+            }
+        }
+
+        /**
+         * @brief Walks the tree once for a packet of up to 32 queries.
+         *
+         * `test(box)` returns a bitmask of the queries that enter `box`, typically from one SIMD test
+         * of all of them; a subtree is skipped only when no query enters it. `fn(proxy, mask)` is called
+         * for every proxy reached, with the queries whose test passed its fat box, and may return
+         * `false` to stop. Coherent queries share most of their path, so the walk costs little more
+         * than one query's.
+         */
+        template <typename Test, typename Fn>
+            requires std::invocable<Test&, const Box&> && std::invocable<Fn&, std::uint32_t, std::uint32_t>
+        void traversePacket(Test&& test, Fn&& fn) const
+        {
+            PSYGINE_DEBUG_ASSERT(!refitPending_, "AabbTree::traversePacket: call refit after setProxyBox");
+            if (root_ == INVALID_INDEX)
+            {
+                return;
+            }
+
+            detail::NodeStack stack;
+            stack.push(root_);
+            while (!stack.empty())
+            {
+                const std::uint32_t index = stack.pop();
+                const Node& node = nodes_[index];
+                const std::uint32_t mask = test(node.box);
+                if (mask == 0)
+                {
+                    continue;
+                }
+                if (node.leaf())
+                {
+                    if constexpr (std::same_as<std::invoke_result_t<Fn&, std::uint32_t, std::uint32_t>, bool>)
+                    {
+                        if (!fn(index, mask))
+                        {
+                            return;
+                        }
+                    }
+                    else
+                    {
+                        fn(index, mask);
+                    }
+                    continue;
+                }
+                stack.push(node.child2);
+                stack.push(node.child1);
+            }
+        }
+
+        [[nodiscard]] const Box& fatBox(const std::uint32_t proxy) const
+        {
+            PSYGINE_DEBUG_ASSERT(proxy < nodes_.size() && nodes_[proxy].leaf(), "AabbTree::fatBox: invalid proxy");
+            return nodes_[proxy].box;
+        }
+
+        [[nodiscard]] std::uint32_t userData(const std::uint32_t proxy) const
+        {
+            PSYGINE_DEBUG_ASSERT(proxy < nodes_.size() && nodes_[proxy].leaf(), "AabbTree::userData: invalid proxy");
+            return nodes_[proxy].userData;
+        }
+
+        /**
+         * @brief Height of the tree; 0 for a single proxy.
+         */
+        [[nodiscard]] std::int32_t height() const
+        {
+            return root_ == INVALID_INDEX ? 0 : nodes_[root_].height;
+        }
+
+        /**
+         * @brief Summed surface area of all nodes over the root's: a quality measure, lower is better.
+         */
+        [[nodiscard]] float areaRatio() const;
+
+        [[nodiscard]] std::size_t size() const
+        {
+            return proxyCount_;
+        }
+
+        [[nodiscard]] bool empty() const
+        {
+            return proxyCount_ == 0;
+        }
+
+    private:
+        struct Node
+        {
+            Box box;
+            // Next free node while the node is on the free list.
+            std::uint32_t parent = INVALID_INDEX;
+            std::uint32_t child1 = INVALID_INDEX;
+            std::uint32_t child2 = INVALID_INDEX;
+            // -1 on the free list, 0 for leaves.
+            std::int32_t height = -1;
+            std::uint32_t userData = 0;
+            bool moved = false;
+            bool dirty = false;
+
+            [[nodiscard]] bool leaf() const
+            {
+                return child1 == INVALID_INDEX;
+            }
+        };
+
+        static std::array<float, D> ToArray(const Vector& v)
+        {
+            if constexpr (D == 2)
+            {
+                return {v.x, v.y};
+            }
+            else
+            {
+                return {v.x, v.y, v.z};
+            }
+        }
+
+        static bool SegmentHits(const Box& box, const std::array<float, D>& origin,
+                                const std::array<float, D>& inverse, const float maxFraction)
+        {
+            const std::array<float, D> lo = ToArray(box.min);
+            const std::array<float, D> hi = ToArray(box.max);
+            float enter = 0.0F;
+            float exit = maxFraction;
+            for (std::size_t a = 0; a < D; ++a)
+            {
+                float t1 = (lo[a] - origin[a]) * inverse[a];
+                float t2 = (hi[a] - origin[a]) * inverse[a];
+                if (t1 > t2)
+                {
+                    std::swap(t1, t2);
+                }
+                // A NaN from a zero direction on a slab plane drops out of min/max and is treated as a hit.
+                enter = std::max(enter, t1);
+                exit = std::min(exit, t2);
+                if (enter > exit)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        std::uint32_t allocateNode();
+        void freeNode(std::uint32_t node);
+        void insertLeaf(std::uint32_t leaf);
+        void removeLeaf(std::uint32_t leaf);
+        std::uint32_t balance(std::uint32_t node);
+        void markMoved(std::uint32_t proxy);
+        // Splits build_[begin, end) with a binned SAH and returns the split point.
+        std::size_t split(std::size_t begin, std::size_t end);
+
+        std::vector<Node> nodes_;
+        std::uint32_t root_ = INVALID_INDEX;
+        std::uint32_t freeList_ = INVALID_INDEX;
+        std::size_t proxyCount_ = 0;
+        float margin_;
+        bool refitPending_ = false;
+
+        std::vector<std::uint32_t> moveBuffer_;
+
+        // Leaf copy that rebuild partitions, so splitting never touches the scattered nodes.
+        struct BuildItem
+        {
+            Box box;
+            Vector centroid;
+            std::uint32_t leaf;
+        };
+
+        // Scratch for refit and rebuild.
+        std::vector<std::uint32_t> order_;
+        std::vector<BuildItem> build_;
+    };
+
+    extern template class AabbTree<2>;
+    extern template class AabbTree<3>;
+
+    using AabbTree2D = AabbTree<2>;
+    using AabbTree3D = AabbTree<3>;
+}
+
+#endif //PSYGINE_AABB_TREE_HPP
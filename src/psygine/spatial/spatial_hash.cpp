@@ -0,0 +1,529 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#include "spatial_hash.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+#include "psygine/debug/assert.hpp"
+
+namespace
+{
+    // Smallest table built when sizing automatically.
+    constexpr std::size_t MIN_BUCKETS = 64;
+
+    // Items per parallel rebuild block; below this a block costs more to schedule than to run.
+    constexpr std::size_t MIN_BLOCK_ITEMS = 4096;
+
+    // Slots per pair-search task. Fixed, so the output order never depends on the pool.
+    constexpr std::size_t PAIR_BLOCK = 1024;
+
+    template <typename Fn>
+    void RunBlocks(psygine::core::ThreadPool* pool, const std::size_t count, const Fn& fn)
+    {
+        if (pool == nullptr || count <= 1)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                fn(i);
+            }
+            return;
+        }
+        pool->parallelFor(count, 1, [&fn](const std::size_t begin, const std::size_t end)
+        {
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                fn(i);
+            }
+        });
+    }
+}
+
+namespace psygine::spatial
+{
+    template <std::size_t D>
+    SpatialHash<D>::SpatialHash(const float cellSize, const std::size_t bucketCount) :
+        cellSize_{cellSize},
+        inverseCellSize_{1.0F / cellSize},
+        requestedBuckets_{bucketCount == 0 ? 0 : std::bit_ceil(std::max(bucketCount, std::size_t{2}))}
+    {
+        PSYGINE_ASSERT(cellSize > 0.0F, "SpatialHash: cell size must be positive");
+        clear();
+    }
+
+    template <std::size_t D>
+    void SpatialHash<D>::rebuild(const std::span<const Vector> positions, const std::span<const float> radii,
+                                 core::ThreadPool* pool)
+    {
+        PSYGINE_ASSERT(radii.empty() || radii.size() == positions.size(),
+                       "SpatialHash::rebuild: radii must match positions");
+        PSYGINE_ASSERT(positions.size() < OVERFLOW_BIT, "SpatialHash::rebuild: too many items");
+
+        const std::size_t count = positions.size();
+        const std::size_t buckets = requestedBuckets_ != 0
+                                        ? requestedBuckets_
+                                        : std::bit_ceil(std::max(MIN_BUCKETS, count * 2));
+        bucketShift_ = static_cast<std::uint32_t>(64 - std::countr_zero(buckets));
+
+        itemKey_.resize(count);
+        itemBucket_.resize(count);
+        key_.resize(count);
+        id_.resize(count);
+        for (std::vector<float>& axis : coords_)
+        {
+            axis.resize(count);
+        }
+        radius_.resize(count);
+        slotOf_.resize(count);
+        overflow_.clear();
+        cellStart_.assign(buckets + 1, 0);
+
+        // A stable counting sort gives the same order however the items are split into blocks, so the
+        // block count only has to depend on how much parallelism is worth it.
+        std::size_t blocks = 1;
+        if (pool != nullptr)
+        {
+            blocks = std::clamp(count / MIN_BLOCK_ITEMS, std::size_t{1}, pool->concurrency());
+        }
+        const std::size_t perBlock = (count + blocks - 1) / std::max(blocks, std::size_t{1});
+        counts_.assign(blocks * buckets, 0);
+
+        struct Bounds
+        {
+            Cell min;
+            Cell max;
+            float radius;
+        };
+        std::vector<Bounds> blockBounds(blocks);
+
+        RunBlocks(pool, blocks, [&](const std::size_t block)
+        {
+            const std::size_t begin = std::min(block * perBlock, count);
+            const std::size_t end = std::min(begin + perBlock, count);
+            std::uint32_t* histogram = counts_.data() + (block * buckets);
+
+            Bounds bounds{};
+            bounds.min.fill(CELL_LIMIT);
+            bounds.max.fill(-CELL_LIMIT);
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                const Cell cell = cellOf(ToPoint(positions[i]));
+                for (std::size_t a = 0; a < D; ++a)
+                {
+                    bounds.min[a] = std::min(bounds.min[a], cell[a]);
+                    bounds.max[a] = std::max(bounds.max[a], cell[a]);
+                }
+                if (!radii.empty())
+                {
+                    bounds.radius = std::max(bounds.radius, radii[i]);
+                }
+
+                const std::uint64_t key = Pack(cell);
+                const std::size_t bucket = bucketOf(key);
+                itemKey_[i] = key;
+                itemBucket_[i] = static_cast<std::uint32_t>(bucket);
+                ++histogram[bucket];
+            }
+            blockBounds[block] = bounds;
+        });
+
+        // Turn the per-block histograms into scatter offsets: bucket-major, then block order.
+        std::uint32_t running = 0;
+        for (std::size_t bucket = 0; bucket < buckets; ++bucket)
+        {
+            cellStart_[bucket] = running;
+            for (std::size_t block = 0; block < blocks; ++block)
+            {
+                std::uint32_t& slot = counts_[(block * buckets) + bucket];
+                const std::uint32_t n = slot;
+                slot = running;
+                running += n;
+            }
+        }
+        cellStart_[buckets] = running;
+
+        RunBlocks(pool, blocks, [&](const std::size_t block)
+        {
+            const std::size_t begin = std::min(block * perBlock, count);
+            const std::size_t end = std::min(begin + perBlock, count);
+            std::uint32_t* offsets = counts_.data() + (block * buckets);
+
+            for (std::size_t i = begin; i < end; ++i)
+            {
+                const std::uint32_t slot = offsets[itemBucket_[i]]++;
+                const Point p = ToPoint(positions[i]);
+                key_[slot] = itemKey_[i];
+                id_[slot] = static_cast<std::uint32_t>(i);
+                for (std::size_t a = 0; a < D; ++a)
+                {
+                    coords_[a][slot] = p[a];
+                }
+                radius_[slot] = radii.empty() ? 0.0F : radii[i];
+                slotOf_[i] = slot;
+            }
+        });
+
+        cellMin_.fill(CELL_LIMIT);
+        cellMax_.fill(-CELL_LIMIT);
+        maxRadius_ = 0.0F;
+        for (const Bounds& bounds : blockBounds)
+        {
+            for (std::size_t a = 0; a < D; ++a)
+            {
+                cellMin_[a] = std::min(cellMin_[a], bounds.min[a]);
+                cellMax_[a] = std::max(cellMax_[a], bounds.max[a]);
+            }
+            maxRadius_ = std::max(maxRadius_, bounds.radius);
+        }
+    }
+
+    template <std::size_t D>
+    void SpatialHash<D>::move(const std::uint32_t item, const Vector& position)
+    {
+        PSYGINE_DEBUG_ASSERT(item < slotOf_.size(), "SpatialHash::move: unknown item");
+
+        const Point p = ToPoint(position);
+        const Cell cell = cellOf(p);
+        for (std::size_t a = 0; a < D; ++a)
+        {
+            cellMin_[a] = std::min(cellMin_[a], cell[a]);
+            cellMax_[a] = std::max(cellMax_[a], cell[a]);
+        }
+
+        const std::uint32_t location = slotOf_[item];
+        if ((location & OVERFLOW_BIT) != 0)
+        {
+            overflow_[location & ~OVERFLOW_BIT].position = p;
+            return;
+        }
+
+        const std::uint64_t key = Pack(cell);
+        if (key != key_[location] && bucketOf(key) != bucketOf(key_[location]))
+        {
+            key_[location] = EMPTY_KEY;
+            slotOf_[item] = OVERFLOW_BIT | static_cast<std::uint32_t>(overflow_.size());
+            overflow_.push_back({item, p, radius_[location]});
+            if (overflow_.size() > MAX_OVERFLOW)
+            {
+                compact();
+            }
+            return;
+        }
+
+        key_[location] = key;
+        for (std::size_t a = 0; a < D; ++a)
+        {
+            coords_[a][location] = p[a];
+        }
+    }
+
+    template <std::size_t D>
+    void SpatialHash<D>::clear()
+    {
+        const std::size_t buckets = requestedBuckets_ != 0 ? requestedBuckets_ : MIN_BUCKETS;
+        bucketShift_ = static_cast<std::uint32_t>(64 - std::countr_zero(buckets));
+        cellStart_.assign(buckets + 1, 0);
+        key_.clear();
+        id_.clear();
+        for (std::vector<float>& axis : coords_)
+        {
+            axis.clear();
+        }
+        radius_.clear();
+        slotOf_.clear();
+        overflow_.clear();
+        cellMin_.fill(CELL_LIMIT);
+        cellMax_.fill(-CELL_LIMIT);
+        maxRadius_ = 0.0F;
+    }
+
+    template <std::size_t D>
+    void SpatialHash<D>::queryRadius(const Vector& center, const float radius, std::vector<std::uint32_t>& out) const
+    {
+        out.clear();
+        forEachInRadius(center, radius, [&out](const std::uint32_t item)
+        {
+            out.push_back(item);
+        });
+    }
+
+    template <std::size_t D>
+    void SpatialHash<D>::queryBox(const Vector& min, const Vector& max, std::vector<std::uint32_t>& out) const
+    {
+        out.clear();
+        forEachInBox(min, max, [&out](const std::uint32_t item)
+        {
+            out.push_back(item);
+        });
+    }
+
+    template <std::size_t D>
+    std::size_t SpatialHash<D>::nearest(const Vector& point, const std::size_t k, std::vector<std::uint32_t>& out,
+                                        const float maxDistance) const
+    {
+        out.clear();
+        if (k == 0)
+        {
+            return 0;
+        }
+
+        using Entry = std::pair<float, std::uint32_t>;
+        std::vector<Entry> heap;
+        heap.reserve(k + 1);
+
+        const Point p = ToPoint(point);
+        const float limit = maxDistance * maxDistance;
+        const auto consider = [&](const Point& q, const std::uint32_t id)
+        {
+            const Entry entry{DistanceSquared(p, q), id};
+            if (entry.first > limit)
+            {
+                return;
+            }
+            if (heap.size() < k)
+            {
+                heap.push_back(entry);
+                std::ranges::push_heap(heap);
+            }
+            else if (entry < heap.front())
+            {
+                std::ranges::pop_heap(heap);
+                heap.back() = entry;
+                std::ranges::push_heap(heap);
+            }
+        };
+
+        for (const OverflowItem& item : overflow_)
+        {
+            consider(item.position, item.id);
+        }
+
+        const Cell center = cellOf(p);
+        std::int32_t rings = -1;
+        // Rings closer than the occupied bounds are empty and skipped.
+        std::int32_t firstRing = 0;
+        for (std::size_t a = 0; a < D; ++a)
+        {
+            if (cellMin_[a] > cellMax_[a])
+            {
+                rings = -1;
+                break;
+            }
+            rings = std::max({rings, center[a] - cellMin_[a], cellMax_[a] - center[a]});
+            firstRing = std::max({firstRing, cellMin_[a] - center[a], center[a] - cellMax_[a]});
+        }
+
+        // Rows and cells walked so far. Once the walk has cost as much as scanning every slot, a scan
+        // answers the query instead; far-flung items could otherwise be billions of rings away.
+        std::size_t work = 0;
+        const std::size_t budget = key_.size();
+
+        const auto visit = [&](const Cell& cell)
+        {
+            const std::uint64_t key = Pack(cell);
+            const std::size_t bucket = bucketOf(key);
+            for (std::size_t slot = cellStart_[bucket]; slot < cellStart_[bucket + 1]; ++slot)
+            {
+                if (key_[slot] == key)
+                {
+                    consider(pointAt(slot), id_[slot]);
+                }
+            }
+        };
+
+        // Ring bounds in 64 bits: a ring can reach twice the cell limit past the center.
+        const auto ringLo = [&](const std::size_t a, const std::int32_t r)
+        { return static_cast<std::int32_t>(std::max<std::int64_t>(std::int64_t{center[a]} - r, cellMin_[a])); };
+        const auto ringHi = [&](const std::size_t a, const std::int32_t r)
+        { return static_cast<std::int32_t>(std::min<std::int64_t>(std::int64_t{center[a]} + r, cellMax_[a])); };
+
+        // Visits the cells of the ring at Chebyshev distance `r` from `center`, clipped to the
+        // occupied bounds.
+        const auto visitRow = [&](Cell cell, const std::int32_t r, const bool edge)
+        {
+            ++work;
+            if (edge)
+            {
+                const std::int32_t hi = ringHi(0, r);
+                for (cell[0] = ringLo(0, r); cell[0] <= hi && work <= budget; ++cell[0], ++work)
+                {
+                    visit(cell);
+                }
+                return;
+            }
+            for (const std::int64_t x : {std::int64_t{center[0]} - r, std::int64_t{center[0]} + r})
+            {
+                if (x >= cellMin_[0] && x <= cellMax_[0])
+                {
+                    cell[0] = static_cast<std::int32_t>(x);
+                    visit(cell);
+                }
+            }
+        };
+
+        for (std::int32_t r = firstRing; r <= rings; ++r)
+        {
+            Cell cell{};
+            const std::int32_t y0 = ringLo(1, r);
+            const std::int32_t y1 = ringHi(1, r);
+            if constexpr (D == 2)
+            {
+                for (cell[1] = y0; cell[1] <= y1 && work <= budget; ++cell[1])
+                {
+                    visitRow(cell, r, std::abs(cell[1] - center[1]) == r);
+                }
+            }
+            else
+            {
+                const std::int32_t z0 = ringLo(2, r);
+                const std::int32_t z1 = ringHi(2, r);
+                for (cell[2] = z0; cell[2] <= z1 && work <= budget; ++cell[2])
+                {
+                    const bool edgeZ = std::abs(cell[2] - center[2]) == r;
+                    for (cell[1] = y0; cell[1] <= y1 && work <= budget; ++cell[1])
+                    {
+                        visitRow(cell, r, edgeZ || std::abs(cell[1] - center[1]) == r);
+                    }
+                }
+            }
+
+            if (work > budget)
+            {
+                // The ring was cut short, so the scan redoes the query from scratch.
+                heap.clear();
+                for (const OverflowItem& item : overflow_)
+                {
+                    consider(item.position, item.id);
+                }
+                for (std::size_t slot = 0; slot < key_.size(); ++slot)
+                {
+                    if (key_[slot] != EMPTY_KEY)
+                    {
+                        consider(pointAt(slot), id_[slot]);
+                    }
+                }
+                break;
+            }
+
+            // Every cell of the next ring is at least this far from the query point.
+            const float reach = static_cast<float>(r) * cellSize_;
+            if (reach > maxDistance || (heap.size() == k && heap.front().first <= reach * reach))
+            {
+                break;
+            }
+        }
+
+        std::ranges::sort_heap(heap);
+        for (const Entry& entry : heap)
+        {
+            out.push_back(entry.second);
+        }
+        return out.size();
+    }
+
+    template <std::size_t D>
+    void SpatialHash<D>::findPairs(std::vector<Pair>& out, const float padding, core::ThreadPool* pool) const
+    {
+        out.clear();
+
+        const auto makePair = [](const std::uint32_t a, const std::uint32_t b)
+        {
+            return a < b ? Pair{a, b} : Pair{b, a};
+        };
+
+        const std::size_t slots = key_.size();
+        std::vector<std::vector<Pair>> blockPairs((slots + PAIR_BLOCK - 1) / PAIR_BLOCK);
+        RunBlocks(pool, blockPairs.size(), [&](const std::size_t block)
+        {
+            std::vector<Pair>& pairs = blockPairs[block];
+            const std::size_t end = std::min((block + 1) * PAIR_BLOCK, slots);
+            for (std::size_t slot = block * PAIR_BLOCK; slot < end; ++slot)
+            {
+                if (key_[slot] == EMPTY_KEY)
+                {
+                    continue;
+                }
+
+                // Both items of an overlapping pair lie within each other's reach, so keeping only
+                // the partner with the higher slot reports every pair exactly once.
+                const Point p = pointAt(slot);
+                const float radius = radius_[slot] + padding;
+                const float reach = radius + maxRadius_;
+                forEachSlot(Offset(p, -reach), Offset(p, reach), [&](const std::size_t other)
+                {
+                    const float range = radius + radius_[other];
+                    if (other > slot && DistanceSquared(p, pointAt(other)) <= range * range)
+                    {
+                        pairs.push_back(makePair(id_[slot], id_[other]));
+                    }
+                });
+            }
+        });
+
+        for (const std::vector<Pair>& pairs : blockPairs)
+        {
+            out.insert(out.end(), pairs.begin(), pairs.end());
+        }
+
+        for (std::size_t i = 0; i < overflow_.size(); ++i)
+        {
+            const OverflowItem& item = overflow_[i];
+            const float radius = item.radius + padding;
+            const float reach = radius + maxRadius_;
+            forEachSlot(Offset(item.position, -reach), Offset(item.position, reach), [&](const std::size_t other)
+            {
+                const float range = radius + radius_[other];
+                if (DistanceSquared(item.position, pointAt(other)) <= range * range)
+                {
+                    out.push_back(makePair(item.id, id_[other]));
+                }
+            });
+            for (std::size_t j = i + 1; j < overflow_.size(); ++j)
+            {
+                const float range = radius + overflow_[j].radius;
+                if (DistanceSquared(item.position, overflow_[j].position) <= range * range)
+                {
+                    out.push_back(makePair(item.id, overflow_[j].id));
+                }
+            }
+        }
+    }
+
+    template <std::size_t D>
+    void SpatialHash<D>::compact()
+    {
+        std::vector<Vector> positions(slotOf_.size());
+        std::vector<float> radii(slotOf_.size());
+        for (std::size_t item = 0; item < slotOf_.size(); ++item)
+        {
+            const std::uint32_t location = slotOf_[item];
+            Point p{};
+            if ((location & OVERFLOW_BIT) != 0)
+            {
+                const OverflowItem& moved = overflow_[location & ~OVERFLOW_BIT];
+                p = moved.position;
+                radii[item] = moved.radius;
+            }
+            else
+            {
+                p = pointAt(location);
+                radii[item] = radius_[location];
+            }
+
+            if constexpr (D == 2)
+            {
+                positions[item] = {p[0], p[1]};
+            }
+            else
+            {
+                positions[item] = {p[0], p[1], p[2]};
+            }
+        }
+        rebuild(positions, radii);
+    }
+
+    template class SpatialHash<2>;
+    template class SpatialHash<3>;
+}
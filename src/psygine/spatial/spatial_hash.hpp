@@ -0,0 +1,398 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#ifndef PSYGINE_SPATIAL_HASH_HPP
+#define PSYGINE_SPATIAL_HASH_HPP
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "psygine/core/thread_pool.hpp"
+#include "psygine/math/vector.hpp"
+
+namespace psygine::spatial
+{
+    /**
+     * @brief Uniform spatial hash over 2D or 3D circles/spheres, for broadphase and proximity queries.
+     *
+     * Items are bucketed by the grid cell that holds their center, and the buckets live in flat
+     * arrays sorted by a counting sort: `rebuild` is O(n) and, given a pool, runs in parallel with the
+     * same result as the serial path. Item data is stored in bucket order, so a query walks a few
+     * short contiguous ranges instead of chasing pointers. Cells are hashed into a power-of-two
+     * bucket table, which keeps memory proportional to the item count for unbounded worlds.
+     *
+     * Pick a cell size around the typical query range, and at least twice the largest radius so a
+     * pair search only visits the neighbouring cells. Rebuild once per fixed tick when most items
+     * move; when few do, `move` updates items in place and only re-buckets the ones that crossed into
+     * another bucket.
+     *
+     * Queries are const and keep no shared scratch, so any number of threads can run them at once
+     * as long as nobody rebuilds or moves items meanwhile. Results come out in a fixed order for a
+     * given set of items, independent of thread count.
+     *
+     * @tparam D The dimension, 2 or 3.
+     */
+    template <std::size_t D>
+    class SpatialHash
+    {
+        static_assert(D == 2 || D == 3, "SpatialHash: only 2D and 3D are supported");
+
+    public:
+        using Vector = std::conditional_t<D == 2, math::Vec2, math::Vec3>;
+
+        /**
+         * @brief Two items whose bounds overlap, with `a < b`.
+         */
+        struct Pair
+        {
+            std::uint32_t a;
+            std::uint32_t b;
+
+            bool operator==(const Pair&) const = default;
+        };
+
+        /**
+         * @param cellSize The edge length of a grid cell.
+         * @param bucketCount Buckets in the hash table, rounded up to a power of two; 0 sizes the table
+         *                    to twice the item count on every rebuild.
+         */
+        explicit SpatialHash(float cellSize, std::size_t bucketCount = 0);
+
+        /**
+         * @brief Replaces the contents with `positions`; item `i` is `positions[i]`.
+         *
+         * @param positions The item centers.
+         * @param radii The item radii, or empty for points.
+         * @param pool Pool to rebuild on; null rebuilds on the calling thread, with the same result.
+         */
+        void rebuild(std::span<const Vector> positions, std::span<const float> radii = {},
+                     core::ThreadPool* pool = nullptr);
+
+        /**
+         * @brief Moves one item without a rebuild.
+         *
+         * Moves within the same bucket are updated in place. An item that lands in another bucket is
+         * kept in a small side list that every query scans, and the whole structure is rebuilt once
+         * that list grows past a fixed limit, so prefer `rebuild` when many items move per tick.
+         */
+        void move(std::uint32_t item, const Vector& position);
+
+        void clear();
+
+        /**
+         * @brief Calls `fn(item)` for every item whose circle/sphere overlaps the one given.
+         */
+        template <typename Fn>
+        void forEachInRadius(const Vector& center, const float radius, Fn&& fn) const
+        {
+            const Point c = ToPoint(center);
+            const float reach = radius + maxRadius_;
+            const auto test = [&](const Point& p, const float r, const std::uint32_t id)
+            {
+                const float range = radius + r;
+                if (DistanceSquared(c, p) <= range * range)
+                {
+                    fn(id);
+                }
+            };
+
+            forEachSlot(Offset(c, -reach), Offset(c, reach), [&](const std::size_t slot)
+            {
+                test(pointAt(slot), radius_[slot], id_[slot]);
+            });
+            for (const OverflowItem& item : overflow_)
+            {
+                test(item.position, item.radius, item.id);
+            }
+        }
+
+        /**
+         * @brief Calls `fn(item)` for every item whose bounding box overlaps [min, max].
+         */
+        template <typename Fn>
+        void forEachInBox(const Vector& min, const Vector& max, Fn&& fn) const
+        {
+            const Point lo = ToPoint(min);
+            const Point hi = ToPoint(max);
+            const auto test = [&](const Point& p, const float r, const std::uint32_t id)
+            {
+                for (std::size_t a = 0; a < D; ++a)
+                {
+                    if (p[a] + r < lo[a] || p[a] - r > hi[a])
+                    {
+                        return;
+                    }
+                }
+                fn(id);
+            };
+
+            forEachSlot(Offset(lo, -maxRadius_), Offset(hi, maxRadius_), [&](const std::size_t slot)
+            {
+                test(pointAt(slot), radius_[slot], id_[slot]);
+            });
+            for (const OverflowItem& item : overflow_)
+            {
+                test(item.position, item.radius, item.id);
+            }
+        }
+
+        /**
+         * @brief Collects the items overlapping a circle/sphere into `out`, replacing its contents.
+         */
+        void queryRadius(const Vector& center, float radius, std::vector<std::uint32_t>& out) const;
+
+        /**
+         * @brief Collects the items whose bounding box overlaps [min, max] into `out`, replacing its contents.
+         */
+        void queryBox(const Vector& min, const Vector& max, std::vector<std::uint32_t>& out) const;
+
+        /**
+         * @brief Finds the `k` items whose centers are closest to `point`, nearest first.
+         *
+         * Searches outward ring by ring from the cell holding `point` and stops as soon as no unvisited
+         * cell can hold anything closer. Equal distances are ordered by item index.
+         *
+         * @param point The query point.
+         * @param k The number of items wanted.
+         * @param out Receives the items, replacing its contents.
+         * @param maxDistance Items farther away than this are ignored.
+         * @return The number of items found, at most `k`.
+         */
+        std::size_t nearest(const Vector& point, std::size_t k, std::vector<std::uint32_t>& out,
+                            float maxDistance = std::numeric_limits<float>::infinity()) const;
+
+        /**
+         * @brief Collects every pair of items closer than the sum of their radii plus `padding`.
+         *
+         * Each pair is reported once. The result is in the same order for any pool, which keeps
+         * contact generation and trigger events deterministic.
+         *
+         * @param out Receives the pairs, replacing its contents.
+         * @param padding Extra distance added to every pair's contact range.
+         * @param pool Pool to search on; null searches on the calling thread.
+         */
+        void findPairs(std::vector<Pair>& out, float padding = 0.0F, core::ThreadPool* pool = nullptr) const;
+
+        [[nodiscard]] float cellSize() const
+        {
+            return cellSize_;
+        }
+
+        [[nodiscard]] std::size_t bucketCount() const
+        {
+            return cellStart_.empty() ? 0 : cellStart_.size() - 1;
+        }
+
+        [[nodiscard]] std::size_t size() const
+        {
+            return slotOf_.size();
+        }
+
+        [[nodiscard]] bool empty() const
+        {
+            return slotOf_.empty();
+        }
+
+    private:
+        using Point = std::array<float, D>;
+        using Cell = std::array<std::int32_t, D>;
+
+        // Cell coordinates are clamped so a packed cell key never collides with EMPTY_KEY.
+        static constexpr std::int32_t CELL_LIMIT = D == 2 ? (1 << 30) - 1 : (1 << 20) - 1;
+        static constexpr std::uint64_t EMPTY_KEY = ~std::uint64_t{0};
+        static constexpr std::uint32_t OVERFLOW_BIT = 1U << 31;
+        static constexpr std::size_t MAX_OVERFLOW = 256;
+
+        struct OverflowItem
+        {
+            std::uint32_t id;
+            Point position;
+            float radius;
+        };
+
+        static Point ToPoint(const Vector& v)
+        {
+            if constexpr (D == 2)
+            {
+                return {v.x, v.y};
+            }
+            else
+            {
+                return {v.x, v.y, v.z};
+            }
+        }
+
+        static Point Offset(Point p, const float amount)
+        {
+            for (float& c : p)
+            {
+                c += amount;
+            }
+            return p;
+        }
+
+        static float DistanceSquared(const Point& p, const Point& q)
+        {
+            float sum = 0.0F;
+            for (std::size_t a = 0; a < D; ++a)
+            {
+                const float d = p[a] - q[a];
+                sum += d * d;
+            }
+            return sum;
+        }
+
+        static std::uint64_t Pack(const Cell& cell)
+        {
+            constexpr std::uint32_t bits = D == 2 ? 31 : 21;
+            std::uint64_t key = 0;
+            for (std::size_t a = 0; a < D; ++a)
+            {
+                key = (key << bits) | static_cast<std::uint64_t>(std::int64_t{cell[a]} + CELL_LIMIT + 1);
+            }
+            return key;
+        }
+
+        [[nodiscard]] Cell cellOf(const Point& p) const
+        {
+            Cell cell{};
+            for (std::size_t a = 0; a < D; ++a)
+            {
+                // Clamped in double: 2^30 - 1 is not a float and would round up past the limit.
+                const double c = std::floor(p[a] * inverseCellSize_);
+                constexpr auto limit = static_cast<double>(CELL_LIMIT);
+                cell[a] = static_cast<std::int32_t>(c < -limit ? -limit : (c > limit ? limit : c));
+            }
+            return cell;
+        }
+
+        [[nodiscard]] std::size_t bucketOf(const std::uint64_t key) const
+        {
+            // Fibonacci hashing: the top bits of the product are well mixed for any table size.
+            return static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ULL) >> bucketShift_);
+        }
+
+        [[nodiscard]] Point pointAt(const std::size_t slot) const
+        {
+            Point p{};
+            for (std::size_t a = 0; a < D; ++a)
+            {
+                p[a] = coords_[a][slot];
+            }
+            return p;
+        }
+
+        // Calls fn(slot) for every live slot whose cell lies in the cells covering [lo, hi]; may pass
+        // extra slots when scanning everything is cheaper, so callers always test the geometry.
+        template <typename Fn>
+        void forEachSlot(const Point& lo, const Point& hi, Fn&& fn) const
+        {
+            Cell first = cellOf(lo);
+            Cell last = cellOf(hi);
+            double cells = 1.0;
+            for (std::size_t a = 0; a < D; ++a)
+            {
+                first[a] = first[a] < cellMin_[a] ? cellMin_[a] : first[a];
+                last[a] = last[a] > cellMax_[a] ? cellMax_[a] : last[a];
+                if (first[a] > last[a])
+                {
+                    return;
+                }
+                cells *= static_cast<double>(last[a] - first[a] + 1);
+            }
+
+            if (cells >= static_cast<double>(key_.size()))
+            {
+                for (std::size_t slot = 0; slot < key_.size(); ++slot)
+                {
+                    if (key_[slot] != EMPTY_KEY)
+                    {
+                        fn(slot);
+                    }
+                }
+                return;
+            }
+
+            const auto visit = [&](const Cell& cell)
+            {
+                const std::uint64_t key = Pack(cell);
+                const std::size_t bucket = bucketOf(key);
+                for (std::size_t slot = cellStart_[bucket]; slot < cellStart_[bucket + 1]; ++slot)
+                {
+                    if (key_[slot] == key)
+                    {
+                        fn(slot);
+                    }
+                }
+            };
+
+            Cell cell{};
+            if constexpr (D == 2)
+            {
+                for (cell[1] = first[1]; cell[1] <= last[1]; ++cell[1])
+                {
+                    for (cell[0] = first[0]; cell[0] <= last[0]; ++cell[0])
+                    {
+                        visit(cell);
+                    }
+                }
+            }
+            else
+            {
+                for (cell[2] = first[2]; cell[2] <= last[2]; ++cell[2])
+                {
+                    for (cell[1] = first[1]; cell[1] <= last[1]; ++cell[1])
+                    {
+                        for (cell[0] = first[0]; cell[0] <= last[0]; ++cell[0])
+                        {
+                            visit(cell);
+                        }
+                    }
+                }
+            }
+        }
+
+        // Rebuilds from the current contents, folding the overflow list back into the buckets.
+        void compact();
+
+        float cellSize_;
+        float inverseCellSize_;
+        std::size_t requestedBuckets_;
+        std::uint32_t bucketShift_ = 64;
+        float maxRadius_ = 0.0F;
+
+        // Conservative bounds of the occupied cells; queries never look outside them.
+        Cell cellMin_{};
+        Cell cellMax_{};
+
+        // Bucket b holds the slots [cellStart_[b], cellStart_[b + 1]); the arrays below are indexed by slot.
+        std::vector<std::uint32_t> cellStart_;
+        std::vector<std::uint64_t> key_;
+        std::vector<std::uint32_t> id_;
+        std::array<std::vector<float>, D> coords_;
+        std::vector<float> radius_;
+
+        // Item -> slot, or OVERFLOW_BIT | index into overflow_.
+        std::vector<std::uint32_t> slotOf_;
+        std::vector<OverflowItem> overflow_;
+
+        // Rebuild scratch, kept to avoid reallocating every tick.
+        std::vector<std::uint64_t> itemKey_;
+        std::vector<std::uint32_t> itemBucket_;
+        std::vector<std::uint32_t> counts_;
+    };
+
+    extern template class SpatialHash<2>;
+    extern template class SpatialHash<3>;
+
+    using SpatialHash2D = SpatialHash<2>;
+    using SpatialHash3D = SpatialHash<3>;
+}
+
+#endif //PSYGINE_SPATIAL_HASH_HPP
@@ -0,0 +1,359 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#include "flock.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+
+#include "psygine/debug/assert.hpp"
+#include "psygine/utilities/simd.hpp"
+
+namespace
+{
+    namespace simd = psygine::utilities::simd;
+    using psygine::math::Vec2;
+
+    constexpr std::size_t LANES = simd::NATIVE_WIDTH;
+    using FloatPack = simd::Float<LANES>;
+    using IntPack = simd::Int<LANES>;
+
+    constexpr std::array<std::int32_t, LANES> LANE_INDEX = []
+    {
+        std::array<std::int32_t, LANES> lanes{};
+        for (std::size_t i = 0; i < LANES; ++i)
+        {
+            lanes[i] = static_cast<std::int32_t>(i);
+        }
+        return lanes;
+    }();
+
+    // Agents steered per claimed chunk; each one walks a few dozen neighbours.
+    constexpr std::size_t AGENT_GRAIN = 256;
+
+    // Padding agents sit here, so they fail every distance test without producing NaNs.
+    constexpr float FAR_AWAY = 1e30F;
+
+    // Keeps the inverse-square separation finite for agents on top of each other.
+    constexpr float MIN_DISTANCE_SQUARED = 1e-6F;
+
+    // Cell coordinates are clamped so far-flung agents still hash.
+    constexpr float CELL_LIMIT = 1073741823.0F;
+
+    std::int32_t CellCoordinate(const float position, const float inverseCellSize)
+    {
+        return static_cast<std::int32_t>(std::clamp(std::floor(position * inverseCellSize), -CELL_LIMIT, CELL_LIMIT));
+    }
+
+    float HorizontalSum(const FloatPack& pack)
+    {
+        std::array<float, LANES> lanes{};
+        simd::Store(lanes.data(), pack);
+        float sum = 0.0F;
+        for (const float lane : lanes)
+        {
+            sum += lane;
+        }
+        return sum;
+    }
+
+    Vec2 ClampLength(const Vec2& v, const float maxLength)
+    {
+        const float lengthSquared = psygine::math::LengthSquared(v);
+        if (lengthSquared <= maxLength * maxLength)
+        {
+            return v;
+        }
+        return v * (maxLength / std::sqrt(lengthSquared));
+    }
+}
+
+namespace psygine::steering
+{
+    Flock::Flock(const FlockSettings& settings) :
+        obstacles_{1.0F}
+    {
+        setSettings(settings);
+    }
+
+    std::uint32_t Flock::add(const math::Vec2& position, const math::Vec2& velocity)
+    {
+        const auto agent = static_cast<std::uint32_t>(positionX_.size());
+        positionX_.push_back(position.x);
+        positionY_.push_back(position.y);
+        velocityX_.push_back(velocity.x);
+        velocityY_.push_back(velocity.y);
+        targetX_.push_back(0.0F);
+        targetY_.push_back(0.0F);
+        seeking_.push_back(0);
+        return agent;
+    }
+
+    void Flock::remove(const std::uint32_t agent)
+    {
+        PSYGINE_ASSERT(agent < size(), "Flock::remove: invalid agent");
+        const auto swapRemove = [agent](auto& values)
+        {
+            values[agent] = values.back();
+            values.pop_back();
+        };
+        swapRemove(positionX_);
+        swapRemove(positionY_);
+        swapRemove(velocityX_);
+        swapRemove(velocityY_);
+        swapRemove(targetX_);
+        swapRemove(targetY_);
+        swapRemove(seeking_);
+    }
+
+    void Flock::clear()
+    {
+        positionX_.clear();
+        positionY_.clear();
+        velocityX_.clear();
+        velocityY_.clear();
+        targetX_.clear();
+        targetY_.clear();
+        seeking_.clear();
+    }
+
+    void Flock::setTarget(const std::uint32_t agent, const math::Vec2& target)
+    {
+        PSYGINE_DEBUG_ASSERT(agent < size(), "Flock::setTarget: invalid agent");
+        targetX_[agent] = target.x;
+        targetY_[agent] = target.y;
+        seeking_[agent] = 1;
+    }
+
+    void Flock::clearTarget(const std::uint32_t agent)
+    {
+        PSYGINE_DEBUG_ASSERT(agent < size(), "Flock::clearTarget: invalid agent");
+        seeking_[agent] = 0;
+    }
+
+    void Flock::setPosition(const std::uint32_t agent, const math::Vec2& position)
+    {
+        PSYGINE_DEBUG_ASSERT(agent < size(), "Flock::setPosition: invalid agent");
+        positionX_[agent] = position.x;
+        positionY_[agent] = position.y;
+    }
+
+    void Flock::setVelocity(const std::uint32_t agent, const math::Vec2& velocity)
+    {
+        PSYGINE_DEBUG_ASSERT(agent < size(), "Flock::setVelocity: invalid agent");
+        velocityX_[agent] = velocity.x;
+        velocityY_[agent] = velocity.y;
+    }
+
+    void Flock::setObstacles(const std::span<const math::Vec2> centers, const std::span<const float> radii)
+    {
+        PSYGINE_ASSERT(centers.size() == radii.size(), "Flock::setObstacles: one radius per obstacle");
+        obstacleCenters_.assign(centers.begin(), centers.end());
+        obstacleRadii_.assign(radii.begin(), radii.end());
+
+        // Cells at least twice the largest radius, as the hash wants, and about the avoidance range.
+        const float largest = radii.empty() ? 0.0F : *std::ranges::max_element(radii);
+        obstacles_ = spatial::SpatialHash2D{std::max({2.0F * largest, settings_.avoidanceDistance, 1.0F})};
+        obstacles_.rebuild(obstacleCenters_, obstacleRadii_);
+    }
+
+    void Flock::setSettings(const FlockSettings& settings)
+    {
+        PSYGINE_ASSERT(settings.neighbourRadius > 0.0F, "Flock::setSettings: neighbour radius must be positive");
+        PSYGINE_ASSERT(settings.separationRadius <= settings.neighbourRadius,
+                       "Flock::setSettings: separation radius must not exceed the neighbour radius");
+        settings_ = settings;
+    }
+
+    void Flock::update(const float deltaTime, core::ThreadPool* pool)
+    {
+        const std::size_t count = size();
+        if (count == 0)
+        {
+            return;
+        }
+        bin();
+
+        const auto fn = [&](const std::size_t begin, const std::size_t end)
+        {
+            for (std::size_t slot = begin; slot < end; ++slot)
+            {
+                steer(slot, deltaTime);
+            }
+        };
+        if (pool == nullptr || count <= AGENT_GRAIN)
+        {
+            fn(0, count);
+        }
+        else
+        {
+            pool->parallelFor(count, AGENT_GRAIN, fn);
+        }
+    }
+
+    void Flock::bin()
+    {
+        const std::size_t count = size();
+        const std::size_t buckets = std::bit_ceil(std::max(count * 2, std::size_t{16}));
+        bucketShift_ = static_cast<std::uint32_t>(64 - std::countr_zero(buckets));
+        const float inverseCellSize = 1.0F / settings_.neighbourRadius;
+
+        // Counting sort by bucket, stable in agent order.
+        agentBucket_.resize(count);
+        bucketStart_.assign(buckets + 1, 0);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const std::uint32_t bucket = bucketOf(CellCoordinate(positionX_[i], inverseCellSize),
+                                                  CellCoordinate(positionY_[i], inverseCellSize));
+            agentBucket_[i] = bucket;
+            ++bucketStart_[bucket + 1];
+        }
+        for (std::size_t b = 0; b < buckets; ++b)
+        {
+            bucketStart_[b + 1] += bucketStart_[b];
+        }
+
+        sortedX_.resize(count + LANES);
+        sortedY_.resize(count + LANES);
+        sortedVelocityX_.resize(count + LANES);
+        sortedVelocityY_.resize(count + LANES);
+        sortedAgent_.resize(count + LANES);
+        // Scatter with each bucket's start as its cursor, which leaves every start at the next bucket's.
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const std::uint32_t slot = bucketStart_[agentBucket_[i]]++;
+            sortedX_[slot] = positionX_[i];
+            sortedY_[slot] = positionY_[i];
+            sortedVelocityX_[slot] = velocityX_[i];
+            sortedVelocityY_[slot] = velocityY_[i];
+            sortedAgent_[slot] = static_cast<std::int32_t>(i);
+        }
+        std::shift_right(bucketStart_.begin(), bucketStart_.end(), 1);
+        bucketStart_[0] = 0;
+
+        for (std::size_t slot = count; slot < count + LANES; ++slot)
+        {
+            sortedX_[slot] = FAR_AWAY;
+            sortedY_[slot] = FAR_AWAY;
+            sortedVelocityX_[slot] = 0.0F;
+            sortedVelocityY_[slot] = 0.0F;
+            sortedAgent_[slot] = -1;
+        }
+    }
+
+    void Flock::steer(const std::size_t slot, const float deltaTime)
+    {
+        const float x = sortedX_[slot];
+        const float y = sortedY_[slot];
+        const std::int32_t agent = sortedAgent_[slot];
+        const float inverseCellSize = 1.0F / settings_.neighbourRadius;
+        const std::int32_t cx = CellCoordinate(x, inverseCellSize);
+        const std::int32_t cy = CellCoordinate(y, inverseCellSize);
+
+        // The buckets of the 3x3 cells around the agent; cells sharing a bucket are walked once.
+        std::array<std::uint32_t, 9> buckets{};
+        std::size_t bucketCount = 0;
+        for (std::int32_t dy = -1; dy <= 1; ++dy)
+        {
+            for (std::int32_t dx = -1; dx <= 1; ++dx)
+            {
+                const std::uint32_t bucket = bucketOf(cx + dx, cy + dy);
+                if (std::find(buckets.begin(), buckets.begin() + static_cast<std::ptrdiff_t>(bucketCount), bucket) ==
+                    buckets.begin() + static_cast<std::ptrdiff_t>(bucketCount))
+                {
+                    buckets[bucketCount++] = bucket;
+                }
+            }
+        }
+
+        const FloatPack px{x};
+        const FloatPack py{y};
+        const FloatPack zero{0.0F};
+        const FloatPack one{1.0F};
+        const FloatPack neighbourRange{settings_.neighbourRadius * settings_.neighbourRadius};
+        const FloatPack separationRange{settings_.separationRadius * settings_.separationRadius};
+        const FloatPack minDistance{MIN_DISTANCE_SQUARED};
+        const IntPack self{agent};
+        const IntPack lanes = simd::Load(LANE_INDEX.data(), IntPack{});
+
+        FloatPack neighbours{0.0F};
+        FloatPack headingX{0.0F};
+        FloatPack headingY{0.0F};
+        FloatPack offsetX{0.0F};
+        FloatPack offsetY{0.0F};
+        FloatPack pushX{0.0F};
+        FloatPack pushY{0.0F};
+        for (std::size_t b = 0; b < bucketCount; ++b)
+        {
+            const std::uint32_t begin = bucketStart_[buckets[b]];
+            const std::uint32_t end = bucketStart_[buckets[b] + 1];
+            const IntPack last{static_cast<std::int32_t>(end)};
+            for (std::uint32_t j = begin; j < end; j += LANES)
+            {
+                const FloatPack dx = simd::Load(&sortedX_[j], FloatPack{}) - px;
+                const FloatPack dy = simd::Load(&sortedY_[j], FloatPack{}) - py;
+                const FloatPack distanceSquared = (dx * dx) + (dy * dy);
+                const IntPack inBucket = (lanes + IntPack{static_cast<std::int32_t>(j)}) < last;
+                const IntPack other = simd::AndNot(simd::Load(&sortedAgent_[j], IntPack{}) == self, inBucket);
+
+                const IntPack near = other & (distanceSquared < neighbourRange);
+                neighbours = neighbours + simd::Select(near, one, zero);
+                headingX = headingX + simd::Select(near, simd::Load(&sortedVelocityX_[j], FloatPack{}), zero);
+                headingY = headingY + simd::Select(near, simd::Load(&sortedVelocityY_[j], FloatPack{}), zero);
+                offsetX = offsetX + simd::Select(near, dx, zero);
+                offsetY = offsetY + simd::Select(near, dy, zero);
+
+                // Pushed away along the offset, harder the closer: -d / |d|^2.
+                const IntPack close = other & (distanceSquared < separationRange);
+                const FloatPack falloff = one / simd::Max(distanceSquared, minDistance);
+                pushX = pushX - simd::Select(close, dx * falloff, zero);
+                pushY = pushY - simd::Select(close, dy * falloff, zero);
+            }
+        }
+
+        const Vec2 position{x, y};
+        const Vec2 velocity{sortedVelocityX_[slot], sortedVelocityY_[slot]};
+        const SteeringWeights& weights = settings_.weights;
+        Vec2 force = Vec2{HorizontalSum(pushX), HorizontalSum(pushY)} * weights.separation;
+        if (const float n = HorizontalSum(neighbours); n > 0.0F)
+        {
+            const Vec2 heading{HorizontalSum(headingX) / n, HorizontalSum(headingY) / n};
+            const Vec2 centre{HorizontalSum(offsetX) / n, HorizontalSum(offsetY) / n};
+            force += (heading - velocity) * weights.alignment;
+            force += centre * weights.cohesion;
+        }
+
+        const auto index = static_cast<std::size_t>(agent);
+        if (seeking_[index] != 0)
+        {
+            const Vec2 target{targetX_[index], targetY_[index]};
+            const Vec2 desired = math::Normalize(target - position) * settings_.maxSpeed;
+            force += (desired - velocity) * weights.seek;
+        }
+
+        if (!obstacleCenters_.empty())
+        {
+            const float range = settings_.avoidanceDistance;
+            Vec2 avoid{};
+            obstacles_.forEachInRadius(position, range, [&](const std::uint32_t obstacle)
+            {
+                const Vec2 away = position - obstacleCenters_[obstacle];
+                const float distance = math::Length(away);
+                const float gap = std::max(distance - obstacleRadii_[obstacle], 0.0F);
+                const Vec2 direction = distance > 0.0F ? away / distance : Vec2{1.0F, 0.0F};
+                avoid += direction * (settings_.maxSpeed * (range - gap) / range);
+            });
+            force += avoid * weights.avoidance;
+        }
+
+        const Vec2 steered = ClampLength(velocity + (ClampLength(force, settings_.maxForce) * deltaTime),
+                                         settings_.maxSpeed);
+        const Vec2 moved = position + (steered * deltaTime);
+        velocityX_[index] = steered.x;
+        velocityY_[index] = steered.y;
+        positionX_[index] = moved.x;
+        positionY_[index] = moved.y;
+    }
+}
@@ -0,0 +1,173 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#ifndef PSYGINE_FLOCK_HPP
+#define PSYGINE_FLOCK_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "psygine/core/thread_pool.hpp"
+#include "psygine/math/vector.hpp"
+#include "psygine/spatial/spatial_hash.hpp"
+
+namespace psygine::steering
+{
+    /**
+     * @brief How strongly each behaviour pulls; 0 turns a behaviour off.
+     */
+    struct SteeringWeights
+    {
+        float separation = 1.5F;
+        float alignment = 1.0F;
+        float cohesion = 1.0F;
+        float seek = 1.0F;
+        float avoidance = 3.0F;
+    };
+
+    struct FlockSettings
+    {
+        // Agents closer than this are neighbours for alignment and cohesion.
+        float neighbourRadius = 3.0F;
+        // Neighbours closer than this push each other apart; at most `neighbourRadius`.
+        float separationRadius = 1.0F;
+        // Obstacles whose surface is closer than this push the agent away.
+        float avoidanceDistance = 2.0F;
+        float maxSpeed = 4.0F;
+        float maxForce = 8.0F;
+        SteeringWeights weights{};
+    };
+
+    /**
+     * @brief Boids: a flock of point agents steered by separation, alignment, cohesion, seeking a
+     * target and avoiding circular obstacles.
+     *
+     * Agent state is kept as separate position and velocity arrays. Every update bins the agents into a
+     * hashed grid of `neighbourRadius` cells by counting sort and copies their state out in cell order,
+     * so an agent's candidate neighbours lie in a few contiguous runs that are tested a SIMD pack at a
+     * time. Agents are then steered in parallel chunks; each reads only the copied state and writes
+     * only its own, so the result is the same for any pool. Step it from `onFixedUpdate`.
+     */
+    class Flock
+    {
+    public:
+        explicit Flock(const FlockSettings& settings = {});
+
+        /**
+         * @brief Adds an agent and returns its index.
+         */
+        std::uint32_t add(const math::Vec2& position, const math::Vec2& velocity = {});
+
+        /**
+         * @brief Removes an agent; the last agent moves into its index.
+         */
+        void remove(std::uint32_t agent);
+
+        void clear();
+
+        /**
+         * @brief Makes an agent seek `target`.
+         */
+        void setTarget(std::uint32_t agent, const math::Vec2& target);
+
+        void clearTarget(std::uint32_t agent);
+
+        void setPosition(std::uint32_t agent, const math::Vec2& position);
+        void setVelocity(std::uint32_t agent, const math::Vec2& velocity);
+
+        /**
+         * @brief Replaces the obstacles agents steer around.
+         */
+        void setObstacles(std::span<const math::Vec2> centers, std::span<const float> radii);
+
+        /**
+         * @brief Steers and moves every agent by one step of `deltaTime` seconds.
+         *
+         * @param pool Spreads the agents over its threads. Null steps them on the calling thread.
+         */
+        void update(float deltaTime, core::ThreadPool* pool = nullptr);
+
+        [[nodiscard]] math::Vec2 position(const std::uint32_t agent) const
+        {
+            return {positionX_[agent], positionY_[agent]};
+        }
+
+        [[nodiscard]] math::Vec2 velocity(const std::uint32_t agent) const
+        {
+            return {velocityX_[agent], velocityY_[agent]};
+        }
+
+        [[nodiscard]] std::span<const float> positionsX() const
+        {
+            return positionX_;
+        }
+
+        [[nodiscard]] std::span<const float> positionsY() const
+        {
+            return positionY_;
+        }
+
+        [[nodiscard]] std::span<const float> velocitiesX() const
+        {
+            return velocityX_;
+        }
+
+        [[nodiscard]] std::span<const float> velocitiesY() const
+        {
+            return velocityY_;
+        }
+
+        [[nodiscard]] std::size_t size() const
+        {
+            return positionX_.size();
+        }
+
+        [[nodiscard]] const FlockSettings& settings() const
+        {
+            return settings_;
+        }
+
+        void setSettings(const FlockSettings& settings);
+
+    private:
+        [[nodiscard]] std::uint32_t bucketOf(const std::int32_t cx, const std::int32_t cy) const
+        {
+            const std::uint64_t key = (static_cast<std::uint64_t>(static_cast<std::uint32_t>(cx)) << 32) |
+                static_cast<std::uint32_t>(cy);
+            // Fibonacci hashing, as in `SpatialHash`.
+            return static_cast<std::uint32_t>((key * 0x9E3779B97F4A7C15ULL) >> bucketShift_);
+        }
+
+        void bin();
+        void steer(std::size_t slot, float deltaTime);
+
+        FlockSettings settings_;
+
+        std::vector<float> positionX_;
+        std::vector<float> positionY_;
+        std::vector<float> velocityX_;
+        std::vector<float> velocityY_;
+        std::vector<float> targetX_;
+        std::vector<float> targetY_;
+        std::vector<std::uint8_t> seeking_;
+
+        std::vector<math::Vec2> obstacleCenters_;
+        std::vector<float> obstacleRadii_;
+        spatial::SpatialHash2D obstacles_;
+
+        // The agents in bucket order for this update, padded by a pack of far-away agents so a pack load
+        // never reads past the end. Bucket b holds the slots [bucketStart_[b], bucketStart_[b + 1]).
+        std::vector<std::uint32_t> bucketStart_;
+        std::vector<std::uint32_t> agentBucket_;
+        std::vector<float> sortedX_;
+        std::vector<float> sortedY_;
+        std::vector<float> sortedVelocityX_;
+        std::vector<float> sortedVelocityY_;
+        std::vector<std::int32_t> sortedAgent_;
+        std::uint32_t bucketShift_ = 64;
+    };
+}
+
+#endif //PSYGINE_FLOCK_HPP
@@ -0,0 +1,441 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#include "distributions.hpp"
+
+#include <bit>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    using psygine::utilities::random::detail::ZIGGURAT_LAYERS;
+    using psygine::utilities::random::detail::ZigguratTable;
+
+    // ---------------- Portable elementary functions ----------------
+    //
+    // The C library's exp and log are not required to round identically across implementations, so the
+    // distributions use these instead. Only basic IEEE operations are involved (this file is compiled
+    // without contraction): slow Taylor series build lookup tables at compile time, and the run-time
+    // versions combine a table entry with a short polynomial. Errors are a few ulps, far below what any
+    // acceptance test can observe.
+
+    constexpr double LN2_HI = 6.93147180369123816490e-01; // low 32 bits zero: k * LN2_HI is exact
+    constexpr double LN2_LO = 1.90821492927058770002e-10;
+    constexpr double INV_LN2 = 1.44269504088896338700e+00;
+
+    constexpr std::uint64_t MANTISSA_MASK = 0x000FFFFFFFFFFFFFULL;
+    constexpr std::uint64_t EXPONENT_ONE = 0x3FF0000000000000ULL;
+
+    // Multiplies by 2^exponent, stepping through intermediate scales so subnormal results stay correct.
+    constexpr double ScaleByPowerOfTwo(double value, int exponent)
+    {
+        while (exponent > 1023)
+        {
+            value *= 0x1.0p1023;
+            exponent -= 1023;
+        }
+        while (exponent < -1022)
+        {
+            value *= 0x1.0p-1022;
+            exponent += 1022;
+        }
+        return value * std::bit_cast<double>(static_cast<std::uint64_t>(exponent + 1023) << 52);
+    }
+
+    // Taylor series for exp on |x| <= 1; only used to build tables.
+    constexpr double ExpSeries(const double x)
+    {
+        double sum = 1.0;
+        for (int n = 24; n >= 1; --n)
+        {
+            sum = 1.0 + ((x / static_cast<double>(n)) * sum);
+        }
+        return sum;
+    }
+
+    // log(1 + r) from the atanh series, for 1 + r in [1, 2); only used to build tables.
+    constexpr double Log1pSeries(const double r)
+    {
+        const double s = r / (2.0 + r);
+        const double s2 = s * s;
+        double series = 0.0;
+        for (int n = 61; n >= 3; n -= 2)
+        {
+            series = (1.0 / static_cast<double>(n)) + (s2 * series);
+        }
+        return (2.0 * s) + ((2.0 * s) * (s2 * series));
+    }
+
+    // exp: x = (64k + j) * ln2 / 64 + r with |r| <= ln2 / 128; EXP_TABLE[j] = 2^(j / 64).
+    constexpr int EXP_TABLE_BITS = 6;
+    constexpr int EXP_TABLE_SIZE = 1 << EXP_TABLE_BITS;
+
+    constexpr std::array<double, EXP_TABLE_SIZE> EXP_TABLE = []
+    {
+        std::array<double, EXP_TABLE_SIZE> table{};
+        for (int j = 0; j < EXP_TABLE_SIZE; ++j)
+        {
+            // 2^(j / 64) = e^(j * ln2 / 64); the argument stays below ln2 where the series is exact enough.
+            const double argument = (static_cast<double>(j) * (LN2_HI + LN2_LO)) / EXP_TABLE_SIZE;
+            table[static_cast<std::size_t>(j)] = ExpSeries(argument);
+        }
+        return table;
+    }();
+
+    constexpr std::array<double, 6> EXP_COEFFICIENTS{1.0, 1.0, 1.0 / 2.0, 1.0 / 6.0, 1.0 / 24.0, 1.0 / 120.0};
+
+    constexpr double PortableExp(const double x)
+    {
+        if (x > 709.782712893384)
+        {
+            return std::numeric_limits<double>::infinity();
+        }
+        if (x < -745.1332191019412)
+        {
+            return 0.0;
+        }
+
+        const double scaled = (x * (INV_LN2 * EXP_TABLE_SIZE)) + (x < 0.0 ? -0.5 : 0.5);
+        const auto k = static_cast<int>(scaled);
+        const double kd = static_cast<double>(k);
+        const double r = (x - (kd * (LN2_HI / EXP_TABLE_SIZE))) - (kd * (LN2_LO / EXP_TABLE_SIZE));
+
+        // |r|^6 / 720 < 2^-54.
+        double p = EXP_COEFFICIENTS.back();
+        for (std::size_t n = EXP_COEFFICIENTS.size() - 1; n-- > 0;)
+        {
+            p = EXP_COEFFICIENTS[n] + (r * p);
+        }
+        const double scale = EXP_TABLE[static_cast<std::size_t>(k & (EXP_TABLE_SIZE - 1))];
+        return ScaleByPowerOfTwo(scale * p, k >> EXP_TABLE_BITS);
+    }
+
+    // log: x = 2^e * m with m in [1, 2), using m / 2 from about sqrt(2) upwards. m = c_j * (1 + r)
+    // with c_j on a 1/128 grid; m - c_j is exact, so r carries one rounding. The buckets on either side
+    // of 1 use c_j = 1, which keeps results near zero free of cancellation.
+    constexpr int LOG_TABLE_BITS = 7;
+    constexpr int LOG_TABLE_SIZE = 1 << LOG_TABLE_BITS;
+    constexpr int LOG_TABLE_SPLIT = 53; // first bucket at or above sqrt(2)
+
+    struct LogEntry
+    {
+        double c;
+        double inverse; // 1 / c rounded to double
+        double logC;
+    };
+
+    constexpr std::array<LogEntry, LOG_TABLE_SIZE> LOG_TABLE = []
+    {
+        std::array<LogEntry, LOG_TABLE_SIZE> table{};
+        for (int j = 0; j < LOG_TABLE_SIZE; ++j)
+        {
+            double c = 1.0 + (static_cast<double>(j) / LOG_TABLE_SIZE);
+            if (j >= LOG_TABLE_SPLIT)
+            {
+                c = j == LOG_TABLE_SIZE - 1 ? 1.0 : 0.5 * c;
+            }
+            table[static_cast<std::size_t>(j)] = {c, 1.0 / c, Log1pSeries(c - 1.0)};
+        }
+        return table;
+    }();
+
+    constexpr std::array<double, 8> LOG1P_COEFFICIENTS{1.0, -1.0 / 2.0, 1.0 / 3.0, -1.0 / 4.0,
+                                                       1.0 / 5.0, -1.0 / 6.0, 1.0 / 7.0, -1.0 / 8.0};
+
+    constexpr double PortableLog(const double x)
+    {
+        if (!(x > 0.0))
+        {
+            return x == 0.0 ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::quiet_NaN();
+        }
+        if (x == std::numeric_limits<double>::infinity())
+        {
+            return x;
+        }
+
+        double value = x;
+        int exponent = 0;
+        if (value < 0x1.0p-1022)
+        {
+            value *= 0x1.0p54;
+            exponent -= 54;
+        }
+        const auto bits = std::bit_cast<std::uint64_t>(value);
+        exponent += static_cast<int>((bits >> 52) & 0x7FFU) - 1023;
+        double m = std::bit_cast<double>((bits & MANTISSA_MASK) | EXPONENT_ONE);
+
+        const auto j = static_cast<int>((bits >> (52 - LOG_TABLE_BITS)) & (LOG_TABLE_SIZE - 1));
+        if (j >= LOG_TABLE_SPLIT)
+        {
+            m *= 0.5;
+            ++exponent;
+        }
+        const LogEntry& entry = LOG_TABLE[static_cast<std::size_t>(j)];
+        const double r = (m - entry.c) * entry.inverse;
+
+        // log(1 + r) to degree 8; |r| <= 1 / 128 so r^9 / 9 < 2^-65.
+        double q = LOG1P_COEFFICIENTS.back();
+        for (std::size_t n = LOG1P_COEFFICIENTS.size() - 1; n-- > 0;)
+        {
+            q = LOG1P_COEFFICIENTS[n] + (r * q);
+        }
+        const double p = r * q;
+        const double e = static_cast<double>(exponent);
+        return (e * LN2_HI) + (entry.logC + ((e * LN2_LO) + p));
+    }
+
+    constexpr double PortableSqrt(const double x)
+    {
+        // Only used for table construction; std::sqrt is correctly rounded at run time.
+        double root = x > 1.0 ? x : 1.0;
+        for (int i = 0; i < 64; ++i)
+        {
+            root = 0.5 * (root + (x / root));
+        }
+        return root;
+    }
+
+    // ---------------- Ziggurat tables ----------------
+
+    // Tail start and per-layer area for 256 layers, from Marsaglia and Tsang (2000).
+    constexpr double NORMAL_R = 3.6541528853610088;
+    constexpr double NORMAL_V = 0.00492867323399;
+    constexpr double EXPONENTIAL_R = 7.69711747013104972;
+    constexpr double EXPONENTIAL_V = 0.0039496598225815571993;
+
+    constexpr double NormalDensity(const double x)
+    {
+        return PortableExp(-0.5 * x * x);
+    }
+
+    constexpr ZigguratTable MakeNormalTable()
+    {
+        ZigguratTable table{};
+        table.x[0] = NORMAL_V / NormalDensity(NORMAL_R);
+        table.x[1] = NORMAL_R;
+        for (std::size_t i = 1; i < ZIGGURAT_LAYERS - 1; ++i)
+        {
+            const double y = (NORMAL_V / table.x[i]) + NormalDensity(table.x[i]);
+            table.x[i + 1] = PortableSqrt(-2.0 * PortableLog(y));
+        }
+        table.x[ZIGGURAT_LAYERS] = 0.0;
+
+        for (std::size_t i = 0; i <= ZIGGURAT_LAYERS; ++i)
+        {
+            table.f[i] = NormalDensity(table.x[i]);
+        }
+        return table;
+    }
+
+    constexpr ZigguratTable MakeExponentialTable()
+    {
+        ZigguratTable table{};
+        table.x[0] = EXPONENTIAL_V / PortableExp(-EXPONENTIAL_R);
+        table.x[1] = EXPONENTIAL_R;
+        for (std::size_t i = 1; i < ZIGGURAT_LAYERS - 1; ++i)
+        {
+            const double y = (EXPONENTIAL_V / table.x[i]) + PortableExp(-table.x[i]);
+            table.x[i + 1] = -PortableLog(y);
+        }
+        table.x[ZIGGURAT_LAYERS] = 0.0;
+
+        for (std::size_t i = 0; i <= ZIGGURAT_LAYERS; ++i)
+        {
+            table.f[i] = PortableExp(-table.x[i]);
+        }
+        return table;
+    }
+
+    // ---------------- Log-factorial ----------------
+
+    constexpr std::size_t LOG_FACTORIAL_TABLE_SIZE = 16;
+
+    constexpr std::array<double, LOG_FACTORIAL_TABLE_SIZE> MakeLogFactorials()
+    {
+        std::array<double, LOG_FACTORIAL_TABLE_SIZE> table{};
+        for (std::size_t k = 2; k < LOG_FACTORIAL_TABLE_SIZE; ++k)
+        {
+            table[k] = table[k - 1] + PortableLog(static_cast<double>(k));
+        }
+        return table;
+    }
+
+    constexpr std::array<double, LOG_FACTORIAL_TABLE_SIZE> LOG_FACTORIALS = MakeLogFactorials();
+
+    // 0.5 * log(2 * pi)
+    constexpr double HALF_LOG_TWO_PI = 0.91893853320467274178;
+
+    // log(k!) exactly from the table for small k, otherwise from Stirling's series for log Gamma(k + 1).
+    double LogFactorial(const std::int64_t k)
+    {
+        if (k < static_cast<std::int64_t>(LOG_FACTORIAL_TABLE_SIZE))
+        {
+            return LOG_FACTORIALS[static_cast<std::size_t>(k)];
+        }
+
+        const double n = static_cast<double>(k) + 1.0;
+        const double inverse = 1.0 / n;
+        const double inverse2 = inverse * inverse;
+        const double correction = inverse *
+            ((1.0 / 12.0) - (inverse2 * ((1.0 / 360.0) - (inverse2 * ((1.0 / 1260.0) - (inverse2 / 1680.0))))));
+        return ((n - 0.5) * PortableLog(n)) - n + HALF_LOG_TWO_PI + correction;
+    }
+}
+
+namespace psygine::utilities::random::detail
+{
+    constinit const ZigguratTable NORMAL_ZIGGURAT = MakeNormalTable();
+    constinit const ZigguratTable EXPONENTIAL_ZIGGURAT = MakeExponentialTable();
+
+    bool NormalWedgeAccepts(const std::size_t layer, const double x, const double u)
+    {
+        const auto& f = NORMAL_ZIGGURAT.f;
+        return f[layer] + ((f[layer + 1] - f[layer]) * u) < NormalDensity(x);
+    }
+
+    bool NormalTailAccepts(const double u1, const double u2, double& x)
+    {
+        // Marsaglia's tail method: exponential proposals beyond r, accepted against the normal tail.
+        const double t = -PortableLog(u1) / NORMAL_R;
+        const double y = -PortableLog(u2);
+        if (y + y < t * t)
+        {
+            return false;
+        }
+        x = NORMAL_R + t;
+        return true;
+    }
+
+    bool ExponentialWedgeAccepts(const std::size_t layer, const double x, const double u)
+    {
+        const auto& f = EXPONENTIAL_ZIGGURAT.f;
+        return f[layer] + ((f[layer + 1] - f[layer]) * u) < PortableExp(-x);
+    }
+
+    double Log(const double x)
+    {
+        return PortableLog(x);
+    }
+
+    double Exp(const double x)
+    {
+        return PortableExp(x);
+    }
+
+    double Add(const double a, const double b)
+    {
+        return a + b;
+    }
+
+    double Affine(const double z, const double mean, const double stddev)
+    {
+        return mean + (stddev * z);
+    }
+
+    void AffineInPlace(const std::span<double> values, const double mean, const double stddev)
+    {
+        for (auto& value : values)
+        {
+            value = mean + (stddev * value);
+        }
+    }
+
+    void AffineInPlace(const std::span<float> values, const double mean, const double stddev)
+    {
+        // The samples were already rounded to float; widen, transform and round once more. Callers
+        // of `fill` therefore match `operator()` only for double output.
+        for (auto& value : values)
+        {
+            value = static_cast<float>(mean + (stddev * static_cast<double>(value)));
+        }
+    }
+
+    GammaParams MakeGammaParams(const double alpha, const double beta)
+    {
+        GammaParams params;
+        params.alpha = alpha;
+        params.beta = beta;
+        params.boosted = alpha < 1.0;
+        params.inverseAlpha = 1.0 / alpha;
+
+        const double shape = params.boosted ? alpha + 1.0 : alpha;
+        params.d = shape - (1.0 / 3.0);
+        params.c = 1.0 / std::sqrt(9.0 * params.d);
+        return params;
+    }
+
+    bool GammaAccepts(const GammaParams& params, const double z, const double u, double& value)
+    {
+        double v = 1.0 + (params.c * z);
+        if (v <= 0.0)
+        {
+            return false;
+        }
+        v = v * v * v;
+
+        const double z2 = z * z;
+        // Cheap squeeze first; it accepts about 98% of the candidates that survive the full test.
+        if (u < 1.0 - (0.0331 * (z2 * z2)) ||
+            PortableLog(u) < (0.5 * z2) + (params.d * ((1.0 - v) + PortableLog(v))))
+        {
+            value = params.d * v;
+            return true;
+        }
+        return false;
+    }
+
+    double GammaBoost(const GammaParams& params, const double value, const double u)
+    {
+        // Gamma(alpha) = Gamma(alpha + 1) * U^(1 / alpha).
+        return value * PortableExp(PortableLog(u) * params.inverseAlpha);
+    }
+
+    PoissonParams MakePoissonParams(const double mean)
+    {
+        PoissonParams params;
+        params.mean = mean;
+        params.transformedRejection = mean >= 10.0;
+        params.expNegMean = PortableExp(-mean);
+
+        if (params.transformedRejection)
+        {
+            const double root = std::sqrt(mean);
+            params.b = 0.931 + (2.53 * root);
+            params.a = -0.059 + (0.02483 * params.b);
+            params.inverseAlpha = 1.1239 + (1.1328 / (params.b - 3.4));
+            params.vr = 0.9277 - (3.6224 / (params.b - 2.0));
+            params.logMean = PortableLog(mean);
+        }
+        return params;
+    }
+
+    bool PoissonAccepts(const PoissonParams& params, double u, const double v, std::int64_t& k)
+    {
+        // Hörmann (1993), "The transformed rejection method for generating Poisson random variables".
+        u -= 0.5;
+        const double us = 0.5 - std::abs(u);
+        const double candidate = std::floor(((((2.0 * params.a) / us) + params.b) * u) + params.mean + 0.43);
+
+        if (us >= 0.07 && v <= params.vr)
+        {
+            k = static_cast<std::int64_t>(candidate);
+            return true;
+        }
+        if (candidate < 0.0 || (us < 0.013 && v > us))
+        {
+            return false;
+        }
+
+        const auto n = static_cast<std::int64_t>(candidate);
+        const double lhs = PortableLog(v) + PortableLog(params.inverseAlpha) -
+            PortableLog((params.a / (us * us)) + params.b);
+        const double rhs = -params.mean + (static_cast<double>(n) * params.logMean) - LogFactorial(n);
+        if (lhs <= rhs)
+        {
+            k = n;
+            return true;
+        }
+        return false;
+    }
+}
@@ -0,0 +1,500 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#include "low_discrepancy.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <numeric>
+
+#include "simd.hpp"
+#include "psygine/debug/assert.hpp"
+
+namespace
+{
+    namespace simd = psygine::utilities::simd;
+    using psygine::utilities::random::Scrambling;
+
+    constexpr std::uint32_t MAX_DIMENSIONS = 16;
+    constexpr std::uint32_t DIRECTION_BITS = 32;
+
+    // Raw 32-bit values are produced in blocks of this size before the SIMD scramble/convert pass.
+    constexpr std::size_t BLOCK_SIZE = 256;
+
+    // The largest float below 1; double-to-float rounding must not return 1.0F.
+    constexpr float ONE_BELOW = 0x1.fffffep-1F;
+
+    template <std::size_t W>
+    using Vf = simd::Float<W>;
+
+    template <std::size_t W>
+    using Vi = simd::Int<W>;
+
+    template <std::size_t W>
+    Vi<W> Constant(const std::uint32_t value)
+    {
+        return Vi<W>(simd::detail::Wrap(value));
+    }
+
+    // ---------------- Sobol ----------------
+
+    // One row of Joe and Kuo's new-joe-kuo-6.21201: primitive polynomial degree, its inner coefficients
+    // and the initial direction numbers.
+    struct SobolPolynomial
+    {
+        std::uint32_t degree;
+        std::uint32_t coefficients;
+        std::array<std::uint32_t, 6> initial;
+    };
+
+    constexpr std::array<SobolPolynomial, MAX_DIMENSIONS - 1> SOBOL_POLYNOMIALS{{
+        {1, 0, {1}},
+        {2, 1, {1, 3}},
+        {3, 1, {1, 3, 1}},
+        {3, 2, {1, 1, 1}},
+        {4, 1, {1, 1, 3, 3}},
+        {4, 4, {1, 3, 5, 13}},
+        {5, 2, {1, 1, 5, 5, 17}},
+        {5, 4, {1, 1, 5, 5, 5}},
+        {5, 7, {1, 1, 7, 11, 19}},
+        {5, 11, {1, 1, 5, 1, 1}},
+        {5, 13, {1, 1, 1, 3, 11}},
+        {5, 14, {1, 3, 5, 5, 31}},
+        {6, 1, {1, 3, 3, 9, 7, 49}},
+        {6, 13, {1, 1, 1, 15, 21, 21}},
+        {6, 16, {1, 3, 1, 13, 27, 49}},
+    }};
+
+    using DirectionTable = std::array<std::array<std::uint32_t, DIRECTION_BITS>, MAX_DIMENSIONS>;
+
+    constexpr DirectionTable MakeSobolDirections()
+    {
+        DirectionTable table{};
+
+        // The first dimension is the van der Corput sequence in base 2.
+        for (std::uint32_t k = 0; k < DIRECTION_BITS; ++k)
+        {
+            table[0][k] = 1U << (31 - k);
+        }
+
+        for (std::uint32_t d = 1; d < MAX_DIMENSIONS; ++d)
+        {
+            const SobolPolynomial& poly = SOBOL_POLYNOMIALS[d - 1];
+            auto& v = table[d];
+            const std::uint32_t s = poly.degree;
+
+            for (std::uint32_t k = 0; k < s; ++k)
+            {
+                v[k] = poly.initial[k] << (31 - k);
+            }
+            for (std::uint32_t k = s; k < DIRECTION_BITS; ++k)
+            {
+                v[k] = v[k - s] ^ (v[k - s] >> s);
+                for (std::uint32_t j = 1; j < s; ++j)
+                {
+                    if (((poly.coefficients >> (s - 1 - j)) & 1U) != 0)
+                    {
+                        v[k] ^= v[k - j];
+                    }
+                }
+            }
+        }
+        return table;
+    }
+
+    constexpr DirectionTable SOBOL_DIRECTIONS = MakeSobolDirections();
+
+    // Unscrambled coordinate of point `index`, in Gray-code order.
+    std::uint32_t SobolRaw(const std::uint32_t index, const std::uint32_t dimension)
+    {
+        const auto& v = SOBOL_DIRECTIONS[dimension];
+        std::uint32_t gray = index ^ (index >> 1);
+        std::uint32_t x = 0;
+        for (std::uint32_t k = 0; gray != 0; ++k, gray >>= 1)
+        {
+            if ((gray & 1U) != 0)
+            {
+                x ^= v[k];
+            }
+        }
+        return x;
+    }
+
+    std::uint32_t ReverseBits(std::uint32_t x)
+    {
+        x = ((x >> 1) & 0x55555555U) | ((x & 0x55555555U) << 1);
+        x = ((x >> 2) & 0x33333333U) | ((x & 0x33333333U) << 2);
+        x = ((x >> 4) & 0x0F0F0F0FU) | ((x & 0x0F0F0F0FU) << 4);
+        x = ((x >> 8) & 0x00FF00FFU) | ((x & 0x00FF00FFU) << 8);
+        return (x >> 16) | (x << 16);
+    }
+
+    // Burley's improved Laine-Karras hash: every step only carries information from lower to higher
+    // bits, so applied to bit-reversed values it is a nested uniform (Owen) scramble.
+    std::uint32_t LaineKarras(std::uint32_t x, const std::uint32_t seed)
+    {
+        x ^= x * 0x3d20adeaU;
+        x += seed;
+        x *= (seed >> 16) | 1U;
+        x ^= x * 0x05526c56U;
+        x ^= x * 0x53a22864U;
+        return x;
+    }
+
+    std::uint32_t Scramble(const std::uint32_t x, const Scrambling mode, const std::uint32_t seed)
+    {
+        switch (mode)
+        {
+        case Scrambling::Xor:
+            return x ^ seed;
+        case Scrambling::Owen:
+            return ReverseBits(LaineKarras(ReverseBits(x), seed));
+        case Scrambling::None:
+        default:
+            return x;
+        }
+    }
+
+    template <std::size_t W>
+    Vi<W> ReverseBits(Vi<W> x)
+    {
+        const auto swap = [](const Vi<W>& v, const int shift, const std::uint32_t mask)
+        {
+            const Vi<W> m = Constant<W>(mask);
+            return (simd::ShiftRightLogical(v, shift) & m) | simd::ShiftLeft(v & m, shift);
+        };
+        x = swap(x, 1, 0x55555555U);
+        x = swap(x, 2, 0x33333333U);
+        x = swap(x, 4, 0x0F0F0F0FU);
+        x = swap(x, 8, 0x00FF00FFU);
+        return simd::ShiftRightLogical(x, 16) | simd::ShiftLeft(x, 16);
+    }
+
+    template <std::size_t W>
+    Vi<W> LaineKarras(Vi<W> x, const std::uint32_t seed)
+    {
+        x = x ^ (x * Constant<W>(0x3d20adeaU));
+        x = x + Constant<W>(seed);
+        x = x * Constant<W>((seed >> 16) | 1U);
+        x = x ^ (x * Constant<W>(0x05526c56U));
+        x = x ^ (x * Constant<W>(0x53a22864U));
+        return x;
+    }
+
+    // Same mapping as random::detail::BitsToUnitFloat: top 24 bits times 2^-24.
+    template <std::size_t W>
+    Vf<W> ToUnit(const Vi<W>& x)
+    {
+        return simd::ToFloat(simd::ShiftRightLogical(x, 8)) * Vf<W>(0x1.0p-24F);
+    }
+
+    // Scrambles and converts `count` raw values; `raw` is padded to a multiple of the SIMD width.
+    template <std::size_t W>
+    void ScrambleToUnit(const std::int32_t* raw, const std::size_t count, const Scrambling mode,
+                        const std::uint32_t seed, float* out)
+    {
+        std::array<float, W> tail{};
+        for (std::size_t i = 0; i < count; i += W)
+        {
+            Vi<W> x = simd::Load(raw + i, Vi<W>{});
+            if (mode == Scrambling::Xor)
+            {
+                x = x ^ Constant<W>(seed);
+            }
+            else if (mode == Scrambling::Owen)
+            {
+                x = ReverseBits(LaineKarras(ReverseBits(x), seed));
+            }
+
+            if (i + W <= count)
+            {
+                simd::Store(out + i, ToUnit(x));
+            }
+            else
+            {
+                simd::Store(tail.data(), ToUnit(x));
+                std::copy_n(tail.data(), count - i, out + i);
+            }
+        }
+    }
+
+    // ---------------- Halton ----------------
+
+    constexpr std::array<std::uint32_t, MAX_DIMENSIONS> PRIMES{2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47,
+                                                                 53};
+
+    // Digit weights for one base. `digits` is the smallest count with base^digits >= 2^32, so every
+    // 32-bit index is represented exactly and the scaled inverse is an integer below 2^38.
+    struct HaltonBase
+    {
+        std::uint32_t base = 0;
+        std::uint32_t digits = 0;
+        std::array<std::int64_t, DIRECTION_BITS> weights{};
+        double scale = 0.0;
+    };
+
+    constexpr std::array<HaltonBase, MAX_DIMENSIONS> MakeHaltonBases()
+    {
+        std::array<HaltonBase, MAX_DIMENSIONS> bases{};
+        for (std::uint32_t d = 0; d < MAX_DIMENSIONS; ++d)
+        {
+            HaltonBase& entry = bases[d];
+            entry.base = PRIMES[d];
+
+            std::uint64_t power = 1;
+            while (power < (std::uint64_t{1} << 32))
+            {
+                power *= entry.base;
+                ++entry.digits;
+            }
+
+            // The least significant index digit gets the largest weight, base^(digits - 1).
+            std::int64_t weight = 1;
+            for (std::uint32_t k = entry.digits; k-- > 0;)
+            {
+                entry.weights[k] = weight;
+                weight *= entry.base;
+            }
+            entry.scale = 1.0 / static_cast<double>(power);
+        }
+        return bases;
+    }
+
+    constexpr std::array<HaltonBase, MAX_DIMENSIONS> HALTON_BASES = MakeHaltonBases();
+
+    float HaltonToUnit(const std::int64_t scaled, const HaltonBase& base)
+    {
+        return std::min(static_cast<float>(static_cast<double>(scaled) * base.scale), ONE_BELOW);
+    }
+
+    // ---------------- R2 ----------------
+
+    // alpha_j = phi_d^-(j + 1), where phi_d is the positive root of x^(d + 1) = x + 1, in 32-bit fixed
+    // point. Evaluated at compile time so the constants cannot differ between platforms.
+    using AlphaTable = std::array<std::array<std::uint32_t, MAX_DIMENSIONS>, MAX_DIMENSIONS>;
+
+    constexpr AlphaTable MakeR2Alphas()
+    {
+        AlphaTable table{};
+        for (std::uint32_t dims = 1; dims <= MAX_DIMENSIONS; ++dims)
+        {
+            double phi = 2.0;
+            for (int iteration = 0; iteration < 64; ++iteration)
+            {
+                double power = 1.0;
+                for (std::uint32_t k = 0; k < dims; ++k)
+                {
+                    power *= phi;
+                }
+                // Newton step on f(x) = x^(d + 1) - x - 1.
+                phi -= ((power * phi) - phi - 1.0) / ((static_cast<double>(dims + 1) * power) - 1.0);
+            }
+
+            double inverse = 1.0;
+            for (std::uint32_t j = 0; j < dims; ++j)
+            {
+                inverse /= phi;
+                table[dims - 1][j] = static_cast<std::uint32_t>((inverse * 4294967296.0) + 0.5);
+            }
+        }
+        return table;
+    }
+
+    constexpr AlphaTable R2_ALPHAS = MakeR2Alphas();
+}
+
+namespace psygine::utilities::random
+{
+    // ---------------- SobolSequence ----------------
+
+    SobolSequence::SobolSequence(const std::uint32_t dimensions) :
+        dimensions_{dimensions}
+    {
+        PSYGINE_ASSERT(dimensions >= 1 && dimensions <= MAX_DIMENSIONS, "SobolSequence: unsupported dimension count");
+    }
+
+    std::uint32_t SobolSequence::bits(const std::uint32_t index, const std::uint32_t dimension) const
+    {
+        PSYGINE_DEBUG_ASSERT(dimension < dimensions_, "SobolSequence: dimension out of range");
+        return Scramble(SobolRaw(index, dimension), scrambling_, seeds_[dimension]);
+    }
+
+    float SobolSequence::sample(const std::uint32_t index, const std::uint32_t dimension) const
+    {
+        return detail::BitsToUnitFloat(bits(index, dimension));
+    }
+
+    void SobolSequence::point(const std::uint32_t index, const std::span<float> out) const
+    {
+        PSYGINE_DEBUG_ASSERT(out.size() >= dimensions_, "SobolSequence: output span too small");
+        for (std::uint32_t d = 0; d < dimensions_; ++d)
+        {
+            out[d] = sample(index, d);
+        }
+    }
+
+    void SobolSequence::fill(const std::uint32_t firstIndex, const std::uint32_t dimension,
+                             const std::span<float> out) const
+    {
+        PSYGINE_DEBUG_ASSERT(dimension < dimensions_, "SobolSequence: dimension out of range");
+        constexpr std::size_t width = simd::NATIVE_WIDTH;
+
+        const auto& v = SOBOL_DIRECTIONS[dimension];
+        std::uint32_t index = firstIndex;
+        std::uint32_t x = SobolRaw(index, dimension);
+
+        alignas(32) std::array<std::int32_t, BLOCK_SIZE> raw{};
+        for (std::size_t base = 0; base < out.size(); base += BLOCK_SIZE)
+        {
+            const std::size_t n = std::min(BLOCK_SIZE, out.size() - base);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                raw[i] = simd::detail::Wrap(x);
+                ++index;
+                // Consecutive Gray codes differ in the bit at the position of the lowest set bit of the index.
+                x = index != 0 ? x ^ v[static_cast<std::size_t>(std::countr_zero(index))] : 0U;
+            }
+            ScrambleToUnit<width>(raw.data(), n, scrambling_, seeds_[dimension], out.data() + base);
+        }
+    }
+
+    // ---------------- HaltonSequence ----------------
+
+    HaltonSequence::HaltonSequence(const std::uint32_t dimensions) :
+        dimensions_{dimensions}
+    {
+        PSYGINE_ASSERT(dimensions >= 1 && dimensions <= MAX_DIMENSIONS, "HaltonSequence: unsupported dimension count");
+        clearScrambling();
+    }
+
+    void HaltonSequence::clearScrambling()
+    {
+        for (auto& digits : permutations_)
+        {
+            std::iota(digits.begin(), digits.end(), std::uint8_t{0});
+        }
+        scrambled_ = false;
+    }
+
+    std::uint32_t HaltonSequence::Base(const std::uint32_t dimension)
+    {
+        return PRIMES[dimension];
+    }
+
+    float HaltonSequence::sample(std::uint32_t index, const std::uint32_t dimension) const
+    {
+        PSYGINE_DEBUG_ASSERT(dimension < dimensions_, "HaltonSequence: dimension out of range");
+        const HaltonBase& base = HALTON_BASES[dimension];
+        const auto& digits = permutations_[dimension];
+
+        std::int64_t scaled = 0;
+        for (std::uint32_t k = 0; k < base.digits; ++k)
+        {
+            scaled += digits[index % base.base] * base.weights[k];
+            index /= base.base;
+        }
+        return HaltonToUnit(scaled, base);
+    }
+
+    void HaltonSequence::point(const std::uint32_t index, const std::span<float> out) const
+    {
+        PSYGINE_DEBUG_ASSERT(out.size() >= dimensions_, "HaltonSequence: output span too small");
+        for (std::uint32_t d = 0; d < dimensions_; ++d)
+        {
+            out[d] = sample(index, d);
+        }
+    }
+
+    void HaltonSequence::fill(const std::uint32_t firstIndex, const std::uint32_t dimension,
+                              const std::span<float> out) const
+    {
+        PSYGINE_DEBUG_ASSERT(dimension < dimensions_, "HaltonSequence: dimension out of range");
+        PSYGINE_DEBUG_ASSERT(out.size() <= std::size_t{std::numeric_limits<std::uint32_t>::max()} - firstIndex + 1,
+                             "HaltonSequence: index range exceeds 32 bits");
+
+        const HaltonBase& base = HALTON_BASES[dimension];
+        const auto& permutation = permutations_[dimension];
+
+        // Odometer over the index digits; `scaled` tracks the permuted radical inverse times base^digits.
+        std::array<std::uint8_t, DIRECTION_BITS> digits{};
+        std::int64_t scaled = 0;
+        std::uint32_t remaining = firstIndex;
+        for (std::uint32_t k = 0; k < base.digits; ++k)
+        {
+            digits[k] = static_cast<std::uint8_t>(remaining % base.base);
+            remaining /= base.base;
+            scaled += permutation[digits[k]] * base.weights[k];
+        }
+
+        for (auto& value : out)
+        {
+            value = HaltonToUnit(scaled, base);
+
+            for (std::uint32_t k = 0; k < base.digits; ++k)
+            {
+                const std::uint8_t digit = digits[k];
+                if (digit + 1U < base.base)
+                {
+                    scaled += (permutation[digit + 1U] - permutation[digit]) * base.weights[k];
+                    digits[k] = static_cast<std::uint8_t>(digit + 1U);
+                    break;
+                }
+                scaled += (permutation[0] - permutation[digit]) * base.weights[k];
+                digits[k] = 0;
+            }
+        }
+    }
+
+    // ---------------- R2Sequence ----------------
+
+    R2Sequence::R2Sequence(const std::uint32_t dimensions) :
+        dimensions_{dimensions}
+    {
+        PSYGINE_ASSERT(dimensions >= 1 && dimensions <= MAX_DIMENSIONS, "R2Sequence: unsupported dimension count");
+        alphas_ = R2_ALPHAS[dimensions - 1];
+    }
+
+    void R2Sequence::point(const std::uint32_t index, const std::span<float> out) const
+    {
+        PSYGINE_DEBUG_ASSERT(out.size() >= dimensions_, "R2Sequence: output span too small");
+        for (std::uint32_t d = 0; d < dimensions_; ++d)
+        {
+            out[d] = sample(index, d);
+        }
+    }
+
+    void R2Sequence::fill(const std::uint32_t firstIndex, const std::uint32_t dimension,
+                          const std::span<float> out) const
+    {
+        PSYGINE_DEBUG_ASSERT(dimension < dimensions_, "R2Sequence: dimension out of range");
+        constexpr std::size_t width = simd::NATIVE_WIDTH;
+
+        std::array<std::int32_t, width> lanes{};
+        for (std::size_t lane = 0; lane < width; ++lane)
+        {
+            lanes[lane] = static_cast<std::int32_t>(lane);
+        }
+
+        const Vi<width> alpha = Constant<width>(alphas_[dimension]);
+        const Vi<width> step = alpha * Constant<width>(static_cast<std::uint32_t>(width));
+        // bits(i) = offset + i * alpha, advanced by `width * alpha` per pack; all wrapping mod 2^32.
+        Vi<width> x = Constant<width>(offsets_[dimension] + (firstIndex * alphas_[dimension])) +
+            (simd::Load(lanes.data(), Vi<width>{}) * alpha);
+
+        std::array<float, width> tail{};
+        for (std::size_t i = 0; i < out.size(); i += width)
+        {
+            if (i + width <= out.size())
+            {
+                simd::Store(out.data() + i, ToUnit(x));
+            }
+            else
+            {
+                simd::Store(tail.data(), ToUnit(x));
+                std::copy_n(tail.data(), out.size() - i, out.data() + i);
+            }
+            x = x + step;
+        }
+    }
+}
@@ -0,0 +1,341 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#ifndef PSYGINE_LOW_DISCREPANCY_HPP
+#define PSYGINE_LOW_DISCREPANCY_HPP
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <span>
+#include <utility>
+
+#include "random.hpp"
+#include "random_bulk.hpp"
+
+namespace psygine::utilities::random
+{
+    /**
+     * @brief How a `SobolSequence` randomizes its points.
+     *
+     * - `None`: the plain sequence; the first point is the origin.
+     * - `Xor`: a random digital shift per dimension. Cheap and keeps the net structure, but points
+     *   stay correlated across dimensions the way the plain sequence is.
+     * - `Owen`: hash-based nested uniform scrambling (Laine-Karras / Burley). Keeps the net structure
+     *   and removes the structured artefacts; usually the best choice for integration.
+     */
+    enum class Scrambling : std::uint8_t
+    {
+        None,
+        Xor,
+        Owen
+    };
+
+    /**
+     * @brief Sobol low-discrepancy sequence in up to 16 dimensions.
+     *
+     * Points are produced in Gray-code order so any point can be computed directly from its index
+     * (`sample`, `point`) while `fill` walks consecutive indices with a single XOR per point and then
+     * scrambles and converts them in SIMD batches. Both paths produce identical values.
+     *
+     * Any power-of-two prefix of the sequence is a (t, m, s)-net, so sample counts should preferably
+     * be powers of two. Direction numbers are Joe and Kuo's `new-joe-kuo-6.21201`.
+     */
+    class SobolSequence
+    {
+    public:
+        static constexpr std::uint32_t MAX_DIMENSIONS = 16;
+
+        /**
+         * @brief Constructs an unscrambled sequence.
+         *
+         * @param dimensions Number of dimensions per point, in [1, MAX_DIMENSIONS].
+         */
+        explicit SobolSequence(std::uint32_t dimensions = 2);
+
+        /**
+         * @brief Randomizes the sequence with seeds drawn from `rng`.
+         *
+         * @param rng The engine to draw per-dimension seeds from.
+         * @param mode The scrambling method.
+         */
+        template <std::uniform_random_bit_generator Engine>
+        void scramble(Engine& rng, const Scrambling mode = Scrambling::Owen)
+        {
+            detail::FillBits(rng, std::span(seeds_.data(), dimensions_));
+            scrambling_ = mode;
+        }
+
+        /**
+         * @brief Randomizes the sequence from a hashed seed.
+         *
+         * @param seed The seed value.
+         * @param mode The scrambling method.
+         * @param hasher The hash function applied to the seed.
+         */
+        template <typename Seed, typename THasher = std::hash<Seed>>
+        void reseed(const Seed& seed, const Scrambling mode = Scrambling::Owen, THasher hasher = {})
+        {
+            auto rng = MakeCustomSeededRngHashed<std::mt19937, Seed, THasher>(seed, hasher);
+            scramble(rng, mode);
+        }
+
+        /**
+         * @brief Restores the unscrambled sequence.
+         */
+        void clearScrambling()
+        {
+            seeds_.fill(0);
+            scrambling_ = Scrambling::None;
+        }
+
+        [[nodiscard]] std::uint32_t dimensions() const
+        {
+            return dimensions_;
+        }
+
+        [[nodiscard]] Scrambling scrambling() const
+        {
+            return scrambling_;
+        }
+
+        /**
+         * @brief Coordinate `dimension` of point `index` as 32-bit fixed point in [0, 2^32).
+         */
+        [[nodiscard]] std::uint32_t bits(std::uint32_t index, std::uint32_t dimension) const;
+
+        /**
+         * @brief Coordinate `dimension` of point `index` in [0, 1).
+         */
+        [[nodiscard]] float sample(std::uint32_t index, std::uint32_t dimension) const;
+
+        /**
+         * @brief Writes all coordinates of point `index`.
+         *
+         * @param index The point index.
+         * @param out Receives `dimensions()` values in [0, 1).
+         */
+        void point(std::uint32_t index, std::span<float> out) const;
+
+        /**
+         * @brief Writes one coordinate of consecutive points, starting at `firstIndex`.
+         *
+         * Call once per dimension to build structure-of-arrays batches.
+         *
+         * @param firstIndex The index of the first point.
+         * @param dimension The coordinate to generate.
+         * @param out Receives coordinate `dimension` of points `firstIndex + i`.
+         */
+        void fill(std::uint32_t firstIndex, std::uint32_t dimension, std::span<float> out) const;
+
+    private:
+        std::uint32_t dimensions_;
+        Scrambling scrambling_ = Scrambling::None;
+        std::array<std::uint32_t, MAX_DIMENSIONS> seeds_{};
+    };
+
+    /**
+     * @brief Halton low-discrepancy sequence in up to 16 dimensions, using the first 16 primes as bases.
+     *
+     * Each coordinate is a radical inverse evaluated over enough digits to cover every 32-bit index, so
+     * random access and the incremental odometer used by `fill` compute exactly the same value.
+     * Scrambling applies a random digit permutation per dimension, which removes the strong
+     * correlation between the higher bases.
+     */
+    class HaltonSequence
+    {
+    public:
+        static constexpr std::uint32_t MAX_DIMENSIONS = 16;
+
+        /**
+         * @brief Constructs an unscrambled sequence.
+         *
+         * @param dimensions Number of dimensions per point, in [1, MAX_DIMENSIONS].
+         */
+        explicit HaltonSequence(std::uint32_t dimensions = 2);
+
+        /**
+         * @brief Draws a random digit permutation per dimension from `rng`, replacing any previous one.
+         *
+         * @param rng The engine to draw from.
+         */
+        template <std::uniform_random_bit_generator Engine>
+        void scramble(Engine& rng)
+        {
+            clearScrambling();
+            for (std::uint32_t d = 0; d < dimensions_; ++d)
+            {
+                auto& digits = permutations_[d];
+                const std::uint32_t base = Base(d);
+                for (std::uint32_t i = base - 1; i > 0; --i)
+                {
+                    std::swap(digits[i], digits[detail::Bounded(rng, i + 1)]);
+                }
+            }
+            scrambled_ = true;
+        }
+
+        /**
+         * @brief Scrambles the sequence from a hashed seed.
+         *
+         * @param seed The seed value.
+         * @param hasher The hash function applied to the seed.
+         */
+        template <typename Seed, typename THasher = std::hash<Seed>>
+        void reseed(const Seed& seed, THasher hasher = {})
+        {
+            auto rng = MakeCustomSeededRngHashed<std::mt19937, Seed, THasher>(seed, hasher);
+            scramble(rng);
+        }
+
+        /**
+         * @brief Restores the unscrambled sequence.
+         */
+        void clearScrambling();
+
+        [[nodiscard]] std::uint32_t dimensions() const
+        {
+            return dimensions_;
+        }
+
+        [[nodiscard]] bool scrambled() const
+        {
+            return scrambled_;
+        }
+
+        /**
+         * @brief The prime base used for `dimension`.
+         */
+        [[nodiscard]] static std::uint32_t Base(std::uint32_t dimension);
+
+        /**
+         * @brief Coordinate `dimension` of point `index` in [0, 1).
+         */
+        [[nodiscard]] float sample(std::uint32_t index, std::uint32_t dimension) const;
+
+        /**
+         * @brief Writes all coordinates of point `index`.
+         *
+         * @param index The point index.
+         * @param out Receives `dimensions()` values in [0, 1).
+         */
+        void point(std::uint32_t index, std::span<float> out) const;
+
+        /**
+         * @brief Writes one coordinate of consecutive points, starting at `firstIndex`.
+         *
+         * Uses an incremental digit counter, so each point costs amortized O(1) instead of one division
+         * per digit.
+         *
+         * @param firstIndex The index of the first point.
+         * @param dimension The coordinate to generate.
+         * @param out Receives coordinate `dimension` of points `firstIndex + i`.
+         */
+        void fill(std::uint32_t firstIndex, std::uint32_t dimension, std::span<float> out) const;
+
+    private:
+        std::uint32_t dimensions_;
+        bool scrambled_ = false;
+        // Largest base is 53, so 64 slots hold every digit permutation.
+        std::array<std::array<std::uint8_t, 64>, MAX_DIMENSIONS> permutations_{};
+    };
+
+    /**
+     * @brief Roberts' R2 sequence and its generalization Rd, in up to 16 dimensions.
+     *
+     * Point i is `frac(offset + i * alpha)` where alpha comes from the generalized golden ratio. It is
+     * the cheapest sequence here: one multiply-add per coordinate, computed in 32-bit fixed point so
+     * it is exact, wraps cleanly and vectorizes. Any number of points is well distributed, not only
+     * powers of two. Scrambling applies a random toroidal shift (Cranley-Patterson rotation).
+     */
+    class R2Sequence
+    {
+    public:
+        static constexpr std::uint32_t MAX_DIMENSIONS = 16;
+
+        /**
+         * @brief Constructs an unshifted sequence.
+         *
+         * @param dimensions Number of dimensions per point, in [1, MAX_DIMENSIONS].
+         */
+        explicit R2Sequence(std::uint32_t dimensions = 2);
+
+        /**
+         * @brief Draws a random offset per dimension from `rng`.
+         *
+         * @param rng The engine to draw from.
+         */
+        template <std::uniform_random_bit_generator Engine>
+        void scramble(Engine& rng)
+        {
+            detail::FillBits(rng, std::span(offsets_.data(), dimensions_));
+        }
+
+        /**
+         * @brief Shifts the sequence from a hashed seed.
+         *
+         * @param seed The seed value.
+         * @param hasher The hash function applied to the seed.
+         */
+        template <typename Seed, typename THasher = std::hash<Seed>>
+        void reseed(const Seed& seed, THasher hasher = {})
+        {
+            auto rng = MakeCustomSeededRngHashed<std::mt19937, Seed, THasher>(seed, hasher);
+            scramble(rng);
+        }
+
+        /**
+         * @brief Restores the unshifted sequence.
+         */
+        void clearScrambling()
+        {
+            offsets_.fill(0);
+        }
+
+        [[nodiscard]] std::uint32_t dimensions() const
+        {
+            return dimensions_;
+        }
+
+        /**
+         * @brief Coordinate `dimension` of point `index` as 32-bit fixed point in [0, 2^32).
+         */
+        [[nodiscard]] std::uint32_t bits(const std::uint32_t index, const std::uint32_t dimension) const
+        {
+            return offsets_[dimension] + (index * alphas_[dimension]);
+        }
+
+        /**
+         * @brief Coordinate `dimension` of point `index` in [0, 1).
+         */
+        [[nodiscard]] float sample(const std::uint32_t index, const std::uint32_t dimension) const
+        {
+            return detail::BitsToUnitFloat(bits(index, dimension));
+        }
+
+        /**
+         * @brief Writes all coordinates of point `index`.
+         *
+         * @param index The point index.
+         * @param out Receives `dimensions()` values in [0, 1).
+         */
+        void point(std::uint32_t index, std::span<float> out) const;
+
+        /**
+         * @brief Writes one coordinate of consecutive points, starting at `firstIndex`, in SIMD batches.
+         *
+         * @param firstIndex The index of the first point.
+         * @param dimension The coordinate to generate.
+         * @param out Receives coordinate `dimension` of points `firstIndex + i`.
+         */
+        void fill(std::uint32_t firstIndex, std::uint32_t dimension, std::span<float> out) const;
+
+    private:
+        std::uint32_t dimensions_;
+        std::array<std::uint32_t, MAX_DIMENSIONS> alphas_{};
+        std::array<std::uint32_t, MAX_DIMENSIONS> offsets_{};
+    };
+}
+
+#endif //PSYGINE_LOW_DISCREPANCY_HPP
@@ -0,0 +1,668 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#include "noise.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+#include "simd.hpp"
+#include "psygine/core/thread_pool.hpp"
+#include "psygine/debug/assert.hpp"
+
+namespace
+{
+    namespace simd = psygine::utilities::simd;
+    using psygine::utilities::noise::CellularDistance;
+    using psygine::utilities::noise::CellularReturn;
+    using psygine::utilities::noise::FractalType;
+    using psygine::utilities::noise::NoiseSettings;
+    using psygine::utilities::noise::NoiseType;
+
+    // Shifts each octave onto an unrelated part of the lattice so octaves do not line up at the origin.
+    constexpr float OCTAVE_OFFSET = 131.7F;
+
+    // Target amount of samples per parallel chunk when filling grids.
+    constexpr std::size_t SAMPLES_PER_CHUNK = 16384;
+
+    template <std::size_t W>
+    using Vf = simd::Float<W>;
+
+    template <std::size_t W>
+    using Vi = simd::Int<W>;
+
+    template <std::size_t W>
+    Vi<W> Not(const Vi<W>& mask)
+    {
+        return mask ^ Vi<W>(-1);
+    }
+
+    // Converts an all-bits mask into 1.0F / 0.0F.
+    template <std::size_t W>
+    Vf<W> MaskToFloat(const Vi<W>& mask)
+    {
+        return simd::ToFloat(mask & Vi<W>(1));
+    }
+
+    template <std::size_t W>
+    Vf<W> Fade(const Vf<W>& t)
+    {
+        return t * t * t * (t * (t * Vf<W>(6.0F) - Vf<W>(15.0F)) + Vf<W>(10.0F));
+    }
+
+    template <std::size_t W>
+    Vf<W> Lerp(const Vf<W>& a, const Vf<W>& b, const Vf<W>& t)
+    {
+        return a + (t * (b - a));
+    }
+
+    template <std::size_t W>
+    Vf<W> Negate(const Vi<W>& h, const std::int32_t bit, const Vf<W>& value)
+    {
+        return simd::Select((h & Vi<W>(bit)) == Vi<W>(bit), -value, value);
+    }
+
+    // perm[perm[perm[x] + y] + z]...; every partial sum stays below 512.
+    template <std::size_t D, std::size_t W>
+    Vi<W> Hash(const std::int32_t* perm, const std::array<Vi<W>, D>& cell)
+    {
+        const Vi<W> mask(255);
+        Vi<W> h = simd::Gather(perm, cell[0] & mask);
+        for (std::size_t d = 1; d < D; ++d)
+        {
+            h = simd::Gather(perm, h + (cell[d] & mask));
+        }
+        return h;
+    }
+
+    // Gradient dot products from Ken Perlin's and Stefan Gustavson's reference implementations.
+    template <std::size_t W>
+    Vf<W> Grad(const Vi<W>& hash, const std::array<Vf<W>, 2>& p)
+    {
+        const Vi<W> h = hash & Vi<W>(7);
+        const Vi<W> low = h < Vi<W>(4);
+        const Vf<W> u = simd::Select(low, p[0], p[1]);
+        const Vf<W> v = simd::Select(low, p[1], p[0]);
+        return Negate(h, 1, u) + Negate(h, 2, Vf<W>(2.0F) * v);
+    }
+
+    template <std::size_t W>
+    Vf<W> Grad(const Vi<W>& hash, const std::array<Vf<W>, 3>& p)
+    {
+        const Vi<W> h = hash & Vi<W>(15);
+        const Vf<W> u = simd::Select(h < Vi<W>(8), p[0], p[1]);
+        const Vi<W> useX = (h == Vi<W>(12)) | (h == Vi<W>(14));
+        const Vf<W> v = simd::Select(h < Vi<W>(4), p[1], simd::Select(useX, p[0], p[2]));
+        return Negate(h, 1, u) + Negate(h, 2, v);
+    }
+
+    template <std::size_t W>
+    Vf<W> Grad(const Vi<W>& hash, const std::array<Vf<W>, 4>& p)
+    {
+        const Vi<W> h = hash & Vi<W>(31);
+        const Vf<W> u = simd::Select(h < Vi<W>(24), p[0], p[1]);
+        const Vf<W> v = simd::Select(h < Vi<W>(16), p[1], p[2]);
+        const Vf<W> w = simd::Select(h < Vi<W>(8), p[2], p[3]);
+        return Negate(h, 1, u) + Negate(h, 2, v) + Negate(h, 4, w);
+    }
+
+    // Value and Perlin noise share the same lattice walk over the 2^D cell corners.
+    template <std::size_t D, std::size_t W, bool Gradient>
+    Vf<W> LatticeNoise(const std::int32_t* perm, const std::array<Vf<W>, D>& p)
+    {
+        constexpr std::size_t corners = std::size_t{1} << D;
+
+        std::array<Vi<W>, D> base;
+        std::array<Vf<W>, D> frac;
+        std::array<Vf<W>, D> fade;
+        for (std::size_t d = 0; d < D; ++d)
+        {
+            const Vf<W> floored = simd::Floor(p[d]);
+            base[d] = simd::ToInt(floored);
+            frac[d] = p[d] - floored;
+            fade[d] = Fade(frac[d]);
+        }
+
+        std::array<Vf<W>, corners> values;
+        for (std::size_t c = 0; c < corners; ++c)
+        {
+            std::array<Vi<W>, D> cell;
+            std::array<Vf<W>, D> offset;
+            for (std::size_t d = 0; d < D; ++d)
+            {
+                const auto bit = static_cast<std::int32_t>((c >> d) & 1U);
+                cell[d] = base[d] + Vi<W>(bit);
+                offset[d] = frac[d] - Vf<W>(static_cast<float>(bit));
+            }
+
+            const Vi<W> h = Hash<D, W>(perm, cell);
+            if constexpr (Gradient)
+            {
+                values[c] = Grad<W>(h, offset);
+            }
+            else
+            {
+                values[c] = (simd::ToFloat(h) * Vf<W>(2.0F / 255.0F)) - Vf<W>(1.0F);
+            }
+        }
+
+        // Collapse one axis at a time; bit d of the corner index is the offset along axis d.
+        for (std::size_t d = 0; d < D; ++d)
+        {
+            for (std::size_t k = 0; k < (corners >> (d + 1)); ++k)
+            {
+                values[k] = Lerp(values[2 * k], values[(2 * k) + 1], fade[d]);
+            }
+        }
+
+        if constexpr (!Gradient)
+        {
+            return values[0];
+        }
+        else if constexpr (D == 2)
+        {
+            return values[0] * Vf<W>(0.507F);
+        }
+        else if constexpr (D == 3)
+        {
+            return values[0] * Vf<W>(0.936F);
+        }
+        else
+        {
+            return values[0] * Vf<W>(0.87F);
+        }
+    }
+
+    // One simplex corner: (r0 - |offset|^2)^4 * grad, clamped to zero outside the kernel radius.
+    template <std::size_t D, std::size_t W>
+    Vf<W> SimplexCorner(const std::int32_t* perm, const std::array<Vi<W>, D>& cell,
+                        const std::array<Vf<W>, D>& offset, const float radius)
+    {
+        Vf<W> t(radius);
+        for (std::size_t d = 0; d < D; ++d)
+        {
+            t = t - (offset[d] * offset[d]);
+        }
+        t = simd::Max(t, Vf<W>(0.0F));
+        t = t * t;
+        return t * t * Grad<W>(Hash<D, W>(perm, cell), offset);
+    }
+
+    template <std::size_t W>
+    Vf<W> Simplex(const std::int32_t* perm, const std::array<Vf<W>, 2>& p)
+    {
+        constexpr float f2 = 0.36602540378F; // (sqrt(3) - 1) / 2
+        constexpr float g2 = 0.21132486540F; // (3 - sqrt(3)) / 6
+
+        const Vf<W> s = (p[0] + p[1]) * Vf<W>(f2);
+        const Vf<W> i = simd::Floor(p[0] + s);
+        const Vf<W> j = simd::Floor(p[1] + s);
+        const Vf<W> t = (i + j) * Vf<W>(g2);
+        const Vf<W> x0 = p[0] - (i - t);
+        const Vf<W> y0 = p[1] - (j - t);
+
+        const Vi<W> xFirst = x0 > y0;
+        const Vf<W> i1 = MaskToFloat(xFirst);
+        const Vf<W> j1 = Vf<W>(1.0F) - i1;
+
+        const Vi<W> ii = simd::ToInt(i);
+        const Vi<W> jj = simd::ToInt(j);
+        const Vi<W> one(1);
+
+        Vf<W> n = SimplexCorner<2, W>(perm, {ii, jj}, {x0, y0}, 0.5F);
+        n = n + SimplexCorner<2, W>(perm, {ii + simd::ToInt(i1), jj + simd::ToInt(j1)},
+                                    {x0 - i1 + Vf<W>(g2), y0 - j1 + Vf<W>(g2)}, 0.5F);
+        n = n + SimplexCorner<2, W>(perm, {ii + one, jj + one},
+                                    {x0 - Vf<W>(1.0F - (2.0F * g2)), y0 - Vf<W>(1.0F - (2.0F * g2))}, 0.5F);
+        return n * Vf<W>(40.0F);
+    }
+
+    template <std::size_t W>
+    Vf<W> Simplex(const std::int32_t* perm, const std::array<Vf<W>, 3>& p)
+    {
+        constexpr float f3 = 1.0F / 3.0F;
+        constexpr float g3 = 1.0F / 6.0F;
+
+        const Vf<W> s = (p[0] + p[1] + p[2]) * Vf<W>(f3);
+        const Vf<W> i = simd::Floor(p[0] + s);
+        const Vf<W> j = simd::Floor(p[1] + s);
+        const Vf<W> k = simd::Floor(p[2] + s);
+        const Vf<W> t = (i + j + k) * Vf<W>(g3);
+        const Vf<W> x0 = p[0] - (i - t);
+        const Vf<W> y0 = p[1] - (j - t);
+        const Vf<W> z0 = p[2] - (k - t);
+
+        // Branch-free ranking of the offset components picks the simplex traversal order.
+        const Vi<W> xy = x0 >= y0;
+        const Vi<W> yz = y0 >= z0;
+        const Vi<W> xz = x0 >= z0;
+        const Vi<W> i1 = xy & xz;
+        const Vi<W> j1 = simd::AndNot(xy, yz);
+        const Vi<W> k1 = simd::AndNot(xz, Not(yz));
+        const Vi<W> i2 = xy | xz;
+        const Vi<W> j2 = Not(xy) | yz;
+        const Vi<W> k2 = Not(xz & yz);
+
+        const Vi<W> ii = simd::ToInt(i);
+        const Vi<W> jj = simd::ToInt(j);
+        const Vi<W> kk = simd::ToInt(k);
+        const Vi<W> one(1);
+
+        Vf<W> n = SimplexCorner<3, W>(perm, {ii, jj, kk}, {x0, y0, z0}, 0.6F);
+        n = n + SimplexCorner<3, W>(perm, {ii + (i1 & one), jj + (j1 & one), kk + (k1 & one)},
+                                    {x0 - MaskToFloat(i1) + Vf<W>(g3), y0 - MaskToFloat(j1) + Vf<W>(g3),
+                                     z0 - MaskToFloat(k1) + Vf<W>(g3)}, 0.6F);
+        n = n + SimplexCorner<3, W>(perm, {ii + (i2 & one), jj + (j2 & one), kk + (k2 & one)},
+                                    {x0 - MaskToFloat(i2) + Vf<W>(2.0F * g3),
+                                     y0 - MaskToFloat(j2) + Vf<W>(2.0F * g3),
+                                     z0 - MaskToFloat(k2) + Vf<W>(2.0F * g3)}, 0.6F);
+        n = n + SimplexCorner<3, W>(perm, {ii + one, jj + one, kk + one},
+                                    {x0 - Vf<W>(1.0F - (3.0F * g3)), y0 - Vf<W>(1.0F - (3.0F * g3)),
+                                     z0 - Vf<W>(1.0F - (3.0F * g3))}, 0.6F);
+        return n * Vf<W>(32.0F);
+    }
+
+    template <std::size_t W>
+    Vf<W> Simplex(const std::int32_t* perm, const std::array<Vf<W>, 4>& p)
+    {
+        constexpr float f4 = 0.30901699437F; // (sqrt(5) - 1) / 4
+        constexpr float g4 = 0.13819660113F; // (5 - sqrt(5)) / 20
+
+        const Vf<W> s = (p[0] + p[1] + p[2] + p[3]) * Vf<W>(f4);
+        std::array<Vf<W>, 4> floored;
+        Vf<W> sum(0.0F);
+        for (std::size_t d = 0; d < 4; ++d)
+        {
+            floored[d] = simd::Floor(p[d] + s);
+            sum = sum + floored[d];
+        }
+        const Vf<W> t = sum * Vf<W>(g4);
+
+        std::array<Vf<W>, 4> x0;
+        std::array<Vi<W>, 4> base;
+        for (std::size_t d = 0; d < 4; ++d)
+        {
+            x0[d] = p[d] - (floored[d] - t);
+            base[d] = simd::ToInt(floored[d]);
+        }
+
+        // Rank each component against the others; rank 3 is the largest.
+        const Vi<W> one(1);
+        std::array<Vi<W>, 4> rank{};
+        for (std::size_t a = 0; a < 4; ++a)
+        {
+            for (std::size_t b = a + 1; b < 4; ++b)
+            {
+                const Vi<W> greater = x0[a] > x0[b];
+                rank[a] = rank[a] + (greater & one);
+                rank[b] = rank[b] + (Not(greater) & one);
+            }
+        }
+
+        Vf<W> n = SimplexCorner<4, W>(perm, base, x0, 0.6F);
+        for (std::int32_t corner = 1; corner <= 3; ++corner)
+        {
+            // Corner c steps along every axis whose rank is at least 4 - c.
+            const Vi<W> threshold(3 - corner);
+            std::array<Vi<W>, 4> cell;
+            std::array<Vf<W>, 4> offset;
+            for (std::size_t d = 0; d < 4; ++d)
+            {
+                const Vi<W> step = rank[d] > threshold;
+                cell[d] = base[d] + (step & one);
+                offset[d] = x0[d] - MaskToFloat(step) + Vf<W>(static_cast<float>(corner) * g4);
+            }
+            n = n + SimplexCorner<4, W>(perm, cell, offset, 0.6F);
+        }
+
+        std::array<Vi<W>, 4> last;
+        std::array<Vf<W>, 4> lastOffset;
+        for (std::size_t d = 0; d < 4; ++d)
+        {
+            last[d] = base[d] + one;
+            lastOffset[d] = x0[d] - Vf<W>(1.0F - (4.0F * g4));
+        }
+        n = n + SimplexCorner<4, W>(perm, last, lastOffset, 0.6F);
+        return n * Vf<W>(27.0F);
+    }
+
+    // Worley noise over the 3^D neighbouring cells, one feature point per cell.
+    template <std::size_t D, std::size_t W>
+    Vf<W> Cellular(const std::int32_t* perm, const NoiseSettings& settings, const std::array<Vf<W>, D>& p)
+    {
+        std::size_t neighbours = 1;
+        for (std::size_t d = 0; d < D; ++d)
+        {
+            neighbours *= 3;
+        }
+
+        std::array<Vi<W>, D> base;
+        std::array<Vf<W>, D> frac;
+        for (std::size_t d = 0; d < D; ++d)
+        {
+            const Vf<W> floored = simd::Floor(p[d]);
+            base[d] = simd::ToInt(floored);
+            frac[d] = p[d] - floored;
+        }
+
+        const float jitter = std::clamp(settings.cellularJitter, 0.0F, 1.0F);
+        const Vf<W> jitterScale(jitter / 255.0F);
+        const Vf<W> jitterBias(0.5F - (0.5F * jitter));
+        const bool euclidean = settings.cellularDistance == CellularDistance::Euclidean;
+
+        Vf<W> f1(1e10F);
+        Vf<W> f2(1e10F);
+        for (std::size_t n = 0; n < neighbours; ++n)
+        {
+            std::array<Vi<W>, D> cell;
+            std::array<float, D> offset{};
+            std::size_t code = n;
+            for (std::size_t d = 0; d < D; ++d)
+            {
+                const auto o = static_cast<std::int32_t>(code % 3) - 1;
+                code /= 3;
+                cell[d] = base[d] + Vi<W>(o);
+                offset[d] = static_cast<float>(o);
+            }
+
+            Vi<W> h = Hash<D, W>(perm, cell);
+            Vf<W> distance(0.0F);
+            for (std::size_t d = 0; d < D; ++d)
+            {
+                h = simd::Gather(perm, h + Vi<W>(1));
+                const Vf<W> feature = Vf<W>(offset[d]) + jitterBias + (simd::ToFloat(h) * jitterScale);
+                const Vf<W> delta = feature - frac[d];
+                distance = distance + (euclidean ? delta * delta : simd::Abs(delta));
+            }
+
+            f2 = simd::Min(simd::Max(f1, distance), f2);
+            f1 = simd::Min(f1, distance);
+        }
+
+        if (euclidean)
+        {
+            f1 = simd::Sqrt(f1);
+            f2 = simd::Sqrt(f2);
+        }
+
+        switch (settings.cellularReturn)
+        {
+            case CellularReturn::F1: return (f1 * Vf<W>(2.0F)) - Vf<W>(1.0F);
+            case CellularReturn::F2: return (f2 * Vf<W>(2.0F)) - Vf<W>(1.0F);
+            case CellularReturn::F2MinusF1: return ((f2 - f1) * Vf<W>(2.0F)) - Vf<W>(1.0F);
+        }
+        return f1;
+    }
+
+    template <std::size_t D, std::size_t W>
+    Vf<W> BaseNoise(const std::int32_t* perm, const NoiseSettings& settings, const std::array<Vf<W>, D>& p)
+    {
+        switch (settings.type)
+        {
+            case NoiseType::Value: return LatticeNoise<D, W, false>(perm, p);
+            case NoiseType::Perlin: return LatticeNoise<D, W, true>(perm, p);
+            case NoiseType::Simplex: return Simplex<W>(perm, p);
+            case NoiseType::Cellular: return Cellular<D, W>(perm, settings, p);
+        }
+        return Vf<W>(0.0F);
+    }
+
+    template <std::size_t D, std::size_t W>
+    Vf<W> Sample(const std::int32_t* perm, const NoiseSettings& settings, std::array<Vf<W>, D> p)
+    {
+        for (auto& coordinate : p)
+        {
+            coordinate = coordinate * Vf<W>(settings.frequency);
+        }
+
+        if (settings.fractal == FractalType::None || settings.octaves <= 1)
+        {
+            return BaseNoise<D, W>(perm, settings, p);
+        }
+
+        Vf<W> sum(0.0F);
+        float amplitude = 1.0F;
+        float norm = 0.0F;
+        for (int octave = 0; octave < settings.octaves; ++octave)
+        {
+            Vf<W> n = BaseNoise<D, W>(perm, settings, p);
+            if (settings.fractal == FractalType::Billow)
+            {
+                n = (simd::Abs(n) * Vf<W>(2.0F)) - Vf<W>(1.0F);
+            }
+            else if (settings.fractal == FractalType::Ridged)
+            {
+                n = Vf<W>(1.0F) - (simd::Abs(n) * Vf<W>(2.0F));
+            }
+
+            sum = sum + (n * Vf<W>(amplitude));
+            norm += amplitude;
+            amplitude *= settings.gain;
+
+            for (auto& coordinate : p)
+            {
+                coordinate = (coordinate * Vf<W>(settings.lacunarity)) + Vf<W>(OCTAVE_OFFSET);
+            }
+        }
+        return sum * Vf<W>(1.0F / norm);
+    }
+
+    template <std::size_t D>
+    float SamplePoint(const std::int32_t* perm, const NoiseSettings& settings, const std::array<float, D>& point)
+    {
+        std::array<Vf<1>, D> p;
+        for (std::size_t d = 0; d < D; ++d)
+        {
+            p[d] = Vf<1>(point[d]);
+        }
+        return Sample<D, 1>(perm, settings, p).v[0];
+    }
+
+    template <std::size_t D>
+    void SampleBatch(const std::int32_t* perm, const NoiseSettings& settings,
+                     const std::array<std::span<const float>, D>& in, const std::span<float> out)
+    {
+        constexpr std::size_t width = simd::NATIVE_WIDTH;
+        for (const auto& coordinates : in)
+        {
+            PSYGINE_DEBUG_ASSERT(coordinates.size() == out.size(), "Noise::evaluate: span sizes must match");
+        }
+
+        std::size_t i = 0;
+        for (; i + width <= out.size(); i += width)
+        {
+            std::array<Vf<width>, D> p;
+            for (std::size_t d = 0; d < D; ++d)
+            {
+                p[d] = simd::Load(in[d].data() + i, Vf<width>{});
+            }
+            simd::Store(out.data() + i, Sample<D, width>(perm, settings, p));
+        }
+
+        if (i < out.size())
+        {
+            const std::size_t tail = out.size() - i;
+            std::array<Vf<width>, D> p;
+            for (std::size_t d = 0; d < D; ++d)
+            {
+                std::array<float, width> padded{};
+                std::copy_n(in[d].data() + i, tail, padded.data());
+                p[d] = simd::Load(padded.data(), Vf<width>{});
+            }
+
+            std::array<float, width> result{};
+            simd::Store(result.data(), Sample<D, width>(perm, settings, p));
+            std::copy_n(result.data(), tail, out.data() + i);
+        }
+    }
+
+    // Fills one row of `width` samples along x; `rest` holds the fixed y/z/w coordinates of the row.
+    template <std::size_t D>
+    void SampleRow(const std::int32_t* perm, const NoiseSettings& settings, const std::span<float> row,
+                   const float originX, const float step, const std::array<float, D - 1>& rest)
+    {
+        constexpr std::size_t width = simd::NATIVE_WIDTH;
+        std::array<Vf<width>, D> p;
+        for (std::size_t d = 1; d < D; ++d)
+        {
+            p[d] = Vf<width>(rest[d - 1]);
+        }
+
+        std::array<float, width> xs{};
+        std::array<float, width> result{};
+        for (std::size_t i = 0; i < row.size(); i += width)
+        {
+            for (std::size_t lane = 0; lane < width; ++lane)
+            {
+                xs[lane] = originX + (static_cast<float>(i + lane) * step);
+            }
+            p[0] = simd::Load(xs.data(), Vf<width>{});
+
+            const Vf<width> value = Sample<D, width>(perm, settings, p);
+            if (i + width <= row.size())
+            {
+                simd::Store(row.data() + i, value);
+            }
+            else
+            {
+                simd::Store(result.data(), value);
+                std::copy_n(result.data(), row.size() - i, row.data() + i);
+            }
+        }
+    }
+
+    // Runs `rowFn(row)` for every row, split across the pool when one is given.
+    template <typename RowFunction>
+    void ForEachRow(const std::size_t rows, const std::size_t rowLength, psygine::core::ThreadPool* pool,
+                    const RowFunction& rowFn)
+    {
+        const auto body = [&rowFn](const std::size_t begin, const std::size_t end)
+        {
+            for (std::size_t row = begin; row < end; ++row)
+            {
+                rowFn(row);
+            }
+        };
+
+        if (pool == nullptr)
+        {
+            body(0, rows);
+            return;
+        }
+
+        const std::size_t grain = std::max<std::size_t>(1, SAMPLES_PER_CHUNK / std::max<std::size_t>(1, rowLength));
+        pool->parallelFor(rows, grain, body);
+    }
+}
+
+namespace psygine::utilities::noise
+{
+    Noise::Noise(const NoiseSettings& settings) :
+        settings_{settings}
+    {
+        reseed(std::uint64_t{0});
+    }
+
+    float Noise::evaluate(const float x, const float y) const
+    {
+        return SamplePoint<2>(perm_.data(), settings_, {x, y});
+    }
+
+    float Noise::evaluate(const float x, const float y, const float z) const
+    {
+        return SamplePoint<3>(perm_.data(), settings_, {x, y, z});
+    }
+
+    float Noise::evaluate(const float x, const float y, const float z, const float w) const
+    {
+        return SamplePoint<4>(perm_.data(), settings_, {x, y, z, w});
+    }
+
+    void Noise::evaluate(const std::span<const float> xs, const std::span<const float> ys,
+                         const std::span<float> out) const
+    {
+        SampleBatch<2>(perm_.data(), settings_, {xs, ys}, out);
+    }
+
+    void Noise::evaluate(const std::span<const float> xs, const std::span<const float> ys,
+                         const std::span<const float> zs, const std::span<float> out) const
+    {
+        SampleBatch<3>(perm_.data(), settings_, {xs, ys, zs}, out);
+    }
+
+    void Noise::evaluate(const std::span<const float> xs, const std::span<const float> ys,
+                         const std::span<const float> zs, const std::span<const float> ws,
+                         const std::span<float> out) const
+    {
+        SampleBatch<4>(perm_.data(), settings_, {xs, ys, zs, ws}, out);
+    }
+
+    void Noise::fill(const std::span<float> out, const Grid2D& grid, core::ThreadPool* pool) const
+    {
+        const std::size_t width = grid.width;
+        PSYGINE_ASSERT(out.size() == width * grid.height, "Noise::fill: output size does not match the grid");
+
+        ForEachRow(grid.height, width, pool, [&](const std::size_t row)
+        {
+            const float y = grid.originY + (static_cast<float>(row) * grid.step);
+            SampleRow<2>(perm_.data(), settings_, out.subspan(row * width, width), grid.originX, grid.step, {y});
+        });
+    }
+
+    void Noise::fill(const std::span<float> out, const Grid3D& grid, core::ThreadPool* pool) const
+    {
+        const std::size_t width = grid.width;
+        const std::size_t rows = static_cast<std::size_t>(grid.height) * grid.depth;
+        PSYGINE_ASSERT(out.size() == width * rows, "Noise::fill: output size does not match the grid");
+
+        ForEachRow(rows, width, pool, [&](const std::size_t row)
+        {
+            const float y = grid.originY + (static_cast<float>(row % grid.height) * grid.step);
+            const float z = grid.originZ + (static_cast<float>(row / grid.height) * grid.step);
+            SampleRow<3>(perm_.data(), settings_, out.subspan(row * width, width), grid.originX, grid.step, {y, z});
+        });
+    }
+
+    void Noise::fill(const std::span<float> out, const Grid4D& grid, core::ThreadPool* pool) const
+    {
+        const std::size_t width = grid.width;
+        const std::size_t rows = static_cast<std::size_t>(grid.height) * grid.depth * grid.count;
+        PSYGINE_ASSERT(out.size() == width * rows, "Noise::fill: output size does not match the grid");
+
+        ForEachRow(rows, width, pool, [&](const std::size_t row)
+        {
+            const std::size_t slice = row / grid.height;
+            const float y = grid.originY + (static_cast<float>(row % grid.height) * grid.step);
+            const float z = grid.originZ + (static_cast<float>(slice % grid.depth) * grid.step);
+            const float w = grid.originW + (static_cast<float>(slice / grid.depth) * grid.step);
+            SampleRow<4>(perm_.data(), settings_, out.subspan(row * width, width), grid.originX, grid.step,
+                         {y, z, w});
+        });
+    }
+
+    void Noise::shuffle(std::mt19937& rng)
+    {
+        std::array<std::int32_t, 256> table{};
+        std::iota(table.begin(), table.end(), 0);
+
+        // Fisher-Yates with Lemire's bounded draw; std::shuffle is implementation-defined and would
+        // give different tables on different standard libraries.
+        for (std::uint32_t i = 255; i > 0; --i)
+        {
+            const std::uint64_t range = i + 1;
+            std::uint64_t product = static_cast<std::uint64_t>(rng()) * range;
+            const auto threshold = static_cast<std::uint32_t>((std::uint64_t{1} << 32) % range);
+            while (static_cast<std::uint32_t>(product) < threshold)
+            {
+                product = static_cast<std::uint64_t>(rng()) * range;
+            }
+            std::swap(table[i], table[static_cast<std::size_t>(product >> 32)]);
+        }
+
+        for (std::size_t i = 0; i < 256; ++i)
+        {
+            perm_[i] = table[i];
+            perm_[i + 256] = table[i];
+        }
+    }
+}
@@ -0,0 +1,596 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#ifndef PSYGINE_POISSON_DISK_HPP
+#define PSYGINE_POISSON_DISK_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <functional>
+#include <numbers>
+#include <random>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "random.hpp"
+#include "random_bulk.hpp"
+#include "psygine/debug/assert.hpp"
+#include "psygine/math/vector.hpp"
+
+namespace psygine::utilities::random
+{
+    /**
+     * @brief Candidates tried around an active point before it is retired; Bridson's recommended value.
+     */
+    inline constexpr std::uint32_t DEFAULT_POISSON_ATTEMPTS = 30;
+
+    namespace detail
+    {
+        // Refuses to allocate absurd background grids when the radius is tiny relative to the domain.
+        inline constexpr std::size_t MAX_POISSON_GRID_CELLS = std::size_t{1} << 26;
+
+        /**
+         * @brief Bridson's O(n) Poisson-disk sampler over an axis-aligned box of dimension D.
+         *
+         * The background grid has cells no wider than `minRadius / sqrt(D)`, so each cell holds at most
+         * one point and a conflict test only visits the cells within `maxRadius`. Two points conflict
+         * when they are closer than the larger of their radii. With `wrap` set, distances and neighbour
+         * cells are measured on the torus, which makes the result tile seamlessly.
+         */
+        template <std::size_t D, std::uniform_random_bit_generator Engine, typename RadiusFn>
+        std::vector<std::array<float, D>> Bridson(Engine& rng, const std::array<float, D>& lo,
+                                                  const std::array<float, D>& hi, const float minRadius,
+                                                  const float maxRadius, RadiusFn&& radiusAt,
+                                                  const std::uint32_t attempts, const bool wrap)
+        {
+            static_assert(D == 2 || D == 3, "Bridson: only 2D and 3D are supported");
+            using Point = std::array<float, D>;
+
+            PSYGINE_DEBUG_ASSERT(minRadius > 0.0F && maxRadius >= minRadius, "PoissonDisk: invalid radius range");
+            PSYGINE_DEBUG_ASSERT(attempts > 0, "PoissonDisk: attempts must be positive");
+
+            std::array<float, D> extent{};
+            std::array<std::uint32_t, D> dims{};
+            std::array<float, D> cellSize{};
+            std::array<std::int32_t, D> reach{};
+            std::size_t cellCount = 1;
+
+            const float maxCell = minRadius / std::sqrt(static_cast<float>(D));
+            for (std::size_t a = 0; a < D; ++a)
+            {
+                extent[a] = hi[a] - lo[a];
+                PSYGINE_DEBUG_ASSERT(extent[a] > 0.0F, "PoissonDisk: empty domain");
+                PSYGINE_DEBUG_ASSERT(!wrap || extent[a] >= 2.0F * maxRadius,
+                                     "PoissonDisk: tileable domain must be at least twice the maximum radius");
+
+                dims[a] = std::max(1U, static_cast<std::uint32_t>(std::ceil(extent[a] / maxCell)));
+                // Dividing the extent exactly keeps cell boundaries aligned with the wrap seam.
+                cellSize[a] = extent[a] / static_cast<float>(dims[a]);
+                reach[a] = static_cast<std::int32_t>(std::ceil(maxRadius / cellSize[a]));
+                cellCount *= dims[a];
+            }
+            PSYGINE_ASSERT(cellCount <= MAX_POISSON_GRID_CELLS, "PoissonDisk: radius too small for the domain");
+
+            std::vector<std::int32_t> grid(cellCount, -1);
+            std::vector<Point> points;
+            std::vector<float> radii;
+            std::vector<std::uint32_t> active;
+
+            const auto cellOf = [&](const Point& p)
+            {
+                std::array<std::int32_t, D> cell{};
+                for (std::size_t a = 0; a < D; ++a)
+                {
+                    const auto c = static_cast<std::int32_t>((p[a] - lo[a]) / cellSize[a]);
+                    cell[a] = std::clamp(c, 0, static_cast<std::int32_t>(dims[a]) - 1);
+                }
+                return cell;
+            };
+
+            const auto flatten = [&](const std::array<std::int32_t, D>& cell)
+            {
+                std::size_t index = 0;
+                for (std::size_t a = D; a-- > 0;)
+                {
+                    index = (index * dims[a]) + static_cast<std::size_t>(cell[a]);
+                }
+                return index;
+            };
+
+            const auto distanceSquared = [&](const Point& p, const Point& q)
+            {
+                float sum = 0.0F;
+                for (std::size_t a = 0; a < D; ++a)
+                {
+                    float d = std::abs(p[a] - q[a]);
+                    if (wrap)
+                    {
+                        d = std::min(d, extent[a] - d);
+                    }
+                    sum += d * d;
+                }
+                return sum;
+            };
+
+            const auto conflicts = [&](const Point& candidate, const float radius)
+            {
+                const auto center = cellOf(candidate);
+
+                // Per axis: first offset and how many cells to visit. On a small torus the window is
+                // clamped to the whole axis so no cell is visited twice.
+                std::array<std::int32_t, D> first{};
+                std::array<std::int32_t, D> span{};
+                for (std::size_t a = 0; a < D; ++a)
+                {
+                    const auto size = static_cast<std::int32_t>(dims[a]);
+                    if (wrap && (2 * reach[a]) + 1 >= size)
+                    {
+                        first[a] = -center[a];
+                        span[a] = size;
+                    }
+                    else
+                    {
+                        first[a] = -reach[a];
+                        span[a] = (2 * reach[a]) + 1;
+                    }
+                }
+
+                std::array<std::int32_t, D> step{};
+                for (;;)
+                {
+                    std::array<std::int32_t, D> cell{};
+                    bool inside = true;
+                    for (std::size_t a = 0; a < D; ++a)
+                    {
+                        const auto size = static_cast<std::int32_t>(dims[a]);
+                        std::int32_t c = center[a] + first[a] + step[a];
+                        if (wrap)
+                        {
+                            c = ((c % size) + size) % size;
+                        }
+                        else if (c < 0 || c >= size)
+                        {
+                            inside = false;
+                            break;
+                        }
+                        cell[a] = c;
+                    }
+
+                    if (inside)
+                    {
+                        const std::int32_t other = grid[flatten(cell)];
+                        if (other >= 0)
+                        {
+                            const auto o = static_cast<std::size_t>(other);
+                            const float limit = std::max(radius, radii[o]);
+                            if (distanceSquared(candidate, points[o]) < limit * limit)
+                            {
+                                return true;
+                            }
+                        }
+                    }
+
+                    std::size_t a = 0;
+                    for (; a < D; ++a)
+                    {
+                        if (++step[a] < span[a])
+                        {
+                            break;
+                        }
+                        step[a] = 0;
+                    }
+                    if (a == D)
+                    {
+                        return false;
+                    }
+                }
+            };
+
+            const auto insert = [&](const Point& p, const float radius)
+            {
+                const auto index = static_cast<std::uint32_t>(points.size());
+                grid[flatten(cellOf(p))] = static_cast<std::int32_t>(index);
+                points.push_back(p);
+                radii.push_back(radius);
+                active.push_back(index);
+            };
+
+            const auto clampRadius = [&](const Point& p)
+            {
+                return std::clamp(static_cast<float>(radiusAt(p)), minRadius, maxRadius);
+            };
+
+            std::array<float, D> unit{};
+            FillUnit(rng, std::span<float>(unit));
+            Point seed{};
+            for (std::size_t a = 0; a < D; ++a)
+            {
+                seed[a] = lo[a] + (unit[a] * extent[a]);
+            }
+            insert(seed, clampRadius(seed));
+
+            constexpr float TWO_PI = 2.0F * std::numbers::pi_v<float>;
+            while (!active.empty())
+            {
+                const std::uint32_t slot = Bounded(rng, static_cast<std::uint32_t>(active.size()));
+                const Point origin = points[active[slot]];
+                const float originRadius = radii[active[slot]];
+
+                bool placed = false;
+                for (std::uint32_t attempt = 0; attempt < attempts && !placed; ++attempt)
+                {
+                    FillUnit(rng, std::span<float>(unit));
+
+                    // Uniform by volume in the shell between r and 2r around the origin.
+                    Point candidate{};
+                    if constexpr (D == 2)
+                    {
+                        const float angle = TWO_PI * unit[0];
+                        const float distance = originRadius * std::sqrt(1.0F + (3.0F * unit[1]));
+                        candidate[0] = origin[0] + (distance * std::cos(angle));
+                        candidate[1] = origin[1] + (distance * std::sin(angle));
+                    }
+                    else
+                    {
+                        const float z = (2.0F * unit[0]) - 1.0F;
+                        const float angle = TWO_PI * unit[1];
+                        const float ring = std::sqrt(std::max(0.0F, 1.0F - (z * z)));
+                        const float distance = originRadius * std::cbrt(1.0F + (7.0F * unit[2]));
+                        candidate[0] = origin[0] + (distance * ring * std::cos(angle));
+                        candidate[1] = origin[1] + (distance * ring * std::sin(angle));
+                        candidate[2] = origin[2] + (distance * z);
+                    }
+
+                    bool inside = true;
+                    for (std::size_t a = 0; a < D; ++a)
+                    {
+                        if (wrap)
+                        {
+                            if (candidate[a] < lo[a])
+                            {
+                                candidate[a] += extent[a];
+                            }
+                            else if (candidate[a] >= hi[a])
+                            {
+                                candidate[a] -= extent[a];
+                            }
+                            // Rounding at the seam can land exactly on `hi`.
+                            if (candidate[a] >= hi[a] || candidate[a] < lo[a])
+                            {
+                                candidate[a] = lo[a];
+                            }
+                        }
+                        else if (candidate[a] < lo[a] || candidate[a] >= hi[a])
+                        {
+                            inside = false;
+                        }
+                    }
+                    if (!inside)
+                    {
+                        continue;
+                    }
+
+                    const float radius = clampRadius(candidate);
+                    if (!conflicts(candidate, radius))
+                    {
+                        insert(candidate, radius);
+                        placed = true;
+                    }
+                }
+
+                if (!placed)
+                {
+                    active[slot] = active.back();
+                    active.pop_back();
+                }
+            }
+
+            return points;
+        }
+
+        template <std::size_t D>
+        struct ConstantRadius
+        {
+            float radius;
+
+            float operator()(const std::array<float, D>& /*point*/) const
+            {
+                return radius;
+            }
+        };
+    } // namespace detail
+
+    /**
+     * @brief Generates a 2D Poisson-disk point set: no two points are closer than `radius`.
+     *
+     * Uses Bridson's algorithm with a background acceleration grid, so the cost is linear in the number
+     * of points produced. Points are returned in generation order, which spreads outward from a random
+     * seed point rather than sweeping across the domain.
+     *
+     * Randomness comes from `rng`, so any engine from `random.hpp` (e.g. `MakeSeededRng`) or a `SimdRng`
+     * gives a reproducible set for a given seed.
+     *
+     * @param rng The engine to draw from.
+     * @param min The lower corner of the domain.
+     * @param max The upper corner of the domain; points lie in [min, max).
+     * @param radius The minimum distance between points.
+     * @param attempts Candidates tried around each point before it is retired.
+     * @return The generated points.
+     */
+    template <std::uniform_random_bit_generator Engine>
+    [[nodiscard]] std::vector<math::Vec2> PoissonDisk(Engine& rng, const math::Vec2 min, const math::Vec2 max,
+                                                      const float radius,
+                                                      const std::uint32_t attempts = DEFAULT_POISSON_ATTEMPTS)
+    {
+        const auto raw = detail::Bridson<2>(rng, {min.x, min.y}, {max.x, max.y}, radius, radius,
+                                            detail::ConstantRadius<2>{radius}, attempts, false);
+        std::vector<math::Vec2> points;
+        points.reserve(raw.size());
+        for (const auto& p : raw)
+        {
+            points.push_back({p[0], p[1]});
+        }
+        return points;
+    }
+
+    /**
+     * @brief Generates a 2D Poisson-disk point set whose spacing varies over the domain.
+     *
+     * `radiusAt` is evaluated once per candidate and clamped to [minRadius, maxRadius]. Two points
+     * conflict when they are closer than the larger of their radii, so dense and sparse regions blend
+     * without overlap at the boundary. The grid is sized for `minRadius` and neighbour searches reach
+     * `maxRadius`, so keep that ratio modest for best speed.
+     *
+     * @param rng The engine to draw from.
+     * @param min The lower corner of the domain.
+     * @param max The upper corner of the domain; points lie in [min, max).
+     * @param minRadius The smallest allowed spacing.
+     * @param maxRadius The largest allowed spacing.
+     * @param radiusAt Callable `float(math::Vec2)` giving the desired spacing at a position.
+     * @param attempts Candidates tried around each point before it is retired.
+     * @return The generated points.
+     */
+    template <std::uniform_random_bit_generator Engine, typename RadiusFn>
+        requires std::invocable<RadiusFn&, math::Vec2>
+    [[nodiscard]] std::vector<math::Vec2> PoissonDisk(Engine& rng, const math::Vec2 min, const math::Vec2 max,
+                                                      const float minRadius, const float maxRadius,
+                                                      RadiusFn&& radiusAt,
+                                                      const std::uint32_t attempts = DEFAULT_POISSON_ATTEMPTS)
+    {
+        const auto raw = detail::Bridson<2>(rng, {min.x, min.y}, {max.x, max.y}, minRadius, maxRadius,
+                                            [&radiusAt](const std::array<float, 2>& p)
+                                            {
+                                                return radiusAt(math::Vec2{p[0], p[1]});
+                                            },
+                                            attempts, false);
+        std::vector<math::Vec2> points;
+        points.reserve(raw.size());
+        for (const auto& p : raw)
+        {
+            points.push_back({p[0], p[1]});
+        }
+        return points;
+    }
+
+    /**
+     * @brief Generates a 3D Poisson-disk point set: no two points are closer than `radius`.
+     *
+     * @param rng The engine to draw from.
+     * @param min The lower corner of the domain.
+     * @param max The upper corner of the domain; points lie in [min, max).
+     * @param radius The minimum distance between points.
+     * @param attempts Candidates tried around each point before it is retired.
+     * @return The generated points.
+     */
+    template <std::uniform_random_bit_generator Engine>
+    [[nodiscard]] std::vector<math::Vec3> PoissonDisk(Engine& rng, const math::Vec3 min, const math::Vec3 max,
+                                                      const float radius,
+                                                      const std::uint32_t attempts = DEFAULT_POISSON_ATTEMPTS)
+    {
+        const auto raw = detail::Bridson<3>(rng, {min.x, min.y, min.z}, {max.x, max.y, max.z}, radius, radius,
+                                            detail::ConstantRadius<3>{radius}, attempts, false);
+        std::vector<math::Vec3> points;
+        points.reserve(raw.size());
+        for (const auto& p : raw)
+        {
+            points.push_back({p[0], p[1], p[2]});
+        }
+        return points;
+    }
+
+    /**
+     * @brief Generates a 3D Poisson-disk point set whose spacing varies over the domain.
+     *
+     * @param rng The engine to draw from.
+     * @param min The lower corner of the domain.
+     * @param max The upper corner of the domain; points lie in [min, max).
+     * @param minRadius The smallest allowed spacing.
+     * @param maxRadius The largest allowed spacing.
+     * @param radiusAt Callable `float(math::Vec3)` giving the desired spacing at a position.
+     * @param attempts Candidates tried around each point before it is retired.
+     * @return The generated points.
+     */
+    template <std::uniform_random_bit_generator Engine, typename RadiusFn>
+        requires std::invocable<RadiusFn&, math::Vec3>
+    [[nodiscard]] std::vector<math::Vec3> PoissonDisk(Engine& rng, const math::Vec3 min, const math::Vec3 max,
+                                                      const float minRadius, const float maxRadius,
+                                                      RadiusFn&& radiusAt,
+                                                      const std::uint32_t attempts = DEFAULT_POISSON_ATTEMPTS)
+    {
+        const auto raw = detail::Bridson<3>(rng, {min.x, min.y, min.z}, {max.x, max.y, max.z}, minRadius,
+                                            maxRadius,
+                                            [&radiusAt](const std::array<float, 3>& p)
+                                            {
+                                                return radiusAt(math::Vec3{p[0], p[1], p[2]});
+                                            },
+                                            attempts, false);
+        std::vector<math::Vec3> points;
+        points.reserve(raw.size());
+        for (const auto& p : raw)
+        {
+            points.push_back({p[0], p[1], p[2]});
+        }
+        return points;
+    }
+
+    /**
+     * @brief A precomputed, seamlessly tileable 2D blue-noise point set.
+     *
+     * The points fill the unit square and were generated on a torus, so repeating the tile in a grid
+     * keeps the minimum spacing across tile edges. Generate a tile once (or load a baked one) and
+     * scatter it over arbitrarily large areas for vegetation, decals or sampling patterns without
+     * running Bridson per area.
+     *
+     * Points are kept sorted by y so rectangle queries only visit the rows they overlap.
+     */
+    class BlueNoiseTile
+    {
+    public:
+        BlueNoiseTile() = default;
+
+        /**
+         * @brief Wraps an existing point set, e.g. one baked into the game data.
+         *
+         * @param points Points in [0, 1)^2 that tile seamlessly.
+         */
+        explicit BlueNoiseTile(std::vector<math::Vec2> points) :
+            points_{std::move(points)}
+        {
+            std::ranges::sort(points_, [](const math::Vec2& a, const math::Vec2& b)
+            {
+                return a.y < b.y || (a.y == b.y && a.x < b.x);
+            });
+        }
+
+        /**
+         * @brief The points of one tile in [0, 1)^2, sorted by y.
+         */
+        [[nodiscard]] std::span<const math::Vec2> points() const
+        {
+            return points_;
+        }
+
+        [[nodiscard]] std::size_t size() const
+        {
+            return points_.size();
+        }
+
+        [[nodiscard]] bool empty() const
+        {
+            return points_.empty();
+        }
+
+        /**
+         * @brief Invokes `fn(math::Vec2)` for every tiled point inside [min, max).
+         *
+         * @param min The lower corner of the query rectangle in world units.
+         * @param max The upper corner of the query rectangle in world units.
+         * @param tileSize The world size of one tile; spacing scales with it.
+         * @param fn The callback receiving world positions.
+         */
+        template <typename Fn>
+        void forEachInRect(const math::Vec2 min, const math::Vec2 max, const float tileSize, Fn&& fn) const
+        {
+            PSYGINE_DEBUG_ASSERT(tileSize > 0.0F, "BlueNoiseTile: tile size must be positive");
+            if (points_.empty() || !(min.x < max.x) || !(min.y < max.y))
+            {
+                return;
+            }
+
+            const auto firstX = static_cast<std::int64_t>(std::floor(min.x / tileSize));
+            const auto lastX = static_cast<std::int64_t>(std::floor(max.x / tileSize));
+            const auto firstY = static_cast<std::int64_t>(std::floor(min.y / tileSize));
+            const auto lastY = static_cast<std::int64_t>(std::floor(max.y / tileSize));
+
+            for (std::int64_t ty = firstY; ty <= lastY; ++ty)
+            {
+                const float originY = static_cast<float>(ty) * tileSize;
+                const float localMinY = (min.y - originY) / tileSize;
+                const float localMaxY = (max.y - originY) / tileSize;
+
+                const auto begin = std::ranges::lower_bound(points_, localMinY, {}, &math::Vec2::y);
+                const auto end = std::ranges::lower_bound(begin, points_.end(), localMaxY, {}, &math::Vec2::y);
+
+                for (std::int64_t tx = firstX; tx <= lastX; ++tx)
+                {
+                    const float originX = static_cast<float>(tx) * tileSize;
+                    for (auto it = begin; it != end; ++it)
+                    {
+                        const math::Vec2 world{originX + (it->x * tileSize), originY + (it->y * tileSize)};
+                        if (world.x >= min.x && world.x < max.x && world.y >= min.y && world.y < max.y)
+                        {
+                            fn(world);
+                        }
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief Appends every tiled point inside [min, max) to `out`.
+         *
+         * @param min The lower corner of the query rectangle in world units.
+         * @param max The upper corner of the query rectangle in world units.
+         * @param tileSize The world size of one tile.
+         * @param out The vector to append to; existing contents are kept.
+         */
+        void collect(const math::Vec2 min, const math::Vec2 max, const float tileSize,
+                     std::vector<math::Vec2>& out) const
+        {
+            forEachInRect(min, max, tileSize, [&out](const math::Vec2 p)
+            {
+                out.push_back(p);
+            });
+        }
+
+    private:
+        std::vector<math::Vec2> points_;
+    };
+
+    /**
+     * @brief Generates a tileable blue-noise tile with the given engine.
+     *
+     * @param rng The engine to draw from.
+     * @param radius The minimum spacing relative to the tile size, in (0, 0.5].
+     * @param attempts Candidates tried around each point before it is retired.
+     * @return The tile.
+     */
+    template <std::uniform_random_bit_generator Engine>
+    [[nodiscard]] BlueNoiseTile GenerateBlueNoiseTile(Engine& rng, const float radius,
+                                                      const std::uint32_t attempts = DEFAULT_POISSON_ATTEMPTS)
+    {
+        const auto raw = detail::Bridson<2>(rng, {0.0F, 0.0F}, {1.0F, 1.0F}, radius, radius,
+                                            detail::ConstantRadius<2>{radius}, attempts, true);
+        std::vector<math::Vec2> points;
+        points.reserve(raw.size());
+        for (const auto& p : raw)
+        {
+            points.push_back({p[0], p[1]});
+        }
+        return BlueNoiseTile(std::move(points));
+    }
+
+    /**
+     * @brief Generates a tileable blue-noise tile from a hashed seed.
+     *
+     * The seed is turned into an engine with `MakeCustomSeededRngHashed`, matching the other seeded
+     * utilities, so the same seed always yields the same tile.
+     *
+     * @param seed The seed value.
+     * @param radius The minimum spacing relative to the tile size, in (0, 0.5].
+     * @param hasher The hash function applied to the seed.
+     * @return The tile.
+     */
+    template <typename Seed, typename THasher = std::hash<Seed>>
+    [[nodiscard]] BlueNoiseTile MakeBlueNoiseTile(const Seed& seed, const float radius, THasher hasher = {})
+    {
+        auto rng = MakeCustomSeededRngHashed<std::mt19937, Seed, THasher>(seed, hasher);
+        return GenerateBlueNoiseTile(rng, radius);
+    }
+}
+
+#endif //PSYGINE_POISSON_DISK_HPP
@@ -9,8 +9,11 @@
 
 #include <algorithm>
 #include <array>
+#include <cstdint>
 #include <functional>
+#include <iterator>
 #include <random>
+#include <ranges>
 #include <type_traits>
 #include <vector>
 
@@ -235,7 +238,7 @@ namespace psygine::utilities::random
      */
     template <typename Engine, typename Seed, typename THasher = std::hash<Seed>>
         requires (std::uniform_random_bit_generator<Engine> &&
-            psyengine::utils::detail::SeedSeqConstructibleOrSeedable<Engine> &&
+            detail::SeedSeqConstructibleOrSeedable<Engine> &&
             std::invocable<THasher, const Seed&>)
     [[nodiscard]] Engine MakeCustomSeededRngHashed(const Seed& seed, THasher hasher = {})
     {
@@ -245,7 +248,7 @@ namespace psygine::utilities::random
         state = detail::Mix64(state);
 
         // Expand into enough 32-bit words for Engine using splitmix64 progression
-        constexpr std::size_t n = psyengine::utils::detail::SeedWordCount<Engine>();
+        constexpr std::size_t n = detail::SeedWordCount<Engine>();
         std::vector<std::seed_seq::result_type> seedData;
         seedData.reserve(n);
 
@@ -253,7 +256,7 @@ namespace psygine::utilities::random
         {
             // advance state (golden ratio increment)
             state += 0x9E3779B97F4A7C15ULL;
-            const std::uint64_t z = psyengine::utils::detail::Mix64(state);
+            const std::uint64_t z = detail::Mix64(state);
             seedData.push_back(static_cast<std::uint32_t>(z)); // take 32-bit chunks
         }
 
@@ -285,7 +288,7 @@ namespace psygine::utilities::random
      */
     template <typename Engine, typename Range, typename THasher>
         requires (std::uniform_random_bit_generator<Engine> &&
-            psyengine::utils::detail::SeedSeqConstructibleOrSeedable<Engine> &&
+            detail::SeedSeqConstructibleOrSeedable<Engine> &&
             requires(const Range& r) { std::begin(r); std::end(r); } &&
             std::invocable<THasher, const std::ranges::range_value_t<Range>&>)
     [[nodiscard]] Engine MakeCustomSeededRngHashedRange(const Range& items, THasher elemHasher)
@@ -400,17 +403,47 @@ namespace psygine::utilities::random
         return dist(rng);
     }
 
-    // Random element selection
-    template <typename Container>
+    /**
+     * @brief Picks a uniformly random element of a non-empty range.
+     *
+     * Sized ranges draw one index and step to it, which is O(1) for random-access containers. Ranges
+     * without a size, such as `std::forward_list`, are walked once, keeping the i-th element with
+     * probability 1 / i, instead of being counted first.
+     *
+     * @param rng The engine to draw from.
+     * @param container The range to pick from; must not be empty.
+     * @return A reference to the picked element.
+     */
+    template <std::ranges::forward_range Container>
     [[nodiscard]] auto& RandomElement(auto& rng, Container& container)
     {
-        auto dist = std::uniform_int_distribution<std::size_t>(0, container.size() - 1);
-        auto it = std::begin(container);
-        std::advance(it, dist(rng));
-        return *it;
+        if constexpr (std::ranges::sized_range<Container>)
+        {
+            auto dist = std::uniform_int_distribution<std::size_t>(0, std::ranges::size(container) - 1);
+            return *std::ranges::next(std::ranges::begin(container),
+                                      static_cast<std::ranges::range_difference_t<Container>>(dist(rng)));
+        }
+        else
+        {
+            auto it = std::ranges::begin(container);
+            auto chosen = it;
+            std::size_t count = 1;
+            for (++it; it != std::ranges::end(container); ++it)
+            {
+                ++count;
+                if (std::uniform_int_distribution<std::size_t>(0, count - 1)(rng) == 0)
+                {
+                    chosen = it;
+                }
+            }
+            return *chosen;
+        }
     }
 
-    // Shuffle wrapper
+    /**
+     * @brief Shuffles the whole container. To pick k elements, `PartialShuffle` or `SampleIndices` in
+     * sampling.hpp only touch O(k) of them.
+     */
     template <typename Container>
     void Shuffle(auto& rng, Container& container)
     {
@@ -438,8 +471,8 @@ namespace psygine::utilities::random
         }
 
     private:
-        static thread_local std::mt19937_64 rng_;
-        static thread_local bool initialized_;
+        static inline thread_local std::mt19937_64 rng_;
+        static inline thread_local bool initialized_ = false;
     };
 
     // Convenience functions using global RNG
@@ -0,0 +1,624 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#ifndef PSYGINE_RANDOM_BULK_HPP
+#define PSYGINE_RANDOM_BULK_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <numbers>
+#include <random>
+#include <span>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+#include "random.hpp"
+#include "psygine/debug/assert.hpp"
+
+namespace psygine::utilities::random
+{
+    /**
+     * @brief Eight-lane xoshiro128++ engine laid out for SIMD generation.
+     *
+     * The engine keeps eight independent xoshiro128++ states in structure-of-arrays form and advances all
+     * of them in lockstep, producing eight 32-bit outputs per step. With AVX2 a step is a single 256-bit
+     * pass, with NEON it is two 128-bit passes and otherwise it is a plain loop the compiler can vectorize.
+     * All paths produce the exact same sequence, so a seed replays identically on every platform.
+     *
+     * It models `std::uniform_random_bit_generator` and can be seeded from a `std::seed_seq`, so it works with
+     * `MakeSeededRng`, `MakeCustomSeededRngHashed` and every helper in `random.hpp`. Bulk consumers should
+     * prefer `fill`, which writes whole blocks straight into the destination.
+     */
+    class SimdRng
+    {
+    public:
+        using result_type = std::uint32_t; // NOLINT(*-identifier-naming) - standard engine interface
+
+        static constexpr std::size_t LANES = 8;
+        static constexpr std::size_t state_size = 4 * LANES; // NOLINT(*-identifier-naming) - read by SeedWordCount
+
+        /**
+         * @brief Constructs the engine from a fixed default seed.
+         */
+        SimdRng()
+        {
+            seed(0x853C49E6748FEA9BULL);
+        }
+
+        /**
+         * @brief Constructs the engine from a 64-bit seed expanded with splitmix64.
+         *
+         * @param value The seed value.
+         */
+        explicit SimdRng(const std::uint64_t value)
+        {
+            seed(value);
+        }
+
+        /**
+         * @brief Constructs the engine from a seed sequence.
+         *
+         * @param seq The seed sequence providing `state_size` words of seed material.
+         */
+        explicit SimdRng(std::seed_seq& seq)
+        {
+            seed(seq);
+        }
+
+        [[nodiscard]] static constexpr result_type min()
+        {
+            return 0;
+        }
+
+        [[nodiscard]] static constexpr result_type max()
+        {
+            return std::numeric_limits<result_type>::max();
+        }
+
+        /**
+         * @brief Re-seeds every lane from a 64-bit value expanded with splitmix64.
+         *
+         * @param value The seed value.
+         */
+        void seed(std::uint64_t value)
+        {
+            std::array<std::uint32_t, state_size> words{};
+            for (auto& word : words)
+            {
+                value += 0x9E3779B97F4A7C15ULL;
+                word = static_cast<std::uint32_t>(detail::Mix64(value));
+            }
+            load(words);
+        }
+
+        /**
+         * @brief Re-seeds every lane from a seed sequence.
+         *
+         * @param seq The seed sequence providing `state_size` words of seed material.
+         */
+        void seed(std::seed_seq& seq)
+        {
+            std::array<std::uint32_t, state_size> words{};
+            seq.generate(words.begin(), words.end());
+            load(words);
+        }
+
+        /**
+         * @brief Returns the next 32-bit value of the interleaved lane stream.
+         */
+        result_type operator()()
+        {
+            if (cursor_ == LANES)
+            {
+                step(buffer_.data());
+                cursor_ = 0;
+            }
+            return buffer_[cursor_++];
+        }
+
+        /**
+         * @brief Fills a span with the next values of the stream.
+         *
+         * Produces the same values as calling `operator()` once per element, but generates whole
+         * blocks directly into the destination.
+         *
+         * @param out The destination span.
+         */
+        void fill(std::span<std::uint32_t> out)
+        {
+            std::size_t i = 0;
+            while (cursor_ < LANES && i < out.size())
+            {
+                out[i++] = buffer_[cursor_++];
+            }
+
+            for (; i + LANES <= out.size(); i += LANES)
+            {
+                step(out.data() + i);
+            }
+
+            if (i < out.size())
+            {
+                step(buffer_.data());
+                cursor_ = 0;
+                while (i < out.size())
+                {
+                    out[i++] = buffer_[cursor_++];
+                }
+            }
+        }
+
+        /**
+         * @brief Advances the engine by `count` values.
+         *
+         * @param count The number of values to skip.
+         */
+        void discard(unsigned long long count)
+        {
+            while (count-- > 0)
+            {
+                (void)(*this)();
+            }
+        }
+
+        friend bool operator==(const SimdRng& lhs, const SimdRng& rhs) = default;
+
+    private:
+        void load(const std::array<std::uint32_t, state_size>& words)
+        {
+            for (std::size_t lane = 0; lane < LANES; ++lane)
+            {
+                s0_[lane] = words[lane];
+                s1_[lane] = words[LANES + lane];
+                s2_[lane] = words[(2 * LANES) + lane];
+                s3_[lane] = words[(3 * LANES) + lane];
+
+                // An all-zero xoshiro state is a fixed point; nudge it onto a real orbit.
+                if ((s0_[lane] | s1_[lane] | s2_[lane] | s3_[lane]) == 0)
+                {
+                    s0_[lane] = static_cast<std::uint32_t>(0x9E3779B9U + lane);
+                }
+            }
+            cursor_ = LANES;
+        }
+
+        void step(std::uint32_t* out)
+        {
+#if defined(__AVX2__)
+            const auto rotl = [](const __m256i x, const int k)
+            {
+                return _mm256_or_si256(_mm256_slli_epi32(x, k), _mm256_srli_epi32(x, 32 - k));
+            };
+
+            __m256i s0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s0_.data()));
+            __m256i s1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s1_.data()));
+            __m256i s2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s2_.data()));
+            __m256i s3 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s3_.data()));
+
+            const __m256i result = _mm256_add_epi32(rotl(_mm256_add_epi32(s0, s3), 7), s0);
+            const __m256i t = _mm256_slli_epi32(s1, 9);
+            s2 = _mm256_xor_si256(s2, s0);
+            s3 = _mm256_xor_si256(s3, s1);
+            s1 = _mm256_xor_si256(s1, s2);
+            s0 = _mm256_xor_si256(s0, s3);
+            s2 = _mm256_xor_si256(s2, t);
+            s3 = rotl(s3, 11);
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), result);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(s0_.data()), s0);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(s1_.data()), s1);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(s2_.data()), s2);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(s3_.data()), s3);
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+            for (std::size_t half = 0; half < LANES; half += 4)
+            {
+                uint32x4_t s0 = vld1q_u32(s0_.data() + half);
+                uint32x4_t s1 = vld1q_u32(s1_.data() + half);
+                uint32x4_t s2 = vld1q_u32(s2_.data() + half);
+                uint32x4_t s3 = vld1q_u32(s3_.data() + half);
+
+                const uint32x4_t sum = vaddq_u32(s0, s3);
+                const uint32x4_t result = vaddq_u32(vsriq_n_u32(vshlq_n_u32(sum, 7), sum, 25), s0);
+                const uint32x4_t t = vshlq_n_u32(s1, 9);
+                s2 = veorq_u32(s2, s0);
+                s3 = veorq_u32(s3, s1);
+                s1 = veorq_u32(s1, s2);
+                s0 = veorq_u32(s0, s3);
+                s2 = veorq_u32(s2, t);
+                s3 = vsriq_n_u32(vshlq_n_u32(s3, 11), s3, 21);
+
+                vst1q_u32(out + half, result);
+                vst1q_u32(s0_.data() + half, s0);
+                vst1q_u32(s1_.data() + half, s1);
+                vst1q_u32(s2_.data() + half, s2);
+                vst1q_u32(s3_.data() + half, s3);
+            }
+#else
+            for (std::size_t lane = 0; lane < LANES; ++lane)
+            {
+                out[lane] = std::rotl(s0_[lane] + s3_[lane], 7) + s0_[lane];
+                const std::uint32_t t = s1_[lane] << 9;
+                s2_[lane] ^= s0_[lane];
+                s3_[lane] ^= s1_[lane];
+                s1_[lane] ^= s2_[lane];
+                s0_[lane] ^= s3_[lane];
+                s2_[lane] ^= t;
+                s3_[lane] = std::rotl(s3_[lane], 11);
+            }
+#endif
+        }
+
+        alignas(32) std::array<std::uint32_t, LANES> s0_{};
+        alignas(32) std::array<std::uint32_t, LANES> s1_{};
+        alignas(32) std::array<std::uint32_t, LANES> s2_{};
+        alignas(32) std::array<std::uint32_t, LANES> s3_{};
+        alignas(32) std::array<std::uint32_t, LANES> buffer_{};
+        std::size_t cursor_ = LANES;
+    };
+
+    /**
+     * @brief Creates a `SimdRng` seeded from `std::random_device`.
+     *
+     * @return A randomly seeded eight-lane engine.
+     */
+    inline auto MakeSimdRng()
+    {
+        return MakeSeededRng<SimdRng>();
+    }
+
+    /**
+     * @brief Creates a `SimdRng` deterministically seeded from a hashed user seed.
+     *
+     * @param seed The seed value used for initializing the random number generator.
+     * @param hasher The custom hash function used for seeding. Defaults to an empty instance of the specified type.
+     * @return A `SimdRng` initialized with the provided seed and hash function.
+     */
+    template <typename Seed, typename THasher = std::hash<Seed>>
+    auto MakeSimdRngCustomSeededHash(const Seed& seed, THasher hasher = {})
+    {
+        return MakeCustomSeededRngHashed<SimdRng, Seed, THasher>(seed, hasher);
+    }
+
+    namespace detail
+    {
+        // Values are generated in stack blocks of this size so raw bits stay in L1 while being converted.
+        inline constexpr std::size_t BULK_BLOCK_SIZE = 256;
+
+        /**
+         * @brief Concept for engines that can write a block of 32-bit values in one call.
+         */
+        template <typename Engine>
+        concept BulkEngine = requires(Engine& e, std::span<std::uint32_t> out)
+        {
+            e.fill(out);
+        };
+
+        /**
+         * @brief True when the engine yields uniformly distributed bits over its full `result_type` range.
+         */
+        template <typename Engine>
+        inline constexpr bool FULL_RANGE_V = Engine::min() == 0 &&
+            Engine::max() == std::numeric_limits<typename Engine::result_type>::max() &&
+            (std::numeric_limits<typename Engine::result_type>::digits == 32 ||
+                std::numeric_limits<typename Engine::result_type>::digits == 64);
+
+        /**
+         * @brief Fills a span with uniformly distributed 32-bit words from any engine.
+         *
+         * Engines with a `fill` member write the block directly, full-range 64-bit engines contribute two
+         * words per call and engines with an unusual output range fall back to `std::uniform_int_distribution`.
+         */
+        template <std::uniform_random_bit_generator Engine>
+        void FillBits(Engine& rng, std::span<std::uint32_t> out)
+        {
+            if constexpr (BulkEngine<Engine>)
+            {
+                rng.fill(out);
+            }
+            else if constexpr (FULL_RANGE_V<Engine> && std::numeric_limits<typename Engine::result_type>::digits == 64)
+            {
+                std::size_t i = 0;
+                for (; i + 2 <= out.size(); i += 2)
+                {
+                    const auto bits = static_cast<std::uint64_t>(rng());
+                    out[i] = static_cast<std::uint32_t>(bits);
+                    out[i + 1] = static_cast<std::uint32_t>(bits >> 32);
+                }
+                if (i < out.size())
+                {
+                    out[i] = static_cast<std::uint32_t>(rng() >> 32);
+                }
+            }
+            else if constexpr (FULL_RANGE_V<Engine>)
+            {
+                for (auto& word : out)
+                {
+                    word = static_cast<std::uint32_t>(rng());
+                }
+            }
+            else
+            {
+                std::uniform_int_distribution<std::uint32_t> dist;
+                for (auto& word : out)
+                {
+                    word = dist(rng);
+                }
+            }
+        }
+
+        /**
+         * @brief Fills a span with uniformly distributed 64-bit words from any engine.
+         */
+        template <std::uniform_random_bit_generator Engine>
+        void FillBits(Engine& rng, std::span<std::uint64_t> out)
+        {
+            if constexpr (FULL_RANGE_V<Engine> && std::numeric_limits<typename Engine::result_type>::digits == 64)
+            {
+                for (auto& word : out)
+                {
+                    word = static_cast<std::uint64_t>(rng());
+                }
+            }
+            else
+            {
+                std::array<std::uint32_t, 2 * BULK_BLOCK_SIZE> halves{};
+                for (std::size_t base = 0; base < out.size(); base += BULK_BLOCK_SIZE)
+                {
+                    const std::size_t n = std::min(BULK_BLOCK_SIZE, out.size() - base);
+                    FillBits(rng, std::span(halves.data(), 2 * n));
+                    for (std::size_t i = 0; i < n; ++i)
+                    {
+                        out[base + i] = static_cast<std::uint64_t>(halves[2 * i]) |
+                            (static_cast<std::uint64_t>(halves[(2 * i) + 1]) << 32);
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief Maps the top 24 bits of a word onto [0, 1) with a single multiply.
+         */
+        constexpr float BitsToUnitFloat(const std::uint32_t bits)
+        {
+            return static_cast<float>(bits >> 8) * 0x1.0p-24F;
+        }
+
+        /**
+         * @brief Maps the top 53 bits of a word onto [0, 1) with a single multiply.
+         */
+        constexpr double BitsToUnitDouble(const std::uint64_t bits)
+        {
+            return static_cast<double>(bits >> 11) * 0x1.0p-53;
+        }
+
+        /**
+         * @brief Fills `out` with uniform values in [0, 1) of type T, block by block.
+         */
+        template <std::floating_point T, std::uniform_random_bit_generator Engine>
+        void FillUnit(Engine& rng, std::span<T> out)
+        {
+            using Word = std::conditional_t<std::is_same_v<T, float>, std::uint32_t, std::uint64_t>;
+            std::array<Word, BULK_BLOCK_SIZE> bits{};
+
+            for (std::size_t base = 0; base < out.size(); base += BULK_BLOCK_SIZE)
+            {
+                const std::size_t n = std::min(BULK_BLOCK_SIZE, out.size() - base);
+                FillBits(rng, std::span(bits.data(), n));
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    if constexpr (std::is_same_v<T, float>)
+                    {
+                        out[base + i] = BitsToUnitFloat(bits[i]);
+                    }
+                    else
+                    {
+                        out[base + i] = static_cast<T>(BitsToUnitDouble(bits[i]));
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief Draws an unbiased index in [0, range) using Lemire's multiply-and-reject method.
+         *
+         * @param rng The engine to draw from.
+         * @param range The exclusive upper bound; must be non-zero.
+         */
+        template <std::uniform_random_bit_generator Engine>
+        std::uint32_t Bounded(Engine& rng, const std::uint32_t range)
+        {
+            std::uint32_t bits = 0;
+            FillBits(rng, std::span(&bits, 1));
+            std::uint64_t product = static_cast<std::uint64_t>(bits) * range;
+            if (static_cast<std::uint32_t>(product) < range)
+            {
+                const std::uint32_t threshold = (0U - range) % range;
+                while (static_cast<std::uint32_t>(product) < threshold)
+                {
+                    FillBits(rng, std::span(&bits, 1));
+                    product = static_cast<std::uint64_t>(bits) * range;
+                }
+            }
+            return static_cast<std::uint32_t>(product >> 32);
+        }
+    } // namespace detail
+
+    /**
+     * @brief Fills a span with uniformly distributed floating-point values in [min, max).
+     *
+     * Raw bits are generated a block at a time (vectorized when the engine is a `SimdRng`) and converted
+     * with a branch-free multiply, instead of constructing a `std::uniform_real_distribution` per value.
+     *
+     * @param rng The engine to draw from.
+     * @param out The destination span.
+     * @param min The inclusive lower bound.
+     * @param max The exclusive upper bound.
+     */
+    template <std::floating_point T, std::uniform_random_bit_generator Engine>
+    void Fill(Engine& rng, std::span<T> out, const T min = T{0}, const T max = T{1})
+    {
+        detail::FillUnit(rng, out);
+
+        const T range = max - min;
+        for (auto& value : out)
+        {
+            value = min + (range * value);
+        }
+    }
+
+    /**
+     * @brief Fills a span with uniformly distributed integers in [min, max].
+     *
+     * Ranges that fit in 32 bits use Lemire's multiply-shift reduction on bulk-generated words; the rare
+     * words that would introduce bias are redrawn, so the output is exactly uniform. Wider ranges fall back
+     * to `std::uniform_int_distribution`.
+     *
+     * @param rng The engine to draw from.
+     * @param out The destination span.
+     * @param min The inclusive lower bound.
+     * @param max The inclusive upper bound.
+     */
+    template <std::integral T, std::uniform_random_bit_generator Engine>
+        requires (!std::same_as<T, bool>)
+    void Fill(Engine& rng, std::span<T> out, const T min, const T max)
+    {
+        using Unsigned = std::make_unsigned_t<T>;
+        const auto spread = static_cast<std::uint64_t>(
+            static_cast<Unsigned>(static_cast<Unsigned>(max) - static_cast<Unsigned>(min)));
+
+        if constexpr (sizeof(T) >= sizeof(std::uint32_t))
+        {
+            if (spread >= std::numeric_limits<std::uint32_t>::max())
+            {
+                std::uniform_int_distribution<T> dist(min, max);
+                for (auto& value : out)
+                {
+                    value = dist(rng);
+                }
+                return;
+            }
+        }
+
+        const std::uint64_t range = spread + 1;
+        // 2^32 mod range: products whose low word falls below this are the biased ones.
+        const auto threshold = static_cast<std::uint32_t>((std::uint64_t{1} << 32) % range);
+        std::array<std::uint32_t, detail::BULK_BLOCK_SIZE> bits{};
+
+        for (std::size_t base = 0; base < out.size(); base += detail::BULK_BLOCK_SIZE)
+        {
+            const std::size_t n = std::min(detail::BULK_BLOCK_SIZE, out.size() - base);
+            detail::FillBits(rng, std::span(bits.data(), n));
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                std::uint64_t product = static_cast<std::uint64_t>(bits[i]) * range;
+                while (static_cast<std::uint32_t>(product) < threshold)
+                {
+                    std::uint32_t redraw = 0;
+                    detail::FillBits(rng, std::span(&redraw, 1));
+                    product = static_cast<std::uint64_t>(redraw) * range;
+                }
+                out[base + i] = static_cast<T>(static_cast<Unsigned>(min) + static_cast<Unsigned>(product >> 32));
+            }
+        }
+    }
+
+    /**
+     * @brief Fills a span with normally distributed values using the Box-Muller transform.
+     *
+     * Uniform inputs are produced in bulk and each pair is turned into two independent normal deviates.
+     *
+     * @param rng The engine to draw from.
+     * @param out The destination span.
+     * @param mean The mean of the distribution.
+     * @param stddev The standard deviation of the distribution.
+     */
+    template <std::floating_point T, std::uniform_random_bit_generator Engine>
+    void FillNormal(Engine& rng, std::span<T> out, const T mean = T{0}, const T stddev = T{1})
+    {
+        constexpr T twoPi = T{2} * std::numbers::pi_v<T>;
+        std::array<T, detail::BULK_BLOCK_SIZE> uniforms{};
+
+        for (std::size_t base = 0; base < out.size(); base += detail::BULK_BLOCK_SIZE)
+        {
+            const std::size_t n = std::min(detail::BULK_BLOCK_SIZE, out.size() - base);
+            const std::size_t pairs = (n + 1) / 2;
+            detail::FillUnit(rng, std::span(uniforms.data(), 2 * pairs));
+
+            for (std::size_t p = 0; p < pairs; ++p)
+            {
+                // 1 - u keeps the log argument in (0, 1].
+                const T radius = stddev * std::sqrt(T{-2} * std::log(T{1} - uniforms[2 * p]));
+                const T theta = twoPi * uniforms[(2 * p) + 1];
+                out[base + (2 * p)] = mean + (radius * std::cos(theta));
+                if ((2 * p) + 1 < n)
+                {
+                    out[base + (2 * p) + 1] = mean + (radius * std::sin(theta));
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Fills structure-of-arrays spans with uniformly distributed 2D unit vectors.
+     *
+     * @param rng The engine to draw from.
+     * @param xs Destination for the x components.
+     * @param ys Destination for the y components; must be the same size as `xs`.
+     */
+    template <std::floating_point T, std::uniform_random_bit_generator Engine>
+    void FillUnitVectors(Engine& rng, std::span<T> xs, std::span<T> ys)
+    {
+        PSYGINE_DEBUG_ASSERT(xs.size() == ys.size(), "FillUnitVectors: component spans must have the same size");
+
+        detail::FillUnit(rng, xs);
+        constexpr T twoPi = T{2} * std::numbers::pi_v<T>;
+        for (std::size_t i = 0; i < xs.size(); ++i)
+        {
+            const T theta = twoPi * xs[i];
+            xs[i] = std::cos(theta);
+            ys[i] = std::sin(theta);
+        }
+    }
+
+    /**
+     * @brief Fills structure-of-arrays spans with uniformly distributed 3D unit vectors.
+     *
+     * Uses Archimedes' projection: z is uniform in [-1, 1) and the azimuth is uniform, which is
+     * uniform on the sphere without any rejection loop.
+     *
+     * @param rng The engine to draw from.
+     * @param xs Destination for the x components.
+     * @param ys Destination for the y components; must be the same size as `xs`.
+     * @param zs Destination for the z components; must be the same size as `xs`.
+     */
+    template <std::floating_point T, std::uniform_random_bit_generator Engine>
+    void FillUnitVectors(Engine& rng, std::span<T> xs, std::span<T> ys, std::span<T> zs)
+    {
+        PSYGINE_DEBUG_ASSERT(xs.size() == ys.size() && xs.size() == zs.size(),
+                             "FillUnitVectors: component spans must have the same size");
+
+        detail::FillUnit(rng, xs);
+        detail::FillUnit(rng, zs);
+        constexpr T twoPi = T{2} * std::numbers::pi_v<T>;
+        for (std::size_t i = 0; i < xs.size(); ++i)
+        {
+            const T z = (T{2} * zs[i]) - T{1};
+            const T radius = std::sqrt(std::max(T{0}, T{1} - (z * z)));
+            const T phi = twoPi * xs[i];
+            xs[i] = radius * std::cos(phi);
+            ys[i] = radius * std::sin(phi);
+            zs[i] = z;
+        }
+    }
+}
+
+#endif //PSYGINE_RANDOM_BULK_HPP
@@ -0,0 +1,26 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#include "sampling.hpp"
+
+#include <cmath>
+
+namespace psygine::utilities::random::detail
+{
+    double ReservoirWeight(const double weight, const std::size_t capacity, const double u)
+    {
+        return weight * Exp(Log(u) / static_cast<double>(capacity));
+    }
+
+    std::uint64_t ReservoirSkip(const double weight, const double u)
+    {
+        // Both logarithms are non-positive; a zero denominator means the weight is too small to ever
+        // accept again within 64 bits of items.
+        const double gap = std::floor(Log(u) / Log(1.0 - weight));
+        if (!(gap >= 0.0 && gap < 0x1.0p64))
+        {
+            return std::numeric_limits<std::uint64_t>::max();
+        }
+        return static_cast<std::uint64_t>(gap);
+    }
+}
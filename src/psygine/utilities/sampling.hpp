@@ -0,0 +1,338 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#ifndef PSYGINE_SAMPLING_HPP
+#define PSYGINE_SAMPLING_HPP
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <ranges>
+#include <span>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "distributions.hpp"
+#include "random_bulk.hpp"
+#include "psygine/debug/assert.hpp"
+
+namespace psygine::utilities::random
+{
+    namespace detail
+    {
+        // Below this many picks a linear scan of the picked indices beats hashing them.
+        inline constexpr std::size_t FLOYD_LINEAR_SCAN_LIMIT = 64;
+
+        /**
+         * @brief Draws an unbiased index in [0, range) for any size, using Lemire's method below 2^32.
+         *
+         * @param rng The engine to draw from.
+         * @param range The exclusive upper bound; must be non-zero.
+         */
+        template <std::uniform_random_bit_generator Engine>
+        std::size_t BoundedIndex(Engine& rng, const std::size_t range)
+        {
+            if (range <= std::numeric_limits<std::uint32_t>::max())
+            {
+                return Bounded(rng, static_cast<std::uint32_t>(range));
+            }
+            std::uniform_int_distribution<std::size_t> dist(0, range - 1);
+            return dist(rng);
+        }
+
+        // Algorithm L steps, out of line in sampling.cpp so the skips are identical on every platform.
+
+        /**
+         * @brief The reservoir's acceptance weight after one more accepted item: `weight * u^(1 / capacity)`.
+         */
+        [[nodiscard]] double ReservoirWeight(double weight, std::size_t capacity, double u);
+
+        /**
+         * @brief How many items to pass over before the next accepted one: `floor(log(u) / log(1 - weight))`.
+         *
+         * Saturates at the largest `std::uint64_t` when the gap is too large to represent.
+         */
+        [[nodiscard]] std::uint64_t ReservoirSkip(double weight, double u);
+    } // namespace detail
+
+    /**
+     * @brief Fixed-size uniform sample over a stream of unknown length (Li's Algorithm L).
+     *
+     * The first `capacity` items are kept as-is. After that the reservoir draws how many items to pass
+     * over before the next replacement, so it spends O(capacity * (1 + log(n / capacity))) random draws
+     * on n items instead of one per item. Producers can query `pending()` and call `skip()` to avoid
+     * building items that would be thrown away.
+     *
+     * @tparam T The item type.
+     */
+    template <typename T>
+    class Reservoir
+    {
+    public:
+        /**
+         * @brief Constructs an empty reservoir.
+         *
+         * @param capacity The number of items to keep; must be non-zero.
+         */
+        explicit Reservoir(const std::size_t capacity) :
+            capacity_{capacity}
+        {
+            PSYGINE_ASSERT(capacity > 0, "Reservoir: capacity must be non-zero");
+            samples_.reserve(capacity);
+        }
+
+        /**
+         * @brief Offers the next item of the stream.
+         *
+         * @param rng The engine to draw from.
+         * @param value The item; only copied or moved when it is accepted.
+         */
+        template <std::uniform_random_bit_generator Engine, typename U>
+            requires std::constructible_from<T, U&&> && std::assignable_from<T&, U&&>
+        void push(Engine& rng, U&& value)
+        {
+            if (samples_.size() < capacity_)
+            {
+                samples_.emplace_back(std::forward<U>(value));
+                if (samples_.size() == capacity_)
+                {
+                    weight_ = 1.0;
+                    advance(rng);
+                }
+            }
+            else if (pending_ == 0)
+            {
+                samples_[detail::BoundedIndex(rng, capacity_)] = std::forward<U>(value);
+                advance(rng);
+            }
+            else
+            {
+                --pending_;
+            }
+            ++seen_;
+        }
+
+        /**
+         * @brief Number of upcoming items that will be passed over without being looked at.
+         */
+        [[nodiscard]] std::uint64_t pending() const
+        {
+            return pending_;
+        }
+
+        /**
+         * @brief Accounts for `count` items that were passed over without calling `push`.
+         *
+         * @param count The number of items skipped; at most `pending()`.
+         */
+        void skip(const std::uint64_t count)
+        {
+            PSYGINE_DEBUG_ASSERT(count <= pending_, "Reservoir: skipped past an accepted item");
+            pending_ -= count;
+            seen_ += count;
+        }
+
+        /**
+         * @brief The current sample, in no particular order. Holds `min(capacity(), seen())` items.
+         */
+        [[nodiscard]] std::span<const T> samples() const
+        {
+            return samples_;
+        }
+
+        /**
+         * @brief Moves the sample out and resets the reservoir.
+         */
+        [[nodiscard]] std::vector<T> release()
+        {
+            std::vector<T> result = std::move(samples_);
+            clear();
+            return result;
+        }
+
+        [[nodiscard]] std::size_t capacity() const
+        {
+            return capacity_;
+        }
+
+        [[nodiscard]] std::uint64_t seen() const
+        {
+            return seen_;
+        }
+
+        /**
+         * @brief Empties the reservoir so it can sample a new stream.
+         */
+        void clear()
+        {
+            samples_.clear();
+            samples_.reserve(capacity_);
+            seen_ = 0;
+            pending_ = 0;
+            weight_ = 1.0;
+        }
+
+    private:
+        template <std::uniform_random_bit_generator Engine>
+        void advance(Engine& rng)
+        {
+            weight_ = detail::ReservoirWeight(weight_, capacity_, detail::NextUnitOpen(rng));
+            pending_ = detail::ReservoirSkip(weight_, detail::NextUnitOpen(rng));
+        }
+
+        std::size_t capacity_;
+        std::vector<T> samples_;
+        std::uint64_t seen_ = 0;
+        std::uint64_t pending_ = 0;
+        double weight_ = 1.0;
+    };
+
+    /**
+     * @brief Picks `count` items uniformly from a range in a single pass.
+     *
+     * Works on input ranges of unknown length. Skipped stretches are stepped over with
+     * `std::ranges::advance`, which is O(1) on random-access ranges, so only the accepted items are
+     * ever dereferenced.
+     *
+     * @param rng The engine to draw from.
+     * @param range The items to sample.
+     * @param count The sample size; fewer items are returned when the range is shorter.
+     * @return The sampled items, in no particular order.
+     */
+    template <std::uniform_random_bit_generator Engine, std::ranges::input_range Range>
+    [[nodiscard]] std::vector<std::ranges::range_value_t<Range>> ReservoirSample(Engine& rng, Range&& range,
+                                                                                 const std::size_t count)
+    {
+        using Difference = std::ranges::range_difference_t<Range>;
+
+        Reservoir<std::ranges::range_value_t<Range>> reservoir(count);
+        auto it = std::ranges::begin(range);
+        const auto end = std::ranges::end(range);
+        while (it != end)
+        {
+            if (const std::uint64_t pending = reservoir.pending(); pending > 0)
+            {
+                const auto step = static_cast<Difference>(
+                    std::min<std::uint64_t>(pending, static_cast<std::uint64_t>(std::numeric_limits<Difference>::max())));
+                const Difference missed = std::ranges::advance(it, step, end);
+                reservoir.skip(static_cast<std::uint64_t>(step - missed));
+                continue;
+            }
+            reservoir.push(rng, *it);
+            ++it;
+        }
+        return reservoir.release();
+    }
+
+    /**
+     * @brief Draws `count` distinct indices from [0, n) with Floyd's algorithm.
+     *
+     * Costs O(count) draws and memory regardless of n. When more than half of the indices are wanted
+     * it switches to a partial shuffle of [0, n), which is cheaper at that point.
+     *
+     * @param rng The engine to draw from.
+     * @param n The exclusive upper bound.
+     * @param count The number of indices; at most `n`.
+     * @return The indices. Floyd's order is not uniformly random; shuffle the result if order matters.
+     */
+    template <std::uniform_random_bit_generator Engine>
+    [[nodiscard]] std::vector<std::size_t> SampleIndices(Engine& rng, const std::size_t n, const std::size_t count)
+    {
+        PSYGINE_ASSERT(count <= n, "SampleIndices: count exceeds the population");
+
+        std::vector<std::size_t> picked;
+        if (count > n / 2)
+        {
+            picked.resize(n);
+            std::iota(picked.begin(), picked.end(), std::size_t{0});
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                std::swap(picked[i], picked[i + detail::BoundedIndex(rng, n - i)]);
+            }
+            picked.resize(count);
+            return picked;
+        }
+
+        picked.reserve(count);
+        if (count <= detail::FLOYD_LINEAR_SCAN_LIMIT)
+        {
+            for (std::size_t j = n - count; j < n; ++j)
+            {
+                const std::size_t t = detail::BoundedIndex(rng, j + 1);
+                picked.push_back(std::ranges::find(picked, t) == picked.end() ? t : j);
+            }
+            return picked;
+        }
+
+        std::unordered_set<std::size_t> seen;
+        seen.reserve(count);
+        for (std::size_t j = n - count; j < n; ++j)
+        {
+            const std::size_t t = detail::BoundedIndex(rng, j + 1);
+            const std::size_t pick = seen.contains(t) ? j : t;
+            seen.insert(pick);
+            picked.push_back(pick);
+        }
+        return picked;
+    }
+
+    /**
+     * @brief Copies `count` distinct elements chosen uniformly from a sized random-access range.
+     *
+     * @param rng The engine to draw from.
+     * @param range The population.
+     * @param count The sample size; at most the size of the range.
+     * @return The sampled elements, in no particular order.
+     */
+    template <std::uniform_random_bit_generator Engine, std::ranges::random_access_range Range>
+        requires std::ranges::sized_range<Range>
+    [[nodiscard]] std::vector<std::ranges::range_value_t<Range>> Sample(Engine& rng, Range&& range,
+                                                                        const std::size_t count)
+    {
+        const auto first = std::ranges::begin(range);
+        std::vector<std::ranges::range_value_t<Range>> result;
+        result.reserve(count);
+        for (const std::size_t index : SampleIndices(rng, static_cast<std::size_t>(std::ranges::size(range)), count))
+        {
+            result.push_back(first[static_cast<std::ranges::range_difference_t<Range>>(index)]);
+        }
+        return result;
+    }
+
+    /**
+     * @brief Fisher-Yates shuffle that stops after the first `count` positions.
+     *
+     * Afterwards the first `count` elements are a uniformly random selection in uniformly random order;
+     * the rest of the range holds the remaining elements in unspecified order. Only O(count) elements are
+     * touched, against O(n) for `Shuffle`.
+     *
+     * @param rng The engine to draw from.
+     * @param range The elements to shuffle in place.
+     * @param count The number of positions to fill; clamped to the size of the range.
+     * @return An iterator past the shuffled prefix.
+     */
+    template <std::uniform_random_bit_generator Engine, std::ranges::random_access_range Range>
+        requires std::ranges::sized_range<Range> && std::permutable<std::ranges::iterator_t<Range>>
+    std::ranges::borrowed_iterator_t<Range> PartialShuffle(Engine& rng, Range&& range, const std::size_t count)
+    {
+        using Difference = std::ranges::range_difference_t<Range>;
+
+        const auto first = std::ranges::begin(range);
+        const auto n = static_cast<std::size_t>(std::ranges::size(range));
+        const std::size_t prefix = std::min(count, n);
+        for (std::size_t i = 0; i < prefix; ++i)
+        {
+            const std::size_t j = i + detail::BoundedIndex(rng, n - i);
+            std::ranges::iter_swap(first + static_cast<Difference>(i), first + static_cast<Difference>(j));
+        }
+        return first + static_cast<Difference>(prefix);
+    }
+}
+
+#endif //PSYGINE_SAMPLING_HPP
@@ -0,0 +1,979 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#ifndef PSYGINE_SIMD_HPP
+#define PSYGINE_SIMD_HPP
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+
+namespace psygine::utilities::simd
+{
+    /**
+     * @brief Widest lane count with a dedicated backend for the current target.
+     *
+     * AVX2 builds use 8 lanes and SSE4.1 builds 4 lanes. Everything else uses the generic 4-lane
+     * backend, a fixed-size array loop that compilers lower to NEON or SSE2 on their own.
+     */
+#if defined(__AVX2__)
+    inline constexpr std::size_t NATIVE_WIDTH = 8;
+#else
+    inline constexpr std::size_t NATIVE_WIDTH = 4;
+#endif
+
+    /**
+     * @brief A pack of `W` floats.
+     *
+     * The generic version stores a plain array; it is used for single-lane evaluation and on targets
+     * without a dedicated backend. Every operation is lane-wise IEEE arithmetic without contraction,
+     * so all backends produce bit-identical results for the same inputs.
+     */
+    template <std::size_t W>
+    struct Float
+    {
+        std::array<float, W> v{};
+
+        Float() = default;
+
+        Float(const float s) // NOLINT(*-explicit-constructor) - broadcast reads like a scalar
+        {
+            v.fill(s);
+        }
+    };
+
+    /**
+     * @brief A pack of `W` signed 32-bit integers, also used as the lane mask type (all bits set = true).
+     */
+    template <std::size_t W>
+    struct Int
+    {
+        std::array<std::int32_t, W> v{};
+
+        Int() = default;
+
+        Int(const std::int32_t s) // NOLINT(*-explicit-constructor) - broadcast reads like a scalar
+        {
+            v.fill(s);
+        }
+    };
+
+    namespace detail
+    {
+        constexpr std::int32_t MaskOf(const bool b)
+        {
+            return b ? -1 : 0;
+        }
+
+        constexpr std::uint32_t Bits(const std::int32_t x)
+        {
+            return static_cast<std::uint32_t>(x);
+        }
+
+        constexpr std::int32_t Wrap(const std::uint32_t x)
+        {
+            return static_cast<std::int32_t>(x);
+        }
+    } // namespace detail
+
+    // ---------------- Generic backend ----------------
+
+    template <std::size_t W>
+    Float<W> Load(const float* p, Float<W>)
+    {
+        Float<W> r;
+        for (std::size_t i = 0; i < W; ++i)
+        {
+            r.v[i] = p[i];
+        }
+        return r;
+    }
+
+    template <std::size_t W>
+    Int<W> Load(const std::int32_t* p, Int<W>)
+    {
+        Int<W> r;
+        for (std::size_t i = 0; i < W; ++i)
+        {
+            r.v[i] = p[i];
+        }
+        return r;
+    }
+
+    template <std::size_t W>
+    void Store(float* p, const Float<W>& a)
+    {
+        for (std::size_t i = 0; i < W; ++i)
+        {
+            p[i] = a.v[i];
+        }
+    }
+
+    template <std::size_t W>
+    void Store(std::int32_t* p, const Int<W>& a)
+    {
+        for (std::size_t i = 0; i < W; ++i)
+        {
+            p[i] = a.v[i];
+        }
+    }
+
+    template <std::size_t W>
+    Float<W> operator+(const Float<W>& a, const Float<W>& b)
+    {
+        Float<W> r;
+        for (std::size_t i = 0; i < W; ++i)
+        {
+            r.v[i] = a.v[i] + b.v[i];
+        }
+        return r;
+    }
+
+    template <std::size_t W>
+    Float<W> operator-(const Float<W>& a, const Float<W>& b)
+    {
+        Float<W> r;
+        for (std::size_t i = 0; i < W; ++i)
+        {
+            r.v[i] = a.v[i] - b.v[i];
+        }
+        return r;
+    }
+
+    template <std::size_t W>
+    Float<W> operator*(const Float<W>& a, const Float<W>& b)
+    {
+        Float<W> r;
+        for (std::size_t i = 0; i < W; ++i)
+        {
+            r.v[i] = a.v[i] * b.v[i];
+        }
+        return r;
+    }
+
+    template <std::size_t W>
+    Float<W> operator/(const Float<W>& a, const Float<W>& b)
+    {
+        Float<W> r;
+        for (std::size_t i = 0; i < W; ++i)
+        {
+            r.v[i] = a.v[i] / b.v[i];
+        }
+        return r;
+    }
+
+    template <std::size_t W>
+    Float<W> operator-(const Float<W>& a)
+    {
+        Float<W> r;
+        for (std::size_t i = 0; i < W; ++i)
+        {
+            r.v[i] = -a.v[i];
+        }
+        return r;
+    }
+
+    // Same operand semantics as minps: b unless a < b.
+    template <std::size_t W>
+    Float<W> Min(const Float<W>& a, const Float<W>& b)
+    {
+        Float<W> r;
+        for (std::size_t i = 0; i < W; ++i)
+        {
+            r.v[i] = a.v[i] < b.v[i] ? a.v[i] : b.v[i];
+        }
+        return r;
+    }
+
+    // Same operand semantics as maxps: b unless a > b.
+    template <std::size_t W>
+    Float<W> Max(const Float<W>& a, const Float<W>& b)
+    {
+        Float<W> r;
+        for (std::size_t i = 0; i < W; ++i)
+        {
+            r.v[i] = a.v[i] > b.v[i] ? a.v[i] : b.v[i];
+        }
+        return r;
+    }
+
+    template <std::size_t W>
+    Float<W> Floor(const Float<W>& a)
+    {
+        Float<W> r;
+        for (std::size_t i = 0; i < W; ++i)
+        {
+            r.v[i] = std::floor(a.v[i]);
+        }
+        return r;
+    }
+
+    template <std::size_t W>
+    Float<W> Abs(const Float<W>& a)
+    {
+        Float<W> r;
+        for (std::size_t i = 0; i < W; ++i)
+        {
+            r.v[i] = std::fabs(a.v[i]);
+        }
+        return r;
+    }
+
+    template <std::size_t W>
+    Float<W> Sqrt(const Float<W>& a)
+    {
+        Float<W> r;
+        for (std::size_t i = 0; i < W; ++i)
+        {
+            r.v[i] = std::sqrt(a.v[i]);
+        }
+        return r;
+    }
+
+    template <std::size_t W>
+    Int<W> operator<(const Float<W>& a, const Float<W>& b)
+    {
+        Int<W> r;
+        for (std::size_t i = 0; i < W; ++i)
+        {
+            r.v[i] = detail::MaskOf(a.v[i] < b.v[i]);
+        }
+        return r;
+    }
+
+    template <std::size_t W>
+    Int<W> operator>(const Float<W>& a, const Float<W>& b)
+    {
+        Int<W> r;
+        for (std::size_t i = 0; i < W; ++i)
+        {
+            r.v[i] = detail::MaskOf(a.v[i] > b.v[i]);
+        }
+        return r;
+    }
+
+    template <std::size_t W>
+    Int<W> operator>=(const Float<W>& a, const Float<W>& b)
+    {
+        Int<W> r;
+        for (std::size_t i = 0; i < W; ++i)
+        {
+            r.v[i] = detail::MaskOf(a.v[i] >= b.v[i]);
+        }
+        return r;
+    }
+
+    template <std::size_t W>
+    Int<W> operator<=(const Float<W>& a, const Float<W>& b)
+    {
+        Int<W> r;
+        for (std::size_t i = 0; i < W; ++i)
+        {
+            r.v[i] = detail::MaskOf(a.v[i] <= b.v[i]);
+        }
+        return r;
+    }
+
+    /**
+     * @brief Lane-wise `mask ? a : b`.
+     */
+    template <std::size_t W>
+    Float<W> Select(const Int<W>& mask, const Float<W>& a, const Float<W>& b)
+    {
+        Float<W> r;
+        for (std::size_t i = 0; i < W; ++i)
+        {
+            r.v[i] = mask.v[i] != 0 ? a.v[i] : b.v[i];
+        }
+        return r;
+    }
+
+    /**
+     * @brief Lane-wise `mask ? a : b`.
+     */
+    template <std::size_t W>
+    Int<W> Select(const Int<W>& mask, const Int<W>& a, const Int<W>& b)
+    {
+        Int<W> r;
+        for (std::size_t i = 0; i < W; ++i)
+        {
+            r.v[i] = mask.v[i] != 0 ? a.v[i] : b.v[i];
+        }
+        return r;
+    }
+
+    /**
+     * @brief Truncating float to int conversion.
+     */
+    template <std::size_t W>
+    Int<W> ToInt(const Float<W>& a)
+    {
+        Int<W> r;
+        for (std::size_t i = 0; i < W; ++i)
+        {
+            r.v[i] = static_cast<std::int32_t>(a.v[i]);
+        }
+        return r;
+    }
+
+    template <std::size_t W>
+    Float<W> ToFloat(const Int<W>& a)
+    {
+        Float<W> r;
+        for (std::size_t i = 0; i < W; ++i)
+        {
+            r.v[i] = static_cast<float>(a.v[i]);
+        }
+        return r;
+    }
+
+    template <std::size_t W>
+    Int<W> operator+(const Int<W>& a, const Int<W>& b)
+    {
+        Int<W> r;
+        for (std::size_t i = 0; i < W; ++i)
+        {
+            r.v[i] = detail::Wrap(detail::Bits(a.v[i]) + detail::Bits(b.v[i]));
+        }
+        return r;
+    }
+
+    template <std::size_t W>
+    Int<W> operator-(const Int<W>& a, const Int<W>& b)
+    {
+        Int<W> r;
+        for (std::size_t i = 0; i < W; ++i)
+        {
+            r.v[i] = detail::Wrap(detail::Bits(a.v[i]) - detail::Bits(b.v[i]));
+        }
+        return r;
+    }
+
+    // Wrapping 32-bit multiply, like pmulld.
+    template <std::size_t W>
+    Int<W> operator*(const Int<W>& a, const Int<W>& b)
+    {
+        Int<W> r;
+        for (std::size_t i = 0; i < W; ++i)
+        {
+            r.v[i] = detail::Wrap(detail::Bits(a.v[i]) * detail::Bits(b.v[i]));
+        }
+        return r;
+    }
+
+    /**
+     * @brief Lane-wise `(a * b + 2^(n - 1)) >> n` on the exact 64-bit product, keeping the low 32 bits:
+     * a fixed-point multiply with `n` fraction bits, rounding halves up. `n` is in [1, 32].
+     */
+    template <std::size_t W>
+    Int<W> MultiplyRoundShift(const Int<W>& a, const Int<W>& b, const int n)
+    {
+        Int<W> r;
+        for (std::size_t i = 0; i < W; ++i)
+        {
+            const std::int64_t product = (std::int64_t{a.v[i]} * b.v[i]) + (std::int64_t{1} << (n - 1));
+            r.v[i] = detail::Wrap(static_cast<std::uint32_t>(static_cast<std::uint64_t>(product) >> n));
+        }
+        return r;
+    }
+
+    template <std::size_t W>
+    Int<W> operator&(const Int<W>& a, const Int<W>& b)
+    {
+        Int<W> r;
+        for (std::size_t i = 0; i < W; ++i)
+        {
+            r.v[i] = a.v[i] & b.v[i];
+        }
+        return r;
+    }
+
+    template <std::size_t W>
+    Int<W> operator|(const Int<W>& a, const Int<W>& b)
+    {
+        Int<W> r;
+        for (std::size_t i = 0; i < W; ++i)
+        {
+            r.v[i] = a.v[i] | b.v[i];
+        }
+        return r;
+    }
+
+    template <std::size_t W>
+    Int<W> operator^(const Int<W>& a, const Int<W>& b)
+    {
+        Int<W> r;
+        for (std::size_t i = 0; i < W; ++i)
+        {
+            r.v[i] = a.v[i] ^ b.v[i];
+        }
+        return r;
+    }
+
+    // ~a & b, same operand order as pandn.
+    template <std::size_t W>
+    Int<W> AndNot(const Int<W>& a, const Int<W>& b)
+    {
+        Int<W> r;
+        for (std::size_t i = 0; i < W; ++i)
+        {
+            r.v[i] = ~a.v[i] & b.v[i];
+        }
+        return r;
+    }
+
+    template <std::size_t W>
+    Int<W> ShiftLeft(const Int<W>& a, const int n)
+    {
+        Int<W> r;
+        for (std::size_t i = 0; i < W; ++i)
+        {
+            r.v[i] = detail::Wrap(detail::Bits(a.v[i]) << n);
+        }
+        return r;
+    }
+
+    template <std::size_t W>
+    Int<W> ShiftRightLogical(const Int<W>& a, const int n)
+    {
+        Int<W> r;
+        for (std::size_t i = 0; i < W; ++i)
+        {
+            r.v[i] = detail::Wrap(detail::Bits(a.v[i]) >> n);
+        }
+        return r;
+    }
+
+    template <std::size_t W>
+    Int<W> operator==(const Int<W>& a, const Int<W>& b)
+    {
+        Int<W> r;
+        for (std::size_t i = 0; i < W; ++i)
+        {
+            r.v[i] = detail::MaskOf(a.v[i] == b.v[i]);
+        }
+        return r;
+    }
+
+    template <std::size_t W>
+    Int<W> operator>(const Int<W>& a, const Int<W>& b)
+    {
+        Int<W> r;
+        for (std::size_t i = 0; i < W; ++i)
+        {
+            r.v[i] = detail::MaskOf(a.v[i] > b.v[i]);
+        }
+        return r;
+    }
+
+    template <std::size_t W>
+    Int<W> operator<(const Int<W>& a, const Int<W>& b)
+    {
+        Int<W> r;
+        for (std::size_t i = 0; i < W; ++i)
+        {
+            r.v[i] = detail::MaskOf(a.v[i] < b.v[i]);
+        }
+        return r;
+    }
+
+    /**
+     * @brief Loads `table[index]` for every lane.
+     */
+    template <std::size_t W>
+    Int<W> Gather(const std::int32_t* table, const Int<W>& index)
+    {
+        Int<W> r;
+        for (std::size_t i = 0; i < W; ++i)
+        {
+            r.v[i] = table[index.v[i]];
+        }
+        return r;
+    }
+
+    /**
+     * @brief One bit per lane, set where the lane's sign bit is: bit `i` is lane `i` of a mask.
+     */
+    template <std::size_t W>
+    std::uint32_t MoveMask(const Int<W>& mask)
+    {
+        std::uint32_t bits = 0;
+        for (std::size_t i = 0; i < W; ++i)
+        {
+            bits |= (detail::Bits(mask.v[i]) >> 31) << i;
+        }
+        return bits;
+    }
+
+    // ---------------- SSE4.1 backend ----------------
+#if defined(__SSE4_1__) && !defined(__AVX2__)
+    template <>
+    struct Float<4>
+    {
+        __m128 v;
+
+        Float() :
+            v(_mm_setzero_ps())
+        {}
+
+        Float(const float s) : // NOLINT(*-explicit-constructor) - broadcast reads like a scalar
+            v(_mm_set1_ps(s))
+        {}
+
+        explicit Float(const __m128 x) :
+            v(x)
+        {}
+    };
+
+    template <>
+    struct Int<4>
+    {
+        __m128i v;
+
+        Int() :
+            v(_mm_setzero_si128())
+        {}
+
+        Int(const std::int32_t s) : // NOLINT(*-explicit-constructor) - broadcast reads like a scalar
+            v(_mm_set1_epi32(s))
+        {}
+
+        explicit Int(const __m128i x) :
+            v(x)
+        {}
+    };
+
+    using F4 = Float<4>;
+    using I4 = Int<4>;
+
+    inline F4 Load(const float* p, F4)
+    {
+        return F4(_mm_loadu_ps(p));
+    }
+
+    inline I4 Load(const std::int32_t* p, I4)
+    {
+        return I4(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+    }
+
+    inline void Store(float* p, const F4& a)
+    {
+        _mm_storeu_ps(p, a.v);
+    }
+
+    inline void Store(std::int32_t* p, const I4& a)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p), a.v);
+    }
+
+    inline F4 operator+(const F4& a, const F4& b)
+    {
+        return F4(_mm_add_ps(a.v, b.v));
+    }
+
+    inline F4 operator-(const F4& a, const F4& b)
+    {
+        return F4(_mm_sub_ps(a.v, b.v));
+    }
+
+    inline F4 operator*(const F4& a, const F4& b)
+    {
+        return F4(_mm_mul_ps(a.v, b.v));
+    }
+
+    inline F4 operator/(const F4& a, const F4& b)
+    {
+        return F4(_mm_div_ps(a.v, b.v));
+    }
+
+    inline F4 operator-(const F4& a)
+    {
+        return F4(_mm_xor_ps(a.v, _mm_set1_ps(-0.0F)));
+    }
+
+    inline F4 Min(const F4& a, const F4& b)
+    {
+        return F4(_mm_min_ps(a.v, b.v));
+    }
+
+    inline F4 Max(const F4& a, const F4& b)
+    {
+        return F4(_mm_max_ps(a.v, b.v));
+    }
+
+    inline F4 Floor(const F4& a)
+    {
+        return F4(_mm_floor_ps(a.v));
+    }
+
+    inline F4 Abs(const F4& a)
+    {
+        return F4(_mm_andnot_ps(_mm_set1_ps(-0.0F), a.v));
+    }
+
+    inline F4 Sqrt(const F4& a)
+    {
+        return F4(_mm_sqrt_ps(a.v));
+    }
+
+    inline I4 operator<(const F4& a, const F4& b)
+    {
+        return I4(_mm_castps_si128(_mm_cmplt_ps(a.v, b.v)));
+    }
+
+    inline I4 operator>(const F4& a, const F4& b)
+    {
+        return I4(_mm_castps_si128(_mm_cmpgt_ps(a.v, b.v)));
+    }
+
+    inline I4 operator>=(const F4& a, const F4& b)
+    {
+        return I4(_mm_castps_si128(_mm_cmpge_ps(a.v, b.v)));
+    }
+
+    inline I4 operator<=(const F4& a, const F4& b)
+    {
+        return I4(_mm_castps_si128(_mm_cmple_ps(a.v, b.v)));
+    }
+
+    inline F4 Select(const I4& mask, const F4& a, const F4& b)
+    {
+        return F4(_mm_blendv_ps(b.v, a.v, _mm_castsi128_ps(mask.v)));
+    }
+
+    inline I4 Select(const I4& mask, const I4& a, const I4& b)
+    {
+        return I4(_mm_blendv_epi8(b.v, a.v, mask.v));
+    }
+
+    inline I4 ToInt(const F4& a)
+    {
+        return I4(_mm_cvttps_epi32(a.v));
+    }
+
+    inline F4 ToFloat(const I4& a)
+    {
+        return F4(_mm_cvtepi32_ps(a.v));
+    }
+
+    inline I4 operator+(const I4& a, const I4& b)
+    {
+        return I4(_mm_add_epi32(a.v, b.v));
+    }
+
+    inline I4 operator-(const I4& a, const I4& b)
+    {
+        return I4(_mm_sub_epi32(a.v, b.v));
+    }
+
+    inline I4 operator*(const I4& a, const I4& b)
+    {
+        return I4(_mm_mullo_epi32(a.v, b.v));
+    }
+
+    // pmuldq multiplies the even lanes; the odd lanes are shifted down, multiplied, and their results
+    // shifted back up into the odd halves.
+    inline I4 MultiplyRoundShift(const I4& a, const I4& b, const int n)
+    {
+        const __m128i round = _mm_set1_epi64x(std::int64_t{1} << (n - 1));
+        const __m128i even = _mm_add_epi64(_mm_mul_epi32(a.v, b.v), round);
+        const __m128i odd = _mm_add_epi64(_mm_mul_epi32(_mm_srli_epi64(a.v, 32), _mm_srli_epi64(b.v, 32)), round);
+        return I4(_mm_blend_epi16(_mm_srl_epi64(even, _mm_cvtsi32_si128(n)),
+                                  _mm_sll_epi64(odd, _mm_cvtsi32_si128(32 - n)), 0xCC));
+    }
+
+    inline I4 operator&(const I4& a, const I4& b)
+    {
+        return I4(_mm_and_si128(a.v, b.v));
+    }
+
+    inline I4 operator|(const I4& a, const I4& b)
+    {
+        return I4(_mm_or_si128(a.v, b.v));
+    }
+
+    inline I4 operator^(const I4& a, const I4& b)
+    {
+        return I4(_mm_xor_si128(a.v, b.v));
+    }
+
+    inline I4 AndNot(const I4& a, const I4& b)
+    {
+        return I4(_mm_andnot_si128(a.v, b.v));
+    }
+
+    inline I4 ShiftLeft(const I4& a, const int n)
+    {
+        return I4(_mm_sll_epi32(a.v, _mm_cvtsi32_si128(n)));
+    }
+
+    inline I4 ShiftRightLogical(const I4& a, const int n)
+    {
+        return I4(_mm_srl_epi32(a.v, _mm_cvtsi32_si128(n)));
+    }
+
+    inline I4 operator==(const I4& a, const I4& b)
+    {
+        return I4(_mm_cmpeq_epi32(a.v, b.v));
+    }
+
+    inline I4 operator>(const I4& a, const I4& b)
+    {
+        return I4(_mm_cmpgt_epi32(a.v, b.v));
+    }
+
+    inline I4 operator<(const I4& a, const I4& b)
+    {
+        return I4(_mm_cmpgt_epi32(b.v, a.v));
+    }
+    inline I4 Gather(const std::int32_t* table, const I4& index)
+    {
+        alignas(16) std::array<std::int32_t, 4> idx{};
+        _mm_store_si128(reinterpret_cast<__m128i*>(idx.data()), index.v);
+        return I4(_mm_setr_epi32(table[idx[0]], table[idx[1]], table[idx[2]], table[idx[3]]));
+    }
+
+    inline std::uint32_t MoveMask(const I4& mask)
+    {
+        return static_cast<std::uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(mask.v)));
+    }
+#endif
+
+    // ---------------- AVX2 backend ----------------
+#if defined(__AVX2__)
+    template <>
+    struct Float<8>
+    {
+        __m256 v;
+
+        Float() :
+            v(_mm256_setzero_ps())
+        {}
+
+        Float(const float s) : // NOLINT(*-explicit-constructor) - broadcast reads like a scalar
+            v(_mm256_set1_ps(s))
+        {}
+
+        explicit Float(const __m256 x) :
+            v(x)
+        {}
+    };
+
+    template <>
+    struct Int<8>
+    {
+        __m256i v;
+
+        Int() :
+            v(_mm256_setzero_si256())
+        {}
+
+        Int(const std::int32_t s) : // NOLINT(*-explicit-constructor) - broadcast reads like a scalar
+            v(_mm256_set1_epi32(s))
+        {}
+
+        explicit Int(const __m256i x) :
+            v(x)
+        {}
+    };
+
+    using F8 = Float<8>;
+    using I8 = Int<8>;
+
+    inline F8 Load(const float* p, F8)
+    {
+        return F8(_mm256_loadu_ps(p));
+    }
+
+    inline I8 Load(const std::int32_t* p, I8)
+    {
+        return I8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+    }
+
+    inline void Store(float* p, const F8& a)
+    {
+        _mm256_storeu_ps(p, a.v);
+    }
+
+    inline void Store(std::int32_t* p, const I8& a)
+    {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), a.v);
+    }
+
+    inline F8 operator+(const F8& a, const F8& b)
+    {
+        return F8(_mm256_add_ps(a.v, b.v));
+    }
+
+    inline F8 operator-(const F8& a, const F8& b)
+    {
+        return F8(_mm256_sub_ps(a.v, b.v));
+    }
+
+    inline F8 operator*(const F8& a, const F8& b)
+    {
+        return F8(_mm256_mul_ps(a.v, b.v));
+    }
+
+    inline F8 operator/(const F8& a, const F8& b)
+    {
+        return F8(_mm256_div_ps(a.v, b.v));
+    }
+
+    inline F8 operator-(const F8& a)
+    {
+        return F8(_mm256_xor_ps(a.v, _mm256_set1_ps(-0.0F)));
+    }
+
+    inline F8 Min(const F8& a, const F8& b)
+    {
+        return F8(_mm256_min_ps(a.v, b.v));
+    }
+
+    inline F8 Max(const F8& a, const F8& b)
+    {
+        return F8(_mm256_max_ps(a.v, b.v));
+    }
+
+    inline F8 Floor(const F8& a)
+    {
+        return F8(_mm256_floor_ps(a.v));
+    }
+
+    inline F8 Abs(const F8& a)
+    {
+        return F8(_mm256_andnot_ps(_mm256_set1_ps(-0.0F), a.v));
+    }
+
+    inline F8 Sqrt(const F8& a)
+    {
+        return F8(_mm256_sqrt_ps(a.v));
+    }
+
+    inline I8 operator<(const F8& a, const F8& b)
+    {
+        return I8(_mm256_castps_si256(_mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ)));
+    }
+
+    inline I8 operator>(const F8& a, const F8& b)
+    {
+        return I8(_mm256_castps_si256(_mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ)));
+    }
+
+    inline I8 operator>=(const F8& a, const F8& b)
+    {
+        return I8(_mm256_castps_si256(_mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ)));
+    }
+
+    inline I8 operator<=(const F8& a, const F8& b)
+    {
+        return I8(_mm256_castps_si256(_mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ)));
+    }
+
+    inline F8 Select(const I8& mask, const F8& a, const F8& b)
+    {
+        return F8(_mm256_blendv_ps(b.v, a.v, _mm256_castsi256_ps(mask.v)));
+    }
+
+    inline I8 Select(const I8& mask, const I8& a, const I8& b)
+    {
+        return I8(_mm256_blendv_epi8(b.v, a.v, mask.v));
+    }
+
+    inline I8 ToInt(const F8& a)
+    {
+        return I8(_mm256_cvttps_epi32(a.v));
+    }
+
+    inline F8 ToFloat(const I8& a)
+    {
+        return F8(_mm256_cvtepi32_ps(a.v));
+    }
+
+    inline I8 operator+(const I8& a, const I8& b)
+    {
+        return I8(_mm256_add_epi32(a.v, b.v));
+    }
+
+    inline I8 operator-(const I8& a, const I8& b)
+    {
+        return I8(_mm256_sub_epi32(a.v, b.v));
+    }
+
+    inline I8 operator*(const I8& a, const I8& b)
+    {
+        return I8(_mm256_mullo_epi32(a.v, b.v));
+    }
+
+    inline I8 MultiplyRoundShift(const I8& a, const I8& b, const int n)
+    {
+        const __m256i round = _mm256_set1_epi64x(std::int64_t{1} << (n - 1));
+        const __m256i even = _mm256_add_epi64(_mm256_mul_epi32(a.v, b.v), round);
+        const __m256i odd =
+            _mm256_add_epi64(_mm256_mul_epi32(_mm256_srli_epi64(a.v, 32), _mm256_srli_epi64(b.v, 32)), round);
+        return I8(_mm256_blend_epi32(_mm256_srl_epi64(even, _mm_cvtsi32_si128(n)),
+                                     _mm256_sll_epi64(odd, _mm_cvtsi32_si128(32 - n)), 0xAA));
+    }
+
+    inline I8 operator&(const I8& a, const I8& b)
+    {
+        return I8(_mm256_and_si256(a.v, b.v));
+    }
+
+    inline I8 operator|(const I8& a, const I8& b)
+    {
+        return I8(_mm256_or_si256(a.v, b.v));
+    }
+
+    inline I8 operator^(const I8& a, const I8& b)
+    {
+        return I8(_mm256_xor_si256(a.v, b.v));
+    }
+
+    inline I8 AndNot(const I8& a, const I8& b)
+    {
+        return I8(_mm256_andnot_si256(a.v, b.v));
+    }
+
+    inline I8 ShiftLeft(const I8& a, const int n)
+    {
+        return I8(_mm256_sll_epi32(a.v, _mm_cvtsi32_si128(n)));
+    }
+
+    inline I8 ShiftRightLogical(const I8& a, const int n)
+    {
+        return I8(_mm256_srl_epi32(a.v, _mm_cvtsi32_si128(n)));
+    }
+
+    inline I8 operator==(const I8& a, const I8& b)
+    {
+        return I8(_mm256_cmpeq_epi32(a.v, b.v));
+    }
+
+    inline I8 operator>(const I8& a, const I8& b)
+    {
+        return I8(_mm256_cmpgt_epi32(a.v, b.v));
+    }
+
+    inline I8 operator<(const I8& a, const I8& b)
+    {
+        return I8(_mm256_cmpgt_epi32(b.v, a.v));
+    }
+    inline I8 Gather(const std::int32_t* table, const I8& index)
+    {
+        return I8(_mm256_i32gather_epi32(table, index.v, 4));
+    }
+
+    inline std::uint32_t MoveMask(const I8& mask)
+    {
+        return static_cast<std::uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(mask.v)));
+    }
+#endif
+}
+
+#endif //PSYGINE_SIMD_HPP
@@ -9,11 +9,6 @@
 namespace psygine::utilities::time
 {
 
-    types::TimePoint Now()
-    {
-        return types::Clock::now();
-    }
-
     types::Duration Elapsed(const types::TimePoint start, const types::TimePoint end)
     {
         return end - start;
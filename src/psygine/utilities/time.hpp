@@ -9,11 +9,15 @@
 
 #include <chrono>
 
+#include "timestamp.hpp"
+
 namespace psygine::utilities::time
 {
     namespace types
     {
-        using Clock = std::chrono::high_resolution_clock;
+        // high_resolution_clock may alias system_clock, which can jump; TickClock is monotonic and reads
+        // the invariant TSC or ARM counter where available.
+        using Clock = TickClock;
         using TimePoint = Clock::time_point;
         using Duration = Clock::duration;
     }
@@ -21,13 +25,16 @@ namespace psygine::utilities::time
     /**
      * Retrieves the current point in time as a `types::TimePoint`.
      *
-     * This function uses the high-resolution clock defined in `types::Clock`
-     * to fetch the current time. The returned value can be used for measuring
-     * elapsed time or other time-related calculations.
+     * This function uses the tick clock defined in `types::Clock`
+     * to fetch the current time. It is inline so a timestamp costs a
+     * counter read and a multiply rather than a call into the library.
      *
      * @return The current time as a `types::TimePoint`.
      */
-    types::TimePoint Now();
+    inline types::TimePoint Now()
+    {
+        return types::Clock::now();
+    }
 
     /**
      * Calculates the time duration between two time points.
@@ -0,0 +1,106 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#include "timestamp.hpp"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+namespace
+{
+    using psygine::utilities::time::TickSource;
+
+    // Long enough that the cost of the bracketing clock reads is a few parts per million of the window.
+    constexpr auto CALIBRATION_WINDOW = std::chrono::milliseconds(10);
+
+    TickSource DetectSource()
+    {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        int regs[4] = {};
+        __cpuid(regs, static_cast<int>(0x80000000U));
+        if (static_cast<unsigned>(regs[0]) >= 0x80000007U)
+        {
+            __cpuid(regs, static_cast<int>(0x80000007U));
+            if ((static_cast<unsigned>(regs[3]) & (1U << 8)) != 0)
+            {
+                return TickSource::Tsc;
+            }
+        }
+#elif defined(__x86_64__) || defined(__i386__)
+        // CPUID 0x80000007, EDX bit 8: invariant TSC.
+        unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+        if (__get_cpuid_max(0x80000000U, nullptr) >= 0x80000007U &&
+            __get_cpuid(0x80000007U, &eax, &ebx, &ecx, &edx) != 0 && (edx & (1U << 8)) != 0)
+        {
+            return TickSource::Tsc;
+        }
+#elif defined(__aarch64__)
+        return TickSource::VirtualCounter;
+#endif
+        // ReSharper disable once CppDFAUnreachableCode
+        return TickSource::SteadyClock;
+    }
+
+    std::uint64_t CounterFrequency([[maybe_unused]] const TickSource source)
+    {
+#if defined(__aarch64__)
+        if (source == TickSource::VirtualCounter)
+        {
+            std::uint64_t frequency = 0;
+            asm volatile("mrs %0, cntfrq_el0" : "=r"(frequency));
+            return frequency;
+        }
+#endif
+        return 0;
+    }
+}
+
+namespace psygine::utilities::time::detail
+{
+    TickCalibration Calibrate()
+    {
+        TickCalibration calibration{};
+        calibration.source = DetectSource();
+
+        if (calibration.source == TickSource::SteadyClock)
+        {
+            calibration.ticksPerSecond = 1.0e9;
+        }
+        else if (const std::uint64_t frequency = CounterFrequency(calibration.source); frequency != 0)
+        {
+            calibration.ticksPerSecond = static_cast<double>(frequency);
+        }
+        else
+        {
+            // Bracket each counter read between two clock reads and keep the midpoint, so preemption
+            // between the reads shows up as a wide bracket rather than as a skewed rate.
+            using SteadyClock = std::chrono::steady_clock;
+            const auto sample = [source = calibration.source](SteadyClock::time_point& at)
+            {
+                const auto before = SteadyClock::now();
+                const std::uint64_t ticks = ReadCounter(source);
+                const auto after = SteadyClock::now();
+                at = before + ((after - before) / 2);
+                return ticks;
+            };
+
+            SteadyClock::time_point start;
+            const std::uint64_t startTicks = sample(start);
+            while (SteadyClock::now() - start < CALIBRATION_WINDOW)
+            {
+            }
+            SteadyClock::time_point end;
+            const std::uint64_t endTicks = sample(end);
+
+            const double seconds = std::chrono::duration<double>(end - start).count();
+            calibration.ticksPerSecond = static_cast<double>(endTicks - startTicks) / seconds;
+        }
+
+        calibration.nanosecondsPerTick = 1.0e9 / calibration.ticksPerSecond;
+        calibration.originTicks = ReadCounter(calibration.source);
+        return calibration;
+    }
+}
@@ -0,0 +1,316 @@
+﻿//  SPDX-FileCopyrightText: 2025 Kevin Blomqvist
+//  SPDX-License-Identifier: MIT
+
+#ifndef PSYGINE_WEIGHTED_SAMPLER_HPP
+#define PSYGINE_WEIGHTED_SAMPLER_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "random_bulk.hpp"
+#include "psygine/debug/assert.hpp"
+
+namespace psygine::utilities::random
+{
+    /**
+     * @brief Controls when a `WeightedSampler` rebuilds its alias table after weights change.
+     *
+     * - `Immediate`: every `setWeight` rebuilds the table before returning.
+     * - `Lazy`: changes are batched and the table is rebuilt on the next sample.
+     * - `Manual`: the table is only rebuilt by an explicit `rebuild()` call; samples keep using the
+     *   previous table until then, which lets callers amortize a burst of edits over a chosen frame.
+     */
+    enum class RebuildPolicy : std::uint8_t
+    {
+        Immediate,
+        Lazy,
+        Manual
+    };
+
+    /**
+     * @brief Weighted discrete sampler based on Vose's alias method.
+     *
+     * Construction and rebuilds are O(n); each sample is O(1): one uniform column pick and one
+     * biased coin flip against that column's threshold. Thresholds are stored as 32-bit fixed point
+     * next to their alias so a sample touches a single table entry.
+     *
+     * Works with any engine accepted by `random.hpp`. Batch sampling pulls its random words in bulk,
+     * which is vectorized when the engine is a `SimdRng`.
+     */
+    class WeightedSampler
+    {
+    public:
+        WeightedSampler() = default;
+
+        /**
+         * @brief Constructs a sampler over the given weights.
+         *
+         * @param weights Non-negative weights; at least one must be positive.
+         * @param policy When to rebuild the alias table after `setWeight`.
+         */
+        explicit WeightedSampler(const std::span<const double> weights,
+                                 const RebuildPolicy policy = RebuildPolicy::Lazy) :
+            policy_{policy}
+        {
+            assign(weights);
+        }
+
+        /**
+         * @brief Replaces all weights and rebuilds the table immediately.
+         *
+         * @param weights Non-negative weights; at least one must be positive.
+         */
+        void assign(const std::span<const double> weights)
+        {
+            PSYGINE_ASSERT(weights.size() <= std::numeric_limits<std::uint32_t>::max(),
+                           "WeightedSampler: too many weights");
+            weights_.assign(weights.begin(), weights.end());
+            rebuild();
+        }
+
+        /**
+         * @brief Changes a single weight, rebuilding according to the sampler's policy.
+         *
+         * @param index The index of the weight to change.
+         * @param weight The new non-negative weight.
+         */
+        void setWeight(const std::size_t index, const double weight)
+        {
+            PSYGINE_DEBUG_ASSERT(index < weights_.size(), "WeightedSampler: index out of range");
+            PSYGINE_DEBUG_ASSERT(weight >= 0.0, "WeightedSampler: weights must be non-negative");
+            weights_[index] = weight;
+            dirty_ = true;
+
+            if (policy_ == RebuildPolicy::Immediate)
+            {
+                rebuild();
+            }
+        }
+
+        /**
+         * @brief Rebuilds the alias table from the current weights in O(n).
+         */
+        void rebuild()
+        {
+            const std::size_t n = weights_.size();
+            table_.resize(n);
+            dirty_ = false;
+
+            total_ = 0.0;
+            for (const double w : weights_)
+            {
+                PSYGINE_DEBUG_ASSERT(w >= 0.0, "WeightedSampler: weights must be non-negative");
+                total_ += w;
+            }
+            if (n == 0)
+            {
+                return;
+            }
+            PSYGINE_ASSERT(total_ > 0.0, "WeightedSampler: total weight must be positive");
+
+            // Scaled probabilities; small entries fill the work list from the front, large from the back.
+            scaled_.resize(n);
+            work_.resize(n);
+            const double scale = static_cast<double>(n) / total_;
+            std::size_t smallCount = 0;
+            std::size_t largeBegin = n;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                scaled_[i] = weights_[i] * scale;
+                if (scaled_[i] < 1.0)
+                {
+                    work_[smallCount++] = static_cast<std::uint32_t>(i);
+                }
+                else
+                {
+                    work_[--largeBegin] = static_cast<std::uint32_t>(i);
+                }
+            }
+
+            std::size_t smallTop = smallCount;
+            std::size_t largeTop = largeBegin;
+            while (smallTop > 0 && largeTop < n)
+            {
+                const std::uint32_t small = work_[--smallTop];
+                const std::uint32_t large = work_[largeTop];
+
+                table_[small] = Entry{.threshold = ToThreshold(scaled_[small]), .alias = large};
+                scaled_[large] = (scaled_[large] + scaled_[small]) - 1.0;
+
+                if (scaled_[large] < 1.0)
+                {
+                    // The large entry became small; move it onto the small stack.
+                    ++largeTop;
+                    work_[smallTop++] = large;
+                }
+            }
+
+            // Whatever remains is 1 up to rounding error.
+            while (largeTop < n)
+            {
+                const std::uint32_t i = work_[largeTop++];
+                table_[i] = Entry{.threshold = ALWAYS, .alias = i};
+            }
+            while (smallTop > 0)
+            {
+                const std::uint32_t i = work_[--smallTop];
+                table_[i] = Entry{.threshold = ALWAYS, .alias = i};
+            }
+        }
+
+        /**
+         * @brief Draws one index with probability proportional to its weight.
+         *
+         * @param rng The engine to draw from.
+         * @return The sampled index.
+         */
+        template <std::uniform_random_bit_generator Engine>
+        [[nodiscard]] std::size_t sample(Engine& rng)
+        {
+            ensureBuilt();
+            std::array<std::uint32_t, 2> bits{};
+            detail::FillBits(rng, std::span(bits));
+            return pick(rng, bits[0], bits[1]);
+        }
+
+        /**
+         * @brief Fills `out` with independently sampled indices.
+         *
+         * @param rng The engine to draw from.
+         * @param out The destination span.
+         */
+        template <std::uniform_random_bit_generator Engine, std::integral Index>
+        void sample(Engine& rng, std::span<Index> out)
+        {
+            ensureBuilt();
+            PSYGINE_DEBUG_ASSERT(table_.size() - 1 <= static_cast<std::size_t>(std::numeric_limits<Index>::max()),
+                                 "WeightedSampler: index type too narrow");
+
+            std::array<std::uint32_t, 2 * detail::BULK_BLOCK_SIZE> bits{};
+            for (std::size_t base = 0; base < out.size(); base += detail::BULK_BLOCK_SIZE)
+            {
+                const std::size_t n = std::min(detail::BULK_BLOCK_SIZE, out.size() - base);
+                detail::FillBits(rng, std::span(bits.data(), 2 * n));
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    out[base + i] = static_cast<Index>(pick(rng, bits[2 * i], bits[(2 * i) + 1]));
+                }
+            }
+        }
+
+        /**
+         * @brief Draws one index; allows the sampler to be used like a distribution.
+         */
+        template <std::uniform_random_bit_generator Engine>
+        [[nodiscard]] std::size_t operator()(Engine& rng)
+        {
+            return sample(rng);
+        }
+
+        [[nodiscard]] std::size_t size() const
+        {
+            return weights_.size();
+        }
+
+        [[nodiscard]] bool empty() const
+        {
+            return weights_.empty();
+        }
+
+        [[nodiscard]] double weight(const std::size_t index) const
+        {
+            return weights_[index];
+        }
+
+        /**
+         * @brief Sum of the weights the current table was built from.
+         */
+        [[nodiscard]] double totalWeight() const
+        {
+            return total_;
+        }
+
+        /**
+         * @brief True when weights changed since the last rebuild.
+         */
+        [[nodiscard]] bool dirty() const
+        {
+            return dirty_;
+        }
+
+        [[nodiscard]] RebuildPolicy policy() const
+        {
+            return policy_;
+        }
+
+        void setPolicy(const RebuildPolicy policy)
+        {
+            policy_ = policy;
+        }
+
+    private:
+        struct Entry
+        {
+            std::uint32_t threshold;
+            std::uint32_t alias;
+        };
+
+        static constexpr std::uint32_t ALWAYS = std::numeric_limits<std::uint32_t>::max();
+
+        static std::uint32_t ToThreshold(const double probability)
+        {
+            if (probability >= 1.0)
+            {
+                return ALWAYS;
+            }
+            return static_cast<std::uint32_t>(probability * 4294967296.0);
+        }
+
+        void ensureBuilt()
+        {
+            if (dirty_ && policy_ == RebuildPolicy::Lazy)
+            {
+                rebuild();
+            }
+            PSYGINE_DEBUG_ASSERT(!table_.empty(), "WeightedSampler: sampling from an empty sampler");
+        }
+
+        // Lemire's unbiased reduction of `columnBits` onto the table, then the alias coin flip.
+        template <typename Engine>
+        std::size_t pick(Engine& rng, std::uint32_t columnBits, const std::uint32_t coinBits) const
+        {
+            const auto n = static_cast<std::uint64_t>(table_.size());
+            std::uint64_t product = static_cast<std::uint64_t>(columnBits) * n;
+            if (static_cast<std::uint32_t>(product) < n)
+            {
+                const auto threshold = static_cast<std::uint32_t>((std::uint64_t{1} << 32) % n);
+                while (static_cast<std::uint32_t>(product) < threshold)
+                {
+                    detail::FillBits(rng, std::span(&columnBits, 1));
+                    product = static_cast<std::uint64_t>(columnBits) * n;
+                }
+            }
+
+            const Entry& entry = table_[static_cast<std::size_t>(product >> 32)];
+            return coinBits < entry.threshold ? static_cast<std::size_t>(product >> 32) : entry.alias;
+        }
+
+        RebuildPolicy policy_ = RebuildPolicy::Lazy;
+        bool dirty_ = false;
+        double total_ = 0.0;
+
+        std::vector<double> weights_;
+        std::vector<Entry> table_;
+
+        // Scratch reused across rebuilds so reweighting does not allocate.
+        std::vector<double> scaled_;
+        std::vector<std::uint32_t> work_;
+    };
+}
+
+#endif //PSYGINE_WEIGHTED_SAMPLER_HPP